@@ -23,14 +23,21 @@
 struct ArrayList{
 
     int size;
+    int elementSize;
     void **pElements;
     int reservedSize;
+    float growthFactor;
+    void (*pAddHook)(void*, void*);
+    void *pHookContext;
+    void (*pRemoveHook)(void*, void*);
+    void *pRemoveHookContext;
 
     int     (*add)();
     int     (*len)();
     int     (*set)();
     int     (*push)();
     int     (*sort)();
+    int     (*sortByKey)();
     int     (*clear)();
     int     (*remove)();
     int     (*indexOf)();
@@ -38,6 +45,9 @@ struct ArrayList{
     int     (*contains)();
     int     (*containsAll)();
     int     (*deleteArrayList)();
+    int     (*reserve)();
+    int     (*shrinkToFit)();
+    int     (*addArray)();
     void*   (*get)();
     void*   (*pop)();
     struct ArrayList* (*clone)();
@@ -54,16 +64,36 @@ struct ArrayList{
 ArrayList *al_newArrayList(void);
 
 /**
- * \brief Add an element to arrayList and if is necessary resize the array
+ * \brief Allocate a new arrayList with AL_INITIAL_VALUE elements that stores copies of the elements by value,
+ *        one after the other in a single block of memory
+ * \param int elementSize size in bytes of every element
+ * \return ArrayList *pAux Return (NULL) if error [invalid elementSize or if can't allocate memory]
+ *                              - (pointer to new arrayList) if ok
+ */
+ArrayList *al_newTypedArrayList(int elementSize);
+
+/**
+ * \brief Add an element to arrayList and if is necessary resize the array. Typed lists store a copy of the element
  * \param ArrayList *this pointer to arrayList
  * \param void *pElement Pointer to element
- * \return int value return (-1) if error [this or pElement are NULL pointer]
+ * \return int value return (-1) if error [this or pElement are NULL pointer or if can't allocate memory]
  *                           (0) if ok
  */
 int al_add(ArrayList *this, void *pElement);
 
 /**
- * \brief Delete arrayList
+ * \brief Add count elements stored one after the other in pElements, resizing the array only once.
+ *        Typed lists copy count values, the other lists copy count pointers
+ * \param ArrayList *this pointer to arrayList
+ * \param void *pElements pointer to the first element
+ * \param int count number of elements
+ * \return int value return (-1) if error [this or pElements are NULL pointer, invalid count or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_addArray(ArrayList *this, void *pElements, int count);
+
+/**
+ * \brief Delete arrayList. The elements of a list of pointers are not released, they belong to the caller
  * \param ArrayList *this pointer to arrayList
  * \return int value return (-1) if error [this is NULL pointer]
  *                           (0) if ok
@@ -78,7 +108,7 @@ int al_deleteArrayList(ArrayList *this);
 int al_len(ArrayList *this);
 
 /**
- * \brief Get an element by index
+ * \brief Get an element by index. In typed lists the pointer is valid until this is modified
  * \param ArrayList *this pointer to arrayList
  * \param int index Index of the element
  * \return void *pAux return (NULL) if error [this is NULL pointer or invalid index]
@@ -116,7 +146,7 @@ int al_set(ArrayList *this, int index, void *pElement);
 int al_remove(ArrayList *this, int index);
 
 /**
- * \brief Removes all of the elements from this list
+ * \brief Removes all of the elements from this list. The elements of a list of pointers are released
  * \param ArrayList *this pointer to arrayList
  * \return int value return (-1) if error [this is NULL pointer]
  *                           (0) if ok
@@ -160,7 +190,7 @@ int al_indexOf(ArrayList *this, void *pElement);
 int al_isEmpty(ArrayList *this);
 
 /**
- * \brief Remove the item at the given position in the list, and return it.
+ * \brief Remove the item at the given position in the list, and return it. In typed lists the pointer is valid until this is modified
  * \param ArrayList *this pointer to arrayList
  * \param int index Index of the element
  * \return void *pAux return (NULL) if error [this is NULL pointer or invalid index]
@@ -190,19 +220,101 @@ ArrayList *al_subList(ArrayList *this, int from, int to);
 int al_containsAll(ArrayList *this, ArrayList *this2);
 
 /**
- * \brief Sorts objects of list, use compare pFunction
+ * \brief Sorts objects of list, use compare pFunction. The sort is stable and takes advantage of the runs already
+ *        sorted in the list (natural merge sort), O(n log n) in the worst case and O(n) if the list is already sorted
  * \param ArrayList *this pointer to arrayList
  * \param pFunction (*pFunction) pointer to function to compare elements of arrayList
  * \param int order [1] indicate UP - [0] indicate DOWN
- * \return int value return (-1) if error [this or pFunc are NULL pointer]
+ * \return int value return (-1) if error [this or pFunc are NULL pointer, invalid order or if can't allocate memory]
  *                           (0) if ok
  */
 int al_sort(ArrayList *this, int (*pFunction)(void*, void*), int order);
 
+/**
+ * \brief Sorts objects of list by an integer key using a stable LSD radix sort, O(n) for any number of elements
+ * \param ArrayList *this pointer to arrayList
+ * \param pFunction (*pFunction) pointer to function that returns the key of an element of arrayList
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \return int value return (-1) if error [this or pFunc are NULL pointer, invalid order or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_sortByKey(ArrayList *this, long long (*pFunction)(void*), int order);
+
+/**
+ * \brief Requests that the capacity of this be at least enough to contain reservedSize elements
+ * \param ArrayList *this pointer to arrayList
+ * \param int reservedSize minimum number of elements to be reserved
+ * \return int value return (-1) if error [this is NULL pointer, invalid reservedSize or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_reserve(ArrayList *this, int reservedSize);
+
+/**
+ * \brief Reduces the capacity of this to the number of elements it contains
+ * \param ArrayList *this pointer to arrayList
+ * \return int value return (-1) if error [this is NULL pointer or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_shrinkToFit(ArrayList *this);
+
+/**
+ * \brief Sets the factor by which the capacity of this is multiplied every time it is full
+ * \param ArrayList *this pointer to arrayList
+ * \param float growthFactor new growth factor, must be greater than 1
+ * \return int value return (-1) if error [this is NULL pointer or invalid growthFactor]
+ *                           (0) if ok
+ */
+int al_setGrowthFactor(ArrayList *this, float growthFactor);
+
+/**
+ * \brief Sets a function that is called with every element added to this by al_add, al_addArray, al_addReserved,
+ *        al_push or al_set. Clones and sub lists don't inherit it
+ * \param ArrayList *this pointer to arrayList
+ * \param void (*pFunction)(void*, void*) function called with pContext and the added element as al_get returns it,
+ *        (NULL) to remove the hook
+ * \param void *pContext pointer passed as first argument of pFunction
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int al_setAddHook(ArrayList *this, void (*pFunction)(void*, void*), void *pContext);
+
+/**
+ * \brief Sets a function that is called with every element that leaves this through al_remove, al_pop, al_clear or
+ *        al_set, before it is removed or replaced. Clones and sub lists don't inherit it
+ * \param ArrayList *this pointer to arrayList
+ * \param void (*pFunction)(void*, void*) function called with pContext and the element as al_get returns it,
+ *        (NULL) to remove the hook
+ * \param void *pContext pointer passed as first argument of pFunction
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int al_setRemoveHook(ArrayList *this, void (*pFunction)(void*, void*), void *pContext);
+
+/**
+ * \brief Reserves room for count more elements at the end of a typed list and returns the address of the first one,
+ *        so they can be written in place, even from several threads. They are not part of this until al_addReserved
+ * \param ArrayList *this pointer to arrayList
+ * \param int count number of elements
+ * \return void *pAux return (NULL) if error [this is NULL pointer, this is not a typed list, invalid count or if can't
+ *                           allocate memory]
+ *                         - (pointer to the slot after the last element) if ok
+ */
+void *al_reserveTail(ArrayList *this, int count);
+
+/**
+ * \brief Adds to this the first count elements written after the last element in the memory returned by
+ *        al_reserveTail. Nothing else can be added to this in between
+ * \param ArrayList *this pointer to arrayList
+ * \param int count number of elements
+ * \return int value return (-1) if error [this is NULL pointer or invalid count]
+ *                           (0) if ok
+ */
+int al_addReserved(ArrayList *this, int count);
+
 
 // PRIVATE FUNCTIONS
 /**
- * \brief Increment the number of elements in this in AL_INCREMENT elements.
+ * \brief Multiply the number of elements reserved in this by its growth factor.
  * \param ArrayList *this pointer to arrayList
  * \return int value return (-1) if error [this is NULL pointer or if can't allocate memory]
  *                           (0) if ok
@@ -227,4 +339,90 @@ int expand(ArrayList *this, int index);
  */
 int contract(ArrayList *this, int index);
 
+/**
+ * \brief Allocate a new arrayList with AL_INITIAL_VALUE elements.
+ * \param int elementSize size in bytes of the elements stored by value, (0) to store pointers
+ * \return ArrayList *pAux Return (NULL) if error [if can't allocate memory]
+ *                              - (pointer to new arrayList) if ok
+ */
+ArrayList *newArrayList(int elementSize);
+
+/**
+ * \brief Size in bytes of every slot of the array
+ * \param ArrayList *this pointer to arrayList
+ * \return int value size of an element in typed lists, size of a pointer in the other lists
+ */
+int slotSize(ArrayList *this);
+
+/**
+ * \brief Address of the slot at index position
+ * \param ArrayList *this pointer to arrayList
+ * \param int index Index of the slot
+ * \return void *pAux pointer to the slot
+ */
+void *slotAt(ArrayList *this, int index);
+
+/**
+ * \brief Store an element in the slot at index position. Typed lists copy the element, the other lists the pointer
+ * \param ArrayList *this pointer to arrayList
+ * \param int index Index of the slot
+ * \param void *pElement pointer to element
+ * \return void
+ */
+void storeAt(ArrayList *this, int index, void *pElement);
+
+/**
+ * \brief Compare the element at index position with pElement. Typed lists compare values, the other lists pointers
+ * \param ArrayList *this pointer to arrayList
+ * \param int index Index of the element
+ * \param void *pElement pointer to element
+ * \return int value return (1) if they are equal
+ *                           (0) if not
+ */
+int equalsAt(ArrayList *this, int index, void *pElement);
+
+/**
+ * \brief Compare two slots of the array in the given order
+ * \param ArrayList *this pointer to arrayList
+ * \param pFunction (*pFunction) pointer to function to compare elements of arrayList
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \param void *pFirst pointer to the first slot
+ * \param void *pSecond pointer to the second slot
+ * \return int value (> 0) if the first element must be placed after the second, (<= 0) if not
+ */
+int compareSlots(ArrayList *this, int (*pFunction)(void*, void*), int order, void *pFirst, void *pSecond);
+
+/**
+ * \brief Merge the sorted slots [from, middle) and [middle, to) of pSource into the same positions of pTarget.
+ *        On equal elements the one on the left is placed first, so the merge is stable
+ * \param ArrayList *this pointer to arrayList
+ * \param pFunction (*pFunction) pointer to function to compare elements of arrayList
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \param char *pSource array with the sorted runs
+ * \param char *pTarget array where the merged run is written
+ * \param int from index of the first slot of the left run
+ * \param int middle index of the first slot of the right run
+ * \param int to index after the last slot of the right run
+ * \return void
+ */
+void mergeSlots(ArrayList *this, int (*pFunction)(void*, void*), int order, char *pSource, char *pTarget, int from, int middle, int to);
+
+/**
+ * \brief Call the add hook of this with the elements between from and to
+ * \param ArrayList *this pointer to arrayList
+ * \param int from Index of the first added element
+ * \param int to Index after the last added element
+ * \return void
+ */
+void notifyAdd(ArrayList *this, int from, int to);
+
+/**
+ * \brief Call the remove hook of this with the elements between from and to
+ * \param ArrayList *this pointer to arrayList
+ * \param int from Index of the first removed element
+ * \param int to Index after the last removed element
+ * \return void
+ */
+void notifyRemove(ArrayList *this, int from, int to);
+
 #endif // ARRAYLIST_H_INCLUDED
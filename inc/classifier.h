@@ -0,0 +1,57 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLASSIFIER_H_INCLUDED
+#define CLASSIFIER_H_INCLUDED
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// CODIGOS DE LOS TIPOS DE EVENTO, EN EL ORDEN EN QUE SE EVALUAN LAS REGLAS
+#define CL_BOOT_BY_TEMPERATURE 0
+#define CL_STOP_BY_TEMPERATURE 1
+#define CL_BOOT_BY_HUMIDITY 2
+#define CL_STOP_BY_HUMIDITY 3
+
+// JUEGOS DE INSTRUCCIONES DE LA CLASIFICACION
+#define CL_SCALAR 0
+#define CL_SSE2 1
+#define CL_AVX2 2
+
+/**
+ * \brief Classify a block of readings with the rules of the event types, in order: boot by temperature if the
+ *        temperature is over the boot threshold and the humidity is not under its threshold, stop by temperature
+ *        if the temperature is under the stop threshold, boot by humidity if the humidity is over its threshold
+ *        and stop by humidity if not. AVX2 or SSE2 are used when the processor has them
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \param unsigned char *pTypes pointer where the CL_ code of each reading is written
+ * \return int value return (-1) if error [NULL pointer or invalid count]
+ *                           (0) if ok
+ */
+int cl_classify(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+
+/**
+ * \brief Get the instruction set used by the classification
+ * \param -
+ * \return int value [CL_SCALAR] [CL_SSE2] [CL_AVX2]
+ */
+int cl_getInstructionSet(void);
+
+#endif // CLASSIFIER_H_INCLUDED
@@ -0,0 +1,168 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+#ifndef COLUMNSTORE_H_INCLUDED
+#define COLUMNSTORE_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CANTIDAD INICIAL DE EVENTOS DE LAS COLUMNAS
+#define CS_INITIAL_SIZE 1024
+
+// CANTIDAD DE EVENTOS POR BLOQUE DE LOS RECORRIDOS
+#define CS_SCAN_BLOCK 256
+
+struct ColumnStore{
+
+    int size;
+    int reservedSize;
+    long long *pTimestamps;
+    unsigned char *pEventTypes;
+    int *pTemperatures;
+    int *pHumidities;
+    int *pEmployees;
+
+}typedef ColumnStore;
+
+/**
+ * \brief Allocate an empty store of events kept by columns: one contiguous array for every field, so a scan over a
+ *        field only reads that field
+ * \param -
+ * \return ColumnStore *pAux Return (NULL) if error [if can't allocate memory]
+ *                                - (pointer to new column store) if ok
+ */
+ColumnStore *cs_newColumnStore(void);
+
+/**
+ * \brief Get the number of events of the store
+ * \param ColumnStore *this pointer to column store
+ * \return int value return number of events or (-1) if error [this is NULL pointer]
+ */
+int cs_len(ColumnStore *this);
+
+/**
+ * \brief Make room for reservedSize events in every column, the events already stored are kept. It does nothing if
+ *        there is already room
+ * \param ColumnStore *this pointer to column store
+ * \param int reservedSize number of events
+ * \return int value return (-1) if error [this is NULL pointer, invalid reservedSize or if can't allocate memory]
+ *                           (0) if ok
+ */
+int cs_reserve(ColumnStore *this, int reservedSize);
+
+/**
+ * \brief Append an event at the end of the store, making room in the columns when they are full
+ * \param ColumnStore *this pointer to column store
+ * \param long long timestamp time of the event in seconds since the epoch
+ * \param int eventType type of the event, from 0 to 255
+ * \param int temperature temperature read in hundredths of a degree
+ * \param int humidity humidity read
+ * \param int employee id of the operator
+ * \return int value return (-1) if error [this is NULL pointer or if can't allocate memory]
+ *                           (0) if ok
+ */
+int cs_add(ColumnStore *this, long long timestamp, int eventType, int temperature, int humidity, int employee);
+
+/**
+ * \brief Write an event at a position of the reserved room of the store, without changing the number of events. Several
+ *        threads can write different positions at once, the events are made part of the store with cs_resize
+ * \param ColumnStore *this pointer to column store
+ * \param int index position of the event, less than the reserved size
+ * \param long long timestamp time of the event in seconds since the epoch
+ * \param int eventType type of the event, from 0 to 255
+ * \param int temperature temperature read in hundredths of a degree
+ * \param int humidity humidity read
+ * \param int employee id of the operator
+ * \return int value return (-1) if error [this is NULL pointer or invalid index]
+ *                           (0) if ok
+ */
+int cs_set(ColumnStore *this, int index, long long timestamp, int eventType, int temperature, int humidity, int employee);
+
+/**
+ * \brief Set the number of events of the store. It drops the events from size on, or adds the ones written with cs_set
+ *        up to size
+ * \param ColumnStore *this pointer to column store
+ * \param int size number of events, not greater than the reserved size
+ * \return int value return (-1) if error [this is NULL pointer or invalid size]
+ *                           (0) if ok
+ */
+int cs_resize(ColumnStore *this, int size);
+
+/**
+ * \brief Remove every event of the store and release the memory of the columns
+ * \param ColumnStore *this pointer to column store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int cs_clear(ColumnStore *this);
+
+/**
+ * \brief Find the first event at or after a time. The events are expected in chronological order, it is a binary
+ *        search over the timestamps column
+ * \param ColumnStore *this pointer to column store
+ * \param long long timestamp time in seconds since the epoch
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (index of the first event with timestamp greater or equal, the number of events if there is
+ *                          none) if ok
+ */
+int cs_find(ColumnStore *this, long long timestamp);
+
+/**
+ * \brief Add the temperatures of count events from first on, leaving out the events of a type. The column is read in
+ *        blocks of CS_SCAN_BLOCK events, whose loop the compiler turns into vector instructions
+ * \param ColumnStore *this pointer to column store
+ * \param int first index of the first event
+ * \param int count number of events
+ * \param int excludedType type of the events left out, (-1) to add all
+ * \param long long *pSum pointer where the sum in hundredths of a degree is written
+ * \return int value return (-1) if error [this or pSum are NULL pointer or invalid range]
+ *                          (number of temperatures added) if ok
+ */
+int cs_sumTemperatures(ColumnStore *this, int first, int count, int excludedType, long long *pSum);
+
+/**
+ * \brief Count the events from first on whose humidity is greater than a threshold, leaving out the events of a type.
+ *        The column is read in blocks of CS_SCAN_BLOCK events, whose loop the compiler turns into vector instructions
+ * \param ColumnStore *this pointer to column store
+ * \param int first index of the first event
+ * \param int count number of events
+ * \param int excludedType type of the events left out, (-1) to count all
+ * \param int threshold humidity threshold
+ * \return int value return (-1) if error [this is NULL pointer or invalid range]
+ *                          (number of events over the threshold) if ok
+ */
+int cs_countHumidityAbove(ColumnStore *this, int first, int count, int excludedType, int threshold);
+
+/**
+ * \brief Count the events of a type from first on
+ * \param ColumnStore *this pointer to column store
+ * \param int first index of the first event
+ * \param int count number of events
+ * \param int eventType type of the events counted
+ * \return int value return (-1) if error [this is NULL pointer or invalid range]
+ *                          (number of events of the type) if ok
+ */
+int cs_countType(ColumnStore *this, int first, int count, int eventType);
+
+/**
+ * \brief Release the column store
+ * \param ColumnStore *this pointer to column store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int cs_deleteColumnStore(ColumnStore *this);
+
+#endif // COLUMNSTORE_H_INCLUDED
@@ -0,0 +1,69 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONFIGWATCH_H_INCLUDED
+#define CONFIGWATCH_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// LONGITUD MAXIMA DE LA RUTA DEL ARCHIVO VIGILADO
+#define CW_MAX_PATH 1024
+
+// BYTES DE EVENTOS LEIDOS POR LLAMADA
+#define CW_EVENT_BUFFER 4096
+
+// ESPERA SIN CAMBIOS ANTES DE AVISAR, AGRUPA LAS ESCRITURAS DE UN MISMO GUARDADO
+#define CW_SETTLE_MS 50
+
+struct ConfigWatch{
+
+    char directory[CW_MAX_PATH];
+    char fileName[CW_MAX_PATH];
+    int notifyFd;
+    int stopFds[2];
+    pthread_t thread;
+
+    // se llama desde el hilo del vigilante
+    void (*pFunction)(void*);
+    void *pContext;
+
+}typedef ConfigWatch;
+
+/**
+ * \brief Starts a thread that watches a file and calls pFunction(pContext) from that thread every time the file is
+ *        written and closed or replaced by another one, as editors that save to a temporary file do. Changes that
+ *        arrive less than CW_SETTLE_MS apart are reported once. The directory of the file is watched, so the file
+ *        can be deleted and created again
+ * \param char *path path of the watched file
+ * \param void (*pFunction)(void*) function called after every change
+ * \param void *pContext pointer given to pFunction
+ * \return ConfigWatch *pAux Return (NULL) if error [path or pFunction are NULL pointer, path too long, the system
+ *                                 can't watch files, can't allocate memory or can't start the thread]
+ *                               - (pointer to new config watch) if ok
+ */
+ConfigWatch *cw_newConfigWatch(char *path, void (*pFunction)(void*), void *pContext);
+
+/**
+ * \brief Stops the thread of the watch, waiting for a call to pFunction in progress, and frees it
+ * \param ConfigWatch *this pointer to config watch
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int cw_deleteConfigWatch(ConfigWatch *this);
+
+#endif // CONFIGWATCH_H_INCLUDED
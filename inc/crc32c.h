@@ -0,0 +1,54 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CRC32C_H_INCLUDED
+#define CRC32C_H_INCLUDED
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// POLINOMIO CRC32C (CASTAGNOLI) INVERTIDO
+#define CRC_POLYNOMIAL 0x82F63B78u
+
+// VALOR INICIAL Y XOR FINAL
+#define CRC_INITIAL 0xFFFFFFFFu
+
+/**
+ * \brief Continue a CRC32C over a block of bytes, without the initial value and the final xor. The SSE4.2 crc32
+ *        instruction is used when the processor has it, a table of 8 x 256 entries when not
+ * \param unsigned int crc value of the CRC over the previous bytes
+ * \param void *pData pointer to the bytes
+ * \param int length number of bytes
+ * \return unsigned int value the CRC over the previous bytes and the block
+ */
+unsigned int crc_update(unsigned int crc, void *pData, int length);
+
+/**
+ * \brief Calculate the CRC32C of a block of bytes
+ * \param void *pData pointer to the bytes
+ * \param int length number of bytes
+ * \return unsigned int value the CRC32C of the block
+ */
+unsigned int crc_checksum(void *pData, int length);
+
+/**
+ * \brief Check if the CRC is calculated with the instruction of the processor
+ * \param -
+ * \return int value 1 if the SSE4.2 crc32 instruction is used - 0 if the table is used
+ */
+int crc_isHardware(void);
+
+#endif // CRC32C_H_INCLUDED
@@ -0,0 +1,130 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef EVENTLOG_H_INCLUDED
+#define EVENTLOG_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+// POLITICAS DE SINCRONIZACION
+#define EL_SYNC_NONE 0
+#define EL_SYNC_FLUSH 1
+#define EL_SYNC_FULL 2
+#define EL_SYNC_GROUP 3
+
+// VALORES INICIALES DEL COMMIT EN GRUPO
+#define EL_GROUP_SIZE 64
+#define EL_GROUP_INTERVAL 100
+
+struct EventLog{
+
+    FILE *file;
+    int recordSize;
+    int syncPolicy;
+    int count;
+
+    int groupSize;
+    int groupInterval;
+    int pending;
+    int error;
+    int running;
+    struct timespec deadline;
+    pthread_t committer;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+
+}typedef EventLog;
+
+/**
+ * \brief Open an append-only log of fixed size records. If the file does not exist or is empty it is created
+ *        and pHeader is written at the beginning. The count of the log starts with the records already stored
+ * \param char *fileName path of the log file
+ * \param void *pHeader pointer to the header of the file, (NULL) if the file has no header
+ * \param int headerSize size in bytes of the header
+ * \param int recordSize size in bytes of every record
+ * \param int syncPolicy [EL_SYNC_NONE] records stay in the stdio buffer until el_sync or close
+ *                       [EL_SYNC_FLUSH] every record is handed to the operating system
+ *                       [EL_SYNC_FULL] every record is forced to the storage device
+ *                       [EL_SYNC_GROUP] records are forced to the storage device in groups, see el_setSyncPolicy
+ * \return EventLog *pAux Return (NULL) if error [invalid parameters or can't open the file]
+ *                             - (pointer to new event log) if ok
+ */
+EventLog *el_newEventLog(char *fileName, void *pHeader, int headerSize, int recordSize, int syncPolicy);
+
+/**
+ * \brief Change the sync policy of an open log. Records pending of the previous policy are forced to the storage
+ *        device first. With EL_SYNC_GROUP a background thread forces the records to the storage device with a
+ *        single sync when groupSize records are pending or groupInterval milliseconds after the first of them was
+ *        appended, whatever happens first, so at most that window of records can be lost
+ * \param EventLog *this pointer to event log
+ * \param int syncPolicy EL_SYNC_NONE, EL_SYNC_FLUSH, EL_SYNC_FULL or EL_SYNC_GROUP
+ * \param int groupSize maximum number of records of a group, only used by EL_SYNC_GROUP
+ * \param int groupInterval maximum time in milliseconds a record waits for its group, only used by EL_SYNC_GROUP
+ * \return int value return (-1) if error [this is NULL pointer, invalid parameters or can't start the thread]
+ *                           (0) if ok
+ */
+int el_setSyncPolicy(EventLog *this, int syncPolicy, int groupSize, int groupInterval);
+
+/**
+ * \brief Append one record to the end of the log, honoring the sync policy. It can be called from several threads
+ * \param EventLog *this pointer to event log
+ * \param void *pRecord pointer to the record to write
+ * \return int value return (-1) if error [this or pRecord are NULL pointer, write failed or the last group
+ *                           commit failed]
+ *                           (0) if ok
+ */
+int el_append(EventLog *this, void *pRecord);
+
+/**
+ * \brief Append count consecutive records to the end of the log with a single write, honoring the sync policy once
+ * \param EventLog *this pointer to event log
+ * \param void *pRecords pointer to the first record
+ * \param int count number of records
+ * \return int value return (-1) if error [this or pRecords are NULL pointer, invalid count, write failed or the
+ *                           last group commit failed]
+ *                           (0) if ok
+ */
+int el_appendArray(EventLog *this, void *pRecords, int count);
+
+/**
+ * \brief Hand every pending record to the operating system, without forcing it to the storage device, so the
+ *        file can be read
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [this is NULL pointer or flush failed]
+ *                           (0) if ok
+ */
+int el_flush(EventLog *this);
+
+/**
+ * \brief Flush every pending record to the operating system and force it to the storage device
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [this is NULL pointer or sync failed]
+ *                           (0) if ok
+ */
+int el_sync(EventLog *this);
+
+/**
+ * \brief Flush pending records, close the file and release the event log. With EL_SYNC_GROUP the last group is
+ *        forced to the storage device
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int el_deleteEventLog(EventLog *this);
+
+#endif // EVENTLOG_H_INCLUDED
@@ -0,0 +1,79 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEST_H_INCLUDED
+#define INGEST_H_INCLUDED
+
+#include "configwatch.h"
+#include "mechatronic.h"
+#include "ringbuffer.h"
+
+// ORIGEN DE LAS LECTURAS
+#define INGEST_SOURCE_FIFO 0
+#define INGEST_SOURCE_SOCKET 1
+
+// CANTIDAD DE LECTURAS EN LAS COLAS HACIA LOS HILOS DE ESCRITURA, REPARTIDA ENTRE ELLOS
+#define INGEST_QUEUE_SIZE 65536
+
+// HILOS DE ESCRITURA, 0 USA UNO POR PROCESADOR
+#define INGEST_WRITER_THREADS 0
+
+// CANTIDAD MAXIMA DE HILOS DE ESCRITURA
+#define INGEST_MAX_WRITERS 16
+
+// CANTIDAD MAXIMA DE EVENTOS GUARDADOS POR BLOQUE
+#define INGEST_BATCH_SIZE 4096
+
+// CANTIDAD MAXIMA DE LECTURAS CLASIFICADAS JUNTAS
+#define INGEST_CLASSIFY_BATCH 256
+
+// BYTES LEIDOS POR LLAMADA AL ORIGEN
+#define INGEST_READ_BUFFER 65536
+
+struct IngestWriter{
+
+    RingBuffer *pQueue;
+    Mechatronic *pEvents;
+    Mechatronic *pSorted;
+    pthread_t thread;
+    int processed;
+    int errors;
+    char failedFile[SL_MAX_NAME_CHARS];
+
+    // solo para dormir con la cola vacia o llena, los eventos pasan por la cola sin bloqueos
+    pthread_mutex_t mutex;
+    pthread_cond_t queued;
+    pthread_cond_t released;
+    int sleeping;
+    int waiting;
+    MachineShard *pShards[MECHATRONIC_MAX_MACHINES];
+
+}typedef IngestWriter;
+
+/**
+ * \brief Runs the program without user interaction. Readings are received as text lines "temperature humidity" of
+ *        the main machine or "machine temperature humidity" from a FIFO or a UNIX socket, classified with the
+ *        thresholds of their machine and handed through lock-free queues to the writer threads, that sleep while
+ *        their queue is empty. Every machine is stored by the same thread in its own shard, so threads never share a
+ *        file. It runs until SIGINT or SIGTERM is received
+ * \param int source [INGEST_SOURCE_FIFO] path is a FIFO, it is created if it does not exist
+ *                   [INGEST_SOURCE_SOCKET] path is a UNIX stream socket where writers connect, one at a time
+ * \param char *path path of the FIFO or the socket
+ * \return int value return (-1) if error [invalid parameters, can't open the source or can't start the thread]
+ *                           (0) if ok
+ */
+int ingest_run(int source, char *path);
+
+#endif // INGEST_H_INCLUDED
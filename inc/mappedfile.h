@@ -0,0 +1,54 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPPEDFILE_H_INCLUDED
+#define MAPPEDFILE_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+struct MappedFile{
+
+    void *pData;
+    long size;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+}typedef MappedFile;
+
+/**
+ * \brief Map the whole content of a file in memory as read-only
+ * \param char *fileName path of the file
+ * \return MappedFile *pAux Return (NULL) if error [fileName is NULL pointer or the file can't be opened or mapped]
+ *                               - (pointer to new mapped file) if ok. An empty file has pData (NULL) and size (0)
+ */
+MappedFile *mf_newMappedFile(char *fileName);
+
+/**
+ * \brief Unmap the file and release the mapped file. Pointers into pData are no longer valid
+ * \param MappedFile *this pointer to mapped file
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int mf_deleteMappedFile(MappedFile *this);
+
+#endif // MAPPEDFILE_H_INCLUDED
@@ -16,9 +16,24 @@
 #ifndef MECHATRONIC_H_INCLUDED
 #define MECHATRONIC_H_INCLUDED
 
+#include <errno.h>
+#include <limits.h>
 #include <time.h>
 #include "arraylist.h"
+#include "classifier.h"
+#include "columnstore.h"
+#include "crc32c.h"
+#include "eventlog.h"
+#include "mappedfile.h"
+#include "pagedstore.h"
+#include "pool.h"
+#include "reportwriter.h"
+#include "segmentlog.h"
+#include "terminal.h"
+#include "textformatter.h"
+#include "timeindex.h"
 #include "validations.h"
+#include "workerpool.h"
 
 // LONGITUD CARACTERES
 #define MAX_EVENTS_CHARS 31
@@ -38,6 +53,12 @@
 // VALOR INICIAL UMBRAL DE HUMEDAD
 #define INITIAL_HUMIDITY_THRESHOLD 70
 
+// RANGOS DE LOS UMBRALES DEL ARCHIVO DE CONFIGURACION, LOS QUE ENTRAN EN LOS REGISTROS DEL ARCHIVO BINARIO
+#define MIN_THRESHOLD_TEMPERATURE -327.68
+#define MAX_THRESHOLD_TEMPERATURE 327.67
+#define MIN_THRESHOLD_HUMIDITY 0
+#define MAX_THRESHOLD_HUMIDITY 100
+
 // VALORES ESTADO EMERGENCIA
 #define EMERGENCY_AMBIENT_HUMIDITY 888
 #define EMERGENCY_AMBIENT_TEMPERATURE 999.00
@@ -49,11 +70,121 @@
 #define STOP_BY_TEMPERATURE "Parada por temperatura"
 #define BOOT_BY_TEMPERATURE "Arranque por temperatura"
 
+
 // ARCHIVOS
 #define MECHATRONIC_OUTPUT_FILE "data.txt"
 #define MECHATRONIC_BINARY_FILE "data.bin"
+#define MECHATRONIC_BINARY_FILE_TEMP "data.bin.tmp"
+#define MECHATRONIC_SEGMENT_BASE "data"
+#define MECHATRONIC_MANIFEST_FILE "data.manifest"
+#define MECHATRONIC_INDEX_FILE "data.idx"
 #define MECHATRONIC_USER_CONFIG "config.ini"
 
+// ARCHIVOS DE CADA MAQUINA, LA MAQUINA 0 USA LOS ARCHIVOS PRINCIPALES
+#define MECHATRONIC_MACHINE_BASE "data-m%03d"
+#define MECHATRONIC_MACHINE_INDEX_FILE "data-m%03d.idx"
+#define MECHATRONIC_MACHINE_OUTPUT_FILE "data-m%03d.txt"
+
+// CANTIDAD MAXIMA DE MAQUINAS DE LA PLANTA
+#define MECHATRONIC_MAX_MACHINES 256
+
+// HILOS QUE LEEN LOS UMBRALES SIN BLOQUEOS, LOS QUE NO TIENEN LUGAR LOS LEEN CON EL MUTEX, Y LONGITUD DE LINEA DE CACHE
+#define MECHATRONIC_THRESHOLD_READERS 64
+#define MECHATRONIC_CACHE_LINE 64
+
+// UMBRALES LEIDOS DEL ARCHIVO DE CONFIGURACION, LOS GENERALES Y LOS PROPIOS DE CADA MAQUINA
+#define MECHATRONIC_KEY_ENGINE_ON 1
+#define MECHATRONIC_KEY_ENGINE_OFF 2
+#define MECHATRONIC_KEY_HUMIDITY 4
+#define MECHATRONIC_KEY_ALL 7
+
+// MODOS DE DURABILIDAD DEL ARCHIVO BINARIO
+#define DURABILITY_NONE "none"
+#define DURABILITY_FLUSH "flush"
+#define DURABILITY_SYNC "sync"
+#define DURABILITY_GROUP "group"
+
+// VALORES INICIALES DE DURABILIDAD
+#define INITIAL_DURABILITY EL_SYNC_FLUSH
+#define INITIAL_GROUP_COMMIT_EVENTS EL_GROUP_SIZE
+#define INITIAL_GROUP_COMMIT_MILLIS EL_GROUP_INTERVAL
+
+// VALORES INICIALES DE LOS SEGMENTOS DEL ARCHIVO BINARIO
+#define INITIAL_SEGMENT_EVENTS 1000000
+#define INITIAL_SEGMENT_DAILY 1
+#define INITIAL_RETENTION_DAYS 0
+
+// VALOR INICIAL DE LA MEMORIA PARA EL HISTORIAL DE EVENTOS, EN MEGABYTES
+#define INITIAL_CACHE_MEGABYTES 16
+
+// FORMATO DEL ARCHIVO BINARIO
+#define MECHATRONIC_FILE_MAGIC "MECH"
+#define MECHATRONIC_FILE_VERSION 2
+#define MECHATRONIC_FILE_HEADER_SIZE 16
+#define MECHATRONIC_RECORD_SIZE 28
+#define MECHATRONIC_CHECKSUM_OFFSET 24
+
+// LIMITES DE LAS TEMPERATURAS QUE ENTRAN EN UN REGISTRO DEL ARCHIVO BINARIO, EN CENTESIMOS DE GRADO
+#define MECHATRONIC_MIN_AMBIENT_HUNDREDTHS INT_MIN
+#define MECHATRONIC_MAX_AMBIENT_HUNDREDTHS INT_MAX
+#define MECHATRONIC_MIN_ENGINE_HUNDREDTHS SHRT_MIN
+#define MECHATRONIC_MAX_ENGINE_HUNDREDTHS SHRT_MAX
+
+// POSICION DEL ID DE MAQUINA EN EL ENCABEZADO DE CADA SEGMENTO
+#define MECHATRONIC_MACHINE_OFFSET 10
+
+// VERSION ANTERIOR DEL ARCHIVO BINARIO, SIN CHECKSUM
+#define MECHATRONIC_PREVIOUS_VERSION 1
+#define MECHATRONIC_PREVIOUS_RECORD_SIZE 24
+
+// SEGUNDOS POR ENTRADA DEL INDICE TEMPORAL
+#define MECHATRONIC_INDEX_BUCKET 3600
+
+// MODO DE CARGA DEL ARCHIVO BINARIO
+#define MECHATRONIC_LOADER_READ 0
+#define MECHATRONIC_LOADER_MMAP 1
+#define MECHATRONIC_LOADER MECHATRONIC_LOADER_MMAP
+
+// CANTIDAD DE REGISTROS LEIDOS POR BLOQUE
+#define MECHATRONIC_READ_CHUNK 512
+
+// CANTIDAD DE REGISTROS DECODIFICADOS POR TAREA DE LA CARGA
+#define MECHATRONIC_LOAD_CHUNK 65536
+
+// CANTIDAD DE REGISTROS MAPEADOS A LA VEZ DURANTE LA CARGA
+#define MECHATRONIC_LOAD_BATCH 1048576
+
+// HILOS DE LA CARGA DEL ARCHIVO BINARIO, 0 USA UNO POR PROCESADOR
+#define MECHATRONIC_LOAD_THREADS 0
+
+// CANTIDAD DE EVENTOS POR PAGINA DEL HISTORIAL
+#define MECHATRONIC_PAGE_EVENTS 4096
+
+// LONGITUD MAXIMA DE UNA LINEA DEL INFORME: NUMEROS, NOMBRES Y SEPARADORES
+#define MECHATRONIC_MAX_ROW_CHARS (8 * 11 + 3 * TF_MAX_NUMBER_CHARS + MAX_EMPLOYEE_NAME_CHARS + MAX_EVENTS_CHARS + 64)
+
+// LONGITUD MAXIMA DE UN EVENTO EN LOS INFORMES DE CONSOLA: NUMEROS, NOMBRES Y TITULOS
+#define MECHATRONIC_MAX_LIST_CHARS (3 * 11 + 3 * TF_MAX_NUMBER_CHARS + MAX_EMPLOYEE_NAME_CHARS + MAX_EVENTS_CHARS + 320)
+
+// CANTIDAD DE ESTRUCTURAS POR BLOQUE DEL POOL
+#define MECHATRONIC_POOL_SLAB 256
+
+// CANTIDAD DE LECTURAS CLASIFICADAS POR BLOQUE
+#define MECHATRONIC_CLASSIFY_BLOCK 1024
+
+// los valores se guardan en el archivo binario, no deben cambiar
+typedef enum{
+
+    EVENT_BOOT_BY_TEMPERATURE = CL_BOOT_BY_TEMPERATURE,
+    EVENT_STOP_BY_TEMPERATURE = CL_STOP_BY_TEMPERATURE,
+    EVENT_BOOT_BY_HUMIDITY = CL_BOOT_BY_HUMIDITY,
+    EVENT_STOP_BY_HUMIDITY = CL_STOP_BY_HUMIDITY,
+    EVENT_EMERGENCY = 4,
+    EVENT_TYPE_COUNT = 5,
+    EVENT_UNKNOWN = 255
+
+}EventType;
+
 typedef struct{
 
     int day;
@@ -68,7 +199,9 @@ typedef struct{
 typedef struct{
 
     Date today;
-    char eventType[MAX_EVENTS_CHARS];
+    long long timestamp;
+    int idMachine;
+    EventType eventType;
     int idEmployee;
     char nameSurname[MAX_EMPLOYEE_NAME_CHARS];
     float ambientTemperatureRead;
@@ -79,42 +212,274 @@ typedef struct{
 
 }Mechatronic;
 
+typedef struct{
+
+    Date today;
+    char eventType[MAX_EVENTS_CHARS];
+    int idEmployee;
+    char nameSurname[MAX_EMPLOYEE_NAME_CHARS];
+    float ambientTemperatureRead;
+    int humidityTemperatureRead;
+    float temperatureEngineOn;
+    float temperatureEngineOff;
+    int humidityThreshold;
+
+}LegacyMechatronic;
+
+typedef struct{
+
+    int count;
+    int typeCount[EVENT_TYPE_COUNT];
+    long long firstTimestamp;
+    long long lastTimestamp;
+    int readCount;
+    float minTemperature;
+    float maxTemperature;
+    double temperatureSum;
+    int minHumidity;
+    int maxHumidity;
+    long long humiditySum;
+
+}EventStats;
+
+typedef struct{
+
+    float temperatureEngineOn;
+    float temperatureEngineOff;
+    int humidityThreshold;
+
+}Thresholds;
+
+typedef struct ThresholdSnapshot{
+
+    int version;
+    Thresholds machines[MECHATRONIC_MAX_MACHINES];
+
+    // configuraciones reemplazadas que aun no se liberaron, la ultima es la inicial
+    struct ThresholdSnapshot *pReplaced;
+
+    // epoca en la que se reemplazo, los lectores que entraron antes todavia la pueden tener
+    unsigned long long retired;
+
+}ThresholdSnapshot;
+
+typedef struct{
+
+    // epoca en la que el hilo empezo a leer los umbrales, 0 si no esta leyendo
+    unsigned long long epoch;
+    int used;
+    char padding[MECHATRONIC_CACHE_LINE - sizeof(unsigned long long) - sizeof(int)];
+
+}ThresholdReader;
+
+typedef struct{
+
+    int idMachine;
+    int firstEvent;
+    char baseName[SL_MAX_NAME_CHARS];
+    char indexName[SL_MAX_NAME_CHARS];
+    char outputName[SL_MAX_NAME_CHARS];
+    SegmentLog *pSegmentLog;
+    TimeIndex *pTimeIndex;
+    ReportWriter *pReportWriter;
+    EventStats stats;
+
+}MachineShard;
+
+typedef struct{
+
+    MappedFile *pMappedFile;
+    unsigned char *pBuffer;
+    unsigned char *pRecords;
+    int count;
+
+}LoadedSegment;
+
+typedef struct{
+
+    unsigned char *pRecords;
+    int count;
+    int length;
+    int segment;
+    int first;
+    EventStats stats;
+
+}LoadChunk;
+
 /**
- * \brief Allocates dynamic memory for a variable of type Mechatronic
+ * \brief Allocates a variable of type Mechatronic from the pool of the event store
  * \param -
- * \return Pointer *value pointer to Mechatronic with dynamic memory
+ * \return Pointer *value pointer to Mechatronic with all its fields set to zero
  *                  - (NULL) if error [if can't allocate memory]
  */
 Mechatronic *new_mechatronic(void);
 
 /**
- * \brief Set datetime to the structure Date
- * \param Mechatronic *this pointer to the structure Mechatronic
- * \param int value option selected by user
+ * \brief Gives back a variable of type Mechatronic to the pool of the event store so it can be reused
+ * \param Mechatronic *this pointer to the structure Mechatronic obtained with new_mechatronic
  * \return void
  */
-void mechatronic_setDate(Mechatronic *this);
+void delete_mechatronic(Mechatronic *this);
 
 /**
- * \brief Set the engine start temperature
- * \param Mechatronic *this pointer to the structure Mechatronic
+ * \brief Creates the event store, where the recent events are kept in memory and the older ones are read from the
+ *        binary file in pages when they are needed, and the pool that owns the mechatronic structures being edited.
+ *        The columns of the history are only created if they were enabled with mechatronic_enableColumns
+ * \param -
+ * \return PagedStore *pPagedStore pointer to the new event store
+ *                  - (NULL) if error [if can't allocate memory]
+ */
+PagedStore *mechatronic_newEventList(void);
+
+/**
+ * \brief Deletes the event store and releases at once every mechatronic structure of the pool and the thresholds
+ *        replaced by the reloads of the configuration. No thread can be classifying readings
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return void
+ */
+void mechatronic_deleteEventList(PagedStore *pPagedStore);
+
+/**
+ * \brief Sets the statistics of an empty event store
+ * \param EventStats *pStats pointer to the statistics
+ * \return void
+ */
+void mechatronic_resetStats(EventStats *pStats);
+
+/**
+ * \brief Adds an event to the statistics of the event store.
+ *        Emergency events don't carry sensor readings and are left out of the temperature and humidity values
+ * \param void *pContext pointer to the statistics
+ * \param void *pElement pointer to the structure Mechatronic added
+ * \return void
+ */
+void mechatronic_updateStats(void *pContext, void *pElement);
+
+/**
+ * \brief Adds a new event to the statistics and to the columns of the event store. It is the add hook of the
+ *        resident events of the store, so both are kept up to date with every new event
+ * \param void *pContext pointer to the statistics
+ * \param void *pElement pointer to the structure Mechatronic added
+ * \return void
+ */
+void mechatronic_trackEvent(void *pContext, void *pElement);
+
+/**
+ * \brief Adds the statistics of a group of events to the statistics of the event store
+ * \param EventStats *pStats pointer to the statistics that are updated
+ * \param EventStats *pOther pointer to the statistics of the other events
+ * \return void
+ */
+void mechatronic_mergeStats(EventStats *pStats, EventStats *pOther);
+
+/**
+ * \brief Marks the statistics and the columns of the event store as outdated when an event leaves the resident
+ *        events. It is the remove hook of the resident events of the store, the minimum and maximum values can't be
+ *        taken back so both are rebuilt the next time the statistics are requested
+ * \param void *pContext pointer to the flag that is set
+ * \param void *pElement pointer to the structure Mechatronic removed
+ * \return void
+ */
+void mechatronic_untrackEvent(void *pContext, void *pElement);
+
+/**
+ * \brief Rebuilds the statistics and the columns of the event store going through every event of the store
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [pPagedStore is NULL pointer, can't allocate memory or an event can't be
+ *                           read]
+ *                           (0) if ok
+ */
+int mechatronic_rebuildStats(PagedStore *pPagedStore);
+
+/**
+ * \brief Drops every event of the event store and its columns from memory, as the modes without interaction do once
+ *        the binary file is loaded. The statistics are kept, they describe the events of the binary file
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return void
+ */
+void mechatronic_evictEvents(PagedStore *pPagedStore);
+
+/**
+ * \brief Gets the statistics of the event store without going through the events, unless an event was removed from
+ *        the store since the last time and they have to be rebuilt
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return EventStats *pStats pointer to the statistics
+ */
+EventStats *mechatronic_getStats(PagedStore *pPagedStore);
+
+/**
+ * \brief Enables or disables the columns of the whole history of the event store, for the scans that go through
+ *        every event. They take about 21 bytes per event, so only the modes that need them enable them. It applies to
+ *        the event stores created from then on
+ * \param int enabled (1) to keep the columns - (0) to leave them out
  * \return void
  */
-void mechatronic_setTemperatureEngineOn(Mechatronic *this);
+void mechatronic_enableColumns(int enabled);
+
+/**
+ * \brief Gets the columns of the whole history of the event store, fed by the same path as the event store. They
+ *        are rebuilt with the statistics, the columns of the sealed segments are there once mechatronic_getStats returns
+ * \param -
+ * \return ColumnStore *pColumnStore pointer to the columns - (NULL) if they are not enabled
+ */
+ColumnStore *mechatronic_getColumns(void);
+
+/**
+ * \brief Copies a list of events, sorted by time, into new columns, for the statistics of the events of a time
+ *        range read with mechatronic_queryRange
+ * \param ArrayList *pEvents pointer to the typed array list of events
+ * \return ColumnStore *pColumns pointer to the new columns, they must be released with cs_deleteColumnStore
+ *                             - (NULL) if error [pEvents is NULL pointer or can't allocate memory]
+ */
+ColumnStore *mechatronic_newColumns(ArrayList *pEvents);
+
+/**
+ * \brief Computes the average ambient temperature read in a time range, going only through the columns of the
+ *        events. Emergency events don't carry readings and are left out
+ * \param ColumnStore *pColumns pointer to the columns of the events, sorted by time
+ * \param long long from start of the range in seconds since the epoch
+ * \param long long to end of the range in seconds since the epoch, included
+ * \param float *pAverage pointer where the average is written, (0) if there are no readings
+ * \return int value return (-1) if error [pColumns or pAverage are NULL pointer or from > to]
+ *                          (number of readings averaged) if ok
+ */
+int mechatronic_getAverageTemperature(ColumnStore *pColumns, long long from, long long to, float *pAverage);
+
+/**
+ * \brief Counts the readings of a time range whose humidity is over the current humidity threshold, going only
+ *        through the columns of the events. Emergency events don't carry readings and are left out
+ * \param ColumnStore *pColumns pointer to the columns of the events, sorted by time
+ * \param long long from start of the range in seconds since the epoch
+ * \param long long to end of the range in seconds since the epoch, included
+ * \return int value return (-1) if error [pColumns is NULL pointer or from > to]
+ *                          (number of readings over the threshold) if ok
+ */
+int mechatronic_countHumidityBreaches(ColumnStore *pColumns, long long from, long long to);
 
 /**
- * \brief Set the engine off temperature
+ * \brief Stores a copy of a mechatronic structure obtained with new_mechatronic at the end of the event store, where
+ *        it stays in memory, and gives the structure back to the pool
+ * \param PagedStore *pPagedStore pointer to the event store
  * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return Mechatronic *this pointer to the stored structure
+ */
+Mechatronic *mechatronic_addEvent(PagedStore *pPagedStore, Mechatronic *this);
+
+/**
+ * \brief Set datetime to the structure Date
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param int value option selected by user
  * \return void
  */
-void mechatronic_setTemperatureEngineOff(Mechatronic *this);
+void mechatronic_setDate(Mechatronic *this);
 
 /**
- * \brief Set the humidity threshold
+ * \brief Set the engine start and off temperatures and the humidity threshold of the machine of the event, all
+ *        three from the same configuration even if it is reloaded meanwhile
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_setHumidityThreshold(Mechatronic *this);
+void mechatronic_setThresholds(Mechatronic *this);
 
 /**
  * \brief Set the employee ID
@@ -178,37 +543,36 @@ void mechatronic_setEventType(Mechatronic *this);
  * \param Int emergencyOption value determining whether an emergency stop has occurred
  * \return void
  */
-void mechatronic_newMechatronicObject(ArrayList *pArrayList, int emergencyOption);
+void mechatronic_newMechatronicObject(PagedStore *pPagedStore, int emergencyOption);
 
 /**
  * \brief Set a mechatronic emergency structure
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_newMechatronicEmergencyObject(ArrayList *pArrayList);
+void mechatronic_newMechatronicEmergencyObject(PagedStore *pPagedStore);
 
 /**
  * \brief Confirmation screen
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_confirmNewMechatronicData(ArrayList *pArrayList, Mechatronic *this);
+void mechatronic_confirmNewMechatronicData(PagedStore *pPagedStore, Mechatronic *this);
 
 /**
  * \brief Screen to modify the data
- * \param ArrayList *pArrayList pointer to the array list
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_editNewMechatronicData(ArrayList *pArrayList, Mechatronic *this);
+void mechatronic_editNewMechatronicData(Mechatronic *this);
 
 /**
  * \brief Display to confirm an emergency stop
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return int opcion selected by the user
  */
-int mechatronic_emergencySwitch(ArrayList *pArrayList);
+int mechatronic_emergencySwitch(PagedStore *pPagedStore);
 
 /**
  * \brief Displays the data of a mechatronic type structure
@@ -219,62 +583,505 @@ void mechatronic_printNewMechatronicData(Mechatronic *this);
 
 /**
  * \brief Displays the general events report
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_generalEventsReport(ArrayList *pArrayList);
+void mechatronic_generalEventsReport(PagedStore *pPagedStore);
 
 /**
  * \brief Displays the emergency report
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_emergencyEventsReport(ArrayList *pArrayList);
+void mechatronic_emergencyEventsReport(PagedStore *pPagedStore);
+
+/**
+ * \brief Displays every event of the store rendered with pFunction. The events are rendered in parallel blocks and
+ *        written to the standard output in order
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \param pFunction (*pFunction) pointer to function that renders one event
+ * \return int value return (-1) if error [can't allocate memory, an event can't be read or a write failed]
+ *                           (0) if ok
+ */
+int mechatronic_printEvents(PagedStore *pPagedStore, int (*pFunction)(TextFormatter*, void*));
 
 /**
- * \brief Displays all data of a mechatronic type structure
+ * \brief Renders all data of a mechatronic structure as it is displayed in the events reports
+ * \param TextFormatter *pFormatter formatter where the event is written
+ * \param void *pElement pointer to the structure Mechatronic
+ * \return int value return (-1) if error [a write failed]
+ *                           (0) if ok
+ */
+int mechatronic_formatEventListRow(TextFormatter *pFormatter, void *pElement);
+
+/**
+ * \brief Renders a mechatronic structure as it is displayed in the events reports, only if it is an emergency
+ * \param TextFormatter *pFormatter formatter where the event is written
+ * \param void *pElement pointer to the structure Mechatronic
+ * \return int value return (-1) if error [a write failed]
+ *                           (0) if ok
+ */
+int mechatronic_formatEmergencyRow(TextFormatter *pFormatter, void *pElement);
+
+/**
+ * \brief Opens the binary file and loads the records of every segment into the event store. Loading stops at the
+ *        first damaged record, the records after it are left out
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [can't open or convert the binary file], the program can't go on
+ *                           (0) if ok
+ */
+int mechatronic_createBinaryFile(PagedStore *pPagedStore);
+
+/**
+ * \brief Opens the binary file as an append-only log split in segments. A single binary file with the legacy layout
+ *        or with the previous version of the format is rewritten with the current format first, and then becomes the
+ *        first segment. Damaged or incomplete records at the end of the segment being written are removed
+ * \param -
+ * \return int value return (-1) if error [can't convert the file or can't open the log]
+ *                           (0) if ok
+ */
+int mechatronic_openBinaryFile(void);
+
+/**
+ * \brief Checks every record of every segment of the binary file without loading them, and prints the result of
+ *        each segment and the speed of the check. Nothing is written: the manifest and the segments are only read,
+ *        an incomplete record at the end of the segment being written is reported but not removed
+ * \param -
+ * \return int value return (-1) if error [can't read the manifest or a segment, a record is damaged or incomplete]
+ *                           (0) if ok
+ */
+int mechatronic_verifyBinaryFile(void);
+
+/**
+ * \brief Opens the time index of the binary file. If the index is missing or does not cover the records of the
+ *        binary file it is rebuilt reading the timestamps of the records, without decoding them. Records are numbered
+ *        from the first record ever stored, so the numbers don't change when old segments are dropped
+ * \param int length number of records of the binary file covered by the index, from the first record kept
+ * \return void
+ */
+void mechatronic_openIndexFile(int length);
+
+/**
+ * \brief Reads from the binary file the records of a time range, using the time index to seek straight to the first
+ *        bucket of the range. Records are expected in chronological order, the scan stops at the first record after the range.
+ *        Records of segments already dropped by the retention are skipped, the scan also stops at a damaged record
+ * \param long long from start of the range in seconds since the epoch
+ * \param long long to end of the range in seconds since the epoch, included
+ * \return ArrayList *pArrayList typed array list with a copy of the records of the range
+ *                  - (NULL) if error [if the index is not open or can't allocate memory]
+ */
+ArrayList *mechatronic_queryRange(long long from, long long to);
+
+/**
+ * \brief Loads the binary file into the event store without keeping every event in memory. Only the segment being
+ *        written is checked: every sealed segment was checked while it was being written and the manifest keeps its
+ *        number of records, so they are taken as they are and their statistics are gathered the first time they are
+ *        requested. The segment being written is mapped and split in chunks of records that the threads of a worker
+ *        pool check at the same time, gathering the statistics of each chunk. The events up to the first damaged
+ *        record become the history of the store, read in pages when they are needed, and the ones of the last
+ *        incomplete page are kept in memory
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value number of segments loaded completely, if it is less than the number of segments the next one
+ *                   can't be read or has a damaged record
+ */
+int mechatronic_loadBinaryFile(PagedStore *pPagedStore);
+
+/**
+ * \brief Reads a page of the history of the event store from the binary file and decodes its records, up to the
+ *        first damaged record. It is the function that loads the pages of the event store
+ * \param void *pContext pointer to the MachineShard whose log is read - (NULL) for the main binary file
+ * \param int first index in the store of the first event of the page
+ * \param void *pElements pointer to an array of count structures Mechatronic
+ * \param int count number of events to read
+ * \return int value number of events read, (0) if the records can't be read or were dropped by the retention
+ */
+int mechatronic_loadPage(void *pContext, int first, void *pElements, int count);
+
+/**
+ * \brief Gets the number of pages of the history of the event store that fit in a memory limit
+ * \param int megabytes memory limit in megabytes
+ * \return int value number of pages, at least 1
+ */
+int mechatronic_getCachePages(int megabytes);
+
+/**
+ * \brief Gets the number of threads used to load the binary file, one for every processor but never more than the
+ *        number of chunks to check
+ * \param int chunkCount number of chunks of records to check
+ * \return int value number of threads, at least 1
+ */
+int mechatronic_getLoadThreads(int chunkCount);
+
+/**
+ * \brief Checks the records of a chunk of a segment and gathers their statistics, up to the first damaged record.
+ *        It is the task of the worker pool that loads the binary file
+ * \param void *pContext pointer to the array of chunks
+ * \param int index position of the chunk in the array
+ * \return void
+ */
+void mechatronic_scanChunk(void *pContext, int index);
+
+/**
+ * \brief Opens a segment of the binary file to load it, mapping it in memory or reading it whole depending on
+ *        MECHATRONIC_LOADER. If the file can't be mapped it is read instead
+ * \param LoadedSegment *pSegment pointer to the segment to set
+ * \param char *fileName path of the segment
+ * \return int value return (-1) if error [can't read the file or its header is not valid]
+ *                           (0) if ok
+ */
+int mechatronic_openSegment(LoadedSegment *pSegment, char *fileName);
+
+/**
+ * \brief Reads every record of a segment of the binary file into a buffer of the segment
+ * \param LoadedSegment *pSegment pointer to the segment to set
+ * \param char *fileName path of the segment
+ * \return int value return (-1) if error [can't read the file, its header is not valid or can't allocate memory]
+ *                           (0) if ok
+ */
+int mechatronic_readSegment(LoadedSegment *pSegment, char *fileName);
+
+/**
+ * \brief Releases the memory of a segment opened with mechatronic_openSegment
+ * \param LoadedSegment *pSegment pointer to the segment
+ * \return void
+ */
+void mechatronic_closeSegment(LoadedSegment *pSegment);
+
+/**
+ * \brief Checks if the binary file has the legacy layout, a raw copy of the mechatronic structures without header
+ * \return int value 1 if the file exists, is not empty and does not begin with the magic of the format - 0 if not
+ */
+int mechatronic_isLegacyBinaryFile(void);
+
+/**
+ * \brief Rewrites a binary file with the legacy layout with the current format. Records with an invalid date or
+ *        event type, or with values that don't fit in a record, are left out. The original file is only replaced
+ *        once the converted one is complete and on disk
+ * \param int *pDiscarded pointer where the number of bytes of an incomplete record at the end is written
+ * \param int *pInvalid pointer where the number of records left out is written
+ * \return int value return (-1) if error [can't read, write or replace the file], the original file is kept
+ *                           (0) if ok
+ */
+int mechatronic_importLegacyBinaryFile(int *pDiscarded, int *pInvalid);
+
+/**
+ * \brief Rewrites a binary file with the previous version of the format, whose records are the current ones without
+ *        the checksum, adding the checksum to every record. Other files are left untouched. The original file is
+ *        only replaced once the converted one is complete and on disk
+ * \param int *pDiscarded pointer where the number of bytes of an incomplete record at the end is written
+ * \return int value return (-1) if error [can't read, write or replace the file], the original file is kept
+ *                           (0) if ok or the file has not the previous format
+ */
+int mechatronic_upgradeBinaryFile(int *pDiscarded);
+
+/**
+ * \brief Checks the checksum of consecutive records of the binary file
+ * \param unsigned char *pRecords pointer to the first record
+ * \param int count number of records
+ * \return int i position of the first damaged record - count if every record is valid
+ */
+int mechatronic_checkRecords(unsigned char *pRecords, int count);
+
+/**
+ * \brief Checks the checksum of a record of the binary file, the CRC32C of the bytes before it
+ * \param void *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \return int value 1 if the record is valid - 0 if it is damaged
+ */
+int mechatronic_isValidRecord(void *pRecord);
+
+/**
+ * \brief Checks that every value of an event fits in a record of the binary file: finite temperatures within the
+ *        limits of their fields, humidity and threshold within their sizes and a known event type. The values that
+ *        don't fit are stored clamped to the nearest limit, NaN as 0
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return int value 1 if the event is stored as it is - 0 if not
+ */
+int mechatronic_isStorableEvent(Mechatronic *this);
+
+/**
+ * \brief Writes the header of the binary file: magic, version, header size, record size and the ID of the machine
+ *        of every record of the file
+ * \param unsigned char *pHeader buffer of MECHATRONIC_FILE_HEADER_SIZE bytes
+ * \param int idMachine ID of the machine, 0 for the main binary file
+ * \return void
+ */
+void mechatronic_encodeFileHeader(unsigned char *pHeader, int idMachine);
+
+/**
+ * \brief Checks the header of the binary file
+ * \param unsigned char *pHeader buffer of MECHATRONIC_FILE_HEADER_SIZE bytes
+ * \return int value 1 if the magic, version and sizes match the current format - 0 if not
+ */
+int mechatronic_checkFileHeader(unsigned char *pHeader);
+
+/**
+ * \brief Encodes a mechatronic structure as a record of the binary file. Every field is stored in little endian:
+ *        timestamp (8 bytes), employee ID (4), ambient temperature in hundredths of degree (4), engine start and
+ *        engine off temperatures in hundredths of degree (2 + 2), humidity (2), humidity threshold (1), event type code (1)
+ *        and the CRC32C of the previous bytes (4). Temperatures that don't fit are clamped, see
+ *        mechatronic_isStorableEvent
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param unsigned char *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \return void
+ */
+void mechatronic_encodeRecord(Mechatronic *this, unsigned char *pRecord);
+
+/**
+ * \brief Decodes a record of the binary file into a mechatronic structure
+ * \param unsigned char *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param Mechatronic *pPrevious pointer to the record decoded before, its date is reused when both records belong
+ *        to the same hour. (NULL) if there is no previous record
+ * \return void
+ */
+void mechatronic_decodeRecord(unsigned char *pRecord, Mechatronic *this, Mechatronic *pPrevious);
+
+/**
+ * \brief Gets the time of a record of the binary file without decoding the rest of it
+ * \param void *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \return long long value time of the record in seconds since the epoch
+ */
+long long mechatronic_getRecordTimestamp(void *pRecord);
+
+/**
+ * \brief Converts a record with the legacy layout into a mechatronic structure
+ * \param LegacyMechatronic *pLegacy pointer to the legacy record
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_printEventList(Mechatronic *this);
+void mechatronic_decodeLegacyRecord(LegacyMechatronic *pLegacy, Mechatronic *this);
 
 /**
- * \brief Creates a binary file with the information of the mechatronic structures. If the file exists, add information to the end of the file
- * \param ArrayList *pArrayList pointer to the array list
+ * \brief Sets the timestamp of the structure and the date that corresponds to it in local time
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param long long timestamp seconds since the epoch
+ * \param Mechatronic *pPrevious pointer to a structure with a date already set, it is reused when both timestamps
+ *        belong to the same hour to avoid the conversion. (NULL) to always convert
+ * \return void
+ */
+void mechatronic_setTimestamp(Mechatronic *this, long long timestamp, Mechatronic *pPrevious);
+
+/**
+ * \brief Gets the event type that corresponds to a name
+ * \param char *eventName name of the event type
+ * \return EventType value the event type - EVENT_UNKNOWN if the name is not valid
+ */
+EventType mechatronic_getEventTypeCode(char *eventName);
+
+/**
+ * \brief Gets the name of an event type, only used to render the reports
+ * \param EventType eventType the event type
+ * \return char *value name of the event type - empty string if the event type is not valid
+ */
+char *mechatronic_getEventTypeName(EventType eventType);
+
+/**
+ * \brief Appends a new record to the end of the binary event log, starting a new segment when the current one is full
+ * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_createBinaryFile(ArrayList *pArrayList);
+void mechatronic_saveBinaryFile(Mechatronic *this);
 
 /**
- * \brief Saves the information in the binary file. If the file exists, add information to the end of the file
- * \param ArrayList *pArrayList pointer to the array list
+ * \brief Sets a mechatronic structure for a reading received from a sensor and classifies it with the current
+ *        configuration. The date is left for mechatronic_saveEvents
  * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param float temperature ambient temperature read
+ * \param int humidity ambient humidity read
+ * \param long long timestamp time of the reading in seconds since the epoch
+ * \return void
+ */
+void mechatronic_newReading(Mechatronic *this, float temperature, int humidity, long long timestamp);
+
+/**
+ * \brief Sets a block of mechatronic structures for readings received from the sensors of a machine and classifies
+ *        them together with the thresholds of the machine. The dates are left for mechatronic_saveEvents
+ * \param Mechatronic *pEvents pointer to the first structure Mechatronic
+ * \param int idMachine ID of the machine, 0 for the main machine
+ * \param float *pTemperatures pointer to the ambient temperatures read
+ * \param int *pHumidities pointer to the ambient humidities read
+ * \param int count number of readings
+ * \param long long timestamp time of the readings in seconds since the epoch
+ * \return int value return (-1) if error [NULL pointer, invalid machine or invalid count]
+ *                           (0) if ok
+ */
+int mechatronic_newReadings(Mechatronic *pEvents, int idMachine, float *pTemperatures, int *pHumidities, int count, long long timestamp);
+
+/**
+ * \brief Gets the thresholds of a machine: the ones of its own keys of the configuration file, the general ones for
+ *        the keys it has not. They are read from the last published configuration without locks, so any thread can
+ *        call it while the configuration is reloaded. Every thread has its own place where it writes the epoch of the
+ *        configuration it reads, the configuration replaced is released once no thread reads it since before it was
+ *        replaced. With more than MECHATRONIC_THRESHOLD_READERS threads the ones left read it with the mutex
+ * \param int idMachine ID of the machine, 0 for the main machine
+ * \param Thresholds *pThresholds pointer where the thresholds are written
+ * \return int value return (-1) if error [pThresholds is NULL pointer or invalid machine]
+ *                           (0) if ok
+ */
+int mechatronic_getThresholds(int idMachine, Thresholds *pThresholds);
+
+/**
+ * \brief Reads the thresholds of the configuration file again and publishes them for the readings classified from
+ *        then on, without stopping the threads that classify. The three general thresholds must be in the file with
+ *        valid values, a file saved halfway is not published. The other keys are only read when the program starts
+ *        or from the menu
+ * \param char *fileName configuration file
+ * \return int value return (-1) if error [fileName is NULL pointer, the file can't be read, a general threshold is
+ *                                        missing or invalid or can't allocate memory], the previous thresholds are kept
+ *                           (version of the published thresholds) if ok
+ */
+int mechatronic_reloadThresholds(char *fileName);
+
+/**
+ * \brief Stores a block of events without keeping them in memory: sets their dates, updates the statistics and
+ *        appends them to the binary file, its time index and the text report, flushing every file once per block
+ * \param Mechatronic *pEvents pointer to the first event, their timestamps must be set
+ * \param int count number of events
+ * \param char *pFailed pointer to SL_MAX_NAME_CHARS chars where the name of the file that failed is written - (NULL)
+ * \return int value return (-1) if error [pEvents is NULL pointer, invalid count or write failed]
+ *                           (0) if ok
+ */
+int mechatronic_saveEvents(Mechatronic *pEvents, int count, char *pFailed);
+
+/**
+ * \brief Opens the shard of a machine: its own binary file split in segments, time index and text report, named
+ *        after MECHATRONIC_MACHINE_BASE. The records are checked to gather the statistics of the machine and to
+ *        rebuild the index or the report if they are missing. A shard is used by one thread at a time
+ * \param int idMachine ID of the machine, from 1 to MECHATRONIC_MAX_MACHINES - 1
+ * \return MachineShard *pAux Return (NULL) if error [invalid machine, can't open the files or allocate memory]
+ *                               - (pointer to the new shard) if ok
+ */
+MachineShard *mechatronic_openShard(int idMachine);
+
+/**
+ * \brief Stores a block of events of a machine in its shard, like mechatronic_saveEvents does with the main files
+ * \param MachineShard *this pointer to the shard
+ * \param Mechatronic *pEvents pointer to the first event, their timestamps must be set
+ * \param int count number of events
+ * \param char *pFailed pointer to SL_MAX_NAME_CHARS chars where the name of the file that failed is written - (NULL)
+ * \return int value return (-1) if error [NULL pointer, invalid count or write failed]
+ *                           (0) if ok
+ */
+int mechatronic_saveShardEvents(MachineShard *this, Mechatronic *pEvents, int count, char *pFailed);
+
+/**
+ * \brief Flushes and closes the files of the shard of a machine and releases it
+ * \param MachineShard *this pointer to the shard
+ * \return void
+ */
+void mechatronic_closeShard(MachineShard *this);
+
+/**
+ * \brief Flushes and closes the binary event log, stopping its compactor, and its time index
  * \return void
  */
-void mechatronic_saveBinaryFile(ArrayList *pArrayList, Mechatronic *this);
+void mechatronic_closeBinaryFile(void);
 
 /**
- * \brief Creates a text file with the information of the mechatronic structures
- * \param ArrayList *pArrayList pointer to the array list
+ * \brief Opens the text report for appending. If the file does not exist or its format changed, it is regenerated
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [can't open or regenerate the text file]
+ *                           (0) if ok
+ */
+int mechatronic_openTextFile(PagedStore *pPagedStore);
+
+/**
+ * \brief Appends the information of a new mechatronic structure to the text file
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_createTextFile(ArrayList *pArrayList, Mechatronic *this);
+void mechatronic_createTextFile(Mechatronic *this);
+
+/**
+ * \brief Rewrites the whole text file from the binary file, for example after its format changed. The text file is
+ *        otherwise only appended to. It must run with the program stopped
+ * \param -
+ * \return int value return (-1) if error [can't open the binary file or can't write the text file]
+ *                           (0) if ok
+ */
+int mechatronic_regenerateTextFile(void);
 
 /**
- * \brief Load configuration file information
+ * \brief Prints the events stored between two dates with the lines of the text file, reading from the binary file
+ *        only the records of the range found with the time index, followed by the average temperature and the
+ *        readings over the humidity threshold of the configuration file, taken from the columns of those records. It
+ *        must run with the program stopped
+ * \param char *from first date of the range, DD/MM/AAAA
+ * \param char *to last date of the range, DD/MM/AAAA, included
+ * \return int value return (-1) if error [invalid dates, can't open the binary file or can't read the records]
+ *                           (0) if ok
+ */
+int mechatronic_rangeEventsReport(char *from, char *to);
+
+/**
+ * \brief Closes the text file
+ * \return void
+ */
+void mechatronic_closeTextFile(void);
+
+/**
+ * \brief Renders the information of a mechatronic structure as a line of the text file. The line is the same as
+ *        the one of printf "%02d/%02d/%d %02d:%02d:%02d\t\t%d\t\t%s\t\t\t%25s\t\t\t\t%.2f..."
+ * \param TextFormatter *pFormatter formatter where the line is written
+ * \param void *pElement pointer to the structure Mechatronic
+ * \return int value return (-1) if error [a write failed]
+ *                           (0) if ok
+ */
+int mechatronic_formatTextFileRow(TextFormatter *pFormatter, void *pElement);
+
+/**
+ * \brief Load configuration file information, showing it to the user. If the file can't be read nor created the
+ *        program ends
  * \param char *filename file to read
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_loadTextFile(char *fileName, ArrayList *pArrayList);
+void mechatronic_loadTextFile(char *fileName, PagedStore *pPagedStore);
+
+/**
+ * \brief Load configuration file information without user interaction, for the modes that run unattended. One line
+ *        tells if the file was read or created, or why it failed
+ * \param char *fileName file to read
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [the file can't be read nor created or a setting can't be applied]
+ *                           (0) if ok
+ */
+int mechatronic_loadConfigFile(char *fileName, PagedStore *pPagedStore);
+
+/**
+ * \brief Reads the configuration file and publishes its thresholds, without user interaction. The keys that are
+ *        missing or invalid keep their default values. If the file does not exist it is created with the default values
+ * \param char *fileName file to read
+ * \param Thresholds *pGeneral pointer where the general thresholds are written
+ * \param int *pMachines pointer where the number of machines with their own thresholds is written
+ * \return int value return (-1) if error [NULL pointer, the file can't be read nor created or can't allocate memory]
+ *                           (0) if the file was read
+ *                           (1) if the file was created with the default values
+ */
+int mechatronic_readConfigFile(char *fileName, Thresholds *pGeneral, int *pMachines);
+
+/**
+ * \brief Applies the durability, the segments, the retention and the memory limit read from the configuration file
+ *        to the binary file and to the event store. The settings that fail are reported and the rest are applied
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [a setting can't be applied]
+ *                           (0) if ok
+ */
+int mechatronic_applyConfig(PagedStore *pPagedStore);
+
+/**
+ * \brief Gets the sync policy of the binary file that corresponds to a durability mode of the configuration file
+ * \param char *durabilityName name of the durability mode: none, flush, sync or group
+ * \return int value EL_SYNC_NONE, EL_SYNC_FLUSH, EL_SYNC_FULL or EL_SYNC_GROUP - INITIAL_DURABILITY if the name is not valid
+ */
+int mechatronic_getDurabilityCode(char *durabilityName);
 
 /**
  * \brief Calls the loadtextfile function
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_userConfig(ArrayList *pArrayList);
+void mechatronic_userConfig(PagedStore *pPagedStore);
 
 /**
  * \brief Message to be displayed when starting the program
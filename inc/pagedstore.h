@@ -0,0 +1,140 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAGEDSTORE_H_INCLUDED
+#define PAGEDSTORE_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arraylist.h"
+
+struct StorePage{
+
+    int number;
+    int count;
+    unsigned int lastUse;
+    char *pElements;
+
+}typedef StorePage;
+
+struct PagedStore{
+
+    int elementSize;
+    int pageSize;
+    int maxPages;
+    int stored;
+    int faults;
+    unsigned int clock;
+    StorePage *pPages;
+    StorePage *pLastPage;
+    ArrayList *pResident;
+    int (*pLoadPage)(void*, int, void*, int);
+    void *pContext;
+
+}typedef PagedStore;
+
+/**
+ * \brief Allocate a store of fixed size elements where only the most recent elements are kept in memory. The older
+ *        ones are read in pages of pageSize elements when they are needed, through pLoadPage, and kept in a cache of
+ *        up to maxPages pages that drops the least recently used page first
+ * \param int elementSize size in bytes of every element
+ * \param int pageSize number of elements of every page
+ * \param int maxPages maximum number of pages kept in memory
+ * \param int (*pLoadPage)(void*, int, void*, int) function called with pContext, the index of the first element, an
+ *        array of elements and the number of elements to read. It returns the number of elements read
+ * \param void *pContext pointer passed as first argument of pLoadPage
+ * \return PagedStore *pAux Return (NULL) if error [invalid parameters or if can't allocate memory]
+ *                               - (pointer to new paged store) if ok
+ */
+PagedStore *ps_newPagedStore(int elementSize, int pageSize, int maxPages, int (*pLoadPage)(void*, int, void*, int), void *pContext);
+
+/**
+ * \brief Get the number of elements of the store, the ones in pages and the resident ones
+ * \param PagedStore *this pointer to paged store
+ * \return int value return number of elements or (-1) if error [this is NULL pointer]
+ */
+int ps_len(PagedStore *this);
+
+/**
+ * \brief Get an element by index. If it belongs to a page that is not in memory the page is read first, and the
+ *        least recently used page is dropped when the cache is full
+ * \param PagedStore *this pointer to paged store
+ * \param int index Index of the element
+ * \return void *pAux return (NULL) if error [this is NULL pointer, invalid index or the page can't be read]
+ *                         - (pointer to element) if ok, valid until the next call to ps_get or ps_add
+ */
+void *ps_get(PagedStore *this, int index);
+
+/**
+ * \brief Copy count consecutive elements, starting at index, into an array. The elements in pages are read with
+ *        pLoadPage without using the cache, so a full pass does not drop the pages in use. While the store is not
+ *        modified it can be called from several threads at once, as long as pLoadPage can
+ * \param PagedStore *this pointer to paged store
+ * \param int index Index of the first element
+ * \param void *pElements pointer to an array of count elements
+ * \param int count number of elements to copy
+ * \return int value return (-1) if error [this or pElements are NULL pointer or invalid parameters]
+ *                          (number of elements copied, less than count if a page can't be read) if ok
+ */
+int ps_read(PagedStore *this, int index, void *pElements, int count);
+
+/**
+ * \brief Add a copy of an element at the end of the store. It stays resident in memory until the resident elements
+ *        fill a page, then the page goes to the cache as its most recently used page, so the resident elements never
+ *        take more than a page. Once it is dropped from the cache it is read with pLoadPage like the older pages
+ * \param PagedStore *this pointer to paged store
+ * \param void *pElement pointer to element
+ * \return int value return (-1) if error [this or pElement are NULL pointer or if can't allocate memory]
+ *                           (0) if ok
+ */
+int ps_add(PagedStore *this, void *pElement);
+
+/**
+ * \brief Set the number of elements that are read in pages, the ones before the resident elements. The pages
+ *        in memory are dropped
+ * \param PagedStore *this pointer to paged store
+ * \param int stored number of elements, a multiple of the page size
+ * \return int value return (-1) if error [this is NULL pointer or invalid stored]
+ *                           (0) if ok
+ */
+int ps_setStored(PagedStore *this, int stored);
+
+/**
+ * \brief Set the maximum number of pages kept in memory. Pages over the new limit are released
+ * \param PagedStore *this pointer to paged store
+ * \param int maxPages maximum number of pages, at least 1
+ * \return int value return (-1) if error [this is NULL pointer, invalid maxPages or if can't allocate memory]
+ *                           (0) if ok
+ */
+int ps_setCapacity(PagedStore *this, int maxPages);
+
+/**
+ * \brief Remove every element of the store and release the memory of the pages
+ * \param PagedStore *this pointer to paged store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int ps_clear(PagedStore *this);
+
+/**
+ * \brief Release the pages and the resident elements and delete the store
+ * \param PagedStore *this pointer to paged store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int ps_deletePagedStore(PagedStore *this);
+
+#endif // PAGEDSTORE_H_INCLUDED
@@ -0,0 +1,77 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef POOL_H_INCLUDED
+#define POOL_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arraylist.h"
+
+struct Pool{
+
+    int elementSize;
+    int slabSize;
+    int used;
+    void *pFree;
+    ArrayList *pSlabs;
+
+}typedef Pool;
+
+/**
+ * \brief Allocate a new pool of fixed size elements. The memory is requested in slabs of slabSize elements
+ * \param int elementSize size in bytes of every element
+ * \param int slabSize number of elements of every slab
+ * \return Pool *pAux Return (NULL) if error [invalid parameters or if can't allocate memory]
+ *                         - (pointer to new pool) if ok
+ */
+Pool *pl_newPool(int elementSize, int slabSize);
+
+/**
+ * \brief Get an element from the pool. Released elements are reused first, otherwise the element is taken from the
+ *        current slab and a new slab is allocated when it is full
+ * \param Pool *this pointer to pool
+ * \return void *pAux return (NULL) if error [this is NULL pointer or if can't allocate memory]
+ *                         - (pointer to element) if ok
+ */
+void *pl_alloc(Pool *this);
+
+/**
+ * \brief Give back an element to the pool so it can be reused by pl_alloc
+ * \param Pool *this pointer to pool
+ * \param void *pElement pointer to an element obtained with pl_alloc
+ * \return int value return (-1) if error [this or pElement are NULL pointer]
+ *                           (0) if ok
+ */
+int pl_free(Pool *this, void *pElement);
+
+/**
+ * \brief Release at once every element of the pool. Pointers obtained before are no longer valid
+ * \param Pool *this pointer to pool
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int pl_clear(Pool *this);
+
+/**
+ * \brief Release every element and delete the pool
+ * \param Pool *this pointer to pool
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int pl_deletePool(Pool *this);
+
+#endif // POOL_H_INCLUDED
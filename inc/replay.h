@@ -0,0 +1,86 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef REPLAY_H_INCLUDED
+#define REPLAY_H_INCLUDED
+
+#include <ctype.h>
+#include <errno.h>
+#include "mechatronic.h"
+
+// ENCABEZADO DE LAS TRAZAS BINARIAS: "MTRC", VERSION Y TAMANO DE REGISTRO DE 2 BYTES CADA UNO
+#define REPLAY_BINARY_MAGIC "MTRC"
+#define REPLAY_BINARY_VERSION 1
+#define REPLAY_HEADER_SIZE 8
+
+// REGISTRO DE LAS TRAZAS BINARIAS: FECHA DE 8 BYTES, TEMPERATURA FLOAT Y HUMEDAD DE 4 BYTES, EN LITTLE ENDIAN
+#define REPLAY_RECORD_SIZE 16
+
+// LONGITUD MAXIMA DE UNA LINEA DE LAS TRAZAS CSV
+#define REPLAY_MAX_LINE_CHARS 256
+
+// LONGITUD MAXIMA DE LAS RUTAS DE LOS DIRECTORIOS
+#define REPLAY_MAX_PATH_CHARS 4096
+
+// CANTIDAD MAXIMA DE LECTURAS POR BLOQUE
+#define REPLAY_BATCH_SIZE 4096
+
+// ETAPAS MEDIDAS: LECTURA DE LA TRAZA, CLASIFICACION Y GUARDADO
+#define REPLAY_STAGE_READ 0
+#define REPLAY_STAGE_CLASSIFY 1
+#define REPLAY_STAGE_SAVE 2
+#define REPLAY_STAGE_COUNT 3
+
+// INTERVALOS DE LA LATENCIA, POTENCIAS DE 2 EN MICROSEGUNDOS
+#define REPLAY_LATENCY_BUCKETS 32
+
+struct ReplayTrace{
+
+    MappedFile *pMappedFile;
+    int binary;
+    long position;
+
+}typedef ReplayTrace;
+
+struct ReplayStats{
+
+    long long readings;
+    long long discarded;
+    int blocks;
+    double seconds;
+    double stageSeconds[REPLAY_STAGE_COUNT];
+    double stageMaxSeconds[REPLAY_STAGE_COUNT];
+    long long latencyCounts[REPLAY_LATENCY_BUCKETS];
+    double maxLatency;
+
+}typedef ReplayStats;
+
+/**
+ * \brief Runs a recorded trace of readings through the classification and the storage of the ingest daemon and
+ *        reports the throughput and the time of each stage. The trace is a text file with one line
+ *        "timestamp,temperature,humidity" per reading (comma, semicolon or spaces) or a binary file that starts
+ *        with REPLAY_BINARY_MAGIC. Lines that do not start with a number are skipped. The log and the report
+ *        of the replay are written in the given directory, never over the live files of the current directory,
+ *        while the thresholds are read from the user configuration of the current directory
+ * \param char *path path of the trace
+ * \param char *directory directory for the files of the replay, created if it does not exist
+ * \param double speed [0] as fast as possible
+ *                     [> 0] the readings are released at the times of the trace divided by speed
+ * \return int value return (-1) if error [invalid parameters, can't open the trace, invalid directory or write failed]
+ *                           (0) if ok
+ */
+int replay_run(char *path, char *directory, double speed);
+
+#endif // REPLAY_H_INCLUDED
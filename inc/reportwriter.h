@@ -0,0 +1,143 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef REPORTWRITER_H_INCLUDED
+#define REPORTWRITER_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pagedstore.h"
+#include "textformatter.h"
+#include "workerpool.h"
+
+// TAMANIO DEL BUFFER DE ESCRITURA DEL INFORME
+#define RW_BUFFER_SIZE 262144
+
+// TAMANIO DEL BUFFER DE LECTURA AL CONTAR LAS LINEAS DEL INFORME
+#define RW_READ_CHARS 65536
+
+// CANTIDAD DE ELEMENTOS POR BLOQUE AL GENERAR EL INFORME
+#define RW_CHUNK_ELEMENTS 4096
+
+// BLOQUES POR HILO EN CADA TANDA, LOS HILOS QUE TERMINAN ANTES TOMAN OTRO BLOQUE
+#define RW_CHUNKS_PER_THREAD 2
+
+// HILOS DE LA GENERACION DEL INFORME, 0 USA UNO POR PROCESADOR
+#define RW_RENDER_THREADS 0
+
+struct ReportWriter{
+
+    FILE *file;
+    char *fileName;
+    char *header;
+    int (*pFunction)(TextFormatter*, void*);
+    TextFormatter *pFormatter;
+
+}typedef ReportWriter;
+
+struct RenderChunk{
+
+    PagedStore *pPagedStore;
+    int (*pFunction)(TextFormatter*, void*);
+    int first;
+    int count;
+    int failed;
+    char *pElements;
+    TextFormatter *pText;
+
+}typedef RenderChunk;
+
+/**
+ * \brief Open a text report for appending. If the file does not exist, its header does not match or it does not have
+ *        one line for every element of pPagedStore, the report is regenerated from pPagedStore
+ * \param char *fileName path of the report file
+ * \param char *header text written once at the beginning of the report
+ * \param pFunction (*pFunction) pointer to function that renders one element as a line of the report into the
+ *        formatter. It returns (0) if ok or (-1) if error
+ * \param PagedStore *pPagedStore pointer to paged store with the elements already stored
+ * \return ReportWriter *pAux Return (NULL) if error [invalid parameters or can't open the file]
+ *                                 - (pointer to new report writer) if ok
+ */
+ReportWriter *rw_newReportWriter(char *fileName, char *header, int (*pFunction)(TextFormatter*, void*), PagedStore *pPagedStore);
+
+/**
+ * \brief Append one element as a new line at the end of the report
+ * \param ReportWriter *this pointer to report writer
+ * \param void *pElement pointer to element
+ * \return int value return (-1) if error [this or pElement are NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int rw_append(ReportWriter *this, void *pElement);
+
+/**
+ * \brief Append count consecutive elements as new lines at the end of the report, writing the file once
+ *        per full buffer
+ * \param ReportWriter *this pointer to report writer
+ * \param void *pElements pointer to the first element
+ * \param int elementSize size in bytes of every element
+ * \param int count number of elements
+ * \return int value return (-1) if error [this or pElements are NULL pointer, invalid sizes or write failed]
+ *                           (0) if ok
+ */
+int rw_appendArray(ReportWriter *this, void *pElements, int elementSize, int count);
+
+/**
+ * \brief Truncate the report and write the header and every element of pPagedStore again. The elements are
+ *        rendered in parallel blocks with rw_renderStore
+ * \param ReportWriter *this pointer to report writer
+ * \param PagedStore *pPagedStore pointer to paged store
+ * \return int value return (-1) if error [this or pPagedStore are NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int rw_regenerate(ReportWriter *this, PagedStore *pPagedStore);
+
+/**
+ * \brief Render every element of pPagedStore, in order, into pOutput. The elements are split in blocks that are read
+ *        and rendered at the same time by a pool of threads, each one into its own buffer. The buffers are written
+ *        in order with as few writes as possible
+ * \param TextFormatter *pOutput pointer to formatter with file descriptor where the text is written
+ * \param PagedStore *pPagedStore pointer to paged store, it can't be modified until the function returns
+ * \param pFunction (*pFunction) pointer to function that renders one element into the formatter. It is called from
+ *        several threads at once. It returns (0) if ok or (-1) if error
+ * \return int value return (-1) if error [NULL pointer, can't allocate memory, an element can't be read or a write
+ *                           failed]
+ *                           (0) if ok
+ */
+int rw_renderStore(TextFormatter *pOutput, PagedStore *pPagedStore, int (*pFunction)(TextFormatter*, void*));
+
+/**
+ * \brief Render every element of pPagedStore, in order, into pOutput like rw_renderStore, with a given number of
+ *        threads. The text does not depend on the number of threads
+ * \param TextFormatter *pOutput pointer to formatter with file descriptor where the text is written
+ * \param PagedStore *pPagedStore pointer to paged store, it can't be modified until the function returns
+ * \param pFunction (*pFunction) pointer to function that renders one element into the formatter. It is called from
+ *        several threads at once. It returns (0) if ok or (-1) if error
+ * \param int threads number of threads of the pool, at least 1
+ * \return int value return (-1) if error [NULL pointer, invalid threads, can't allocate memory, an element can't be
+ *                           read or a write failed]
+ *                           (0) if ok
+ */
+int rw_renderStoreThreads(TextFormatter *pOutput, PagedStore *pPagedStore, int (*pFunction)(TextFormatter*, void*), int threads);
+
+/**
+ * \brief Close the report file and release the report writer
+ * \param ReportWriter *this pointer to report writer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int rw_deleteReportWriter(ReportWriter *this);
+
+#endif // REPORTWRITER_H_INCLUDED
@@ -0,0 +1,99 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef RINGBUFFER_H_INCLUDED
+#define RINGBUFFER_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// LONGITUD DE LINEA DE CACHE
+#define RB_CACHE_LINE 64
+
+struct RingBuffer{
+
+    int elementSize;
+    unsigned int capacity;
+    char *pElements;
+
+    // escritos solo por el productor
+    unsigned int head;
+    unsigned int cachedTail;
+    char producerPadding[RB_CACHE_LINE - 2 * sizeof(unsigned int)];
+
+    // escritos solo por el consumidor
+    unsigned int tail;
+    unsigned int cachedHead;
+    char consumerPadding[RB_CACHE_LINE - 2 * sizeof(unsigned int)];
+
+    int closed;
+
+}typedef RingBuffer;
+
+/**
+ * \brief Allocate a lock-free queue of fixed size elements for one producer thread and one consumer thread
+ * \param int elementSize size in bytes of every element
+ * \param int capacity maximum number of queued elements, rounded up to a power of two
+ * \return RingBuffer *pAux Return (NULL) if error [invalid parameters or if can't allocate memory]
+ *                               - (pointer to new ring buffer) if ok
+ */
+RingBuffer *rb_newRingBuffer(int elementSize, int capacity);
+
+/**
+ * \brief Copy an element at the end of the queue. Only the producer thread can call it
+ * \param RingBuffer *this pointer to ring buffer
+ * \param void *pElement pointer to element
+ * \return int value return (-1) if error [this or pElement are NULL pointer or the queue is full]
+ *                           (0) if ok
+ */
+int rb_push(RingBuffer *this, void *pElement);
+
+/**
+ * \brief Copy up to count elements from the front of the queue and remove them. Only the consumer thread can call it
+ * \param RingBuffer *this pointer to ring buffer
+ * \param void *pElements pointer to an array of at least count elements
+ * \param int count maximum number of elements to copy
+ * \return int value return (-1) if error [this or pElements are NULL pointer or invalid count]
+ *                          (number of elements copied, 0 if the queue is empty) if ok
+ */
+int rb_popArray(RingBuffer *this, void *pElements, int count);
+
+/**
+ * \brief Mark that the producer won't push more elements. Only the producer thread can call it
+ * \param RingBuffer *this pointer to ring buffer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int rb_close(RingBuffer *this);
+
+/**
+ * \brief Find if the producer closed the queue. The elements pushed before closing are still available after it
+ * \param RingBuffer *this pointer to ring buffer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if it is open
+ *                           (1) if it is closed
+ */
+int rb_isClosed(RingBuffer *this);
+
+/**
+ * \brief Release the ring buffer. No thread can be using it
+ * \param RingBuffer *this pointer to ring buffer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int rb_deleteRingBuffer(RingBuffer *this);
+
+#endif // RINGBUFFER_H_INCLUDED
@@ -0,0 +1,250 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEGMENTLOG_H_INCLUDED
+#define SEGMENTLOG_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "arraylist.h"
+#include "eventlog.h"
+
+// FORMATO DEL MANIFIESTO
+#define SL_FILE_MAGIC "MSEG"
+#define SL_FILE_VERSION 1
+
+// TAMANIO EN EL MANIFIESTO DEL ENCABEZADO Y DE CADA SEGMENTO, LOS ENTEROS SE GUARDAN EN LITTLE ENDIAN
+#define SL_HEADER_SIZE 16
+#define SL_ENTRY_SIZE 32
+
+// LONGITUD DE LOS NOMBRES DE ARCHIVO
+#define SL_MAX_NAME_CHARS 256
+
+// CANTIDAD DE REGISTROS LEIDOS POR BLOQUE AL VERIFICAR EL SEGMENTO ACTIVO
+#define SL_READ_CHUNK 512
+
+// SEGUNDOS POR DIA
+#define SL_DAY 86400
+
+// SEGUNDOS ENTRE PASADAS DEL COMPACTADOR
+#define SL_COMPACT_INTERVAL 60
+
+struct Segment{
+
+    int number;
+    int first;
+    int count;
+    int sealed;
+    long long firstTimestamp;
+    long long lastTimestamp;
+
+}typedef Segment;
+
+struct SegmentLog{
+
+    char *baseName;
+    char *manifestName;
+    void *pHeader;
+    int headerSize;
+    int recordSize;
+    long long (*pTimestampOf)(void*);
+    int (*pIsValid)(void*);
+
+    int syncPolicy;
+    int groupSize;
+    int groupInterval;
+    int segmentRecords;
+    int segmentPeriod;
+    long long retention;
+
+    int first;
+    int next;
+    int truncated;
+    int readOnly;
+    ArrayList *pSegments;
+    EventLog *pActive;
+
+    int running;
+    pthread_t compactor;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+
+}typedef SegmentLog;
+
+/**
+ * \brief Open a log of fixed size records split in segment files named baseName.NNNNNN.bin and listed in order by
+ *        the manifest baseName.manifest. Every segment but the last is sealed and never written again, records are
+ *        only appended to the last one. If there is no manifest and the single file baseName.bin exists, it becomes
+ *        the first segment. Records are numbered from the first record ever appended, the numbers are kept when old
+ *        segments are dropped. The segment being written is checked before it is opened and cut at the first
+ *        damaged or incomplete record, the number of records removed is left in truncated. Segment files that the
+ *        manifest does not list, left by a crash while a segment was dropped or started, are deleted
+ * \param char *baseName path of the log without extension
+ * \param void *pHeader pointer to the header written at the beginning of every segment, (NULL) if they have no header
+ * \param int headerSize size in bytes of the header
+ * \param int recordSize size in bytes of every record
+ * \param long long (*pTimestampOf)(void*) function that returns the time of a record in seconds since the epoch
+ * \param int (*pIsValid)(void*) function that returns 1 if a record is not damaged, (NULL) to only remove an
+ *        incomplete last record
+ * \param int syncPolicy sync policy of the segment being written, see el_newEventLog
+ * \return SegmentLog *pAux Return (NULL) if error [invalid parameters, invalid manifest, can't open the files or
+ *                               can't allocate memory]
+ *                               - (pointer to new segment log) if ok
+ */
+SegmentLog *sl_newSegmentLog(char *baseName, void *pHeader, int headerSize, int recordSize, long long (*pTimestampOf)(void*), int (*pIsValid)(void*), int syncPolicy);
+
+/**
+ * \brief Open the manifest of a log only to list its segments, see sl_newSegmentLog. Nothing is written: the single
+ *        file of an old log is not renamed, the segment being written is neither checked nor cut, the compactor is
+ *        not started and records can't be appended. The segment files are read by the caller with sl_getFileName
+ * \param char *baseName path of the log without extension
+ * \param int headerSize size in bytes of the header of every segment
+ * \param int recordSize size in bytes of every record
+ * \return SegmentLog *pAux Return (NULL) if error [invalid parameters, there is no manifest or it is not valid or
+ *                               can't allocate memory]
+ *                               - (pointer to new segment log) if ok
+ */
+SegmentLog *sl_newReadOnlySegmentLog(char *baseName, int headerSize, int recordSize);
+
+/**
+ * \brief Change the sync policy of the segment being written and of the next ones, see el_setSyncPolicy
+ * \param SegmentLog *this pointer to segment log
+ * \param int syncPolicy EL_SYNC_NONE, EL_SYNC_FLUSH, EL_SYNC_FULL or EL_SYNC_GROUP
+ * \param int groupSize maximum number of records of a group, only used by EL_SYNC_GROUP
+ * \param int groupInterval maximum time in milliseconds a record waits for its group, only used by EL_SYNC_GROUP
+ * \return int value return (-1) if error [this is NULL pointer or invalid parameters]
+ *                           (0) if ok
+ */
+int sl_setSyncPolicy(SegmentLog *this, int syncPolicy, int groupSize, int groupInterval);
+
+/**
+ * \brief Set when the segment being written is sealed and a new one is started: before it holds more than
+ *        segmentRecords records, or before a record of a new period of segmentPeriod seconds is appended
+ * \param SegmentLog *this pointer to segment log
+ * \param int segmentRecords maximum number of records of a segment, (0) without limit
+ * \param int segmentPeriod length in seconds of the period of a segment, SL_DAY for a segment per day, (0) without limit
+ * \return int value return (-1) if error [this is NULL pointer or invalid parameters]
+ *                           (0) if ok
+ */
+int sl_setRotation(SegmentLog *this, int segmentRecords, int segmentPeriod);
+
+/**
+ * \brief Set how long the records are kept. A background thread drops, every SL_COMPACT_INTERVAL seconds and after
+ *        a segment is sealed, the sealed segments whose last record is older than the retention. The segment being
+ *        written is never dropped and the writers are not blocked while the files are removed
+ * \param SegmentLog *this pointer to segment log
+ * \param long long retention time in seconds the records are kept, (0) to keep them forever
+ * \return int value return (-1) if error [this is NULL pointer, the log is read only, invalid retention or
+ *                           can't start the thread]
+ *                           (0) if ok
+ */
+int sl_setRetention(SegmentLog *this, long long retention);
+
+/**
+ * \brief Append one record to the segment being written, sealing it first if the record does not fit in it
+ * \param SegmentLog *this pointer to segment log
+ * \param void *pRecord pointer to the record to write
+ * \return int value return (-1) if error [this or pRecord are NULL pointer, the log is read only, write failed
+ *                           or can't start a new segment]
+ *                           (0) if ok
+ */
+int sl_append(SegmentLog *this, void *pRecord);
+
+/**
+ * \brief Append count consecutive records, with a single write per segment they are stored in
+ * \param SegmentLog *this pointer to segment log
+ * \param void *pRecords pointer to the first record
+ * \param int count number of records
+ * \return int value return (-1) if error [this or pRecords are NULL pointer, the log is read only, invalid count,
+ *                           write failed or can't start a new segment]
+ *                           (0) if ok
+ */
+int sl_appendArray(SegmentLog *this, void *pRecords, int count);
+
+/**
+ * \brief Read consecutive records, crossing from one segment to the next when needed
+ * \param SegmentLog *this pointer to segment log
+ * \param int record number of the first record to read
+ * \param void *pRecords pointer to a buffer of count records
+ * \param int count maximum number of records to read
+ * \return int value return (-1) if error [this or pRecords are NULL pointer, invalid parameters or the record was
+ *                          dropped]
+ *                          (number of records read, 0 after the last record) if ok
+ */
+int sl_read(SegmentLog *this, int record, void *pRecords, int count);
+
+/**
+ * \brief Get the number of segments of the log
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (number of segments) if ok
+ */
+int sl_len(SegmentLog *this);
+
+/**
+ * \brief Get the number of the oldest record kept, the records before it were dropped with their segments
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (number of the first record) if ok
+ */
+int sl_getFirst(SegmentLog *this);
+
+/**
+ * \brief Get the file name of a segment. Sealed segments can be read without locking, they are not written again
+ * \param SegmentLog *this pointer to segment log
+ * \param int index position of the segment, from the oldest (0) to the segment being written (sl_len - 1)
+ * \param char *fileName buffer where the name is copied
+ * \param int size size of the buffer
+ * \return int value return (-1) if error [this or fileName are NULL pointer, invalid index or the buffer is too small]
+ *                           (0) if ok
+ */
+int sl_getFileName(SegmentLog *this, int index, char *fileName, int size);
+
+/**
+ * \brief Drop now the sealed segments older than the retention
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer, the log is read only or can't write the manifest]
+ *                          (number of segments dropped) if ok
+ */
+int sl_compact(SegmentLog *this);
+
+/**
+ * \brief Hand every pending record of the segment being written to the operating system, see el_flush
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer or flush failed]
+ *                           (0) if ok
+ */
+int sl_flush(SegmentLog *this);
+
+/**
+ * \brief Force every pending record of the segment being written to the storage device, see el_sync
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer or sync failed]
+ *                           (0) if ok
+ */
+int sl_sync(SegmentLog *this);
+
+/**
+ * \brief Stop the compactor, close the segment being written and release the segment log
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int sl_deleteSegmentLog(SegmentLog *this);
+
+#endif // SEGMENTLOG_H_INCLUDED
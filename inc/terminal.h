@@ -0,0 +1,73 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TERMINAL_H_INCLUDED
+#define TERMINAL_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// TAMANIO DEL BUFFER DE SALIDA DE UNA PANTALLA
+#define TM_OUTPUT_BUFFER 16384
+
+// SECUENCIA ANSI PARA BORRAR LA PANTALLA Y VOLVER AL INICIO
+#define TM_CLEAR_SEQUENCE "\033[H\033[2J\033[3J"
+
+// MENSAJE DE ESPERA
+#define TM_PAUSE_MESSAGE "Presione una tecla para continuar . . . "
+
+/**
+ * \brief Prepare the console. The standard output is fully buffered, so every screen is written at once when the
+ *        program waits for the user, and on Windows the console is set to understand ANSI sequences
+ * \param void
+ * \return int value return (-1) if error [the console does not support ANSI sequences, tm_clear uses the console API]
+ *                           (0) if ok
+ */
+int tm_init(void);
+
+/**
+ * \brief Start a new screen: the console is cleared and the cursor goes to the top left corner.
+ *        The clear is buffered with the rest of the screen
+ * \param void
+ * \return void
+ */
+void tm_clear(void);
+
+/**
+ * \brief Write the buffered screen to the console
+ * \param void
+ * \return void
+ */
+void tm_flush(void);
+
+/**
+ * \brief Show the buffered screen and wait until the user presses a key. When the input is not a console
+ *        there is nobody to wait for and it returns right away
+ * \param void
+ * \return void
+ */
+void tm_pause(void);
+
+/**
+ * \brief Show the buffered screen and read a line typed by the user, without the line break
+ * \param char *input buffer where the line is loaded
+ * \param int size size of the buffer, longer lines are cut and the rest is discarded
+ * \return int value return (-1) if error [invalid parameters or end of the input, input is left empty]
+ *                           (0) if ok
+ */
+int tm_readLine(char *input, int size);
+
+#endif // TERMINAL_H_INCLUDED
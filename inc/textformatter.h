@@ -0,0 +1,152 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+#ifndef TEXTFORMATTER_H_INCLUDED
+#define TEXTFORMATTER_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// CANTIDAD MAXIMA DE CARACTERES DE UN NUMERO
+#define TF_MAX_NUMBER_CHARS 64
+
+// CANTIDAD MAXIMA DE BUFFERS POR ESCRITURA
+#define TF_MAX_VECTORS 64
+
+struct TextFormatter{
+
+    int fd;
+    int size;
+    int length;
+    int failed;
+    char *pBuffer;
+
+}typedef TextFormatter;
+
+/**
+ * \brief Allocate a formatter that renders text into a reusable buffer of size bytes. The buffer is written to the
+ *        file descriptor with one write when it is full or when tf_flush is called. Until tf_setFile is called the
+ *        buffer grows instead, keeping all the text until it is written with tf_writeBuffers
+ * \param int size size in bytes of the buffer, not less than TF_MAX_NUMBER_CHARS
+ * \return TextFormatter *pAux Return (NULL) if error [invalid size or if can't allocate memory]
+ *                                  - (pointer to new formatter) if ok
+ */
+TextFormatter *tf_newTextFormatter(int size);
+
+/**
+ * \brief Set the file descriptor where the buffer is written. The text already in the buffer is not written
+ * \param TextFormatter *this pointer to formatter
+ * \param int fd file descriptor opened for writing
+ * \return int value return (-1) if error [this is NULL pointer or fd is invalid]
+ *                           (0) if ok
+ */
+int tf_setFile(TextFormatter *this, int fd);
+
+/**
+ * \brief Append count characters
+ * \param TextFormatter *this pointer to formatter
+ * \param char *pChars pointer to the characters
+ * \param int count number of characters
+ * \return int value return (-1) if error [this or pChars are NULL pointer, count is negative or write failed]
+ *                           (0) if ok
+ */
+int tf_putChars(TextFormatter *this, char *pChars, int count);
+
+/**
+ * \brief Append a string, the same as printf "%s"
+ * \param TextFormatter *this pointer to formatter
+ * \param char *string string ended with '\0'
+ * \return int value return (-1) if error [this or string are NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int tf_putString(TextFormatter *this, char *string);
+
+/**
+ * \brief Make room for up to count characters at the end of the buffer, writing the buffer first if they don't fit.
+ *        The characters are rendered directly in the buffer with the tf_format functions and appended with tf_commit
+ * \param TextFormatter *this pointer to formatter
+ * \param int count maximum number of characters that will be rendered
+ * \return char *pAux Return (NULL) if error [this is NULL pointer, count is negative or greater than the buffer of a
+ *                            formatter with file descriptor, or can't allocate memory]
+ *                    - (pointer to the first free character of the buffer) if ok
+ */
+char *tf_reserve(TextFormatter *this, int count);
+
+/**
+ * \brief Append the characters rendered in the buffer since the last tf_reserve
+ * \param TextFormatter *this pointer to formatter
+ * \param char *pEnd pointer to the character after the last one rendered
+ * \return int value return (-1) if error [this is NULL pointer, pEnd is out of the buffer or a write failed]
+ *                           (0) if ok
+ */
+int tf_commit(TextFormatter *this, char *pEnd);
+
+/**
+ * \brief Render an integer filled with zeros up to width characters, the same as printf "%0*d". With width 0 it
+ *        is the same as "%d". It renders at most the greater of width and 11 characters
+ * \param char *pChars pointer where the text is rendered
+ * \param int number number to render
+ * \param int width minimum number of characters, the sign included
+ * \return char *pAux pointer to the character after the text
+ */
+char *tf_formatInteger(char *pChars, int number, int width);
+
+/**
+ * \brief Render a float with two decimals, the same as printf "%.2f". The rounding is done over the exact value of
+ *        the float, so the text is identical to the one of printf. It renders at most TF_MAX_NUMBER_CHARS characters
+ * \param char *pChars pointer where the text is rendered
+ * \param float number number to render
+ * \return char *pAux pointer to the character after the text
+ */
+char *tf_formatFloat(char *pChars, float number);
+
+/**
+ * \brief Render a string aligned to the right with spaces up to width characters, the same as printf "%*s". With
+ *        width 0 it is the same as "%s". It renders the greater of width and the length of the string
+ * \param char *pChars pointer where the text is rendered
+ * \param char *string string ended with '\0'
+ * \param int width minimum number of characters
+ * \return char *pAux pointer to the character after the text
+ */
+char *tf_formatString(char *pChars, char *string, int width);
+
+/**
+ * \brief Write the text of the buffer and then the text of count formatters without file descriptor, in order, with
+ *        as few writes as possible. The buffers of the formatters are emptied
+ * \param TextFormatter *this pointer to formatter
+ * \param TextFormatter **ppBuffers pointer to an array of count formatters
+ * \param int count number of formatters
+ * \return int value return (-1) if error [this or ppBuffers are NULL pointer, count is negative or a write failed]
+ *                           (0) if ok
+ */
+int tf_writeBuffers(TextFormatter *this, TextFormatter **ppBuffers, int count);
+
+/**
+ * \brief Write the text of the buffer to the file descriptor and empty the buffer
+ * \param TextFormatter *this pointer to formatter
+ * \return int value return (-1) if error [this is NULL pointer or a write failed since the last flush]
+ *                           (0) if ok
+ */
+int tf_flush(TextFormatter *this);
+
+/**
+ * \brief Release the formatter. The text that was not flushed is lost
+ * \param TextFormatter *this pointer to formatter
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int tf_deleteTextFormatter(TextFormatter *this);
+
+#endif // TEXTFORMATTER_H_INCLUDED
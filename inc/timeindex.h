@@ -0,0 +1,105 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TIMEINDEX_H_INCLUDED
+#define TIMEINDEX_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arraylist.h"
+
+// FORMATO DEL ARCHIVO DE INDICE
+#define TI_FILE_MAGIC "MIDX"
+#define TI_FILE_VERSION 1
+
+// TAMANIO EN EL ARCHIVO DEL ENCABEZADO Y DE CADA ENTRADA, LOS ENTEROS SE GUARDAN EN LITTLE ENDIAN
+#define TI_HEADER_SIZE 16
+#define TI_ENTRY_SIZE 16
+
+struct TimeIndexEntry{
+
+    long long bucket;
+    int record;
+
+}typedef TimeIndexEntry;
+
+struct TimeIndex{
+
+    FILE *file;
+    char *fileName;
+    int bucketSize;
+    ArrayList *pEntries;
+
+}typedef TimeIndex;
+
+/**
+ * \brief Open a sparse index of a log whose records are appended in chronological order. The index keeps one
+ *        entry per time bucket with the number of the first record of that bucket. If the file does not exist,
+ *        is not valid or was written with another bucket size it is created empty
+ * \param char *fileName path of the index file
+ * \param int bucketSize size of every bucket in seconds
+ * \return TimeIndex *pAux Return (NULL) if error [invalid parameters, can't open the file or can't allocate memory]
+ *                              - (pointer to new time index) if ok
+ */
+TimeIndex *ti_newTimeIndex(char *fileName, int bucketSize);
+
+/**
+ * \brief Register a record appended to the log. An entry is only written when the record starts a new bucket
+ * \param TimeIndex *this pointer to time index
+ * \param long long timestamp time of the record in seconds since the epoch
+ * \param int record number of the record in the log
+ * \return int value return (-1) if error [this is NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int ti_add(TimeIndex *this, long long timestamp, int record);
+
+/**
+ * \brief Find the record where a scan for the records at or after a time has to start
+ * \param TimeIndex *this pointer to time index
+ * \param long long timestamp time in seconds since the epoch
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (number of the first record of the bucket that contains timestamp, or of the first
+ *                          bucket after it) if ok
+ */
+int ti_find(TimeIndex *this, long long timestamp);
+
+/**
+ * \brief Check if the index covers every record of the log, that is, the last entry points to an existing record
+ *        and no record after it starts a new bucket
+ * \param TimeIndex *this pointer to time index
+ * \param int count number of records of the log
+ * \param long long lastTimestamp time of the last record of the log
+ * \return int value return (1) if the index is valid - (0) if not or this is NULL pointer
+ */
+int ti_isValid(TimeIndex *this, int count, long long lastTimestamp);
+
+/**
+ * \brief Remove every entry of the index and truncate the file so it can be rebuilt with ti_add
+ * \param TimeIndex *this pointer to time index
+ * \return int value return (-1) if error [this is NULL pointer or can't reopen the file]
+ *                           (0) if ok
+ */
+int ti_clear(TimeIndex *this);
+
+/**
+ * \brief Close the file and release the time index
+ * \param TimeIndex *this pointer to time index
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int ti_deleteTimeIndex(TimeIndex *this);
+
+#endif // TIMEINDEX_H_INCLUDED
@@ -16,11 +16,11 @@
 #ifndef VALIDATIONS_H_INCLUDED
 #define VALIDATIONS_H_INCLUDED
 
-#include <conio.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
+#include "terminal.h"
 
 #define ENTER_KEY 13
 #define BACKSPACE_KEY 8
@@ -224,4 +224,11 @@ int getValidPhoneNumber(char *requestMessage, char *errorMessage, char *errorMes
  */
 void firstUppercaseLetter(char *string);
 
+/**
+ * \brief Converts every character to uppercase
+ * \param char *string string to convert
+ * \return void
+ */
+void allUppercaseLetters(char *string);
+
 #endif // VALIDATIONS_H_INCLUDED
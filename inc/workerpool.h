@@ -0,0 +1,90 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef WORKERPOOL_H_INCLUDED
+#define WORKERPOOL_H_INCLUDED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// CANTIDAD MAXIMA DE HILOS DEL POOL
+#define WP_MAX_THREADS 64
+
+struct WorkerPool{
+
+    int threads;
+    pthread_t *pThreads;
+    pthread_mutex_t mutex;
+    pthread_cond_t start;
+    pthread_cond_t done;
+
+    // tarea en curso, se cambia solo con todos los hilos esperando
+    void (*pTask)(void*, int);
+    void *pContext;
+    int taskCount;
+    int nextTask;
+    int busy;
+    int round;
+    int running;
+
+}typedef WorkerPool;
+
+/**
+ * \brief Allocate a pool of threads that run the tasks given with wp_run. The thread that calls wp_run also runs
+ *        tasks, so the pool creates threads - 1 threads
+ * \param int threads number of threads that run tasks, (0) to use one for every processor of the system
+ * \return WorkerPool *pAux Return (NULL) if error [invalid threads, can't allocate memory or can't start a thread]
+ *                               - (pointer to new worker pool) if ok
+ */
+WorkerPool *wp_newWorkerPool(int threads);
+
+/**
+ * \brief Run taskCount tasks calling pTask(pContext, index) for every index from 0 to taskCount - 1, spread over the
+ *        threads of the pool. Tasks are taken in increasing order but can finish in any order. It returns when every
+ *        task has finished
+ * \param WorkerPool *this pointer to worker pool
+ * \param void (*pTask)(void*, int) function that runs a task
+ * \param void *pContext pointer given to every task
+ * \param int taskCount number of tasks
+ * \return int value return (-1) if error [this or pTask are NULL pointer or invalid taskCount]
+ *                           (0) if ok
+ */
+int wp_run(WorkerPool *this, void (*pTask)(void*, int), void *pContext, int taskCount);
+
+/**
+ * \brief Get the number of threads that run tasks, including the one that calls wp_run
+ * \param WorkerPool *this pointer to worker pool
+ * \return int value return number of threads or (-1) if error [this is NULL pointer]
+ */
+int wp_len(WorkerPool *this);
+
+/**
+ * \brief Get the number of processors of the system available to run threads
+ * \param -
+ * \return int value number of processors, at least 1
+ */
+int wp_getProcessors(void);
+
+/**
+ * \brief Stop the threads of the pool and release it. It must not be called while wp_run is running
+ * \param WorkerPool *this pointer to worker pool
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int wp_deleteWorkerPool(WorkerPool *this);
+
+#endif // WORKERPOOL_H_INCLUDED
@@ -19,9 +19,25 @@
 int resizeUp(ArrayList *this);
 int expand(ArrayList *this, int index);
 int contract(ArrayList *this, int index);
+ArrayList *newArrayList(int elementSize);
+int slotSize(ArrayList *this);
+void *slotAt(ArrayList *this, int index);
+void storeAt(ArrayList *this, int index, void *pElement);
+int equalsAt(ArrayList *this, int index, void *pElement);
+int compareSlots(ArrayList *this, int (*pFunction)(void*, void*), int order, void *pFirst, void *pSecond);
+void mergeSlots(ArrayList *this, int (*pFunction)(void*, void*), int order, char *pSource, char *pTarget, int from, int middle, int to);
+void notifyAdd(ArrayList *this, int from, int to);
+void notifyRemove(ArrayList *this, int from, int to);
 
-#define AL_INCREMENT      10
 #define AL_INITIAL_VALUE  10
+#define AL_GROWTH_FACTOR  2.0f
+
+typedef struct{
+
+    unsigned long long key;
+    int index;
+
+}KeyIndex;
 
 /**
  * \brief Allocate a new arrayList with AL_INITIAL_VALUE elements.
@@ -31,72 +47,76 @@ int contract(ArrayList *this, int index);
  */
 ArrayList *al_newArrayList(void)
 {
-    ArrayList *this = NULL;
-    ArrayList *pAux = NULL;
-    void *pElements = NULL;
+    return newArrayList(0);
+}
 
-    this = (ArrayList*)malloc(sizeof(ArrayList));
+/**
+ * \brief Allocate a new arrayList with AL_INITIAL_VALUE elements that stores copies of the elements by value,
+ *        one after the other in a single block of memory
+ * \param int elementSize size in bytes of every element
+ * \return ArrayList *pAux Return (NULL) if error [invalid elementSize or if can't allocate memory]
+ *                              - (pointer to new arrayList) if ok
+ */
+ArrayList *al_newTypedArrayList(int elementSize)
+{
+    ArrayList *pAux = NULL;
 
-    if(this != NULL){
-        pElements = malloc(sizeof(void*) * AL_INITIAL_VALUE);
-
-        if(pElements != NULL){
-            this->size = 0;
-            this->pElements = pElements;
-            this->reservedSize = AL_INITIAL_VALUE;
-            this->add = al_add;
-            this->len = al_len;
-            this->set = al_set;
-            this->remove = al_remove;
-            this->clear = al_clear;
-            this->clone = al_clone;
-            this->get = al_get;
-            this->contains = al_contains;
-            this->push = al_push;
-            this->indexOf = al_indexOf;
-            this->isEmpty = al_isEmpty;
-            this->pop = al_pop;
-            this->subList = al_subList;
-            this->containsAll = al_containsAll;
-            this->deleteArrayList = al_deleteArrayList;
-            this->sort = al_sort;
-            pAux = this;
-        }
-        else
-            free(this);
-    }
+    if(elementSize > 0)
+        pAux = newArrayList(elementSize);
 
     return pAux;
 }
 
 /**
- * \brief Add an element to arrayList and if is necessary resize the array
+ * \brief Add an element to arrayList and if is necessary resize the array. Typed lists store a copy of the element
  * \param ArrayList *this pointer to arrayList
  * \param void *pElement Pointer to element
- * \return int value return (-1) if error [this or pElement are NULL pointer]
+ * \return int value return (-1) if error [this or pElement are NULL pointer or if can't allocate memory]
  *                           (0) if ok
  */
 int al_add(ArrayList *this, void *pElement)
 {
     int value = -1;
 
-    if(this != NULL && pElement != NULL && this->size == this->reservedSize){
-        resizeUp(this);
-        this->pElements[this->size] = pElement;
-        this->size++;
-        value = 0;
+    if(this != NULL && pElement != NULL){
+        if(this->size < this->reservedSize || resizeUp(this) == 0){
+            storeAt(this, this->size, pElement);
+            this->size++;
+            notifyAdd(this, this->size - 1, this->size);
+            value = 0;
+        }
     }
-    else{
-        this->pElements[this->size] = pElement;
-        this->size++;
-        value = 0;
+
+    return value;
+}
+
+/**
+ * \brief Add count elements stored one after the other in pElements, resizing the array only once.
+ *        Typed lists copy count values, the other lists copy count pointers
+ * \param ArrayList *this pointer to arrayList
+ * \param void *pElements pointer to the first element
+ * \param int count number of elements
+ * \return int value return (-1) if error [this or pElements are NULL pointer, invalid count or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_addArray(ArrayList *this, void *pElements, int count)
+{
+    int value = -1;
+
+    if(this != NULL && pElements != NULL && count >= 0){
+        if(al_reserve(this, this->size + count) == 0){
+            memcpy(slotAt(this, this->size), pElements, (size_t)slotSize(this) * count);
+            this->size += count;
+            notifyAdd(this, this->size - count, this->size);
+            value = 0;
+        }
     }
 
     return value;
 }
 
 /**
- * \brief Delete arrayList
+ * \brief Delete arrayList. The elements of a list of pointers are not released, they belong to the caller
  * \param ArrayList *this pointer to arrayList
  * \return int value return (-1) if error [this is NULL pointer]
  *                           (0) if ok
@@ -130,7 +150,7 @@ int al_len(ArrayList *this)
 }
 
 /**
- * \brief Get an element by index
+ * \brief Get an element by index. In typed lists the pointer is valid until this is modified
  * \param ArrayList *this pointer to arrayList
  * \param int index Index of the element
  * \return void *pAux return (NULL) if error [this is NULL pointer or invalid index]
@@ -141,7 +161,7 @@ void *al_get(ArrayList *this, int index)
     void *pAux = NULL;
 
     if(this != NULL && (index >= 0 && index < this->size))
-        pAux = this->pElements[index];
+        pAux = this->elementSize > 0 ? slotAt(this, index) : this->pElements[index];
 
     return pAux;
 }
@@ -161,7 +181,7 @@ int al_contains(ArrayList *this, void *pElement)
 
     if(this != NULL && pElement != NULL){
         for(i = 0; i < this->size; i++){
-            if(this->pElements[i] == pElement){
+            if(equalsAt(this, i, pElement)){
                 value = 1;
                 break;
             }
@@ -187,7 +207,9 @@ int al_set(ArrayList *this, int index, void *pElement)
 
     if(this != NULL && pElement != NULL){
         if(index >= 0 && index < this->size){
-            this->pElements[index] = pElement;
+            notifyRemove(this, index, index + 1);
+            storeAt(this, index, pElement);
+            notifyAdd(this, index, index + 1);
             value = 0;
         }
     }
@@ -204,14 +226,11 @@ int al_set(ArrayList *this, int index, void *pElement)
  */
 int al_remove(ArrayList *this, int index)
 {
-    int i;
     int value = -1;
 
     if(this != NULL && (index >= 0 && index < this->size)){
-        for(i = index; i < this->size - 1; i++){
-            this->pElements[i] = this->pElements[i + 1];
-        }
-
+        notifyRemove(this, index, index + 1);
+        memmove(slotAt(this, index), slotAt(this, index + 1), (size_t)slotSize(this) * (this->size - index - 1));
         this->size--;
         value = 0;
     }
@@ -220,7 +239,7 @@ int al_remove(ArrayList *this, int index)
 }
 
 /**
- * \brief Removes all of the elements from this list
+ * \brief Removes all of the elements from this list. The elements of a list of pointers are released
  * \param ArrayList *this pointer to arrayList
  * \return int value return (-1) if error [this is NULL pointer]
  *                           (0) if ok
@@ -231,7 +250,9 @@ int al_clear(ArrayList *this)
     int value = -1;
 
     if(this != NULL){
-        for(i = 0; i < this->reservedSize; i++){
+        notifyRemove(this, 0, this->size);
+
+        for(i = 0; i < this->size && this->elementSize == 0; i++){
             free(this->pElements[i]);
         }
 
@@ -250,15 +271,14 @@ int al_clear(ArrayList *this)
  */
 ArrayList *al_clone(ArrayList *this)
 {
-    int i;
     ArrayList *pAux = NULL;
 
     if(this != NULL){
-        pAux = al_newArrayList();
+        pAux = newArrayList(this->elementSize);
 
-        if(pAux != NULL){
-            for(i = 0; i < this->size; i++)
-                al_add(pAux, al_get(this, i));
+        if(pAux != NULL && al_addArray(pAux, this->pElements, this->size) != 0){
+            al_deleteArrayList(pAux);
+            pAux = NULL;
         }
     }
 
@@ -275,31 +295,16 @@ ArrayList *al_clone(ArrayList *this)
  */
 int al_push(ArrayList *this, int index, void *pElement)
 {
-    int i;
     int value = -1;
 
-    if(this != NULL && pElement != NULL){
-        if(index >= 0 && index <= this->size){
-            if(this->size == this->reservedSize){
-                resizeUp(this);
-
-                for(i = index; i < this->size - 1; i++){
-                    this->pElements[i + 1] = this->pElements[i];
-                }
-
-                this->pElements[index] = pElement;
-                this->size++;
-            }
-            else{
-                for(i = index; i < this->size - 1; i++){
-                    this->pElements[i + 1] = this->pElements[i];
-                }
-
-                this->pElements[index] = pElement;
-                this->size++;
-            }
+    if(this != NULL && pElement != NULL && (index >= 0 && index <= this->size)){
+        if(this->size < this->reservedSize || resizeUp(this) == 0){
+            memmove(slotAt(this, index + 1), slotAt(this, index), (size_t)slotSize(this) * (this->size - index));
+            storeAt(this, index, pElement);
+            this->size++;
+            notifyAdd(this, index, index + 1);
+            value = 0;
         }
-        value = 0;
     }
 
     return value;
@@ -319,7 +324,7 @@ int al_indexOf(ArrayList *this, void *pElement)
 
     if(this != NULL && pElement != NULL){
         for(i = 0; i < this->size; i++){
-            if(this->pElements[i] == pElement){
+            if(equalsAt(this, i, pElement)){
                 value = i;
                 break;
             }
@@ -352,7 +357,7 @@ int al_isEmpty(ArrayList *this)
 }
 
 /**
- * \brief Remove the item at the given position in the list, and return it.
+ * \brief Remove the item at the given position in the list, and return it. In typed lists the pointer is valid until this is modified
  * \param ArrayList *this pointer to arrayList
  * \param int index Index of the element
  * \return void *pAux return (NULL) if error [this is NULL pointer or invalid index]
@@ -364,7 +369,20 @@ void *al_pop(ArrayList *this, int index)
 
     if(this != NULL && (index >= 0 && index < this->size)){
         pAux = al_get(this, index);
-        al_remove(this, index);
+
+        if(this->elementSize > 0){
+            // el valor se copia al espacio libre que queda al final del array
+            if(this->size < this->reservedSize || resizeUp(this) == 0){
+                pAux = al_get(this, index);
+                memcpy(slotAt(this, this->size), pAux, this->elementSize);
+                al_remove(this, index);
+                pAux = slotAt(this, this->size + 1);
+            }
+            else
+                pAux = NULL;
+        }
+        else
+            al_remove(this, index);
     }
 
     return pAux;
@@ -384,7 +402,7 @@ ArrayList *al_subList(ArrayList *this, int from, int to)
     ArrayList *pAux = NULL;
 
     if(this != NULL && (from >= 0 && from < to && to <= this->size)){
-        pAux = al_newArrayList();
+        pAux = newArrayList(this->elementSize);
 
         if(pAux != NULL){
             for(i = from; i <= to; i++)
@@ -410,7 +428,7 @@ int al_containsAll(ArrayList *this, ArrayList *this2)
 
     if(this != NULL && this2 != NULL){
         for(i = 0; i < this->size; i++){
-            if(this->pElements[i] == this2->pElements[i])
+            if(equalsAt(this, i, al_get(this2, i)))
                 value = 1;
 
             else
@@ -422,64 +440,335 @@ int al_containsAll(ArrayList *this, ArrayList *this2)
 }
 
 /**
- * \brief Sorts objects of list, use compare pFunction
+ * \brief Sorts objects of list, use compare pFunction. The sort is stable and takes advantage of the runs already
+ *        sorted in the list (natural merge sort), O(n log n) in the worst case and O(n) if the list is already sorted
  * \param ArrayList *this pointer to arrayList
  * \param pFunction (*pFunction) pointer to function to compare elements of arrayList
  * \param int order [1] indicate UP - [0] indicate DOWN
- * \return int value return (-1) if error [this or pFunc are NULL pointer]
+ * \return int value return (-1) if error [this or pFunc are NULL pointer, invalid order or if can't allocate memory]
  *                           (0) if ok
  */
 int al_sort(ArrayList *this, int (*pFunction)(void*, void*), int order)
 {
-    int i, j;
-    int value = 0;
-    void *pAux = NULL;
+    int i;
+    int runs;
+    int value = -1;
+    int *pRuns = NULL;
+    char *pAux = NULL;
+    char *pBuffer = NULL;
+    char *pSource = NULL;
+    char *pTarget = NULL;
 
     if(this != NULL && pFunction != NULL && (order == 1 || order == 0)){
-        for(i = 0; i < this->size - 1; i++){
-            for(j = i + 1; j < this->size; j++){
-                if(pFunction(this->pElements[i], this->pElements[j]) > 0 && order == 1){
-                    pAux = this->pElements[i];
-                    this->pElements[i] = this->pElements[j];
-                    this->pElements[j] = pAux;
+        if(this->size < 2)
+            value = 0;
+
+        else{
+            pRuns = (int*)malloc(sizeof(int) * (this->size + 1));
+            pBuffer = (char*)malloc((size_t)slotSize(this) * this->size);
+
+            if(pRuns != NULL && pBuffer != NULL){
+                // limites de los tramos que ya estan ordenados
+                runs = 0;
+                pRuns[runs++] = 0;
+
+                for(i = 1; i < this->size; i++){
+                    if(compareSlots(this, pFunction, order, slotAt(this, i - 1), slotAt(this, i)) > 0)
+                        pRuns[runs++] = i;
                 }
-                if(!(pFunction(this->pElements[i], this->pElements[j]) > 0 && order == 0)){
-                    pAux = this->pElements[i];
-                    this->pElements[i] = this->pElements[j];
-                    this->pElements[j] = pAux;
+
+                pRuns[runs] = this->size;
+                pSource = (char*)this->pElements;
+                pTarget = pBuffer;
+
+                // se mezclan los tramos de a pares hasta que queda uno solo
+                while(runs > 1){
+                    for(i = 0; i + 1 < runs; i += 2)
+                        mergeSlots(this, pFunction, order, pSource, pTarget, pRuns[i], pRuns[i + 1], pRuns[i + 2]);
+
+                    if(i < runs)
+                        memcpy(pTarget + (size_t)slotSize(this) * pRuns[i], pSource + (size_t)slotSize(this) * pRuns[i], (size_t)slotSize(this) * (pRuns[runs] - pRuns[i]));
+
+                    for(i = 0; i * 2 <= runs; i++)
+                        pRuns[i] = pRuns[i * 2 < runs ? i * 2 : runs];
+
+                    runs = (runs + 1) / 2;
+                    pRuns[runs] = this->size;
+
+                    pAux = pSource;
+                    pSource = pTarget;
+                    pTarget = pAux;
                 }
+
+                if(pSource != (char*)this->pElements)
+                    memcpy(this->pElements, pSource, (size_t)slotSize(this) * this->size);
+
+                value = 0;
             }
+
+            free(pRuns);
+            free(pBuffer);
         }
-        value = 1;
     }
 
     return value;
 }
 
 /**
- * \brief Increment the number of elements in this in AL_INCREMENT elements.
+ * \brief Sorts objects of list by an integer key using a stable LSD radix sort, O(n) for any number of elements
+ * \param ArrayList *this pointer to arrayList
+ * \param pFunction (*pFunction) pointer to function that returns the key of an element of arrayList
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \return int value return (-1) if error [this or pFunc are NULL pointer, invalid order or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_sortByKey(ArrayList *this, long long (*pFunction)(void*), int order)
+{
+    int i;
+    int shift;
+    int value = -1;
+    int count[256];
+    KeyIndex *pKeys = NULL;
+    KeyIndex *pSorted = NULL;
+    KeyIndex *pAux = NULL;
+    char *pBuffer = NULL;
+
+    if(this != NULL && pFunction != NULL && (order == 1 || order == 0)){
+        pKeys = (KeyIndex*)malloc(sizeof(KeyIndex) * (this->size + 1));
+        pSorted = (KeyIndex*)malloc(sizeof(KeyIndex) * (this->size + 1));
+        pBuffer = (char*)malloc((size_t)slotSize(this) * (this->size + 1));
+
+        if(pKeys != NULL && pSorted != NULL && pBuffer != NULL){
+            // se invierte el bit de signo para que las claves negativas queden primero
+            for(i = 0; i < this->size; i++){
+                pKeys[i].key = (unsigned long long)pFunction(al_get(this, i)) ^ (1ULL << 63);
+                pKeys[i].index = i;
+
+                if(order == 0)
+                    pKeys[i].key = ~pKeys[i].key;
+            }
+
+            for(shift = 0; shift < 64; shift += 8){
+                memset(count, 0, sizeof(count));
+
+                for(i = 0; i < this->size; i++)
+                    count[(pKeys[i].key >> shift) & 0xFF]++;
+
+                // si todas las claves comparten este byte la pasada no cambia el orden
+                if(this->size > 0 && count[(pKeys[0].key >> shift) & 0xFF] == this->size)
+                    continue;
+
+                for(i = 1; i < 256; i++)
+                    count[i] += count[i - 1];
+
+                for(i = this->size - 1; i >= 0; i--)
+                    pSorted[--count[(pKeys[i].key >> shift) & 0xFF]] = pKeys[i];
+
+                pAux = pKeys;
+                pKeys = pSorted;
+                pSorted = pAux;
+            }
+
+            for(i = 0; i < this->size; i++)
+                memcpy(pBuffer + (size_t)slotSize(this) * i, slotAt(this, pKeys[i].index), slotSize(this));
+
+            memcpy(this->pElements, pBuffer, (size_t)slotSize(this) * this->size);
+            value = 0;
+        }
+
+        free(pKeys);
+        free(pSorted);
+        free(pBuffer);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Requests that the capacity of this be at least enough to contain reservedSize elements
+ * \param ArrayList *this pointer to arrayList
+ * \param int reservedSize minimum number of elements to be reserved
+ * \return int value return (-1) if error [this is NULL pointer, invalid reservedSize or if can't allocate memory]
+ *                           (0) if ok
+ */
+int al_reserve(ArrayList *this, int reservedSize)
+{
+    int value = -1;
+    void *pAux = NULL;
+
+    if(this != NULL && reservedSize >= 0){
+        if(reservedSize <= this->reservedSize)
+            value = 0;
+
+        else{
+            pAux = realloc(this->pElements, (size_t)slotSize(this) * reservedSize);
+
+            if(pAux != NULL){
+                this->pElements = pAux;
+                this->reservedSize = reservedSize;
+                value = 0;
+            }
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reduces the capacity of this to the number of elements it contains
  * \param ArrayList *this pointer to arrayList
  * \return int value return (-1) if error [this is NULL pointer or if can't allocate memory]
  *                           (0) if ok
  */
-int resizeUp(ArrayList *this)
+int al_shrinkToFit(ArrayList *this)
 {
     int value = -1;
+    int reservedSize;
     void *pAux = NULL;
 
     if(this != NULL){
-        pAux = realloc(this->pElements, sizeof(void*) * (this->size + AL_INCREMENT));
+        reservedSize = this->size > 0 ? this->size : 1;
+        pAux = realloc(this->pElements, (size_t)slotSize(this) * reservedSize);
 
         if(pAux != NULL){
             this->pElements = pAux;
-            this->reservedSize = (this->size + AL_INCREMENT);
+            this->reservedSize = reservedSize;
+            value = 0;
         }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Sets the factor by which the capacity of this is multiplied every time it is full
+ * \param ArrayList *this pointer to arrayList
+ * \param float growthFactor new growth factor, must be greater than 1
+ * \return int value return (-1) if error [this is NULL pointer or invalid growthFactor]
+ *                           (0) if ok
+ */
+int al_setGrowthFactor(ArrayList *this, float growthFactor)
+{
+    int value = -1;
+
+    if(this != NULL && growthFactor > 1.0f){
+        this->growthFactor = growthFactor;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Sets a function that is called with every element added to this by al_add, al_addArray, al_addReserved,
+ *        al_push or al_set. Clones and sub lists don't inherit it
+ * \param ArrayList *this pointer to arrayList
+ * \param void (*pFunction)(void*, void*) function called with pContext and the added element as al_get returns it,
+ *        (NULL) to remove the hook
+ * \param void *pContext pointer passed as first argument of pFunction
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int al_setAddHook(ArrayList *this, void (*pFunction)(void*, void*), void *pContext)
+{
+    int value = -1;
+
+    if(this != NULL){
+        this->pAddHook = pFunction;
+        this->pHookContext = pContext;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Sets a function that is called with every element that leaves this through al_remove, al_pop, al_clear or
+ *        al_set, before it is removed or replaced. Clones and sub lists don't inherit it
+ * \param ArrayList *this pointer to arrayList
+ * \param void (*pFunction)(void*, void*) function called with pContext and the element as al_get returns it,
+ *        (NULL) to remove the hook
+ * \param void *pContext pointer passed as first argument of pFunction
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int al_setRemoveHook(ArrayList *this, void (*pFunction)(void*, void*), void *pContext)
+{
+    int value = -1;
+
+    if(this != NULL){
+        this->pRemoveHook = pFunction;
+        this->pRemoveHookContext = pContext;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reserves room for count more elements at the end of a typed list and returns the address of the first one,
+ *        so they can be written in place, even from several threads. They are not part of this until al_addReserved
+ * \param ArrayList *this pointer to arrayList
+ * \param int count number of elements
+ * \return void *pAux return (NULL) if error [this is NULL pointer, this is not a typed list, invalid count or if can't
+ *                           allocate memory]
+ *                         - (pointer to the slot after the last element) if ok
+ */
+void *al_reserveTail(ArrayList *this, int count)
+{
+    void *pAux = NULL;
+
+    if(this != NULL && this->elementSize > 0 && count >= 0 && al_reserve(this, this->size + count) == 0)
+        pAux = slotAt(this, this->size);
+
+    return pAux;
+}
+
+/**
+ * \brief Adds to this the first count elements written after the last element in the memory returned by
+ *        al_reserveTail. Nothing else can be added to this in between
+ * \param ArrayList *this pointer to arrayList
+ * \param int count number of elements
+ * \return int value return (-1) if error [this is NULL pointer or invalid count]
+ *                           (0) if ok
+ */
+int al_addReserved(ArrayList *this, int count)
+{
+    int value = -1;
+
+    if(this != NULL && count >= 0 && this->size + count <= this->reservedSize){
+        this->size += count;
+        notifyAdd(this, this->size - count, this->size);
         value = 0;
     }
 
     return value;
 }
 
+/**
+ * \brief Multiply the number of elements reserved in this by its growth factor.
+ * \param ArrayList *this pointer to arrayList
+ * \return int value return (-1) if error [this is NULL pointer or if can't allocate memory]
+ *                           (0) if ok
+ */
+int resizeUp(ArrayList *this)
+{
+    int value = -1;
+    int reservedSize;
+
+    if(this != NULL){
+        reservedSize = (int)(this->reservedSize * this->growthFactor);
+
+        // un factor cercano a 1 no debe impedir que la lista crezca
+        if(reservedSize < this->reservedSize + AL_INITIAL_VALUE)
+            reservedSize = this->reservedSize + AL_INITIAL_VALUE;
+
+        value = al_reserve(this, reservedSize);
+    }
+
+    return value;
+}
+
 /**
  * \brief Expand an array list
  * \param ArrayList *this pointer to arrayList
@@ -493,7 +782,7 @@ int expand(ArrayList *this, int index)
     void *pAux = NULL;
 
     if(this != NULL && (index > 0 && index <= this->reservedSize)){
-        pAux = realloc(this->pElements, sizeof(void*) * (this->size + index));
+        pAux = realloc(this->pElements, (size_t)slotSize(this) * (this->size + index));
 
         if(pAux != NULL){
             this->pElements = pAux;
@@ -522,7 +811,7 @@ int contract(ArrayList *this, int index)
         auxSize = (this->reservedSize - this->size);
 
         if(index <= auxSize)
-            pAux = realloc(this->pElements, sizeof(void*) * index);
+            pAux = realloc(this->pElements, (size_t)slotSize(this) * index);
 
         if(pAux != NULL){
             this->pElements = pAux;
@@ -533,3 +822,196 @@ int contract(ArrayList *this, int index)
 
     return value;
 }
+
+/**
+ * \brief Allocate a new arrayList with AL_INITIAL_VALUE elements.
+ * \param int elementSize size in bytes of the elements stored by value, (0) to store pointers
+ * \return ArrayList *pAux Return (NULL) if error [if can't allocate memory]
+ *                              - (pointer to new arrayList) if ok
+ */
+ArrayList *newArrayList(int elementSize)
+{
+    ArrayList *this = NULL;
+    ArrayList *pAux = NULL;
+    void *pElements = NULL;
+
+    this = (ArrayList*)malloc(sizeof(ArrayList));
+
+    if(this != NULL){
+        pElements = malloc((elementSize > 0 ? (size_t)elementSize : sizeof(void*)) * AL_INITIAL_VALUE);
+
+        if(pElements != NULL){
+            this->size = 0;
+            this->elementSize = elementSize;
+            this->pElements = pElements;
+            this->reservedSize = AL_INITIAL_VALUE;
+            this->growthFactor = AL_GROWTH_FACTOR;
+            this->pAddHook = NULL;
+            this->pHookContext = NULL;
+            this->pRemoveHook = NULL;
+            this->pRemoveHookContext = NULL;
+            this->add = al_add;
+            this->len = al_len;
+            this->set = al_set;
+            this->remove = al_remove;
+            this->clear = al_clear;
+            this->clone = al_clone;
+            this->get = al_get;
+            this->contains = al_contains;
+            this->push = al_push;
+            this->indexOf = al_indexOf;
+            this->isEmpty = al_isEmpty;
+            this->pop = al_pop;
+            this->subList = al_subList;
+            this->containsAll = al_containsAll;
+            this->deleteArrayList = al_deleteArrayList;
+            this->sort = al_sort;
+            this->sortByKey = al_sortByKey;
+            this->reserve = al_reserve;
+            this->shrinkToFit = al_shrinkToFit;
+            this->addArray = al_addArray;
+            pAux = this;
+        }
+        else
+            free(this);
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Size in bytes of every slot of the array
+ * \param ArrayList *this pointer to arrayList
+ * \return int value size of an element in typed lists, size of a pointer in the other lists
+ */
+int slotSize(ArrayList *this)
+{
+    return this->elementSize > 0 ? this->elementSize : (int)sizeof(void*);
+}
+
+/**
+ * \brief Address of the slot at index position
+ * \param ArrayList *this pointer to arrayList
+ * \param int index Index of the slot
+ * \return void *pAux pointer to the slot
+ */
+void *slotAt(ArrayList *this, int index)
+{
+    return (char*)this->pElements + (size_t)slotSize(this) * index;
+}
+
+/**
+ * \brief Store an element in the slot at index position. Typed lists copy the element, the other lists the pointer
+ * \param ArrayList *this pointer to arrayList
+ * \param int index Index of the slot
+ * \param void *pElement pointer to element
+ * \return void
+ */
+void storeAt(ArrayList *this, int index, void *pElement)
+{
+    if(this->elementSize > 0)
+        memcpy(slotAt(this, index), pElement, this->elementSize);
+    else
+        this->pElements[index] = pElement;
+}
+
+/**
+ * \brief Compare the element at index position with pElement. Typed lists compare values, the other lists pointers
+ * \param ArrayList *this pointer to arrayList
+ * \param int index Index of the element
+ * \param void *pElement pointer to element
+ * \return int value return (1) if they are equal
+ *                           (0) if not
+ */
+int equalsAt(ArrayList *this, int index, void *pElement)
+{
+    int value;
+
+    if(this->elementSize > 0)
+        value = pElement != NULL && !memcmp(slotAt(this, index), pElement, this->elementSize);
+    else
+        value = this->pElements[index] == pElement;
+
+    return value;
+}
+
+/**
+ * \brief Compare two slots of the array in the given order
+ * \param ArrayList *this pointer to arrayList
+ * \param pFunction (*pFunction) pointer to function to compare elements of arrayList
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \param void *pFirst pointer to the first slot
+ * \param void *pSecond pointer to the second slot
+ * \return int value (> 0) if the first element must be placed after the second, (<= 0) if not
+ */
+int compareSlots(ArrayList *this, int (*pFunction)(void*, void*), int order, void *pFirst, void *pSecond)
+{
+    if(this->elementSize == 0){
+        pFirst = *(void**)pFirst;
+        pSecond = *(void**)pSecond;
+    }
+
+    return order == 1 ? pFunction(pFirst, pSecond) : pFunction(pSecond, pFirst);
+}
+
+/**
+ * \brief Merge the sorted slots [from, middle) and [middle, to) of pSource into the same positions of pTarget.
+ *        On equal elements the one on the left is placed first, so the merge is stable
+ * \param ArrayList *this pointer to arrayList
+ * \param pFunction (*pFunction) pointer to function to compare elements of arrayList
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \param char *pSource array with the sorted runs
+ * \param char *pTarget array where the merged run is written
+ * \param int from index of the first slot of the left run
+ * \param int middle index of the first slot of the right run
+ * \param int to index after the last slot of the right run
+ * \return void
+ */
+void mergeSlots(ArrayList *this, int (*pFunction)(void*, void*), int order, char *pSource, char *pTarget, int from, int middle, int to)
+{
+    int i = from;
+    int j = middle;
+    int k = from;
+    size_t size = slotSize(this);
+
+    while(i < middle && j < to){
+        if(compareSlots(this, pFunction, order, pSource + size * i, pSource + size * j) <= 0)
+            memcpy(pTarget + size * k++, pSource + size * i++, size);
+        else
+            memcpy(pTarget + size * k++, pSource + size * j++, size);
+    }
+
+    memcpy(pTarget + size * k, pSource + size * i, size * (middle - i));
+    k += middle - i;
+    memcpy(pTarget + size * k, pSource + size * j, size * (to - j));
+}
+
+/**
+ * \brief Call the add hook of this with the elements between from and to
+ * \param ArrayList *this pointer to arrayList
+ * \param int from Index of the first added element
+ * \param int to Index after the last added element
+ * \return void
+ */
+void notifyAdd(ArrayList *this, int from, int to)
+{
+    int i;
+
+    for(i = from; i < to && this->pAddHook != NULL; i++)
+        this->pAddHook(this->pHookContext, al_get(this, i));
+}
+
+/**
+ * \brief Call the remove hook of this with the elements between from and to
+ * \param ArrayList *this pointer to arrayList
+ * \param int from Index of the first removed element
+ * \param int to Index after the last removed element
+ * \return void
+ */
+void notifyRemove(ArrayList *this, int from, int to)
+{
+    int i;
+
+    for(i = from; i < to && this->pRemoveHook != NULL; i++)
+        this->pRemoveHook(this->pRemoveHookContext, al_get(this, i));
+}
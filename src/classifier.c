@@ -0,0 +1,226 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/classifier.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CL_SIMD
+#include <immintrin.h>
+#endif
+
+int classifierSet = CL_SCALAR;
+void (*pClassify)(float*, int*, int, float, float, int, unsigned char*) = NULL;
+pthread_once_t classifierOnce = PTHREAD_ONCE_INIT;
+
+// private functions
+void selectClassify(void);
+void classifyScalar(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+#ifdef CL_SIMD
+void classifySse2(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+void classifyAvx2(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+#endif
+
+/**
+ * \brief Classify a block of readings with the rules of the event types, in order: boot by temperature if the
+ *        temperature is over the boot threshold and the humidity is not under its threshold, stop by temperature
+ *        if the temperature is under the stop threshold, boot by humidity if the humidity is over its threshold
+ *        and stop by humidity if not. AVX2 or SSE2 are used when the processor has them
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \param unsigned char *pTypes pointer where the CL_ code of each reading is written
+ * \return int value return (-1) if error [NULL pointer or invalid count]
+ *                           (0) if ok
+ */
+int cl_classify(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes)
+{
+    int value = -1;
+
+    if(pTemperatures != NULL && pHumidities != NULL && pTypes != NULL && count >= 0){
+        pthread_once(&classifierOnce, selectClassify);
+        pClassify(pTemperatures, pHumidities, count, engineOn, engineOff, humidityThreshold, pTypes);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the instruction set used by the classification
+ * \param -
+ * \return int value [CL_SCALAR] [CL_SSE2] [CL_AVX2]
+ */
+int cl_getInstructionSet(void)
+{
+    pthread_once(&classifierOnce, selectClassify);
+
+    return classifierSet;
+}
+
+/**
+ * \brief Choose the widest instruction set the processor has. It runs once
+ * \param -
+ * \return void
+ */
+void selectClassify(void)
+{
+    pClassify = classifyScalar;
+    classifierSet = CL_SCALAR;
+
+#ifdef CL_SIMD
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2")){
+        pClassify = classifyAvx2;
+        classifierSet = CL_AVX2;
+    }
+    else if(__builtin_cpu_supports("sse2")){
+        pClassify = classifySse2;
+        classifierSet = CL_SSE2;
+    }
+#endif
+}
+
+/**
+ * \brief Classify a block of readings one at a time. The vector versions use it for the last readings
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \param unsigned char *pTypes pointer where the CL_ code of each reading is written
+ * \return void
+ */
+void classifyScalar(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes)
+{
+    int i;
+
+    for(i = 0; i < count; i++){
+        if(pTemperatures[i] > engineOn && pHumidities[i] >= humidityThreshold)
+            pTypes[i] = CL_BOOT_BY_TEMPERATURE;
+        else if(pTemperatures[i] < engineOff)
+            pTypes[i] = CL_STOP_BY_TEMPERATURE;
+        else if(pHumidities[i] > humidityThreshold)
+            pTypes[i] = CL_BOOT_BY_HUMIDITY;
+        else
+            pTypes[i] = CL_STOP_BY_HUMIDITY;
+    }
+}
+
+#ifdef CL_SIMD
+/**
+ * \brief Classify a block of readings with SSE2, 8 at a time. The comparisons of floats are ordered like the
+ *        ones of C, so a NaN temperature is never over or under a threshold
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \param unsigned char *pTypes pointer where the CL_ code of each reading is written
+ * \return void
+ */
+__attribute__((target("sse2")))
+void classifySse2(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes)
+{
+    int i;
+    int j;
+    __m128 on = _mm_set1_ps(engineOn);
+    __m128 off = _mm_set1_ps(engineOff);
+    __m128i threshold = _mm_set1_epi32(humidityThreshold);
+    __m128i stopByHumidity = _mm_set1_epi32(CL_STOP_BY_HUMIDITY);
+    __m128i stopByTemperature = _mm_set1_epi32(CL_STOP_BY_TEMPERATURE);
+    __m128i codes[2];
+    __m128i humidity;
+    __m128i boot;
+    __m128i stop;
+    __m128 temperature;
+
+    for(i = 0; i + 8 <= count; i += 8){
+        for(j = 0; j < 2; j++){
+            temperature = _mm_loadu_ps(pTemperatures + i + 4 * j);
+            humidity = _mm_loadu_si128((__m128i*)(pHumidities + i + 4 * j));
+
+            // las mascaras valen -1 donde se cumple la regla, se aplican de la ultima a la primera
+            codes[j] = _mm_add_epi32(stopByHumidity, _mm_cmpgt_epi32(humidity, threshold));
+            stop = _mm_castps_si128(_mm_cmplt_ps(temperature, off));
+            codes[j] = _mm_or_si128(_mm_andnot_si128(stop, codes[j]), _mm_and_si128(stop, stopByTemperature));
+            boot = _mm_andnot_si128(_mm_cmpgt_epi32(threshold, humidity), _mm_castps_si128(_mm_cmpgt_ps(temperature, on)));
+            codes[j] = _mm_andnot_si128(boot, codes[j]);
+        }
+
+        codes[0] = _mm_packs_epi32(codes[0], codes[1]);
+        _mm_storel_epi64((__m128i*)(pTypes + i), _mm_packus_epi16(codes[0], codes[0]));
+    }
+
+    classifyScalar(pTemperatures + i, pHumidities + i, count - i, engineOn, engineOff, humidityThreshold, pTypes + i);
+}
+
+/**
+ * \brief Classify a block of readings with AVX2, 16 at a time. The comparisons of floats are ordered like the
+ *        ones of C, so a NaN temperature is never over or under a threshold
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \param unsigned char *pTypes pointer where the CL_ code of each reading is written
+ * \return void
+ */
+__attribute__((target("avx2")))
+void classifyAvx2(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes)
+{
+    int i;
+    int j;
+    __m256 on = _mm256_set1_ps(engineOn);
+    __m256 off = _mm256_set1_ps(engineOff);
+    __m256i threshold = _mm256_set1_epi32(humidityThreshold);
+    __m256i stopByHumidity = _mm256_set1_epi32(CL_STOP_BY_HUMIDITY);
+    __m256i stopByTemperature = _mm256_set1_epi32(CL_STOP_BY_TEMPERATURE);
+    __m256i codes[2];
+    __m256i humidity;
+    __m256i boot;
+    __m256i stop;
+    __m256 temperature;
+    __m128i packed;
+
+    for(i = 0; i + 16 <= count; i += 16){
+        for(j = 0; j < 2; j++){
+            temperature = _mm256_loadu_ps(pTemperatures + i + 8 * j);
+            humidity = _mm256_loadu_si256((__m256i*)(pHumidities + i + 8 * j));
+
+            // las mascaras valen -1 donde se cumple la regla, se aplican de la ultima a la primera
+            codes[j] = _mm256_add_epi32(stopByHumidity, _mm256_cmpgt_epi32(humidity, threshold));
+            stop = _mm256_castps_si256(_mm256_cmp_ps(temperature, off, _CMP_LT_OQ));
+            codes[j] = _mm256_blendv_epi8(codes[j], stopByTemperature, stop);
+            boot = _mm256_andnot_si256(_mm256_cmpgt_epi32(threshold, humidity), _mm256_castps_si256(_mm256_cmp_ps(temperature, on, _CMP_GT_OQ)));
+            codes[j] = _mm256_andnot_si256(boot, codes[j]);
+        }
+
+        // el empaquetado de AVX2 mezcla las mitades, se ordenan antes de guardar los 16 codigos
+        codes[0] = _mm256_packs_epi32(codes[0], codes[1]);
+        codes[0] = _mm256_permute4x64_epi64(codes[0], 0xD8);
+        packed = _mm_packus_epi16(_mm256_castsi256_si128(codes[0]), _mm256_extracti128_si256(codes[0], 1));
+        _mm_storeu_si128((__m128i*)(pTypes + i), packed);
+    }
+
+    classifyScalar(pTemperatures + i, pHumidities + i, count - i, engineOn, engineOff, humidityThreshold, pTypes + i);
+}
+#endif
@@ -0,0 +1,368 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+#include "../inc/columnstore.h"
+
+/**
+ * \brief Allocate an empty store of events kept by columns: one contiguous array for every field, so a scan over a
+ *        field only reads that field
+ * \param -
+ * \return ColumnStore *pAux Return (NULL) if error [if can't allocate memory]
+ *                                - (pointer to new column store) if ok
+ */
+ColumnStore *cs_newColumnStore(void)
+{
+    ColumnStore *this = NULL;
+    ColumnStore *pAux = NULL;
+
+    this = (ColumnStore*)malloc(sizeof(ColumnStore));
+
+    if(this != NULL){
+        memset(this, 0, sizeof(ColumnStore));
+
+        if(cs_reserve(this, CS_INITIAL_SIZE) == 0)
+            pAux = this;
+        else
+            cs_deleteColumnStore(this);
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Get the number of events of the store
+ * \param ColumnStore *this pointer to column store
+ * \return int value return number of events or (-1) if error [this is NULL pointer]
+ */
+int cs_len(ColumnStore *this)
+{
+    int value = -1;
+
+    if(this != NULL)
+        value = this->size;
+
+    return value;
+}
+
+/**
+ * \brief Make room for reservedSize events in every column, the events already stored are kept. It does nothing if
+ *        there is already room
+ * \param ColumnStore *this pointer to column store
+ * \param int reservedSize number of events
+ * \return int value return (-1) if error [this is NULL pointer, invalid reservedSize or if can't allocate memory]
+ *                           (0) if ok
+ */
+int cs_reserve(ColumnStore *this, int reservedSize)
+{
+    int value = -1;
+    void *pAux = NULL;
+
+    if(this != NULL && reservedSize >= 0){
+        value = 0;
+
+        // cada columna se agranda por separado, las que ya crecieron conservan el tamanio nuevo
+        if(reservedSize > this->reservedSize){
+            if((pAux = realloc(this->pTimestamps, sizeof(long long) * reservedSize)) != NULL)
+                this->pTimestamps = (long long*)pAux;
+
+            if(pAux != NULL && (pAux = realloc(this->pEventTypes, sizeof(unsigned char) * reservedSize)) != NULL)
+                this->pEventTypes = (unsigned char*)pAux;
+
+            if(pAux != NULL && (pAux = realloc(this->pTemperatures, sizeof(int) * reservedSize)) != NULL)
+                this->pTemperatures = (int*)pAux;
+
+            if(pAux != NULL && (pAux = realloc(this->pHumidities, sizeof(int) * reservedSize)) != NULL)
+                this->pHumidities = (int*)pAux;
+
+            if(pAux != NULL && (pAux = realloc(this->pEmployees, sizeof(int) * reservedSize)) != NULL)
+                this->pEmployees = (int*)pAux;
+
+            if(pAux != NULL)
+                this->reservedSize = reservedSize;
+            else
+                value = -1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append an event at the end of the store, making room in the columns when they are full
+ * \param ColumnStore *this pointer to column store
+ * \param long long timestamp time of the event in seconds since the epoch
+ * \param int eventType type of the event, from 0 to 255
+ * \param int temperature temperature read in hundredths of a degree
+ * \param int humidity humidity read
+ * \param int employee id of the operator
+ * \return int value return (-1) if error [this is NULL pointer or if can't allocate memory]
+ *                           (0) if ok
+ */
+int cs_add(ColumnStore *this, long long timestamp, int eventType, int temperature, int humidity, int employee)
+{
+    int value = -1;
+
+    if(this != NULL && (this->size < this->reservedSize || cs_reserve(this, this->reservedSize > 0 ? this->reservedSize * 2 : CS_INITIAL_SIZE) == 0)){
+        this->size++;
+        value = cs_set(this, this->size - 1, timestamp, eventType, temperature, humidity, employee);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Write an event at a position of the reserved room of the store, without changing the number of events. Several
+ *        threads can write different positions at once, the events are made part of the store with cs_resize
+ * \param ColumnStore *this pointer to column store
+ * \param int index position of the event, less than the reserved size
+ * \param long long timestamp time of the event in seconds since the epoch
+ * \param int eventType type of the event, from 0 to 255
+ * \param int temperature temperature read in hundredths of a degree
+ * \param int humidity humidity read
+ * \param int employee id of the operator
+ * \return int value return (-1) if error [this is NULL pointer or invalid index]
+ *                           (0) if ok
+ */
+int cs_set(ColumnStore *this, int index, long long timestamp, int eventType, int temperature, int humidity, int employee)
+{
+    int value = -1;
+
+    if(this != NULL && index >= 0 && index < this->reservedSize){
+        this->pTimestamps[index] = timestamp;
+        this->pEventTypes[index] = (unsigned char)eventType;
+        this->pTemperatures[index] = temperature;
+        this->pHumidities[index] = humidity;
+        this->pEmployees[index] = employee;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Set the number of events of the store. It drops the events from size on, or adds the ones written with cs_set
+ *        up to size
+ * \param ColumnStore *this pointer to column store
+ * \param int size number of events, not greater than the reserved size
+ * \return int value return (-1) if error [this is NULL pointer or invalid size]
+ *                           (0) if ok
+ */
+int cs_resize(ColumnStore *this, int size)
+{
+    int value = -1;
+
+    if(this != NULL && size >= 0 && size <= this->reservedSize){
+        this->size = size;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Remove every event of the store and release the memory of the columns
+ * \param ColumnStore *this pointer to column store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int cs_clear(ColumnStore *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        free(this->pTimestamps);
+        free(this->pEventTypes);
+        free(this->pTemperatures);
+        free(this->pHumidities);
+        free(this->pEmployees);
+        memset(this, 0, sizeof(ColumnStore));
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Find the first event at or after a time. The events are expected in chronological order, it is a binary
+ *        search over the timestamps column
+ * \param ColumnStore *this pointer to column store
+ * \param long long timestamp time in seconds since the epoch
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (index of the first event with timestamp greater or equal, the number of events if there is
+ *                          none) if ok
+ */
+int cs_find(ColumnStore *this, long long timestamp)
+{
+    int middle;
+    int last;
+    int value = -1;
+
+    if(this != NULL){
+        value = 0;
+        last = this->size;
+
+        while(value < last){
+            middle = value + (last - value) / 2;
+
+            if(this->pTimestamps[middle] < timestamp)
+                value = middle + 1;
+            else
+                last = middle;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Add the temperatures of count events from first on, leaving out the events of a type. The column is read in
+ *        blocks of CS_SCAN_BLOCK events, whose loop the compiler turns into vector instructions
+ * \param ColumnStore *this pointer to column store
+ * \param int first index of the first event
+ * \param int count number of events
+ * \param int excludedType type of the events left out, (-1) to add all
+ * \param long long *pSum pointer where the sum in hundredths of a degree is written
+ * \return int value return (-1) if error [this or pSum are NULL pointer or invalid range]
+ *                          (number of temperatures added) if ok
+ */
+int cs_sumTemperatures(ColumnStore *this, int first, int count, int excludedType, long long *pSum)
+{
+    int i;
+    int j;
+    int included;
+    int value = -1;
+    long long sum = 0;
+    long long blockSum;
+
+    if(this != NULL && pSum != NULL && first >= 0 && count >= 0 && first + count <= this->size){
+        value = 0;
+
+        // un bloque de largo fijo no necesita resto, asi -O2 ya lo vectoriza
+        for(i = first; i + CS_SCAN_BLOCK <= first + count; i += CS_SCAN_BLOCK){
+            blockSum = 0;
+            included = 0;
+
+            for(j = 0; j < CS_SCAN_BLOCK; j++){
+                // sin saltos: la temperatura se multiplica por 0 o 1
+                blockSum += this->pTemperatures[i + j] * (this->pEventTypes[i + j] != excludedType);
+                included += this->pEventTypes[i + j] != excludedType;
+            }
+
+            sum += blockSum;
+            value += included;
+        }
+
+        for(; i < first + count; i++){
+            if(this->pEventTypes[i] != excludedType){
+                sum += this->pTemperatures[i];
+                value++;
+            }
+        }
+
+        *pSum = sum;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Count the events from first on whose humidity is greater than a threshold, leaving out the events of a type.
+ *        The column is read in blocks of CS_SCAN_BLOCK events, whose loop the compiler turns into vector instructions
+ * \param ColumnStore *this pointer to column store
+ * \param int first index of the first event
+ * \param int count number of events
+ * \param int excludedType type of the events left out, (-1) to count all
+ * \param int threshold humidity threshold
+ * \return int value return (-1) if error [this is NULL pointer or invalid range]
+ *                          (number of events over the threshold) if ok
+ */
+int cs_countHumidityAbove(ColumnStore *this, int first, int count, int excludedType, int threshold)
+{
+    int i;
+    int j;
+    int blockCount;
+    int value = -1;
+
+    if(this != NULL && first >= 0 && count >= 0 && first + count <= this->size){
+        value = 0;
+
+        for(i = first; i + CS_SCAN_BLOCK <= first + count; i += CS_SCAN_BLOCK){
+            blockCount = 0;
+
+            for(j = 0; j < CS_SCAN_BLOCK; j++)
+                blockCount += (this->pHumidities[i + j] > threshold) & (this->pEventTypes[i + j] != excludedType);
+
+            value += blockCount;
+        }
+
+        for(; i < first + count; i++)
+            value += this->pHumidities[i] > threshold && this->pEventTypes[i] != excludedType;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Count the events of a type from first on
+ * \param ColumnStore *this pointer to column store
+ * \param int first index of the first event
+ * \param int count number of events
+ * \param int eventType type of the events counted
+ * \return int value return (-1) if error [this is NULL pointer or invalid range]
+ *                          (number of events of the type) if ok
+ */
+int cs_countType(ColumnStore *this, int first, int count, int eventType)
+{
+    int i;
+    int j;
+    int blockCount;
+    int value = -1;
+
+    if(this != NULL && first >= 0 && count >= 0 && first + count <= this->size){
+        value = 0;
+
+        for(i = first; i + CS_SCAN_BLOCK <= first + count; i += CS_SCAN_BLOCK){
+            blockCount = 0;
+
+            for(j = 0; j < CS_SCAN_BLOCK; j++)
+                blockCount += this->pEventTypes[i + j] == eventType;
+
+            value += blockCount;
+        }
+
+        for(; i < first + count; i++)
+            value += this->pEventTypes[i] == eventType;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Release the column store
+ * \param ColumnStore *this pointer to column store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int cs_deleteColumnStore(ColumnStore *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        cs_clear(this);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
@@ -0,0 +1,202 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/configwatch.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+// private functions
+void *watchFile(void *pArgument);
+void closeWatchFds(ConfigWatch *this);
+
+/**
+ * \brief Starts a thread that watches a file and calls pFunction(pContext) from that thread every time the file is
+ *        written and closed or replaced by another one, as editors that save to a temporary file do. Changes that
+ *        arrive less than CW_SETTLE_MS apart are reported once. The directory of the file is watched, so the file
+ *        can be deleted and created again
+ * \param char *path path of the watched file
+ * \param void (*pFunction)(void*) function called after every change
+ * \param void *pContext pointer given to pFunction
+ * \return ConfigWatch *pAux Return (NULL) if error [path or pFunction are NULL pointer, path too long, the system
+ *                                 can't watch files, can't allocate memory or can't start the thread]
+ *                               - (pointer to new config watch) if ok
+ */
+ConfigWatch *cw_newConfigWatch(char *path, void (*pFunction)(void*), void *pContext)
+{
+    char *pSlash = NULL;
+    ConfigWatch *this = NULL;
+    ConfigWatch *pAux = NULL;
+
+    if(path != NULL && pFunction != NULL && strlen(path) < CW_MAX_PATH)
+        this = (ConfigWatch*)calloc(1, sizeof(ConfigWatch));
+
+    if(this != NULL){
+        this->notifyFd = -1;
+        this->stopFds[0] = -1;
+        this->stopFds[1] = -1;
+        this->pFunction = pFunction;
+        this->pContext = pContext;
+
+        // se vigila el directorio, los editores suelen reemplazar el archivo en lugar de escribirlo
+        pSlash = strrchr(path, '/');
+
+        if(pSlash == NULL){
+            strcpy(this->directory, ".");
+            strcpy(this->fileName, path);
+        }
+        else{
+            memcpy(this->directory, path, pSlash == path ? 1 : pSlash - path);
+            strcpy(this->fileName, pSlash + 1);
+        }
+
+        this->notifyFd = inotify_init1(IN_CLOEXEC);
+
+        if(this->fileName[0] != '\0' && this->notifyFd >= 0 && pipe(this->stopFds) == 0 &&
+           inotify_add_watch(this->notifyFd, this->directory, IN_CLOSE_WRITE | IN_MOVED_TO) >= 0 &&
+           pthread_create(&this->thread, NULL, watchFile, this) == 0)
+            pAux = this;
+        else{
+            closeWatchFds(this);
+            free(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Stops the thread of the watch, waiting for a call to pFunction in progress, and frees it
+ * \param ConfigWatch *this pointer to config watch
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int cw_deleteConfigWatch(ConfigWatch *this)
+{
+    int value = -1;
+    char stop = 0;
+
+    if(this != NULL){
+        // cualquier byte en la tuberia despierta al hilo y lo termina
+        while(write(this->stopFds[1], &stop, 1) < 0 && errno == EINTR);
+
+        pthread_join(this->thread, NULL);
+        closeWatchFds(this);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+// private functions
+
+/**
+ * \brief Thread of a config watch. Waits for events of the directory and, once the file changed and no more events
+ *        arrived for CW_SETTLE_MS, calls the function of the watch. Runs until something is written to the stop pipe
+ * \param void *pArgument pointer to the ConfigWatch
+ * \return void *NULL
+ */
+void *watchFile(void *pArgument)
+{
+    int result;
+    int offset;
+    int length;
+    int changed = 0;
+    ConfigWatch *this = (ConfigWatch*)pArgument;
+    struct pollfd fds[2];
+    struct inotify_event *pEvent = NULL;
+    char buffer[CW_EVENT_BUFFER] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    fds[0].fd = this->notifyFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = this->stopFds[0];
+    fds[1].events = POLLIN;
+
+    while(1){
+        // con un cambio pendiente se espera a que el archivo deje de cambiar
+        result = poll(fds, 2, changed ? CW_SETTLE_MS : -1);
+
+        if(result < 0 && errno == EINTR)
+            continue;
+
+        if(result < 0 || fds[1].revents != 0)
+            break;
+
+        if(result == 0){
+            changed = 0;
+            this->pFunction(this->pContext);
+            continue;
+        }
+
+        length = read(this->notifyFd, buffer, sizeof(buffer));
+
+        for(offset = 0; offset < length; offset += sizeof(struct inotify_event) + pEvent->len){
+            pEvent = (struct inotify_event*)(buffer + offset);
+
+            if(pEvent->len > 0 && !strcmp(pEvent->name, this->fileName))
+                changed = 1;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Closes the descriptors of a config watch that are open
+ * \param ConfigWatch *this pointer to config watch
+ * \return void
+ */
+void closeWatchFds(ConfigWatch *this)
+{
+    if(this->notifyFd >= 0)
+        close(this->notifyFd);
+
+    if(this->stopFds[0] >= 0)
+        close(this->stopFds[0]);
+
+    if(this->stopFds[1] >= 0)
+        close(this->stopFds[1]);
+}
+
+#else
+
+/**
+ * \brief Starts a thread that watches a file. Not available on Windows, the configuration is only read again from
+ *        the menu
+ * \param char *path path of the watched file
+ * \param void (*pFunction)(void*) function called after every change
+ * \param void *pContext pointer given to pFunction
+ * \return ConfigWatch *pAux (NULL)
+ */
+ConfigWatch *cw_newConfigWatch(char *path, void (*pFunction)(void*), void *pContext)
+{
+    return NULL;
+}
+
+/**
+ * \brief Stops the thread of the watch and frees it. Not available on Windows
+ * \param ConfigWatch *this pointer to config watch
+ * \return int value (-1)
+ */
+int cw_deleteConfigWatch(ConfigWatch *this)
+{
+    return -1;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/crc32c.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC_HARDWARE
+#include <nmmintrin.h>
+#endif
+
+unsigned int crcTable[8][256];
+unsigned int (*pCrcUpdate)(unsigned int, unsigned char*, int) = NULL;
+pthread_once_t crcOnce = PTHREAD_ONCE_INIT;
+
+// private functions
+void selectCrcUpdate(void);
+unsigned int updateWithTable(unsigned int crc, unsigned char *pData, int length);
+#ifdef CRC_HARDWARE
+unsigned int updateWithInstruction(unsigned int crc, unsigned char *pData, int length);
+#endif
+
+/**
+ * \brief Continue a CRC32C over a block of bytes, without the initial value and the final xor. The SSE4.2 crc32
+ *        instruction is used when the processor has it, a table of 8 x 256 entries when not
+ * \param unsigned int crc value of the CRC over the previous bytes
+ * \param void *pData pointer to the bytes
+ * \param int length number of bytes
+ * \return unsigned int value the CRC over the previous bytes and the block
+ */
+unsigned int crc_update(unsigned int crc, void *pData, int length)
+{
+    pthread_once(&crcOnce, selectCrcUpdate);
+
+    return pData != NULL && length > 0 ? pCrcUpdate(crc, (unsigned char*)pData, length) : crc;
+}
+
+/**
+ * \brief Calculate the CRC32C of a block of bytes
+ * \param void *pData pointer to the bytes
+ * \param int length number of bytes
+ * \return unsigned int value the CRC32C of the block
+ */
+unsigned int crc_checksum(void *pData, int length)
+{
+    return crc_update(CRC_INITIAL, pData, length) ^ CRC_INITIAL;
+}
+
+/**
+ * \brief Check if the CRC is calculated with the instruction of the processor
+ * \param -
+ * \return int value 1 if the SSE4.2 crc32 instruction is used - 0 if the table is used
+ */
+int crc_isHardware(void)
+{
+    pthread_once(&crcOnce, selectCrcUpdate);
+
+    return pCrcUpdate != updateWithTable;
+}
+
+/**
+ * \brief Build the table and choose the instruction of the processor if it has SSE4.2. It runs once
+ * \param -
+ * \return void
+ */
+void selectCrcUpdate(void)
+{
+    int i;
+    int j;
+    unsigned int crc;
+
+    for(i = 0; i < 256; i++){
+        crc = i;
+
+        for(j = 0; j < 8; j++)
+            crc = crc & 1 ? (crc >> 1) ^ CRC_POLYNOMIAL : crc >> 1;
+
+        crcTable[0][i] = crc;
+    }
+
+    // cada tabla avanza un byte mas, para procesar 8 bytes por vuelta
+    for(i = 0; i < 256; i++){
+        for(j = 1; j < 8; j++)
+            crcTable[j][i] = (crcTable[j - 1][i] >> 8) ^ crcTable[0][crcTable[j - 1][i] & 0xFF];
+    }
+
+    pCrcUpdate = updateWithTable;
+
+#ifdef CRC_HARDWARE
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("sse4.2"))
+        pCrcUpdate = updateWithInstruction;
+#endif
+}
+
+/**
+ * \brief Continue a CRC32C with the tables, 8 bytes at a time
+ * \param unsigned int crc value of the CRC over the previous bytes
+ * \param unsigned char *pData pointer to the bytes
+ * \param int length number of bytes
+ * \return unsigned int value the CRC over the previous bytes and the block
+ */
+unsigned int updateWithTable(unsigned int crc, unsigned char *pData, int length)
+{
+    while(length >= 8){
+        crc ^= pData[0] | pData[1] << 8 | pData[2] << 16 | (unsigned int)pData[3] << 24;
+        crc = crcTable[7][crc & 0xFF] ^ crcTable[6][(crc >> 8) & 0xFF] ^ crcTable[5][(crc >> 16) & 0xFF] ^ crcTable[4][crc >> 24] ^
+              crcTable[3][pData[4]] ^ crcTable[2][pData[5]] ^ crcTable[1][pData[6]] ^ crcTable[0][pData[7]];
+        pData += 8;
+        length -= 8;
+    }
+
+    while(length-- > 0)
+        crc = crcTable[0][(crc ^ *pData++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+#ifdef CRC_HARDWARE
+/**
+ * \brief Continue a CRC32C with the SSE4.2 crc32 instruction, 8 bytes at a time on 64 bit processors
+ * \param unsigned int crc value of the CRC over the previous bytes
+ * \param unsigned char *pData pointer to the bytes
+ * \param int length number of bytes
+ * \return unsigned int value the CRC over the previous bytes and the block
+ */
+__attribute__((target("sse4.2")))
+unsigned int updateWithInstruction(unsigned int crc, unsigned char *pData, int length)
+{
+    unsigned int word;
+#ifdef __x86_64__
+    unsigned long long value = crc;
+    unsigned long long wide;
+
+    while(length >= 8){
+        memcpy(&wide, pData, 8);
+        value = _mm_crc32_u64(value, wide);
+        pData += 8;
+        length -= 8;
+    }
+
+    crc = (unsigned int)value;
+#endif
+
+    while(length >= 4){
+        memcpy(&word, pData, 4);
+        crc = _mm_crc32_u32(crc, word);
+        pData += 4;
+        length -= 4;
+    }
+
+    while(length-- > 0)
+        crc = _mm_crc32_u8(crc, *pData++);
+
+    return crc;
+}
+#endif
@@ -0,0 +1,395 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/eventlog.h"
+
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define fileSync(fd) _commit(fd)
+#define fileDataSync(fd) _commit(fd)
+#define fileNumber(file) _fileno(file)
+#else
+#include <unistd.h>
+#define fileSync(fd) fsync(fd)
+#define fileNumber(file) fileno(file)
+#ifdef __APPLE__
+#define fileDataSync(fd) fsync(fd)
+#else
+#define fileDataSync(fd) fdatasync(fd)
+#endif
+#endif
+
+// private functions
+int applyPolicy(EventLog *this, int count);
+int commitPending(EventLog *this);
+int stopCommitter(EventLog *this);
+void *commitGroups(void *pArgument);
+
+/**
+ * \brief Open an append-only log of fixed size records. If the file does not exist or is empty it is created
+ *        and pHeader is written at the beginning. The count of the log starts with the records already stored
+ * \param char *fileName path of the log file
+ * \param void *pHeader pointer to the header of the file, (NULL) if the file has no header
+ * \param int headerSize size in bytes of the header
+ * \param int recordSize size in bytes of every record
+ * \param int syncPolicy [EL_SYNC_NONE] records stay in the stdio buffer until el_sync or close
+ *                       [EL_SYNC_FLUSH] every record is handed to the operating system
+ *                       [EL_SYNC_FULL] every record is forced to the storage device
+ *                       [EL_SYNC_GROUP] records are forced to the storage device in groups, see el_setSyncPolicy
+ * \return EventLog *pAux Return (NULL) if error [invalid parameters or can't open the file]
+ *                             - (pointer to new event log) if ok
+ */
+EventLog *el_newEventLog(char *fileName, void *pHeader, int headerSize, int recordSize, int syncPolicy)
+{
+    EventLog *this = NULL;
+    EventLog *pAux = NULL;
+    FILE *file = NULL;
+
+    if(fileName != NULL && headerSize >= 0 && recordSize > 0 && syncPolicy >= EL_SYNC_NONE && syncPolicy <= EL_SYNC_GROUP){
+        this = (EventLog*)malloc(sizeof(EventLog));
+
+        if(this != NULL){
+            file = fopen(fileName, "ab");
+
+            if(file != NULL && fseek(file, 0, SEEK_END) == 0 && ftell(file) == 0 && pHeader != NULL && headerSize > 0){
+                if(fwrite(pHeader, headerSize, 1, file) != 1 || fflush(file) != 0){
+                    fclose(file);
+                    file = NULL;
+                }
+            }
+
+            if(file != NULL){
+                this->file = file;
+                this->recordSize = recordSize;
+                this->syncPolicy = EL_SYNC_NONE;
+                this->count = (ftell(file) - headerSize) / recordSize;
+                this->pending = 0;
+                this->error = 0;
+                this->running = 0;
+                pthread_mutex_init(&this->mutex, NULL);
+                pthread_cond_init(&this->condition, NULL);
+                pAux = this;
+
+                if(el_setSyncPolicy(this, syncPolicy, EL_GROUP_SIZE, EL_GROUP_INTERVAL) != 0){
+                    el_deleteEventLog(this);
+                    pAux = NULL;
+                }
+            }
+            else
+                free(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Change the sync policy of an open log. Records pending of the previous policy are forced to the storage
+ *        device first. With EL_SYNC_GROUP a background thread forces the records to the storage device with a
+ *        single sync when groupSize records are pending or groupInterval milliseconds after the first of them was
+ *        appended, whatever happens first, so at most that window of records can be lost
+ * \param EventLog *this pointer to event log
+ * \param int syncPolicy EL_SYNC_NONE, EL_SYNC_FLUSH, EL_SYNC_FULL or EL_SYNC_GROUP
+ * \param int groupSize maximum number of records of a group, only used by EL_SYNC_GROUP
+ * \param int groupInterval maximum time in milliseconds a record waits for its group, only used by EL_SYNC_GROUP
+ * \return int value return (-1) if error [this is NULL pointer, invalid parameters or can't start the thread]
+ *                           (0) if ok
+ */
+int el_setSyncPolicy(EventLog *this, int syncPolicy, int groupSize, int groupInterval)
+{
+    int value = -1;
+
+    if(this != NULL && syncPolicy >= EL_SYNC_NONE && syncPolicy <= EL_SYNC_GROUP && groupSize > 0 && groupInterval > 0){
+        pthread_mutex_lock(&this->mutex);
+        value = 0;
+
+        if(this->running && syncPolicy != EL_SYNC_GROUP)
+            stopCommitter(this);
+
+        if(this->pending > 0 && commitPending(this) != 0)
+            value = -1;
+
+        this->syncPolicy = syncPolicy;
+        this->groupSize = groupSize;
+        this->groupInterval = groupInterval;
+
+        if(syncPolicy == EL_SYNC_GROUP && !this->running){
+            this->running = 1;
+
+            if(pthread_create(&this->committer, NULL, commitGroups, this) != 0){
+                this->running = 0;
+                this->syncPolicy = EL_SYNC_FLUSH;
+                value = -1;
+            }
+        }
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append one record to the end of the log, honoring the sync policy. It can be called from several threads
+ * \param EventLog *this pointer to event log
+ * \param void *pRecord pointer to the record to write
+ * \return int value return (-1) if error [this or pRecord are NULL pointer, write failed or the last group
+ *                           commit failed]
+ *                           (0) if ok
+ */
+int el_append(EventLog *this, void *pRecord)
+{
+    int value = -1;
+
+    if(this != NULL && pRecord != NULL){
+        pthread_mutex_lock(&this->mutex);
+
+        if(fwrite(pRecord, this->recordSize, 1, this->file) == 1)
+            value = applyPolicy(this, 1);
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append count consecutive records to the end of the log with a single write, honoring the sync policy once
+ * \param EventLog *this pointer to event log
+ * \param void *pRecords pointer to the first record
+ * \param int count number of records
+ * \return int value return (-1) if error [this or pRecords are NULL pointer, invalid count, write failed or the
+ *                           last group commit failed]
+ *                           (0) if ok
+ */
+int el_appendArray(EventLog *this, void *pRecords, int count)
+{
+    int value = -1;
+    int written;
+
+    if(this != NULL && pRecords != NULL && count >= 0){
+        pthread_mutex_lock(&this->mutex);
+        written = fwrite(pRecords, this->recordSize, count, this->file);
+
+        if(applyPolicy(this, written) == 0 && written == count)
+            value = 0;
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Hand every pending record to the operating system, without forcing it to the storage device, so the
+ *        file can be read
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [this is NULL pointer or flush failed]
+ *                           (0) if ok
+ */
+int el_flush(EventLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+
+        if(fflush(this->file) == 0)
+            value = 0;
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Flush every pending record to the operating system and force it to the storage device
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [this is NULL pointer or sync failed]
+ *                           (0) if ok
+ */
+int el_sync(EventLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+
+        if(fflush(this->file) == 0){
+            this->pending = 0;
+            value = 0;
+        }
+
+        pthread_mutex_unlock(&this->mutex);
+
+        if(value == 0 && fileSync(fileNumber(this->file)) != 0)
+            value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Flush pending records, close the file and release the event log. With EL_SYNC_GROUP the last group is
+ *        forced to the storage device
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int el_deleteEventLog(EventLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+
+        if(this->running)
+            stopCommitter(this);
+
+        if(this->syncPolicy == EL_SYNC_GROUP && this->pending > 0)
+            commitPending(this);
+
+        pthread_mutex_unlock(&this->mutex);
+
+        fclose(this->file);
+        pthread_mutex_destroy(&this->mutex);
+        pthread_cond_destroy(&this->condition);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Count the records just written and apply the sync policy. The mutex must be locked
+ * \param EventLog *this pointer to event log
+ * \param int count number of records written
+ * \return int value return (-1) if error [flush or sync failed, or the last group commit failed]
+ *                           (0) if ok
+ */
+int applyPolicy(EventLog *this, int count)
+{
+    int value = 0;
+
+    this->count += count;
+
+    if(this->error){
+        this->error = 0;
+        value = -1;
+    }
+
+    if(count > 0){
+        // el primer registro pendiente fija el limite de espera de su grupo
+        if(this->pending == 0){
+            clock_gettime(CLOCK_REALTIME, &this->deadline);
+            this->deadline.tv_sec += this->groupInterval / 1000;
+            this->deadline.tv_nsec += (this->groupInterval % 1000) * 1000000L;
+
+            if(this->deadline.tv_nsec >= 1000000000L){
+                this->deadline.tv_sec++;
+                this->deadline.tv_nsec -= 1000000000L;
+            }
+        }
+
+        this->pending += count;
+
+        if(this->syncPolicy == EL_SYNC_FLUSH && fflush(this->file) != 0)
+            value = -1;
+
+        else if(this->syncPolicy == EL_SYNC_FULL && commitPending(this) != 0)
+            value = -1;
+
+        else if(this->syncPolicy == EL_SYNC_GROUP && (this->pending == count || this->pending >= this->groupSize))
+            pthread_cond_signal(&this->condition);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Hand the pending records to the operating system and force them to the storage device with a single sync.
+ *        The mutex must be locked, it is released during the sync so other threads can keep appending
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [flush or sync failed]
+ *                           (0) if ok
+ */
+int commitPending(EventLog *this)
+{
+    int value = -1;
+
+    if(fflush(this->file) == 0){
+        this->pending = 0;
+        pthread_mutex_unlock(&this->mutex);
+        value = fileDataSync(fileNumber(this->file)) == 0 ? 0 : -1;
+        pthread_mutex_lock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Stop the group commit thread and wait for it. The mutex must be locked
+ * \param EventLog *this pointer to event log
+ * \return int value return (-1) if error [can't join the thread]
+ *                           (0) if ok
+ */
+int stopCommitter(EventLog *this)
+{
+    int value;
+
+    this->running = 0;
+    pthread_cond_signal(&this->condition);
+    pthread_mutex_unlock(&this->mutex);
+    value = pthread_join(this->committer, NULL) == 0 ? 0 : -1;
+    pthread_mutex_lock(&this->mutex);
+
+    return value;
+}
+
+/**
+ * \brief Body of the group commit thread. Waits until a group is full or the first record of the group waited
+ *        groupInterval milliseconds and commits it
+ * \param void *pArgument pointer to event log
+ * \return void *value (NULL)
+ */
+void *commitGroups(void *pArgument)
+{
+    int timeout;
+    EventLog *this = (EventLog*)pArgument;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while(this->running){
+        if(this->pending == 0)
+            pthread_cond_wait(&this->condition, &this->mutex);
+        else{
+            timeout = 0;
+
+            if(this->pending < this->groupSize)
+                timeout = pthread_cond_timedwait(&this->condition, &this->mutex, &this->deadline) == ETIMEDOUT;
+
+            if((timeout || this->pending >= this->groupSize) && this->pending > 0 && commitPending(this) != 0)
+                this->error = 1;
+        }
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
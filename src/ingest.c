@@ -0,0 +1,703 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/ingest.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// private functions
+void requestStop(int signalNumber);
+int openSource(int source, char *path, int listener);
+int waitSource(int fd);
+int parseReadings(IngestWriter *pWriters, int writers, char *pBuffer, int length, long long timestamp);
+int parseReading(char *pLine, int *pMachine, float *pTemperature, int *pHumidity);
+void pushReadings(IngestWriter *pWriters, int writers, int *pMachines, float *pTemperatures, int *pHumidities, int count, long long timestamp);
+void wakeWriter(IngestWriter *this);
+void *writeEvents(void *pArgument);
+void saveMachineEvents(IngestWriter *this, int idMachine, Mechatronic *pEvents, int count);
+void reloadConfig(void *pContext);
+
+volatile sig_atomic_t stopRequested = 0;
+int readingsDiscarded = 0;
+
+// la senial de terminar tambien se escribe en un pipe, asi poll la ve aunque llegue antes de bloquearse
+int stopPipe[2] = {-1, -1};
+
+/**
+ * \brief Runs the program without user interaction. Readings are received as text lines "temperature humidity" of
+ *        the main machine or "machine temperature humidity" from a FIFO or a UNIX socket, classified with the
+ *        thresholds of their machine and handed through lock-free queues to the writer threads. Every machine is
+ *        stored by the same thread in its own shard, so threads never share a file. When the configuration file
+ *        changes its thresholds are reloaded and used for the next readings. It runs until SIGINT or SIGTERM is
+ *        received
+ * \param int source [INGEST_SOURCE_FIFO] path is a FIFO, it is created if it does not exist
+ *                   [INGEST_SOURCE_SOCKET] path is a UNIX stream socket where writers connect, one at a time
+ * \param char *path path of the FIFO or the socket
+ * \return int value return (-1) if error [invalid parameters, can't open the source, no memory or can't start the thread]
+ *                           (0) if ok
+ */
+int ingest_run(int source, char *path)
+{
+    int i;
+    int fd;
+    int length;
+    int pending;
+    int consumed;
+    int draining;
+    int writers;
+    int started = 0;
+    int processed = 0;
+    int errors = 0;
+    int value = -1;
+    int listener = -1;
+    int outOfMemory = 0;
+    char *pBuffer = NULL;
+    sigset_t signals;
+    sigset_t previous;
+    struct sigaction action;
+    struct sockaddr_un address;
+    PagedStore *pPagedStore = NULL;
+    IngestWriter *pWriters = NULL;
+    ConfigWatch *pConfigWatch = NULL;
+
+    if(path == NULL || (source != INGEST_SOURCE_FIFO && source != INGEST_SOURCE_SOCKET)){
+        printf("\nERROR!, origen de lecturas invalido.\n");
+        return value;
+    }
+
+    pPagedStore = mechatronic_newEventList();
+
+    // sin el archivo binario o el informe no hay donde guardar las lecturas, sin configuracion no hay como clasificarlas
+    if(mechatronic_createBinaryFile(pPagedStore) == 0){
+        if(mechatronic_openTextFile(pPagedStore) != 0)
+            printf("ERROR!, no se pudo crear el archivo: %s\n", MECHATRONIC_OUTPUT_FILE);
+        else if(mechatronic_loadConfigFile(MECHATRONIC_USER_CONFIG, pPagedStore) == 0){
+            // las estadisticas ya estan cargadas, los eventos no se mantienen en memoria
+            mechatronic_evictEvents(pPagedStore);
+
+            if(source == INGEST_SOURCE_FIFO){
+                if(mkfifo(path, 0660) == 0 || errno == EEXIST)
+                    value = 0;
+            }
+            else{
+                memset(&address, 0, sizeof(address));
+                address.sun_family = AF_UNIX;
+                listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+                if(listener >= 0 && strlen(path) < sizeof(address.sun_path)){
+                    strcpy(address.sun_path, path);
+                    unlink(path);
+
+                    if(bind(listener, (struct sockaddr*)&address, sizeof(address)) == 0 && listen(listener, 1) == 0)
+                        value = 0;
+                }
+            }
+        }
+    }
+
+    // cada hilo de escritura tiene su cola y guarda siempre las mismas maquinas
+    writers = INGEST_WRITER_THREADS > 0 ? INGEST_WRITER_THREADS : wp_getProcessors();
+    writers = writers < 1 ? 1 : writers > INGEST_MAX_WRITERS ? INGEST_MAX_WRITERS : writers;
+    pWriters = (IngestWriter*)calloc(writers, sizeof(IngestWriter));
+    pBuffer = (char*)malloc(INGEST_READ_BUFFER + 1);
+
+    // los bloques de cada hilo se reservan antes de iniciarlo, un hilo sin memoria no podria vaciar su cola
+    for(i = 0; pWriters != NULL && i < writers; i++){
+        pWriters[i].pQueue = rb_newRingBuffer(sizeof(Mechatronic), INGEST_QUEUE_SIZE / writers);
+        pWriters[i].pEvents = (Mechatronic*)malloc(sizeof(Mechatronic) * INGEST_BATCH_SIZE);
+        pWriters[i].pSorted = (Mechatronic*)malloc(sizeof(Mechatronic) * INGEST_BATCH_SIZE);
+        pthread_mutex_init(&pWriters[i].mutex, NULL);
+        pthread_cond_init(&pWriters[i].queued, NULL);
+        pthread_cond_init(&pWriters[i].released, NULL);
+
+        if(pWriters[i].pQueue == NULL || pWriters[i].pEvents == NULL || pWriters[i].pSorted == NULL)
+            outOfMemory = 1;
+    }
+
+    if(pWriters == NULL || pBuffer == NULL || outOfMemory){
+        printf("\nERROR!, no hay espacio en memoria RAM.\n");
+        value = -1;
+    }
+
+    if(value == 0 && pipe(stopPipe) != 0){
+        printf("\nERROR!, no se pudo crear el aviso de terminacion.\n");
+        value = -1;
+    }
+
+    if(value == 0){
+        fcntl(stopPipe[1], F_SETFL, fcntl(stopPipe[1], F_GETFL) | O_NONBLOCK);
+
+        // sin SA_RESTART las lecturas bloqueadas terminan al llegar SIGINT o SIGTERM
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = requestStop;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, NULL);
+        sigaction(SIGTERM, &action, NULL);
+
+        // los hilos de escritura bloquean SIGINT y SIGTERM, asi siempre interrumpen al hilo lector
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, &previous);
+
+        for(i = 0; i < writers && value == 0; i++){
+            if(pthread_create(&pWriters[i].thread, NULL, writeEvents, &pWriters[i]) == 0)
+                started++;
+            else
+                value = -1;
+        }
+
+        // los umbrales se vuelven a leer en otro hilo, el lector solo toma la ultima configuracion publicada
+        if(value == 0){
+            pConfigWatch = cw_newConfigWatch(MECHATRONIC_USER_CONFIG, reloadConfig, MECHATRONIC_USER_CONFIG);
+
+            if(pConfigWatch == NULL)
+                printf("No se vigilaran los cambios de '%s'.\n", MECHATRONIC_USER_CONFIG);
+        }
+
+        pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    }
+    else
+        value = -1;
+
+    if(value == 0){
+        printf("Recibiendo lecturas desde '%s'. Presione Ctrl+C para terminar.\n", path);
+
+        while(!stopRequested){
+            fd = openSource(source, path, listener);
+
+            if(fd < 0){
+                if(errno != EINTR){
+                    printf("\nERROR!, no se pudo abrir '%s'.\n", path);
+                    break;
+                }
+
+                continue;
+            }
+
+            pending = 0;
+            draining = 0;
+            length = -1;
+
+            while(length != 0){
+                // al terminar se guarda lo que ya esta en el origen, sin esperar nuevos datos
+                if(!draining && waitSource(fd)){
+                    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                    draining = 1;
+                }
+
+                length = read(fd, pBuffer + pending, INGEST_READ_BUFFER - pending);
+
+                if(length < 0){
+                    if(errno == EINTR)
+                        continue;
+
+                    break;
+                }
+
+                consumed = parseReadings(pWriters, writers, pBuffer, pending + length, time(NULL));
+                pending = pending + length - consumed;
+                memmove(pBuffer, pBuffer + consumed, pending);
+
+                // una linea que no entra en el buffer no es una lectura valida
+                if(pending == INGEST_READ_BUFFER){
+                    readingsDiscarded++;
+                    pending = 0;
+                }
+            }
+
+            // la ultima linea puede no terminar con un salto de linea
+            if(pending > 0){
+                pBuffer[pending] = '\n';
+                parseReadings(pWriters, writers, pBuffer, pending + 1, time(NULL));
+            }
+
+            close(fd);
+        }
+    }
+    else
+        printf("\nERROR!, no se pudo iniciar la recepcion de lecturas desde '%s'.\n", path);
+
+    cw_deleteConfigWatch(pConfigWatch);
+
+    // cada hilo termina al vaciar su cola cerrada
+    for(i = 0; i < started; i++){
+        rb_close(pWriters[i].pQueue);
+        wakeWriter(&pWriters[i]);
+        pthread_join(pWriters[i].thread, NULL);
+        processed += pWriters[i].processed;
+        errors += pWriters[i].errors;
+    }
+
+    if(value == 0){
+        printf("\nLecturas guardadas: %d\nLecturas descartadas: %d\n", processed, readingsDiscarded);
+
+        // cada hilo informa el primer archivo que fallo
+        for(i = 0; i < started; i++){
+            if(pWriters[i].errors > 0)
+                printf("ERROR!, no se pudieron guardar todos los eventos en: %s.\n", pWriters[i].failedFile);
+        }
+
+        if(errors > 0)
+            value = -1;
+    }
+
+    if(listener >= 0){
+        close(listener);
+        unlink(path);
+    }
+
+    for(i = 0; pWriters != NULL && i < writers; i++){
+        rb_deleteRingBuffer(pWriters[i].pQueue);
+        free(pWriters[i].pEvents);
+        free(pWriters[i].pSorted);
+        pthread_mutex_destroy(&pWriters[i].mutex);
+        pthread_cond_destroy(&pWriters[i].queued);
+        pthread_cond_destroy(&pWriters[i].released);
+    }
+
+    for(i = 0; i < 2; i++){
+        if(stopPipe[i] >= 0)
+            close(stopPipe[i]);
+
+        stopPipe[i] = -1;
+    }
+
+    free(pBuffer);
+    free(pWriters);
+    mechatronic_closeTextFile();
+    mechatronic_closeBinaryFile();
+    mechatronic_deleteEventList(pPagedStore);
+
+    return value;
+}
+
+/**
+ * \brief Handler of SIGINT and SIGTERM
+ * \param int signalNumber signal received
+ * \return void
+ */
+void requestStop(int signalNumber)
+{
+    int error = errno;
+    ssize_t written;
+
+    (void)signalNumber;
+    stopRequested = 1;
+
+    // write se puede llamar desde un handler, si el pipe esta lleno ya tiene el aviso
+    written = write(stopPipe[1], "", 1);
+    (void)written;
+    errno = error;
+}
+
+/**
+ * \brief Waits for a writer of the source or for SIGINT or SIGTERM. The FIFO is opened without blocking and waited
+ *        for with poll, the same as the socket, so a signal received just before waiting is not lost
+ * \param int source INGEST_SOURCE_FIFO or INGEST_SOURCE_SOCKET
+ * \param char *path path of the FIFO
+ * \param int listener listening socket
+ * \return int value return (-1) if error [can't open the FIFO or accept a connection, errno is set, EINTR if a
+ *                          signal to stop was received]
+ *                          (file descriptor to read the readings) if ok
+ */
+int openSource(int source, char *path, int listener)
+{
+    int value = -1;
+    int fd = listener;
+
+    if(source == INGEST_SOURCE_FIFO)
+        fd = open(path, O_RDONLY | O_NONBLOCK);
+
+    // un FIFO recien abierto no queda listo hasta que se conecta un escritor
+    if(fd >= 0 && waitSource(fd)){
+        if(source == INGEST_SOURCE_FIFO)
+            close(fd);
+
+        errno = EINTR;
+    }
+    else if(fd >= 0 && source == INGEST_SOURCE_FIFO){
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        value = fd;
+    }
+    else if(fd >= 0)
+        value = accept(listener, NULL, NULL);
+
+    return value;
+}
+
+/**
+ * \brief Sleeps until a file descriptor can be read or SIGINT or SIGTERM is received
+ * \param int fd file descriptor of the FIFO, the connection or the listening socket
+ * \return int value 1 if a signal to stop was received - 0 if fd can be read
+ */
+int waitSource(int fd)
+{
+    struct pollfd fds[2];
+
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = stopPipe[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    // el handler escribe en el pipe antes de que poll termine por EINTR
+    while(poll(fds, 2, -1) < 0 && errno == EINTR)
+        ;
+
+    return fds[1].revents != 0;
+}
+
+/**
+ * \brief Parses the complete lines of the buffer and queues a classified event for every valid reading.
+ *        Lines with wrong format or values out of range are discarded
+ * \param IngestWriter *pWriters pointer to the array of writer threads
+ * \param int writers number of writer threads
+ * \param char *pBuffer buffer with the data read
+ * \param int length number of bytes of the buffer
+ * \param long long timestamp time of the readings in seconds since the epoch
+ * \return int value number of bytes consumed, the bytes after the last line break are not consumed
+ */
+int parseReadings(IngestWriter *pWriters, int writers, char *pBuffer, int length, long long timestamp)
+{
+    int value = 0;
+    int count = 0;
+    char *pEnd = NULL;
+    int machines[INGEST_CLASSIFY_BATCH];
+    int humidities[INGEST_CLASSIFY_BATCH];
+    float temperatures[INGEST_CLASSIFY_BATCH];
+
+    while((pEnd = memchr(pBuffer + value, '\n', length - value)) != NULL){
+        *pEnd = '\0';
+
+        if(parseReading(pBuffer + value, &machines[count], &temperatures[count], &humidities[count])){
+            count++;
+
+            if(count == INGEST_CLASSIFY_BATCH){
+                pushReadings(pWriters, writers, machines, temperatures, humidities, count, timestamp);
+                count = 0;
+            }
+        }
+        else if(pEnd != pBuffer + value)
+            readingsDiscarded++;
+
+        value = pEnd + 1 - pBuffer;
+    }
+
+    pushReadings(pWriters, writers, machines, temperatures, humidities, count, timestamp);
+
+    return value;
+}
+
+/**
+ * \brief Parses a line "temperature humidity" of the main machine or "machine temperature humidity". The values
+ *        are separated with spaces, comma or semicolon
+ * \param char *pLine pointer to the line, ended with '\0'
+ * \param int *pMachine pointer where the ID of the machine is written, only if the line is valid
+ * \param float *pTemperature pointer where the temperature is written
+ * \param int *pHumidity pointer where the humidity is written, only if the line is valid
+ * \return int value 1 if the line is a valid reading - 0 if not
+ */
+int parseReading(char *pLine, int *pMachine, float *pTemperature, int *pHumidity)
+{
+    int i;
+    int value = 0;
+    int parsed;
+    long machine;
+    long humidity;
+    char *pField = NULL;
+    char *pNext = NULL;
+
+    // primero sin id de maquina, como las lecturas de una sola maquina
+    for(i = 0; i < 2 && !value; i++){
+        pField = pLine;
+        machine = 0;
+
+        if(i == 1){
+            machine = strtol(pField, &pNext, 10);
+
+            // la maquina es un entero seguido de un separador, "60.5 50" no es la maquina 60
+            if(pNext == pField || strchr(" \t,;", *pNext) == NULL || *pNext == '\0')
+                break;
+
+            pField = pNext + (*pNext == ',' || *pNext == ';');
+        }
+
+        *pTemperature = strtof(pField, &pNext);
+
+        if(pNext != pField){
+            pField = pNext + (*pNext == ',' || *pNext == ';');
+            humidity = strtol(pField, &pNext, 10);
+            parsed = pNext != pField;
+            pNext += strspn(pNext, " \t\r");
+
+            // mismos rangos que el ingreso manual, se revisan antes de pasar a int para que un numero enorme no de la vuelta
+            value = parsed && *pNext == '\0' && *pTemperature >= -20 && *pTemperature <= 60 && humidity >= 0 && humidity <= 100 &&
+                    machine >= 0 && machine < MECHATRONIC_MAX_MACHINES;
+        }
+    }
+
+    if(value){
+        *pMachine = (int)machine;
+        *pHumidity = (int)humidity;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Classifies a block of readings with the thresholds of their machines and queues their events to the writer
+ *        thread of each machine. If a queue is full it sleeps until its writer thread takes events from it, so no
+ *        reading is lost. Every writer that received events is woken once at the end
+ * \param IngestWriter *pWriters pointer to the array of writer threads
+ * \param int writers number of writer threads
+ * \param int *pMachines pointer to the IDs of the machines of the readings, they are overwritten
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings
+ * \param long long timestamp time of the readings in seconds since the epoch
+ * \return void
+ */
+void pushReadings(IngestWriter *pWriters, int writers, int *pMachines, float *pTemperatures, int *pHumidities, int count, long long timestamp)
+{
+    int i;
+    int j;
+    int length;
+    int idMachine;
+    unsigned int woken = 0;
+    IngestWriter *pWriter = NULL;
+    int humidities[INGEST_CLASSIFY_BATCH];
+    float temperatures[INGEST_CLASSIFY_BATCH];
+    Mechatronic events[INGEST_CLASSIFY_BATCH];
+
+    // las lecturas de cada maquina se clasifican juntas, en el orden en que llegaron
+    for(i = 0; i < count; i++){
+        if(pMachines[i] < 0)
+            continue;
+
+        idMachine = pMachines[i];
+        length = 0;
+
+        for(j = i; j < count; j++){
+            if(pMachines[j] == idMachine){
+                temperatures[length] = pTemperatures[j];
+                humidities[length++] = pHumidities[j];
+                pMachines[j] = -1;
+            }
+        }
+
+        mechatronic_newReadings(events, idMachine, temperatures, humidities, length, timestamp);
+        pWriter = &pWriters[idMachine % writers];
+        woken |= 1u << (idMachine % writers);
+
+        for(j = 0; j < length; j++){
+            if(rb_push(pWriter->pQueue, events + j) != 0){
+                // la cola llena se libera cuando el hilo de escritura la vacia, hay que despertarlo antes de esperar
+                wakeWriter(pWriter);
+                pthread_mutex_lock(&pWriter->mutex);
+                __atomic_store_n(&pWriter->waiting, 1, __ATOMIC_RELAXED);
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+                while(rb_push(pWriter->pQueue, events + j) != 0)
+                    pthread_cond_wait(&pWriter->released, &pWriter->mutex);
+
+                __atomic_store_n(&pWriter->waiting, 0, __ATOMIC_RELAXED);
+                pthread_mutex_unlock(&pWriter->mutex);
+            }
+        }
+    }
+
+    for(i = 0; i < writers; i++){
+        if(woken & (1u << i))
+            wakeWriter(&pWriters[i]);
+    }
+}
+
+/**
+ * \brief Wakes a writer thread that sleeps with its queue empty, after events were queued or the queue was closed.
+ *        The mutex is only taken if the thread announced that it is going to sleep
+ * \param IngestWriter *this pointer to the writer thread
+ * \return void
+ */
+void wakeWriter(IngestWriter *this)
+{
+    // la barrera ordena lo encolado antes de leer el aviso, el hilo hace lo mismo al reves antes de dormirse
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // con el mutex tomado el hilo no puede estar entre revisar la cola y dormirse
+    if(__atomic_load_n(&this->sleeping, __ATOMIC_RELAXED)){
+        pthread_mutex_lock(&this->mutex);
+        pthread_cond_signal(&this->queued);
+        pthread_mutex_unlock(&this->mutex);
+    }
+}
+
+/**
+ * \brief Body of a writer thread. Takes the events from its queue in blocks, groups them by machine and stores
+ *        every group in the files of its machine, until the queue is closed and empty. The queue is read without
+ *        locks, the mutex is only taken to sleep while the queue is empty and to wake the reader thread if it waits
+ *        for room. The shards are opened with the first event of their machine and closed at the end
+ * \param void *pArgument pointer to the IngestWriter of the thread
+ * \return void *value (NULL)
+ */
+void *writeEvents(void *pArgument)
+{
+    int i;
+    int count;
+    int closed;
+    int first;
+    int idMachine;
+    int offsets[MECHATRONIC_MAX_MACHINES + 1];
+    IngestWriter *this = (IngestWriter*)pArgument;
+    Mechatronic *pEvents = this->pEvents;
+    Mechatronic *pSorted = this->pSorted;
+
+    do{
+        // el cierre se lee antes de vaciar la cola para no perder lo encolado antes de cerrar
+        closed = rb_isClosed(this->pQueue);
+        count = rb_popArray(this->pQueue, pEvents, INGEST_BATCH_SIZE);
+
+        // con la cola vacia avisa que se va a dormir y la vuelve a revisar, lo encolado antes del aviso no se pierde
+        if(count == 0 && !closed){
+            pthread_mutex_lock(&this->mutex);
+            __atomic_store_n(&this->sleeping, 1, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            closed = rb_isClosed(this->pQueue);
+            count = rb_popArray(this->pQueue, pEvents, INGEST_BATCH_SIZE);
+
+            while(count == 0 && !closed){
+                pthread_cond_wait(&this->queued, &this->mutex);
+                closed = rb_isClosed(this->pQueue);
+                count = rb_popArray(this->pQueue, pEvents, INGEST_BATCH_SIZE);
+            }
+
+            __atomic_store_n(&this->sleeping, 0, __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&this->mutex);
+        }
+
+        if(count > 0){
+            // el lector solo espera lugar con la cola llena
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+            if(__atomic_load_n(&this->waiting, __ATOMIC_RELAXED)){
+                pthread_mutex_lock(&this->mutex);
+                pthread_cond_signal(&this->released);
+                pthread_mutex_unlock(&this->mutex);
+            }
+
+            // ordenamiento por conteo: los eventos de cada maquina quedan juntos y en el mismo orden
+            memset(offsets, 0, sizeof(offsets));
+
+            for(i = 0; i < count; i++)
+                offsets[pEvents[i].idMachine + 1]++;
+
+            for(i = 0; i < MECHATRONIC_MAX_MACHINES; i++)
+                offsets[i + 1] += offsets[i];
+
+            for(i = 0; i < count; i++)
+                pSorted[offsets[pEvents[i].idMachine]++] = pEvents[i];
+
+            for(idMachine = 0, first = 0; idMachine < MECHATRONIC_MAX_MACHINES; first = offsets[idMachine++]){
+                if(offsets[idMachine] > first)
+                    saveMachineEvents(this, idMachine, pSorted + first, offsets[idMachine] - first);
+            }
+
+            this->processed += count;
+        }
+    }while(count > 0 || !closed);
+
+    for(i = 0; i < MECHATRONIC_MAX_MACHINES; i++)
+        mechatronic_closeShard(this->pShards[i]);
+
+    return NULL;
+}
+
+/**
+ * \brief Stores a block of events of one machine: the main machine in the main files, the others in their shards
+ * \param IngestWriter *this pointer to the writer thread, the only one that stores the events of the machine
+ * \param int idMachine ID of the machine
+ * \param Mechatronic *pEvents pointer to the first event
+ * \param int count number of events
+ * \return void
+ */
+void saveMachineEvents(IngestWriter *this, int idMachine, Mechatronic *pEvents, int count)
+{
+    int result;
+    char failedFile[SL_MAX_NAME_CHARS];
+
+    // si no se sabe que archivo fallo se informa el manifiesto, que lista los segmentos de la maquina
+    if(idMachine == 0)
+        strcpy(failedFile, MECHATRONIC_MANIFEST_FILE);
+    else
+        sprintf(failedFile, MECHATRONIC_MACHINE_BASE ".manifest", idMachine);
+
+    if(idMachine == 0)
+        result = mechatronic_saveEvents(pEvents, count, failedFile);
+    else{
+        if(this->pShards[idMachine] == NULL)
+            this->pShards[idMachine] = mechatronic_openShard(idMachine);
+
+        result = mechatronic_saveShardEvents(this->pShards[idMachine], pEvents, count, failedFile);
+    }
+
+    if(result != 0 && this->errors++ == 0)
+        strcpy(this->failedFile, failedFile);
+}
+
+/**
+ * \brief Reloads the thresholds when the configuration file changes. It runs in the thread of the config watch, the
+ *        readings already classified keep the thresholds they had
+ * \param void *pContext pointer to the name of the configuration file
+ * \return void
+ */
+void reloadConfig(void *pContext)
+{
+    int version;
+
+    version = mechatronic_reloadThresholds((char*)pContext);
+
+    if(version >= 0)
+        printf("Umbrales recargados desde '%s' (version %d).\n", (char*)pContext, version);
+    else
+        printf("ERROR!, no se pudo leer '%s' o le falta un umbral general valido, se mantienen los umbrales anteriores.\n", (char*)pContext);
+
+    fflush(stdout);
+}
+
+#else
+
+/**
+ * \brief Runs the program without user interaction. Not available on Windows
+ * \param int source INGEST_SOURCE_FIFO or INGEST_SOURCE_SOCKET
+ * \param char *path path of the FIFO or the socket
+ * \return int value (-1)
+ */
+int ingest_run(int source, char *path)
+{
+    printf("\nERROR!, el modo sin interaccion no esta disponible en este sistema.\n");
+
+    return -1;
+}
+
+#endif
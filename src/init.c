@@ -19,32 +19,43 @@ void init()
 {
     char start;
     int option, emergencyOption;
-    ArrayList *pArrayList = al_newArrayList();
+    PagedStore *pPagedStore = NULL;
 
-    mechatronic_createBinaryFile(pArrayList);
-    mechatronic_loadTextFile(MECHATRONIC_USER_CONFIG, pArrayList);
+    tm_init();
+    pPagedStore = mechatronic_newEventList();
 
-    start = 's';
+    // sin el archivo binario los eventos no se podrian guardar
+    start = mechatronic_createBinaryFile(pPagedStore) == 0 ? 's' : 'n';
     emergencyOption = 0;
 
+    if(start == 's'){
+        if(mechatronic_openTextFile(pPagedStore) != 0){
+            tm_clear();
+            printf("\nERROR!, no se pudo crear el archivo: %s\n", MECHATRONIC_OUTPUT_FILE);
+            tm_pause();
+        }
+
+        mechatronic_loadTextFile(MECHATRONIC_USER_CONFIG, pPagedStore);
+    }
+
     while(start == 's'){
         option = mechatronic_showMainMenu();
 
         switch(option){
             case 1:
-                mechatronic_newMechatronicObject(pArrayList, emergencyOption);
+                mechatronic_newMechatronicObject(pPagedStore, emergencyOption);
                 break;
             case 2:
-                emergencyOption = mechatronic_emergencySwitch(pArrayList);
+                emergencyOption = mechatronic_emergencySwitch(pPagedStore);
                 break;
             case 3:
-                mechatronic_generalEventsReport(pArrayList);
+                mechatronic_generalEventsReport(pPagedStore);
                 break;
             case 4:
-                mechatronic_emergencyEventsReport(pArrayList);
+                mechatronic_emergencyEventsReport(pPagedStore);
                 break;
             case 5:
-                mechatronic_userConfig(pArrayList);
+                mechatronic_userConfig(pPagedStore);
                 break;
             case 6:
                 start = 'n';
@@ -52,5 +63,7 @@ void init()
         }
     }
 
-    al_deleteArrayList(pArrayList);
+    mechatronic_closeTextFile();
+    mechatronic_closeBinaryFile();
+    mechatronic_deleteEventList(pPagedStore);
 }
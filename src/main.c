@@ -15,9 +15,44 @@
 
 #include <stdlib.h>
 #include "../inc/init.h"
+#include "../inc/ingest.h"
+#include "../inc/replay.h"
 
 int main(int argc, char **argcv)
 {
-    init();
-    return 0;
+    int value = 0;
+    double speed = 0;
+    char *pEnd = NULL;
+
+    // la velocidad de la reproduccion es opcional, 0 es la maxima
+    if(argc == 5)
+        speed = strtod(argcv[4], &pEnd);
+
+    // sin argumentos se usa el menu interactivo
+    if(argc == 3 && !strcmp(argcv[1], "--fifo"))
+        value = ingest_run(INGEST_SOURCE_FIFO, argcv[2]) == 0 ? 0 : 1;
+
+    else if(argc == 3 && !strcmp(argcv[1], "--socket"))
+        value = ingest_run(INGEST_SOURCE_SOCKET, argcv[2]) == 0 ? 0 : 1;
+
+    else if(argc == 2 && !strcmp(argcv[1], "--verify"))
+        value = mechatronic_verifyBinaryFile() == 0 ? 0 : 1;
+
+    else if(argc == 2 && !strcmp(argcv[1], "--regenerate"))
+        value = mechatronic_regenerateTextFile() == 0 ? 0 : 1;
+
+    else if(argc == 4 && !strcmp(argcv[1], "--range"))
+        value = mechatronic_rangeEventsReport(argcv[2], argcv[3]) == 0 ? 0 : 1;
+
+    else if((argc == 4 || argc == 5) && !strcmp(argcv[1], "--replay") && (argc == 4 || (pEnd != argcv[4] && *pEnd == '\0' && speed >= 0)))
+        value = replay_run(argcv[2], argcv[3], speed) == 0 ? 0 : 1;
+
+    else if(argc > 1){
+        printf("Uso: %s [--fifo RUTA | --socket RUTA | --replay RUTA DIRECTORIO [VELOCIDAD] | --verify | --regenerate | --range DD/MM/AAAA DD/MM/AAAA]\n", argcv[0]);
+        value = 1;
+    }
+    else
+        init();
+
+    return value;
 }
@@ -0,0 +1,141 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/mappedfile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * \brief Map the whole content of a file in memory as read-only
+ * \param char *fileName path of the file
+ * \return MappedFile *pAux Return (NULL) if error [fileName is NULL pointer or the file can't be opened or mapped]
+ *                               - (pointer to new mapped file) if ok. An empty file has pData (NULL) and size (0)
+ */
+MappedFile *mf_newMappedFile(char *fileName)
+{
+    MappedFile *this = NULL;
+    MappedFile *pAux = NULL;
+
+    if(fileName != NULL){
+        this = (MappedFile*)malloc(sizeof(MappedFile));
+
+        if(this != NULL){
+            this->pData = NULL;
+            this->size = 0;
+
+#ifdef _WIN32
+            LARGE_INTEGER size;
+
+            this->mapping = NULL;
+            this->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+            if(this->file != INVALID_HANDLE_VALUE && GetFileSizeEx(this->file, &size)){
+                this->size = (long)size.QuadPart;
+
+                if(this->size == 0)
+                    pAux = this;
+
+                else{
+                    this->mapping = CreateFileMappingA(this->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+                    if(this->mapping != NULL)
+                        this->pData = MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+
+                    if(this->pData != NULL)
+                        pAux = this;
+                }
+            }
+
+            if(pAux == NULL){
+                if(this->mapping != NULL)
+                    CloseHandle(this->mapping);
+
+                if(this->file != INVALID_HANDLE_VALUE)
+                    CloseHandle(this->file);
+
+                free(this);
+            }
+#else
+            int fd;
+            struct stat status;
+            void *pData = NULL;
+
+            fd = open(fileName, O_RDONLY);
+
+            if(fd != -1 && fstat(fd, &status) == 0){
+                this->size = (long)status.st_size;
+
+                if(this->size == 0)
+                    pAux = this;
+
+                else{
+                    pData = mmap(NULL, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                    if(pData != MAP_FAILED){
+                        // la carga inicial recorre el archivo completo en orden
+                        madvise(pData, this->size, MADV_SEQUENTIAL);
+                        this->pData = pData;
+                        pAux = this;
+                    }
+                }
+            }
+
+            // el mapeo sigue siendo valido despues de cerrar el descriptor
+            if(fd != -1)
+                close(fd);
+
+            if(pAux == NULL)
+                free(this);
+#endif
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Unmap the file and release the mapped file. Pointers into pData are no longer valid
+ * \param MappedFile *this pointer to mapped file
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int mf_deleteMappedFile(MappedFile *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+#ifdef _WIN32
+        if(this->pData != NULL)
+            UnmapViewOfFile(this->pData);
+
+        if(this->mapping != NULL)
+            CloseHandle(this->mapping);
+
+        CloseHandle(this->file);
+#else
+        if(this->pData != NULL)
+            munmap(this->pData, this->size);
+#endif
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
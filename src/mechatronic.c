@@ -15,24 +15,476 @@
 
 #include "../inc/mechatronic.h"
 
-int humidityThreshold;
-float temperatureEngineOn;
-float temperatureEngineOff;
+#ifdef _WIN32
+#include <io.h>
+#define fileSync(fd) _commit(fd)
+#define fileNumber(file) _fileno(file)
+#else
+#include <unistd.h>
+#define fileSync(fd) fsync(fd)
+#define fileNumber(file) fileno(file)
+#endif
+
+// private functions
+void putInteger(unsigned char *pBuffer, long long value, int bytes);
+long long getInteger(unsigned char *pBuffer, int bytes);
+long toHundredths(float number, long minimum, long maximum);
+int fitsHundredths(float number, long minimum, long maximum);
+int isValidLegacyDate(Date *pDate);
+int appendEvents(SegmentLog *pLog, TimeIndex *pIndex, ReportWriter *pWriter, char *reportName, EventStats *pStats, Mechatronic *pEvents, int count, char *pFailed);
+int replaceBinaryFile(FILE *target, int value);
+int parseReportDate(char *text, int endOfDay, long long *pTimestamp);
+int parseThresholdLine(char *pLine, Thresholds *pGeneral, Thresholds *pOverrides, unsigned char *pKeys);
+int parseThresholdTemperature(char *pText, float *pTemperature);
+int parseThresholdHumidity(char *pText, int *pHumidity);
+void parseMachineThreshold(char *pLine, Thresholds *pOverrides, unsigned char *pKeys);
+int publishThresholds(Thresholds *pGeneral, Thresholds *pOverrides, unsigned char *pKeys);
+void releaseThresholds(ThresholdSnapshot *pSnapshot);
+ThresholdReader *joinThresholds(void);
+void leaveThresholds(void *pArgument);
+void createThresholdKey(void);
+
+int durability = INITIAL_DURABILITY;
+int groupCommitEvents = INITIAL_GROUP_COMMIT_EVENTS;
+int groupCommitMillis = INITIAL_GROUP_COMMIT_MILLIS;
+int segmentEvents = INITIAL_SEGMENT_EVENTS;
+int segmentDaily = INITIAL_SEGMENT_DAILY;
+int retentionDays = INITIAL_RETENTION_DAYS;
+int cacheMegabytes = INITIAL_CACHE_MEGABYTES;
+int firstEvent = 0;
+SegmentLog *pSegmentLog = NULL;
+TimeIndex *pTimeIndex = NULL;
+ReportWriter *pReportWriter = NULL;
+ColumnStore *pColumnStore = NULL;
+int columnsEnabled = 0;
+Pool *pMechatronicPool = NULL;
+EventStats eventStats;
+int statsOutdated = 0;
+ThresholdSnapshot initialThresholds;
+ThresholdSnapshot *pThresholdSnapshot = &initialThresholds;
+unsigned long long thresholdEpoch = 1;
+ThresholdReader thresholdReaders[MECHATRONIC_THRESHOLD_READERS] __attribute__((aligned(MECHATRONIC_CACHE_LINE)));
+pthread_mutex_t thresholdsMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_once_t thresholdOnce = PTHREAD_ONCE_INIT;
+pthread_key_t thresholdKey;
+int thresholdKeyCreated = 0;
+
+char *durabilityNames[] = {DURABILITY_NONE, DURABILITY_FLUSH, DURABILITY_SYNC, DURABILITY_GROUP};
+
+char *eventTypeNames[EVENT_TYPE_COUNT] = {BOOT_BY_TEMPERATURE, STOP_BY_TEMPERATURE, BOOT_BY_HUMIDITY, STOP_BY_HUMIDITY, EMERGENCY};
+
+char *textFileHeader = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t******************** LISTADO DE EVENTOS ********************\n\n\n"
+                       "FECHA EVENTO\t\t\tID OPERARIO\t\tNOMBRE OPERARIO\t\t\t\t\tTIPO DE EVENTO\t\t\t\t\tTEMPERATURA AMBIENTE SENSADA\t\t\tHUMEDAD AMBIENTE SENSADA\t\t\tTEMPERATURA CONFIGURADA MOTOR ENCENDIDO\t\tTEMPERATURA CONFIGURADA MOTOR APAGADO\t\tUMBRAL HUMEDAD\t\t\t\t\t\t\n"
+                       "-------------\t\t\t-----------\t\t---------------\t\t\t\t\t-----------------\t\t\t\t----------------------------\t\t\t------------------------\t\t\t---------------------------------------\t\t-------------------------------------\t\t--------------\n\n";
 
 /**
- * \brief Allocates dynamic memory for a variable of type Mechatronic
+ * \brief Allocates a variable of type Mechatronic from the pool of the event store
  * \param -
- * \return Pointer *value pointer to Mechatronic with dynamic memory
+ * \return Pointer *value pointer to Mechatronic with all its fields set to zero
  *                  - (NULL) if error [if can't allocate memory]
  */
 Mechatronic *new_mechatronic(void)
 {
     Mechatronic *this = NULL;
 
-    this = (Mechatronic*)malloc(sizeof(Mechatronic));
+    this = (Mechatronic*)pl_alloc(pMechatronicPool);
 
     if(this == NULL)
         mechatronic_showErrorMessage();
+    else
+        memset(this, 0, sizeof(Mechatronic));
+
+    return this;
+}
+
+/**
+ * \brief Gives back a variable of type Mechatronic to the pool of the event store so it can be reused
+ * \param Mechatronic *this pointer to the structure Mechatronic obtained with new_mechatronic
+ * \return void
+ */
+void delete_mechatronic(Mechatronic *this)
+{
+    pl_free(pMechatronicPool, this);
+}
+
+/**
+ * \brief Creates the event store, where the recent events are kept in memory and the older ones are read from the
+ *        binary file in pages when they are needed, the columns of the whole history used by the analytics if they
+ *        were enabled with mechatronic_enableColumns and the pool that owns the mechatronic structures being edited
+ * \param -
+ * \return PagedStore *pPagedStore pointer to the new event store
+ *                  - (NULL) if error [if can't allocate memory]
+ */
+PagedStore *mechatronic_newEventList(void)
+{
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = ps_newPagedStore(sizeof(Mechatronic), MECHATRONIC_PAGE_EVENTS, mechatronic_getCachePages(cacheMegabytes), mechatronic_loadPage, NULL);
+    pColumnStore = columnsEnabled ? cs_newColumnStore() : NULL;
+    mechatronic_resetStats(&eventStats);
+    statsOutdated = 0;
+
+    if(pPagedStore != NULL){
+        al_setAddHook(pPagedStore->pResident, mechatronic_trackEvent, &eventStats);
+        al_setRemoveHook(pPagedStore->pResident, mechatronic_untrackEvent, &statsOutdated);
+    }
+
+    pMechatronicPool = pl_newPool(sizeof(Mechatronic), MECHATRONIC_POOL_SLAB);
+
+    if(pPagedStore == NULL || (columnsEnabled && pColumnStore == NULL) || pMechatronicPool == NULL)
+        mechatronic_showErrorMessage();
+
+    return pPagedStore;
+}
+
+/**
+ * \brief Deletes the event store and its columns and releases at once every mechatronic structure of the pool and
+ *        the thresholds replaced by the reloads of the configuration. No thread can be classifying readings
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return void
+ */
+void mechatronic_deleteEventList(PagedStore *pPagedStore)
+{
+    ThresholdSnapshot *pSnapshot = NULL;
+
+    ps_deletePagedStore(pPagedStore);
+    cs_deleteColumnStore(pColumnStore);
+    pColumnStore = NULL;
+    pl_deletePool(pMechatronicPool);
+    pMechatronicPool = NULL;
+
+    // los hilos que clasifican ya terminaron, las configuraciones reemplazadas se pueden liberar
+    pthread_mutex_lock(&thresholdsMutex);
+
+    while(pThresholdSnapshot != &initialThresholds){
+        pSnapshot = pThresholdSnapshot;
+        pThresholdSnapshot = pSnapshot->pReplaced;
+        free(pSnapshot);
+    }
+
+    pthread_mutex_unlock(&thresholdsMutex);
+}
+
+/**
+ * \brief Sets the statistics of an empty event store
+ * \param EventStats *pStats pointer to the statistics
+ * \return void
+ */
+void mechatronic_resetStats(EventStats *pStats)
+{
+    memset(pStats, 0, sizeof(EventStats));
+}
+
+/**
+ * \brief Adds an event to the statistics of the event store.
+ *        Emergency events don't carry sensor readings and are left out of the temperature and humidity values
+ * \param void *pContext pointer to the statistics
+ * \param void *pElement pointer to the structure Mechatronic added
+ * \return void
+ */
+void mechatronic_updateStats(void *pContext, void *pElement)
+{
+    EventStats *pStats = (EventStats*)pContext;
+    Mechatronic *this = (Mechatronic*)pElement;
+
+    if(pStats->count == 0 || this->timestamp < pStats->firstTimestamp)
+        pStats->firstTimestamp = this->timestamp;
+
+    if(pStats->count == 0 || this->timestamp > pStats->lastTimestamp)
+        pStats->lastTimestamp = this->timestamp;
+
+    pStats->count++;
+
+    if(this->eventType >= 0 && this->eventType < EVENT_TYPE_COUNT)
+        pStats->typeCount[this->eventType]++;
+
+    if(this->eventType != EVENT_EMERGENCY){
+        if(pStats->readCount == 0 || this->ambientTemperatureRead < pStats->minTemperature)
+            pStats->minTemperature = this->ambientTemperatureRead;
+
+        if(pStats->readCount == 0 || this->ambientTemperatureRead > pStats->maxTemperature)
+            pStats->maxTemperature = this->ambientTemperatureRead;
+
+        if(pStats->readCount == 0 || this->humidityTemperatureRead < pStats->minHumidity)
+            pStats->minHumidity = this->humidityTemperatureRead;
+
+        if(pStats->readCount == 0 || this->humidityTemperatureRead > pStats->maxHumidity)
+            pStats->maxHumidity = this->humidityTemperatureRead;
+
+        pStats->temperatureSum += this->ambientTemperatureRead;
+        pStats->humiditySum += this->humidityTemperatureRead;
+        pStats->readCount++;
+    }
+}
+
+/**
+ * \brief Adds a new event to the statistics and to the columns of the event store. It is the add hook of the
+ *        resident events of the store, so both are kept up to date with every new event
+ * \param void *pContext pointer to the statistics
+ * \param void *pElement pointer to the structure Mechatronic added
+ * \return void
+ */
+void mechatronic_trackEvent(void *pContext, void *pElement)
+{
+    Mechatronic *this = (Mechatronic*)pElement;
+
+    mechatronic_updateStats(pContext, pElement);
+
+    if(pColumnStore != NULL)
+        cs_add(pColumnStore, this->timestamp, this->eventType, toHundredths(this->ambientTemperatureRead, MECHATRONIC_MIN_AMBIENT_HUNDREDTHS, MECHATRONIC_MAX_AMBIENT_HUNDREDTHS), this->humidityTemperatureRead, this->idEmployee);
+}
+
+/**
+ * \brief Marks the statistics and the columns of the event store as outdated when an event leaves the resident
+ *        events. It is the remove hook of the resident events of the store, the minimum and maximum values can't be
+ *        taken back so both are rebuilt the next time the statistics are requested
+ * \param void *pContext pointer to the flag that is set
+ * \param void *pElement pointer to the structure Mechatronic removed
+ * \return void
+ */
+void mechatronic_untrackEvent(void *pContext, void *pElement)
+{
+    (void)pElement;
+    *(int*)pContext = 1;
+}
+
+/**
+ * \brief Rebuilds the statistics and the columns of the event store going through every event of the store
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [pPagedStore is NULL pointer, can't allocate memory or an event can't be
+ *                           read]
+ *                           (0) if ok
+ */
+int mechatronic_rebuildStats(PagedStore *pPagedStore)
+{
+    int i;
+    int j;
+    int count = 0;
+    int length;
+    int value = -1;
+    Mechatronic *pEvents = NULL;
+
+    if(pPagedStore != NULL)
+        pEvents = (Mechatronic*)malloc(sizeof(Mechatronic) * MECHATRONIC_READ_CHUNK);
+
+    if(pEvents != NULL){
+        value = 0;
+        length = ps_len(pPagedStore);
+        mechatronic_resetStats(&eventStats);
+        cs_clear(pColumnStore);
+        cs_reserve(pColumnStore, length);
+
+        for(i = 0; value == 0 && i < length; i += count){
+            count = ps_read(pPagedStore, i, pEvents, length - i < MECHATRONIC_READ_CHUNK ? length - i : MECHATRONIC_READ_CHUNK);
+
+            if(count <= 0)
+                value = -1;
+
+            for(j = 0; j < count; j++)
+                mechatronic_trackEvent(&eventStats, &pEvents[j]);
+        }
+
+        statsOutdated = 0;
+    }
+
+    free(pEvents);
+
+    return value;
+}
+
+/**
+ * \brief Drops every event of the event store and its columns from memory, as the modes without interaction do once
+ *        the binary file is loaded. The statistics are kept, they describe the events of the binary file
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return void
+ */
+void mechatronic_evictEvents(PagedStore *pPagedStore)
+{
+    EventStats stats = eventStats;
+
+    // al vaciar la lista residente las estadisticas quedan marcadas para reconstruir, se conservan las del archivo
+    ps_clear(pPagedStore);
+    cs_clear(pColumnStore);
+    eventStats = stats;
+    statsOutdated = 0;
+}
+
+/**
+ * \brief Adds the statistics of a group of events to the statistics of the event store
+ * \param EventStats *pStats pointer to the statistics that are updated
+ * \param EventStats *pOther pointer to the statistics of the other events
+ * \return void
+ */
+void mechatronic_mergeStats(EventStats *pStats, EventStats *pOther)
+{
+    int i;
+
+    if(pOther->count > 0){
+        if(pStats->count == 0 || pOther->firstTimestamp < pStats->firstTimestamp)
+            pStats->firstTimestamp = pOther->firstTimestamp;
+
+        if(pStats->count == 0 || pOther->lastTimestamp > pStats->lastTimestamp)
+            pStats->lastTimestamp = pOther->lastTimestamp;
+
+        pStats->count += pOther->count;
+
+        for(i = 0; i < EVENT_TYPE_COUNT; i++)
+            pStats->typeCount[i] += pOther->typeCount[i];
+    }
+
+    if(pOther->readCount > 0){
+        if(pStats->readCount == 0 || pOther->minTemperature < pStats->minTemperature)
+            pStats->minTemperature = pOther->minTemperature;
+
+        if(pStats->readCount == 0 || pOther->maxTemperature > pStats->maxTemperature)
+            pStats->maxTemperature = pOther->maxTemperature;
+
+        if(pStats->readCount == 0 || pOther->minHumidity < pStats->minHumidity)
+            pStats->minHumidity = pOther->minHumidity;
+
+        if(pStats->readCount == 0 || pOther->maxHumidity > pStats->maxHumidity)
+            pStats->maxHumidity = pOther->maxHumidity;
+
+        pStats->temperatureSum += pOther->temperatureSum;
+        pStats->humiditySum += pOther->humiditySum;
+        pStats->readCount += pOther->readCount;
+    }
+}
+
+/**
+ * \brief Gets the statistics of the event store without going through the events, unless an event was removed from
+ *        the store since the last time and they have to be rebuilt
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return EventStats *pStats pointer to the statistics
+ */
+EventStats *mechatronic_getStats(PagedStore *pPagedStore)
+{
+    if(statsOutdated && mechatronic_rebuildStats(pPagedStore) != 0)
+        mechatronic_showErrorMessage();
+
+    return &eventStats;
+}
+
+/**
+ * \brief Enables or disables the columns of the whole history of the event store, for the scans that go through
+ *        every event. They take about 21 bytes per event, so only the modes that need them enable them. It applies to
+ *        the event stores created from then on
+ * \param int enabled (1) to keep the columns - (0) to leave them out
+ * \return void
+ */
+void mechatronic_enableColumns(int enabled)
+{
+    columnsEnabled = enabled != 0;
+}
+
+/**
+ * \brief Gets the columns of the whole history of the event store, fed by the same path as the event store. They
+ *        are rebuilt with the statistics, the columns of the sealed segments are there once mechatronic_getStats returns
+ * \param -
+ * \return ColumnStore *pColumnStore pointer to the columns - (NULL) if they are not enabled
+ */
+ColumnStore *mechatronic_getColumns(void)
+{
+    return pColumnStore;
+}
+
+/**
+ * \brief Copies a list of events, sorted by time, into new columns, for the statistics of the events of a time
+ *        range read with mechatronic_queryRange
+ * \param ArrayList *pEvents pointer to the typed array list of events
+ * \return ColumnStore *pColumns pointer to the new columns, they must be released with cs_deleteColumnStore
+ *                             - (NULL) if error [pEvents is NULL pointer or can't allocate memory]
+ */
+ColumnStore *mechatronic_newColumns(ArrayList *pEvents)
+{
+    int i;
+    Mechatronic *this = NULL;
+    ColumnStore *pColumns = NULL;
+
+    if(pEvents != NULL)
+        pColumns = cs_newColumnStore();
+
+    if(pColumns != NULL && cs_reserve(pColumns, al_len(pEvents)) != 0){
+        cs_deleteColumnStore(pColumns);
+        pColumns = NULL;
+    }
+
+    for(i = 0; pColumns != NULL && i < al_len(pEvents); i++){
+        this = al_get(pEvents, i);
+        cs_add(pColumns, this->timestamp, this->eventType, toHundredths(this->ambientTemperatureRead, MECHATRONIC_MIN_AMBIENT_HUNDREDTHS, MECHATRONIC_MAX_AMBIENT_HUNDREDTHS), this->humidityTemperatureRead, this->idEmployee);
+    }
+
+    return pColumns;
+}
+
+/**
+ * \brief Computes the average ambient temperature read in a time range, going only through the columns of the
+ *        events. Emergency events don't carry readings and are left out
+ * \param ColumnStore *pColumns pointer to the columns of the events, sorted by time
+ * \param long long from start of the range in seconds since the epoch
+ * \param long long to end of the range in seconds since the epoch, included
+ * \param float *pAverage pointer where the average is written, (0) if there are no readings
+ * \return int value return (-1) if error [pColumns or pAverage are NULL pointer or from > to]
+ *                          (number of readings averaged) if ok
+ */
+int mechatronic_getAverageTemperature(ColumnStore *pColumns, long long from, long long to, float *pAverage)
+{
+    int first;
+    int last;
+    int value = -1;
+    long long sum = 0;
+
+    if(pColumns != NULL && pAverage != NULL && from <= to){
+        // el rango termina en el primer evento posterior a to
+        first = cs_find(pColumns, from);
+        last = to < LLONG_MAX ? cs_find(pColumns, to + 1) : cs_len(pColumns);
+        value = cs_sumTemperatures(pColumns, first, last - first, EVENT_EMERGENCY, &sum);
+        *pAverage = value > 0 ? (float)((double)sum / value / 100) : 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Counts the readings of a time range whose humidity is over the current humidity threshold, going only
+ *        through the columns of the events. Emergency events don't carry readings and are left out
+ * \param ColumnStore *pColumns pointer to the columns of the events, sorted by time
+ * \param long long from start of the range in seconds since the epoch
+ * \param long long to end of the range in seconds since the epoch, included
+ * \return int value return (-1) if error [pColumns is NULL pointer or from > to]
+ *                          (number of readings over the threshold) if ok
+ */
+int mechatronic_countHumidityBreaches(ColumnStore *pColumns, long long from, long long to)
+{
+    int first;
+    int last;
+    int value = -1;
+    Thresholds thresholds;
+
+    if(pColumns != NULL && from <= to && mechatronic_getThresholds(0, &thresholds) == 0){
+        // el rango termina en el primer evento posterior a to
+        first = cs_find(pColumns, from);
+        last = to < LLONG_MAX ? cs_find(pColumns, to + 1) : cs_len(pColumns);
+        value = cs_countHumidityAbove(pColumns, first, last - first, EVENT_EMERGENCY, thresholds.humidityThreshold);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Stores a copy of a mechatronic structure obtained with new_mechatronic at the end of the event store, where
+ *        it stays in memory, and gives the structure back to the pool
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return Mechatronic *this pointer to the stored structure
+ */
+Mechatronic *mechatronic_addEvent(PagedStore *pPagedStore, Mechatronic *this)
+{
+    if(ps_add(pPagedStore, this) != 0)
+        mechatronic_showErrorMessage();
+
+    delete_mechatronic(this);
+    this = ps_get(pPagedStore, ps_len(pPagedStore) - 1);
 
     return this;
 }
@@ -52,6 +504,7 @@ void mechatronic_setDate(Mechatronic *this)
     date = localtime(&now);
 
     if(date != NULL){
+        this->timestamp = now;
         this->today.day = date->tm_mday;
         this->today.month = date->tm_mon + 1;
         this->today.year = date->tm_year + 1900;
@@ -64,33 +517,20 @@ void mechatronic_setDate(Mechatronic *this)
 }
 
 /**
- * \brief Set the engine start temperature
- * \param Mechatronic *this pointer to the structure Mechatronic
- * \return void
- */
-void mechatronic_setTemperatureEngineOn(Mechatronic *this)
-{
-    this->temperatureEngineOn = temperatureEngineOn;
-}
-
-/**
- * \brief Set the engine off temperature
+ * \brief Set the engine start and off temperatures and the humidity threshold of the machine of the event, all
+ *        three from the same configuration even if it is reloaded meanwhile
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_setTemperatureEngineOff(Mechatronic *this)
+void mechatronic_setThresholds(Mechatronic *this)
 {
-    this->temperatureEngineOff = temperatureEngineOff;
-}
+    Thresholds thresholds;
 
-/**
- * \brief Set the humidity threshold
- * \param Mechatronic *this pointer to the structure Mechatronic
- * \return void
- */
-void mechatronic_setHumidityThreshold(Mechatronic *this)
-{
-    this->humidityThreshold = humidityThreshold;
+    if(mechatronic_getThresholds(this->idMachine, &thresholds) == 0){
+        this->temperatureEngineOn = thresholds.temperatureEngineOn;
+        this->temperatureEngineOff = thresholds.temperatureEngineOff;
+        this->humidityThreshold = thresholds.humidityThreshold;
+    }
 }
 
 /**
@@ -170,7 +610,7 @@ void mechatronic_setAmbientHumidityRead( Mechatronic *this, int value)
  */
 void mechatronic_setEmergencyEventType(Mechatronic *this)
 {
-    strcpy(this->eventType, EMERGENCY);
+    this->eventType = EVENT_EMERGENCY;
 }
 
 /**
@@ -180,29 +620,18 @@ void mechatronic_setEmergencyEventType(Mechatronic *this)
  */
 void mechatronic_setEventType(Mechatronic *this)
 {
+    unsigned char type;
+
     if(this != NULL)
     {
-        if(this->ambientTemperatureRead > this->temperatureEngineOn && this->humidityTemperatureRead >= this->humidityThreshold)
-        {
-            strcpy(this->eventType, BOOT_BY_TEMPERATURE);
-        }
-        else if(this->ambientTemperatureRead < this->temperatureEngineOff)
-        {
-            strcpy(this->eventType, STOP_BY_TEMPERATURE);
-        }
-        else if(this->humidityTemperatureRead > this->humidityThreshold)
-        {
-            strcpy(this->eventType, BOOT_BY_HUMIDITY);
-        }
-        else if(this->humidityTemperatureRead <= this->humidityThreshold)
-        {
-            strcpy(this->eventType, STOP_BY_HUMIDITY);
-        }
+        // las mismas reglas que los bloques de lecturas, en el mismo orden
+        cl_classify(&this->ambientTemperatureRead, &this->humidityTemperatureRead, 1, this->temperatureEngineOn, this->temperatureEngineOff, this->humidityThreshold, &type);
+        this->eventType = type;
     }
     else
     {
         printf("\nError!, no hay espacio en memoria RAM.\n\n");
-        system("pause");
+        tm_pause();
     }
 }
 
@@ -212,27 +641,26 @@ void mechatronic_setEventType(Mechatronic *this)
  * \param Int emergencyOption value determining whether an emergency stop has occurred
  * \return void
  */
-void mechatronic_newMechatronicObject(ArrayList *pArrayList, int emergencyOption)
+void mechatronic_newMechatronicObject(PagedStore *pPagedStore, int emergencyOption)
 {
-    if(pArrayList != NULL && emergencyOption != 1){
+    if(pPagedStore != NULL && emergencyOption != 1){
         Mechatronic *this = new_mechatronic();
+
         mechatronic_setDate(this);
         mechatronic_setIdEmployee(this);
         mechatronic_setNameSurname(this);
-        mechatronic_setTemperatureEngineOn(this);
-        mechatronic_setTemperatureEngineOff(this);
-        mechatronic_setHumidityThreshold(this);
+        mechatronic_setThresholds(this);
         mechatronic_setAmbientTemperatureRead(this, mechatronic_newAmbientTemperatureRead());
         mechatronic_setAmbientHumidityRead(this, mechatronic_newAmbientHumidityRead());
         mechatronic_setEventType(this);
-        mechatronic_confirmNewMechatronicData(pArrayList, this);
+        mechatronic_confirmNewMechatronicData(pPagedStore, this);
         printf("\n");
-        system("pause");
+        tm_pause();
     }
-    else if(pArrayList != NULL && emergencyOption == 1){
+    else if(pPagedStore != NULL && emergencyOption == 1){
         mechatronic_showWelcomeMessage();
         printf("No se puede utilizar este menu debido a que se ha ejecutado un evento de tipo '%s'.\n\n", EMERGENCY);
-        system("pause");
+        tm_pause();
     }
     else
         mechatronic_showErrorMessage();
@@ -240,26 +668,26 @@ void mechatronic_newMechatronicObject(ArrayList *pArrayList, int emergencyOption
 
 /**
  * \brief Set a mechatronic emergency structure
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_newMechatronicEmergencyObject(ArrayList *pArrayList)
+void mechatronic_newMechatronicEmergencyObject(PagedStore *pPagedStore)
 {
-    if (pArrayList != NULL){
+    if (pPagedStore != NULL){
         Mechatronic *this = new_mechatronic();
+
         mechatronic_setDate(this);
         mechatronic_setIdEmployee(this);
         mechatronic_setNameSurname(this);
-        mechatronic_setTemperatureEngineOn(this);
-        mechatronic_setTemperatureEngineOff(this);
-        mechatronic_setHumidityThreshold(this);
+        mechatronic_setThresholds(this);
         mechatronic_setAmbientTemperatureRead(this, EMERGENCY_AMBIENT_TEMPERATURE);
         mechatronic_setAmbientHumidityRead(this, EMERGENCY_AMBIENT_HUMIDITY);
         mechatronic_setEmergencyEventType(this);
         mechatronic_printNewMechatronicData(this);
-        al_add(pArrayList, this);
-        mechatronic_saveBinaryFile(pArrayList, this);
-        mechatronic_createTextFile(pArrayList, this);
+        this = mechatronic_addEvent(pPagedStore, this);
+        mechatronic_saveBinaryFile(this);
+        sl_sync(pSegmentLog);
+        mechatronic_createTextFile(this);
     }
     else
         mechatronic_showErrorMessage();
@@ -267,11 +695,11 @@ void mechatronic_newMechatronicEmergencyObject(ArrayList *pArrayList)
 
 /**
  * \brief Confirmation screen
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_confirmNewMechatronicData(ArrayList *pArrayList, Mechatronic *this)
+void mechatronic_confirmNewMechatronicData(PagedStore *pPagedStore, Mechatronic *this)
 {
     int option;
 
@@ -282,28 +710,28 @@ void mechatronic_confirmNewMechatronicData(ArrayList *pArrayList, Mechatronic *t
         getValidInt("\nINGRESE OPCION: ", "\nERROR!, la opcion debe ser numerica\n\n", "\nERROR!, ingrese una opcion entre 1 y 3\n\n", &option, 1, 3, 100);
 
         if(option == 1){
-            al_add(pArrayList, this);
+            this = mechatronic_addEvent(pPagedStore, this);
+            mechatronic_saveBinaryFile(this);
+            mechatronic_createTextFile(this);
             printf("\n****** DATOS GUARDADOS ******\n");
         }
-        else if(option == 2)
+        else if(option == 2){
+            delete_mechatronic(this);
             printf("\n****** OPERACION CANCELADA ******\n");
+        }
 
         else
-            mechatronic_editNewMechatronicData(pArrayList, this);
+            mechatronic_editNewMechatronicData(this);
 
     }while(option == 3);
-
-    mechatronic_saveBinaryFile(pArrayList, this);
-    mechatronic_createTextFile(pArrayList, this);
 }
 
 /**
  * \brief Screen to modify the data
- * \param ArrayList *pArrayList pointer to the array list
  * \param Mechatronic *this pointer to the structure Mechatronic
  * \return void
  */
-void mechatronic_editNewMechatronicData(ArrayList *pArrayList, Mechatronic *this)
+void mechatronic_editNewMechatronicData(Mechatronic *this)
 {
     int option;
 
@@ -317,19 +745,19 @@ void mechatronic_editNewMechatronicData(ArrayList *pArrayList, Mechatronic *this
         mechatronic_setAmbientTemperatureRead(this, mechatronic_newAmbientTemperatureRead());
         mechatronic_setAmbientHumidityRead(this, mechatronic_newAmbientHumidityRead());
         printf("\nDATOS MODIFICADOS\n\n");
-        system("pause");
+        tm_pause();
     }
     else if(option == 2){
         mechatronic_showModifyMechatronicMessage();
         mechatronic_setAmbientTemperatureRead(this, mechatronic_newAmbientTemperatureRead());
         printf("\nDATO MODIFICADO\n\n");
-        system("pause");
+        tm_pause();
     }
     else if(option == 3){
         mechatronic_showModifyMechatronicMessage();
         mechatronic_setAmbientHumidityRead(this, mechatronic_newAmbientHumidityRead());
         printf("\nDATO MODIFICADO\n\n");
-        system("pause");
+        tm_pause();
     }
     else
         option = 4;
@@ -337,10 +765,10 @@ void mechatronic_editNewMechatronicData(ArrayList *pArrayList, Mechatronic *this
 
 /**
  * \brief Display to confirm an emergency stop
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return int opcion selected by the user
  */
-int mechatronic_emergencySwitch(ArrayList *pArrayList)
+int mechatronic_emergencySwitch(PagedStore *pPagedStore)
 {
     int option;
 
@@ -349,14 +777,14 @@ int mechatronic_emergencySwitch(ArrayList *pArrayList)
     getValidInt("\nINGRESE OPCION: ", "\nERROR!, la opcion debe ser numerica\n", "\nERROR!, ingrese una opcion entre 1 y 2\n", &option, 1, 2, 100);
 
     if(option == 1){
-        mechatronic_newMechatronicEmergencyObject(pArrayList);
+        mechatronic_newMechatronicEmergencyObject(pPagedStore);
         printf("\nPARADA DE EMERGENCIA EJECUTADA\n\n");
-        system("pause");
+        tm_pause();
     }
     else{
         option = 2;
         printf("\nOPERACION CANCELADA\n\n");
-        system("pause");
+        tm_pause();
     }
 
     return option;
@@ -369,40 +797,35 @@ int mechatronic_emergencySwitch(ArrayList *pArrayList)
  */
 void mechatronic_printNewMechatronicData(Mechatronic *this)
 {
-    printf("\nID OPERARIO: %d\n\nNOMBRE OPERARIO: %s\n\nTIPO DE EVENTO: %s\n\nTEMPERATURA AMBIENTE SENSADA: %.2f\n\nHUMEDAD AMBIENTE SENSADA: %d\n", this->idEmployee, this->nameSurname, this->eventType, this->ambientTemperatureRead, this->humidityTemperatureRead);
+    printf("\nID OPERARIO: %d\n\nNOMBRE OPERARIO: %s\n\nTIPO DE EVENTO: %s\n\nTEMPERATURA AMBIENTE SENSADA: %.2f\n\nHUMEDAD AMBIENTE SENSADA: %d\n", this->idEmployee, this->nameSurname, mechatronic_getEventTypeName(this->eventType), this->ambientTemperatureRead, this->humidityTemperatureRead);
     printf("\n-----------------------------------------------\n");
 }
 
 /**
  * \brief Displays the general events report
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_generalEventsReport(ArrayList *pArrayList)
+void mechatronic_generalEventsReport(PagedStore *pPagedStore)
 {
-    int i;
-    Mechatronic *this = NULL;
+    EventStats *pStats = NULL;
 
     mechatronic_showWelcomeMessage();
     printf("************** INFORME GENERAL DE EVENTOS ***********\n\n");
 
-    if(pArrayList != NULL){
-        for(i = 0; i < al_len(pArrayList); i++){
-            this = al_get(pArrayList, i);
+    if(pPagedStore != NULL){
+        pStats = mechatronic_getStats(pPagedStore);
 
-            if(this != NULL)
-                mechatronic_printEventList(this);
-            else
-                mechatronic_showErrorMessage();
-        }
+        if(mechatronic_printEvents(pPagedStore, mechatronic_formatEventListRow) != 0)
+            mechatronic_showErrorMessage();
 
-        if(i == 0) {
+        if(pStats->count == 0) {
             printf("El programa no tiene registros almacenados.\n\n");
-            system("pause");
+            tm_pause();
         }
         else {
-            printf("Cantidad total de eventos registrados: %d\n\n", i);
-            system("pause");
+            printf("Cantidad total de eventos registrados: %d\n\n", pStats->count);
+            tm_pause();
         }
     }
     else
@@ -411,35 +834,30 @@ void mechatronic_generalEventsReport(ArrayList *pArrayList)
 
 /**
  * \brief Displays the emergency report
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_emergencyEventsReport(ArrayList *pArrayList)
+void mechatronic_emergencyEventsReport(PagedStore *pPagedStore)
 {
-    int i, j = 0;
-    Mechatronic *this = NULL;
+    EventStats *pStats = NULL;
 
     mechatronic_showWelcomeMessage();
     printf("*************** INFORME DE EMERGENCIAS **************\n\n");
 
-    if(pArrayList != NULL){
-        for(i = 0; i < al_len(pArrayList); i++){
-            this = al_get(pArrayList, i);
+    if(pPagedStore != NULL){
+        pStats = mechatronic_getStats(pPagedStore);
 
-            if(this != NULL){
-                if(!strcmp(this->eventType, EMERGENCY)){
-                    mechatronic_printEventList(this);
-                    j++;
-                }
-            }
-        }
-        if(i == 0){
+        // sin emergencias contadas no hace falta recorrer el historial
+        if(pStats->typeCount[EVENT_EMERGENCY] > 0 && mechatronic_printEvents(pPagedStore, mechatronic_formatEmergencyRow) != 0)
+            mechatronic_showErrorMessage();
+
+        if(pStats->count == 0){
             printf("El programa no tiene registros almacenados.\n\n");
-            system("pause");
+            tm_pause();
         }
         else{
-            printf("Cantidad total de eventos '%s' registrados: %d\n\n", EMERGENCY, j);
-            system("pause");
+            printf("Cantidad total de eventos '%s' registrados: %d\n\n", EMERGENCY, pStats->typeCount[EVENT_EMERGENCY]);
+            tm_pause();
         }
     }
     else
@@ -447,262 +865,1840 @@ void mechatronic_emergencyEventsReport(ArrayList *pArrayList)
 }
 
 /**
- * \brief Displays all data of a mechatronic type structure
- * \param Mechatronic *this pointer to the structure Mechatronic
- * \return void
+ * \brief Displays every event of the store rendered with pFunction. The events are rendered in parallel blocks and
+ *        written to the standard output in order
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \param pFunction (*pFunction) pointer to function that renders one event
+ * \return int value return (-1) if error [can't allocate memory, an event can't be read or a write failed]
+ *                           (0) if ok
  */
-void mechatronic_printEventList(Mechatronic *this)
+int mechatronic_printEvents(PagedStore *pPagedStore, int (*pFunction)(TextFormatter*, void*))
 {
-    printf("ID OPERARIO: %d\n\nNOMBRE OPERARIO: %s\n\nTIPO DE EVENTO: %s\n\nTEMPERATURA AMBIENTE SENSADA: %.2f\n\nHUMEDAD AMBIENTE SENSADA: %d\n\nTEMPERATURA CONFIGURADA MOTOR ENCENDIDO: %.2f\n\nTEMPERATURA CONFIGURADA MOTOR APAGADO: %.2f\n\nUMBRAL HUMEDAD : %d\n", this->idEmployee, this->nameSurname, this->eventType, this->ambientTemperatureRead, this->humidityTemperatureRead, this->temperatureEngineOn, this->temperatureEngineOff, this->humidityThreshold);
-    printf("\n---------------------------------------------------\n\n");
+    int value = -1;
+    TextFormatter *pFormatter = NULL;
+
+    // lo que printf tiene pendiente sale antes que los eventos
+    fflush(stdout);
+    pFormatter = tf_newTextFormatter(RW_BUFFER_SIZE);
+
+    if(tf_setFile(pFormatter, fileNumber(stdout)) == 0 && rw_renderStore(pFormatter, pPagedStore, pFunction) == 0)
+        value = 0;
+
+    if(tf_flush(pFormatter) != 0)
+        value = -1;
+
+    tf_deleteTextFormatter(pFormatter);
+
+    return value;
 }
 
 /**
- * \brief Creates a binary file with the information of the mechatronic structures. If the file exists, add information to the end of the file
- * \param ArrayList *pArrayList pointer to the array list
- * \return void
+ * \brief Renders all data of a mechatronic structure as it is displayed in the events reports
+ * \param TextFormatter *pFormatter formatter where the event is written
+ * \param void *pElement pointer to the structure Mechatronic
+ * \return int value return (-1) if error [a write failed]
+ *                           (0) if ok
  */
-void mechatronic_createBinaryFile(ArrayList *pArrayList)
+int mechatronic_formatEventListRow(TextFormatter *pFormatter, void *pElement)
 {
-    int i;
-    int size;
-    int length;
-    FILE *file = NULL;
-    Mechatronic *this = NULL;
+    int value = -1;
+    Mechatronic *this = pElement;
+    char *pChars = NULL;
+
+    pChars = tf_reserve(pFormatter, MECHATRONIC_MAX_LIST_CHARS);
+
+    if(pChars != NULL){
+        pChars = tf_formatString(pChars, "ID OPERARIO: ", 0);
+        pChars = tf_formatInteger(pChars, this->idEmployee, 0);
+        pChars = tf_formatString(pChars, "\n\nNOMBRE OPERARIO: ", 0);
+        pChars = tf_formatString(pChars, this->nameSurname, 0);
+        pChars = tf_formatString(pChars, "\n\nTIPO DE EVENTO: ", 0);
+        pChars = tf_formatString(pChars, mechatronic_getEventTypeName(this->eventType), 0);
+        pChars = tf_formatString(pChars, "\n\nTEMPERATURA AMBIENTE SENSADA: ", 0);
+        pChars = tf_formatFloat(pChars, this->ambientTemperatureRead);
+        pChars = tf_formatString(pChars, "\n\nHUMEDAD AMBIENTE SENSADA: ", 0);
+        pChars = tf_formatInteger(pChars, this->humidityTemperatureRead, 0);
+        pChars = tf_formatString(pChars, "\n\nTEMPERATURA CONFIGURADA MOTOR ENCENDIDO: ", 0);
+        pChars = tf_formatFloat(pChars, this->temperatureEngineOn);
+        pChars = tf_formatString(pChars, "\n\nTEMPERATURA CONFIGURADA MOTOR APAGADO: ", 0);
+        pChars = tf_formatFloat(pChars, this->temperatureEngineOff);
+        pChars = tf_formatString(pChars, "\n\nUMBRAL HUMEDAD : ", 0);
+        pChars = tf_formatInteger(pChars, this->humidityThreshold, 0);
+        pChars = tf_formatString(pChars, "\n\n---------------------------------------------------\n\n", 0);
+
+        value = tf_commit(pFormatter, pChars);
+    }
 
-    if(pArrayList != NULL){
-        file = fopen(MECHATRONIC_BINARY_FILE, "rb");
+    return value;
+}
 
-        if(file == NULL){
-            file = fopen(MECHATRONIC_BINARY_FILE, "wb");
+/**
+ * \brief Renders a mechatronic structure as it is displayed in the events reports, only if it is an emergency
+ * \param TextFormatter *pFormatter formatter where the event is written
+ * \param void *pElement pointer to the structure Mechatronic
+ * \return int value return (-1) if error [a write failed]
+ *                           (0) if ok
+ */
+int mechatronic_formatEmergencyRow(TextFormatter *pFormatter, void *pElement)
+{
+    int value = 0;
+    Mechatronic *this = pElement;
 
-            if(file == NULL){
-                system("cls");
-                printf("\nERROR!, no se pudo leer/crear el archivo: %s.\nNo hay datos cargados.\n", MECHATRONIC_BINARY_FILE);
-                system("pause");
-            }
+    if(this->eventType == EVENT_EMERGENCY)
+        value = mechatronic_formatEventListRow(pFormatter, pElement);
+
+    return value;
+}
+
+/**
+ * \brief Opens the binary file and loads the records of every segment into the event store. Loading stops at the
+ *        first damaged record, the records after it are left out
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [can't open or convert the binary file], the program can't go on
+ *                           (0) if ok
+ */
+int mechatronic_createBinaryFile(PagedStore *pPagedStore)
+{
+    int loaded;
+    int value = -1;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    if(pPagedStore != NULL){
+        if(mechatronic_openBinaryFile() != 0){
+            tm_clear();
+            printf("\nERROR!, no se pudo leer/crear el archivo: %s.\nEl programa se cerrara.\n", MECHATRONIC_MANIFEST_FILE);
+            tm_pause();
         }
         else{
-            fseek(file, 0, SEEK_END);
-            size = ftell(file);
-            length = size / sizeof(Mechatronic);
-            rewind(file);
+            value = 0;
 
-            for(i = 0; i < length; i++){
-                this = new_mechatronic();
-                fread(this, sizeof(Mechatronic), 1, file);
-                al_add(pArrayList, this);
+            if(pSegmentLog->truncated > 0){
+                tm_clear();
+                printf("\nERROR!, se descartaron %d registros danados o incompletos al final del archivo binario.\n", pSegmentLog->truncated);
+                tm_pause();
             }
+
+            loaded = mechatronic_loadBinaryFile(pPagedStore);
+
+            if(loaded < sl_len(pSegmentLog)){
+                sl_getFileName(pSegmentLog, loaded, fileName, sizeof(fileName));
+                tm_clear();
+                printf("\nERROR!, el archivo %s tiene registros danados.\nSe cargaron los %d eventos anteriores.\n", fileName, ps_len(pPagedStore));
+                tm_pause();
+            }
+
+            mechatronic_openIndexFile(ps_len(pPagedStore));
         }
     }
     else
         mechatronic_showErrorMessage();
 
-    fclose(file);
+    return value;
 }
 
 /**
- * \brief Saves the information in the binary file. If the file exists, add information to the end of the file
- * \param ArrayList *pArrayList pointer to the array list
- * \param Mechatronic *this pointer to the structure Mechatronic
- * \return void
+ * \brief Opens the binary file as an append-only log split in segments. A single binary file with the legacy layout
+ *        or with the previous version of the format is rewritten with the current format first, and then becomes the
+ *        first segment. Damaged or incomplete records at the end of the segment being written are removed
+ * \param -
+ * \return int value return (-1) if error [can't convert the file or can't open the log]
+ *                           (0) if ok
  */
-void mechatronic_saveBinaryFile(ArrayList *pArrayList, Mechatronic *this)
+int mechatronic_openBinaryFile(void)
 {
-    int i;
-    FILE *file = NULL;
-
-    file = fopen(MECHATRONIC_BINARY_FILE, "wb");
+    int value = -1;
+    int discarded = 0;
+    int invalid = 0;
+    unsigned char header[MECHATRONIC_FILE_HEADER_SIZE];
 
-    if(file != NULL){
-        for(i = 0; i < al_len(pArrayList); i++){
-            this = al_get(pArrayList, i);
+    if(mechatronic_isLegacyBinaryFile())
+        value = mechatronic_importLegacyBinaryFile(&discarded, &invalid);
+    else
+        value = mechatronic_upgradeBinaryFile(&discarded);
 
-            if(this != NULL)
-                fwrite(this, sizeof(Mechatronic), 1, file);
-            else
-                mechatronic_showErrorMessage();
-        }
+    // si la conversion fallo el archivo original queda intacto y no se abre el registro
+    if(value != 0){
+        tm_clear();
+        printf("\nERROR!, no se pudo convertir el archivo %s al formato actual. El archivo no se modifico.\n", MECHATRONIC_BINARY_FILE);
+        tm_pause();
     }
     else{
-        system("cls");
-        printf("\nERROR!, no se pudo abrir el archivo: %s.\nDatos sin guardar.\n", MECHATRONIC_BINARY_FILE);
-        system("pause");
+        if(discarded > 0){
+            tm_clear();
+            printf("\nERROR!, se descartaron %d bytes de un registro incompleto al final del archivo %s.\n", discarded, MECHATRONIC_BINARY_FILE);
+            tm_pause();
+        }
+
+        if(invalid > 0){
+            tm_clear();
+            printf("\nERROR!, se descartaron %d registros con fechas o valores invalidos del archivo %s.\n", invalid, MECHATRONIC_BINARY_FILE);
+            tm_pause();
+        }
+
+        mechatronic_encodeFileHeader(header, 0);
+        pSegmentLog = sl_newSegmentLog(MECHATRONIC_SEGMENT_BASE, header, MECHATRONIC_FILE_HEADER_SIZE, MECHATRONIC_RECORD_SIZE, mechatronic_getRecordTimestamp, mechatronic_isValidRecord, durability);
+
+        if(pSegmentLog == NULL)
+            value = -1;
     }
 
-    fclose(file);
+    return value;
 }
 
 /**
- * \brief Creates a text file with the information of the mechatronic structures
- * \param ArrayList *pArrayList pointer to the array list
- * \param Mechatronic *this pointer to the structure Mechatronic
- * \return void
+ * \brief Checks every record of every segment of the binary file without loading them, and prints the result of
+ *        each segment and the speed of the check. Nothing is written: the manifest and the segments are only read,
+ *        an incomplete record at the end of the segment being written is reported but not removed
+ * \param -
+ * \return int value return (-1) if error [can't read the manifest or a segment, a record is damaged or incomplete]
+ *                           (0) if ok
  */
-void mechatronic_createTextFile(ArrayList *pArrayList, Mechatronic *this)
+int mechatronic_verifyBinaryFile(void)
 {
     int i;
-    FILE *file = NULL;
-
-    file = fopen(MECHATRONIC_OUTPUT_FILE, "w");
+    int count;
+    int length;
+    int extra;
+    int value = -1;
+    long long records = 0;
+    double bytes = 0;
+    double seconds;
+    struct timespec start;
+    struct timespec end;
+    Segment *pSegment = NULL;
+    SegmentLog *pLog = NULL;
+    MappedFile *pMappedFile = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    pLog = sl_newReadOnlySegmentLog(MECHATRONIC_SEGMENT_BASE, MECHATRONIC_FILE_HEADER_SIZE, MECHATRONIC_RECORD_SIZE);
+
+    if(pLog == NULL)
+        printf("ERROR!, no se pudo leer el archivo: %s.\n", MECHATRONIC_MANIFEST_FILE);
+    else{
+        value = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        printf("Verificando %s (checksum %s)\n\n", MECHATRONIC_MANIFEST_FILE, crc_isHardware() ? "SSE4.2" : "por tabla");
 
-    if(file != NULL){
-        fprintf(file, "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t******************** LISTADO DE EVENTOS ********************\n\n\n");
-        fprintf(file, "FECHA EVENTO\t\t\tID OPERARIO\t\tNOMBRE OPERARIO\t\t\t\t\tTIPO DE EVENTO\t\t\t\t\tTEMPERATURA AMBIENTE SENSADA\t\t\tHUMEDAD AMBIENTE SENSADA\t\t\tTEMPERATURA CONFIGURADA MOTOR ENCENDIDO\t\tTEMPERATURA CONFIGURADA MOTOR APAGADO\t\tUMBRAL HUMEDAD\t\t\t\t\t\t\n");
-        fprintf(file, "-------------\t\t\t-----------\t\t---------------\t\t\t\t\t-----------------\t\t\t\t----------------------------\t\t\t------------------------\t\t\t---------------------------------------\t\t-------------------------------------\t\t--------------\n\n");
+        for(i = 0; i < sl_len(pLog); i++){
+            if(sl_getFileName(pLog, i, fileName, sizeof(fileName)) != 0)
+                continue;
 
-        for(i = 0; i < al_len(pArrayList); i++){
-            this = al_get(pArrayList, i);
+            pSegment = al_get(pLog->pSegments, i);
+            pMappedFile = mf_newMappedFile(fileName);
 
-            if(this != NULL)
-                fprintf(file, "%02d/%02d/%d %02d:%02d:%02d\t\t%d\t\t%s\t\t\t%25s\t\t\t\t%.2f\t\t\t\t\t\t%d\t\t\t\t\t\t%.2f\t\t\t\t\t\t%.2f\t\t\t\t\t\t%d\n", this->today.day, this->today.month, this->today.year, this->today.hour, this->today.minutes, this->today.seconds, this->idEmployee, this->nameSurname, this->eventType, this->ambientTemperatureRead, this->humidityTemperatureRead, this->temperatureEngineOn, this->temperatureEngineOff, this->humidityThreshold);
-            else
-                mechatronic_showErrorMessage();
-        }
-    }
-    else{
-        system("cls");
-        printf("\nERROR!, no se pudo crear el archivo: %s\n", MECHATRONIC_OUTPUT_FILE);
-        system("pause");
-    }
+            // el segmento activo puede no existir todavia si nunca se escribio
+            if(pMappedFile == NULL && !pSegment->sealed && pSegment->count == 0)
+                printf("%s: 0 registros OK\n", fileName);
 
-    fclose(file);
+            else if(pMappedFile == NULL || pMappedFile->size < MECHATRONIC_FILE_HEADER_SIZE || !mechatronic_checkFileHeader(pMappedFile->pData)){
+                printf("%s: ERROR, no se pudo leer el archivo o su encabezado no es valido\n", fileName);
+                value = -1;
+            }
+            else{
+                length = (pMappedFile->size - MECHATRONIC_FILE_HEADER_SIZE) / MECHATRONIC_RECORD_SIZE;
+                extra = (pMappedFile->size - MECHATRONIC_FILE_HEADER_SIZE) % MECHATRONIC_RECORD_SIZE;
+                count = mechatronic_checkRecords((unsigned char*)pMappedFile->pData + MECHATRONIC_FILE_HEADER_SIZE, length);
+                records += length;
+                bytes += pMappedFile->size;
+
+                if(count < length){
+                    printf("%s: ERROR, el registro %d de %d esta danado\n", fileName, count + 1, length);
+                    value = -1;
+                }
+                else if(extra > 0){
+                    printf("%s: ERROR, %d registros OK y %d bytes de un registro incompleto al final\n", fileName, length, extra);
+                    value = -1;
+                }
+                else if(pSegment->sealed && length != pSegment->count){
+                    printf("%s: ERROR, tiene %d registros y el manifiesto indica %d\n", fileName, length, pSegment->count);
+                    value = -1;
+                }
+                else
+                    printf("%s: %d registros OK\n", fileName, length);
+            }
+
+            mf_deleteMappedFile(pMappedFile);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        printf("\nRegistros verificados: %lld en %d segmentos, %.1f MB en %.3f s (%.1f MB/s)\n", records, sl_len(pLog),
+               bytes / 1e6, seconds, seconds > 0 ? bytes / 1e6 / seconds : 0);
+        printf("Resultado: %s\n", value == 0 ? "OK" : "ERROR");
+
+        sl_deleteSegmentLog(pLog);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Opens the time index of the binary file. If the index is missing or does not cover the records of the
+ *        binary file it is rebuilt reading the timestamps of the records, without decoding them. Records are numbered
+ *        from the first record ever stored, so the numbers don't change when old segments are dropped
+ * \param int length number of records of the binary file covered by the index, from the first record kept
+ * \return void
+ */
+void mechatronic_openIndexFile(int length)
+{
+    int i;
+    int j;
+    int count;
+    long long lastTimestamp = 0;
+    unsigned char record[MECHATRONIC_RECORD_SIZE];
+    unsigned char *pRecords = NULL;
+
+    pTimeIndex = ti_newTimeIndex(MECHATRONIC_INDEX_FILE, MECHATRONIC_INDEX_BUCKET);
+
+    if(pTimeIndex != NULL){
+        // solo se lee el ultimo registro para saber si el indice esta al dia
+        if(length > 0 && sl_read(pSegmentLog, firstEvent + length - 1, record, 1) == 1)
+            lastTimestamp = mechatronic_getRecordTimestamp(record);
+
+        if(!ti_isValid(pTimeIndex, firstEvent + length, lastTimestamp) && ti_clear(pTimeIndex) == 0){
+            pRecords = (unsigned char*)malloc(MECHATRONIC_RECORD_SIZE * MECHATRONIC_READ_CHUNK);
+
+            for(i = 0; pRecords != NULL && i < length; i += count){
+                count = sl_read(pSegmentLog, firstEvent + i, pRecords, length - i < MECHATRONIC_READ_CHUNK ? length - i : MECHATRONIC_READ_CHUNK);
+
+                if(count <= 0)
+                    break;
+
+                for(j = 0; j < count; j++)
+                    ti_add(pTimeIndex, mechatronic_getRecordTimestamp(pRecords + (size_t)MECHATRONIC_RECORD_SIZE * j), firstEvent + i + j);
+            }
+
+            free(pRecords);
+        }
+    }
+}
+
+/**
+ * \brief Reads from the binary file the records of a time range, using the time index to seek straight to the first
+ *        bucket of the range. Records are expected in chronological order, the scan stops at the first record after the range.
+ *        Records of segments already dropped by the retention are skipped, the scan also stops at a damaged record
+ * \param long long from start of the range in seconds since the epoch
+ * \param long long to end of the range in seconds since the epoch, included
+ * \return ArrayList *pArrayList typed array list with a copy of the records of the range
+ *                  - (NULL) if error [if the index is not open or can't allocate memory]
+ */
+ArrayList *mechatronic_queryRange(long long from, long long to)
+{
+    int i;
+    int count;
+    int first;
+    int stop = 0;
+    Mechatronic record;
+    Mechatronic *pPrevious = NULL;
+    ArrayList *pArrayList = NULL;
+    unsigned char *pRecords = NULL;
+
+    first = ti_find(pTimeIndex, from);
+
+    if(first >= 0 && pSegmentLog != NULL)
+        pArrayList = al_newTypedArrayList(sizeof(Mechatronic));
+
+    if(pArrayList != NULL && from <= to){
+        pRecords = (unsigned char*)malloc(MECHATRONIC_RECORD_SIZE * MECHATRONIC_READ_CHUNK);
+
+        // el indice puede apuntar a registros de segmentos ya borrados
+        if(first < sl_getFirst(pSegmentLog))
+            first = sl_getFirst(pSegmentLog);
+
+        if(pRecords != NULL){
+            while(!stop && (count = sl_read(pSegmentLog, first, pRecords, MECHATRONIC_READ_CHUNK)) > 0){
+                first += count;
+
+                for(i = 0; i < count && !stop; i++){
+                    mechatronic_decodeRecord(pRecords + (size_t)MECHATRONIC_RECORD_SIZE * i, &record, pPrevious);
+
+                    if(record.timestamp > to || !mechatronic_isValidRecord(pRecords + (size_t)MECHATRONIC_RECORD_SIZE * i))
+                        stop = 1;
+
+                    else if(record.timestamp >= from){
+                        al_add(pArrayList, &record);
+                        pPrevious = al_get(pArrayList, al_len(pArrayList) - 1);
+                    }
+                }
+            }
+        }
+
+        free(pRecords);
+    }
+
+    return pArrayList;
+}
+
+/**
+ * \brief Loads the binary file into the event store without keeping every event in memory. Only the segment being
+ *        written is checked: every sealed segment was checked while it was being written and the manifest keeps its
+ *        number of records, so they are taken as they are and their statistics are gathered the first time they are
+ *        requested. The segment being written is mapped and split in chunks of records that the threads of a worker
+ *        pool check at the same time, gathering the statistics of each chunk. The events up to the first damaged
+ *        record become the history of the store, read in pages when they are needed, and the ones of the last
+ *        incomplete page are kept in memory
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value number of segments loaded completely, if it is less than the number of segments the next one
+ *                   can't be read or has a damaged record
+ */
+int mechatronic_loadBinaryFile(PagedStore *pPagedStore)
+{
+    int i;
+    int j;
+    int count;
+    int first;
+    int records;
+    int value = 0;
+    int length = 0;
+    int stored;
+    int position;
+    int chunkCount;
+    int damaged = 0;
+    EventStats stats;
+    Segment *pActive = NULL;
+    LoadedSegment *pSegments = NULL;
+    LoadChunk *pChunks = NULL;
+    LoadChunk *pAux = NULL;
+    Mechatronic *pEvents = NULL;
+    WorkerPool *pWorkerPool = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    count = sl_len(pSegmentLog);
+    firstEvent = sl_getFirst(pSegmentLog);
+    pSegments = (LoadedSegment*)calloc(count > 0 ? count : 1, sizeof(LoadedSegment));
+    mechatronic_resetStats(&stats);
+
+    // las columnas se reservan una sola vez para todo el historial
+    if(pColumnStore != NULL && cs_reserve(pColumnStore, pSegmentLog->next - firstEvent) != 0)
+        mechatronic_showErrorMessage();
+
+    // los segmentos sellados no se recorren, el primer evento del segmento activo dice cuantos tienen
+    if(count > 0){
+        pActive = al_get(pSegmentLog->pSegments, count - 1);
+        value = count - 1;
+        length = pActive->first - firstEvent;
+    }
+
+    while(pSegments != NULL && !damaged && value < count){
+        first = value;
+        records = 0;
+        chunkCount = 0;
+
+        // se mapean segmentos hasta completar el lote, asi la memoria no depende del largo del historial
+        for(i = first; i < count && (i == first || records < MECHATRONIC_LOAD_BATCH); i++){
+            if(sl_getFileName(pSegmentLog, i, fileName, sizeof(fileName)) != 0 || mechatronic_openSegment(&pSegments[i], fileName) != 0)
+                break;
+
+            chunkCount += (pSegments[i].count + MECHATRONIC_LOAD_CHUNK - 1) / MECHATRONIC_LOAD_CHUNK;
+            records += pSegments[i].count;
+        }
+
+        damaged = i == first;
+        pAux = (LoadChunk*)realloc(pChunks, sizeof(LoadChunk) * (chunkCount > 0 ? chunkCount : 1));
+
+        if(pAux != NULL){
+            pChunks = pAux;
+            pWorkerPool = wp_newWorkerPool(mechatronic_getLoadThreads(chunkCount));
+        }
+
+        if(pAux != NULL && pWorkerPool != NULL){
+            chunkCount = 0;
+            position = length;
+
+            for(value = first; value < i; value++){
+                for(j = 0; j < pSegments[value].count; j += MECHATRONIC_LOAD_CHUNK){
+                    pChunks[chunkCount].pRecords = pSegments[value].pRecords + (size_t)MECHATRONIC_RECORD_SIZE * j;
+                    pChunks[chunkCount].count = pSegments[value].count - j < MECHATRONIC_LOAD_CHUNK ? pSegments[value].count - j : MECHATRONIC_LOAD_CHUNK;
+                    pChunks[chunkCount].segment = value;
+
+                    // las columnas reciben los eventos del bloque en su posicion, desde varios hilos
+                    pChunks[chunkCount].first = position;
+                    position += pChunks[chunkCount].count;
+                    chunkCount++;
+                }
+            }
+
+            wp_run(pWorkerPool, mechatronic_scanChunk, pChunks, chunkCount);
+            wp_deleteWorkerPool(pWorkerPool);
+
+            // los eventos se cuentan en orden hasta el primer registro danado
+            for(j = 0; j < chunkCount && !damaged; j++){
+                length += pChunks[j].length;
+                mechatronic_mergeStats(&stats, &pChunks[j].stats);
+
+                if(pChunks[j].length < pChunks[j].count){
+                    value = pChunks[j].segment;
+                    damaged = 1;
+                }
+            }
+        }
+        else{
+            mechatronic_showErrorMessage();
+            value = first;
+            damaged = 1;
+        }
+
+        for(j = first; j < i; j++)
+            mechatronic_closeSegment(&pSegments[j]);
+    }
+
+    // solo la ultima pagina incompleta queda en memoria, el resto se lee cuando se necesita
+    stored = length - length % MECHATRONIC_PAGE_EVENTS;
+    ps_setStored(pPagedStore, stored);
+
+    // los eventos residentes vuelven a las columnas a traves del hook, como los eventos nuevos
+    cs_resize(pColumnStore, stored);
+    pEvents = (Mechatronic*)al_reserveTail(pPagedStore->pResident, length - stored);
+
+    if(pEvents != NULL)
+        al_addReserved(pPagedStore->pResident, mechatronic_loadPage(NULL, stored, pEvents, length - stored));
+
+    // las estadisticas del recorrido ya incluyen a los eventos en memoria, las de los sellados se juntan al pedirlas
+    eventStats = stats;
+    statsOutdated = pActive != NULL && pActive->first > firstEvent;
+
+    free(pSegments);
+    free(pChunks);
+
+    return value;
+}
+
+/**
+ * \brief Reads a page of the history of the event store from the binary file and decodes its records, up to the
+ *        first damaged record. It is the function that loads the pages of the event store
+ * \param void *pContext pointer to the MachineShard whose log is read - (NULL) for the main binary file
+ * \param int first index in the store of the first event of the page
+ * \param void *pElements pointer to an array of count structures Mechatronic
+ * \param int count number of events to read
+ * \return int value number of events read, (0) if the records can't be read or were dropped by the retention
+ */
+int mechatronic_loadPage(void *pContext, int first, void *pElements, int count)
+{
+    int i;
+    int length = 0;
+    Mechatronic *pEvents = (Mechatronic*)pElements;
+    MachineShard *pShard = (MachineShard*)pContext;
+    unsigned char *pRecords = NULL;
+
+    pRecords = (unsigned char*)malloc((size_t)MECHATRONIC_RECORD_SIZE * count + 1);
+
+    if(pRecords != NULL && pShard != NULL)
+        length = sl_read(pShard->pSegmentLog, pShard->firstEvent + first, pRecords, count);
+
+    else if(pRecords != NULL)
+        length = sl_read(pSegmentLog, firstEvent + first, pRecords, count);
+
+    for(i = 0; i < length && mechatronic_isValidRecord(pRecords + (size_t)MECHATRONIC_RECORD_SIZE * i); i++){
+        mechatronic_decodeRecord(pRecords + (size_t)MECHATRONIC_RECORD_SIZE * i, &pEvents[i], i > 0 ? &pEvents[i - 1] : NULL);
+        pEvents[i].idMachine = pShard != NULL ? pShard->idMachine : 0;
+    }
+
+    free(pRecords);
+
+    return i;
+}
+
+/**
+ * \brief Gets the number of pages of the history of the event store that fit in a memory limit
+ * \param int megabytes memory limit in megabytes
+ * \return int value number of pages, at least 1
+ */
+int mechatronic_getCachePages(int megabytes)
+{
+    long long value = (long long)megabytes * 1024 * 1024 / ((long long)MECHATRONIC_PAGE_EVENTS * sizeof(Mechatronic));
+
+    return value > 0 ? (int)value : 1;
+}
+
+/**
+ * \brief Gets the number of threads used to load the binary file, one for every processor but never more than the
+ *        number of chunks to check
+ * \param int chunkCount number of chunks of records to check
+ * \return int value number of threads, at least 1
+ */
+int mechatronic_getLoadThreads(int chunkCount)
+{
+    int value = MECHATRONIC_LOAD_THREADS > 0 ? MECHATRONIC_LOAD_THREADS : wp_getProcessors();
+
+    if(value > chunkCount)
+        value = chunkCount;
+
+    return value > 0 ? value : 1;
+}
+
+/**
+ * \brief Checks the records of a chunk of a segment and gathers their statistics, up to the first damaged record.
+ *        It is the task of the worker pool that loads the binary file
+ * \param void *pContext pointer to the array of chunks
+ * \param int index position of the chunk in the array
+ * \return void
+ */
+void mechatronic_scanChunk(void *pContext, int index)
+{
+    int i;
+    Mechatronic records[2];
+    LoadChunk *pChunk = (LoadChunk*)pContext + index;
+    unsigned char *pRecord = pChunk->pRecords;
+
+    mechatronic_resetStats(&pChunk->stats);
+
+    // se alternan dos estructuras para reutilizar la fecha del registro anterior
+    for(i = 0; i < pChunk->count && mechatronic_isValidRecord(pRecord); i++, pRecord += MECHATRONIC_RECORD_SIZE){
+        mechatronic_decodeRecord(pRecord, &records[i % 2], i > 0 ? &records[(i + 1) % 2] : NULL);
+        mechatronic_updateStats(&pChunk->stats, &records[i % 2]);
+        cs_set(pColumnStore, pChunk->first + i, records[i % 2].timestamp, records[i % 2].eventType, toHundredths(records[i % 2].ambientTemperatureRead, MECHATRONIC_MIN_AMBIENT_HUNDREDTHS, MECHATRONIC_MAX_AMBIENT_HUNDREDTHS), records[i % 2].humidityTemperatureRead, records[i % 2].idEmployee);
+    }
+
+    pChunk->length = i;
+}
+
+/**
+ * \brief Opens a segment of the binary file to load it, mapping it in memory or reading it whole depending on
+ *        MECHATRONIC_LOADER. If the file can't be mapped it is read instead
+ * \param LoadedSegment *pSegment pointer to the segment to set
+ * \param char *fileName path of the segment
+ * \return int value return (-1) if error [can't read the file or its header is not valid]
+ *                           (0) if ok
+ */
+int mechatronic_openSegment(LoadedSegment *pSegment, char *fileName)
+{
+    int value = -1;
+    MappedFile *pMappedFile = NULL;
+
+    memset(pSegment, 0, sizeof(LoadedSegment));
+
+    if(MECHATRONIC_LOADER == MECHATRONIC_LOADER_MMAP)
+        pMappedFile = mf_newMappedFile(fileName);
+
+    if(pMappedFile != NULL){
+        pSegment->pMappedFile = pMappedFile;
+
+        if(pMappedFile->size >= MECHATRONIC_FILE_HEADER_SIZE && mechatronic_checkFileHeader(pMappedFile->pData)){
+            pSegment->pRecords = (unsigned char*)pMappedFile->pData + MECHATRONIC_FILE_HEADER_SIZE;
+            pSegment->count = (pMappedFile->size - MECHATRONIC_FILE_HEADER_SIZE) / MECHATRONIC_RECORD_SIZE;
+            value = 0;
+        }
+    }
+    else
+        value = mechatronic_readSegment(pSegment, fileName);
+
+    if(value != 0)
+        mechatronic_closeSegment(pSegment);
+
+    return value;
+}
+
+/**
+ * \brief Reads every record of a segment of the binary file into a buffer of the segment
+ * \param LoadedSegment *pSegment pointer to the segment to set
+ * \param char *fileName path of the segment
+ * \return int value return (-1) if error [can't read the file, its header is not valid or can't allocate memory]
+ *                           (0) if ok
+ */
+int mechatronic_readSegment(LoadedSegment *pSegment, char *fileName)
+{
+    long size;
+    int value = -1;
+    FILE *file = NULL;
+    unsigned char header[MECHATRONIC_FILE_HEADER_SIZE];
+
+    file = fopen(fileName, "rb");
+
+    if(file != NULL){
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+
+        if(fread(header, MECHATRONIC_FILE_HEADER_SIZE, 1, file) == 1 && mechatronic_checkFileHeader(header)){
+            pSegment->count = (size - MECHATRONIC_FILE_HEADER_SIZE) / MECHATRONIC_RECORD_SIZE;
+            pSegment->pBuffer = (unsigned char*)malloc((size_t)MECHATRONIC_RECORD_SIZE * pSegment->count + 1);
+
+            if(pSegment->pBuffer != NULL && fread(pSegment->pBuffer, MECHATRONIC_RECORD_SIZE, pSegment->count, file) == (size_t)pSegment->count){
+                pSegment->pRecords = pSegment->pBuffer;
+                value = 0;
+            }
+        }
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Releases the memory of a segment opened with mechatronic_openSegment
+ * \param LoadedSegment *pSegment pointer to the segment
+ * \return void
+ */
+void mechatronic_closeSegment(LoadedSegment *pSegment)
+{
+    mf_deleteMappedFile(pSegment->pMappedFile);
+    free(pSegment->pBuffer);
+    memset(pSegment, 0, sizeof(LoadedSegment));
+}
+
+/**
+ * \brief Checks if the binary file has the legacy layout, a raw copy of the mechatronic structures without header
+ * \return int value 1 if the file exists, is not empty and does not begin with the magic of the format - 0 if not
+ */
+int mechatronic_isLegacyBinaryFile(void)
+{
+    int value = 0;
+    FILE *file = NULL;
+    unsigned char header[MECHATRONIC_FILE_HEADER_SIZE];
+
+    file = fopen(MECHATRONIC_BINARY_FILE, "rb");
+
+    if(file != NULL){
+        if(fread(header, 1, MECHATRONIC_FILE_HEADER_SIZE, file) > 0 && memcmp(header, MECHATRONIC_FILE_MAGIC, 4))
+            value = 1;
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Rewrites a binary file with the legacy layout with the current format. Records with an invalid date or
+ *        event type, or with values that don't fit in a record, are left out. The original file is only replaced
+ *        once the converted one is complete and on disk
+ * \param int *pDiscarded pointer where the number of bytes of an incomplete record at the end is written
+ * \param int *pInvalid pointer where the number of records left out is written
+ * \return int value return (-1) if error [can't read, write or replace the file], the original file is kept
+ *                           (0) if ok
+ */
+int mechatronic_importLegacyBinaryFile(int *pDiscarded, int *pInvalid)
+{
+    int value = -1;
+    FILE *file = NULL;
+    FILE *target = NULL;
+    Mechatronic record;
+    LegacyMechatronic legacy;
+    unsigned char buffer[MECHATRONIC_FILE_HEADER_SIZE > MECHATRONIC_RECORD_SIZE ? MECHATRONIC_FILE_HEADER_SIZE : MECHATRONIC_RECORD_SIZE];
+
+    *pDiscarded = 0;
+    *pInvalid = 0;
+    file = fopen(MECHATRONIC_BINARY_FILE, "rb");
+
+    // el archivo convertido se escribe aparte y solo reemplaza al original si se completo
+    if(file != NULL)
+        target = fopen(MECHATRONIC_BINARY_FILE_TEMP, "wb");
+
+    if(target != NULL){
+        mechatronic_encodeFileHeader(buffer, 0);
+
+        if(fwrite(buffer, MECHATRONIC_FILE_HEADER_SIZE, 1, target) == 1)
+            value = 0;
+
+        while(value == 0 && fread(&legacy, sizeof(LegacyMechatronic), 1, file) == 1){
+            mechatronic_decodeLegacyRecord(&legacy, &record);
+
+            // un registro con fecha o valores imposibles no se convierte, se cuenta
+            if(!isValidLegacyDate(&legacy.today) || record.timestamp == -1 || !mechatronic_isStorableEvent(&record))
+                (*pInvalid)++;
+            else{
+                mechatronic_encodeRecord(&record, buffer);
+
+                if(fwrite(buffer, MECHATRONIC_RECORD_SIZE, 1, target) != 1)
+                    value = -1;
+            }
+        }
+
+        if(ferror(file))
+            value = -1;
+        else
+            *pDiscarded = ftell(file) % sizeof(LegacyMechatronic);
+
+        fclose(file);
+        file = NULL;
+        value = replaceBinaryFile(target, value);
+    }
+
+    if(file != NULL)
+        fclose(file);
+
+    return value;
+}
+
+/**
+ * \brief Rewrites a binary file with the previous version of the format, whose records are the current ones without
+ *        the checksum, adding the checksum to every record. Other files are left untouched. The original file is
+ *        only replaced once the converted one is complete and on disk
+ * \param int *pDiscarded pointer where the number of bytes of an incomplete record at the end is written
+ * \return int value return (-1) if error [can't read, write or replace the file], the original file is kept
+ *                           (0) if ok or the file has not the previous format
+ */
+int mechatronic_upgradeBinaryFile(int *pDiscarded)
+{
+    int value = 0;
+    long size;
+    FILE *file = NULL;
+    FILE *target = NULL;
+    unsigned char header[MECHATRONIC_FILE_HEADER_SIZE];
+    unsigned char record[MECHATRONIC_RECORD_SIZE];
+
+    *pDiscarded = 0;
+    file = fopen(MECHATRONIC_BINARY_FILE, "rb");
+
+    if(file != NULL && fread(header, MECHATRONIC_FILE_HEADER_SIZE, 1, file) == 1 && !memcmp(header, MECHATRONIC_FILE_MAGIC, 4) &&
+       getInteger(header + 4, 2) == MECHATRONIC_PREVIOUS_VERSION && getInteger(header + 8, 2) == MECHATRONIC_PREVIOUS_RECORD_SIZE){
+        value = -1;
+
+        // el archivo convertido se escribe aparte y solo reemplaza al original si se completo
+        target = fopen(MECHATRONIC_BINARY_FILE_TEMP, "wb");
+
+        if(target != NULL){
+            mechatronic_encodeFileHeader(header, 0);
+
+            if(fwrite(header, MECHATRONIC_FILE_HEADER_SIZE, 1, target) == 1)
+                value = 0;
+
+            while(value == 0 && fread(record, MECHATRONIC_PREVIOUS_RECORD_SIZE, 1, file) == 1){
+                putInteger(record + MECHATRONIC_CHECKSUM_OFFSET, crc_checksum(record, MECHATRONIC_CHECKSUM_OFFSET), 4);
+
+                if(fwrite(record, MECHATRONIC_RECORD_SIZE, 1, target) != 1)
+                    value = -1;
+            }
+
+            size = ftell(file);
+
+            if(ferror(file) || size < 0)
+                value = -1;
+            else
+                *pDiscarded = (size - MECHATRONIC_FILE_HEADER_SIZE) % MECHATRONIC_PREVIOUS_RECORD_SIZE;
+
+            fclose(file);
+            file = NULL;
+            value = replaceBinaryFile(target, value);
+        }
+    }
+
+    if(file != NULL)
+        fclose(file);
+
+    return value;
+}
+
+/**
+ * \brief Checks the checksum of consecutive records of the binary file
+ * \param unsigned char *pRecords pointer to the first record
+ * \param int count number of records
+ * \return int i position of the first damaged record - count if every record is valid
+ */
+int mechatronic_checkRecords(unsigned char *pRecords, int count)
+{
+    int i;
+
+    for(i = 0; i < count && mechatronic_isValidRecord(pRecords + (size_t)MECHATRONIC_RECORD_SIZE * i); i++);
+
+    return i;
+}
+
+/**
+ * \brief Checks the checksum of a record of the binary file, the CRC32C of the bytes before it
+ * \param void *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \return int value 1 if the record is valid - 0 if it is damaged
+ */
+int mechatronic_isValidRecord(void *pRecord)
+{
+    unsigned char *pBytes = (unsigned char*)pRecord;
+
+    return (unsigned int)getInteger(pBytes + MECHATRONIC_CHECKSUM_OFFSET, 4) == crc_checksum(pBytes, MECHATRONIC_CHECKSUM_OFFSET);
+}
+
+/**
+ * \brief Checks that every value of an event fits in a record of the binary file: finite temperatures within the
+ *        limits of their fields, humidity and threshold within their sizes and a known event type. The values that
+ *        don't fit are stored clamped to the nearest limit, NaN as 0
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return int value 1 if the event is stored as it is - 0 if not
+ */
+int mechatronic_isStorableEvent(Mechatronic *this)
+{
+    return fitsHundredths(this->ambientTemperatureRead, MECHATRONIC_MIN_AMBIENT_HUNDREDTHS, MECHATRONIC_MAX_AMBIENT_HUNDREDTHS) &&
+           fitsHundredths(this->temperatureEngineOn, MECHATRONIC_MIN_ENGINE_HUNDREDTHS, MECHATRONIC_MAX_ENGINE_HUNDREDTHS) &&
+           fitsHundredths(this->temperatureEngineOff, MECHATRONIC_MIN_ENGINE_HUNDREDTHS, MECHATRONIC_MAX_ENGINE_HUNDREDTHS) &&
+           this->humidityTemperatureRead >= 0 && this->humidityTemperatureRead <= USHRT_MAX && this->humidityThreshold >= 0 &&
+           this->humidityThreshold <= UCHAR_MAX && (int)this->eventType >= 0 && this->eventType < EVENT_TYPE_COUNT;
+}
+
+/**
+ * \brief Writes the header of the binary file: magic, version, header size, record size and the ID of the machine
+ *        of every record of the file
+ * \param unsigned char *pHeader buffer of MECHATRONIC_FILE_HEADER_SIZE bytes
+ * \param int idMachine ID of the machine, 0 for the main binary file
+ * \return void
+ */
+void mechatronic_encodeFileHeader(unsigned char *pHeader, int idMachine)
+{
+    memset(pHeader, 0, MECHATRONIC_FILE_HEADER_SIZE);
+    memcpy(pHeader, MECHATRONIC_FILE_MAGIC, 4);
+    putInteger(pHeader + 4, MECHATRONIC_FILE_VERSION, 2);
+    putInteger(pHeader + 6, MECHATRONIC_FILE_HEADER_SIZE, 2);
+    putInteger(pHeader + 8, MECHATRONIC_RECORD_SIZE, 2);
+    putInteger(pHeader + MECHATRONIC_MACHINE_OFFSET, idMachine, 2);
+}
+
+/**
+ * \brief Checks the header of the binary file
+ * \param unsigned char *pHeader buffer of MECHATRONIC_FILE_HEADER_SIZE bytes
+ * \return int value 1 if the magic, version and sizes match the current format - 0 if not
+ */
+int mechatronic_checkFileHeader(unsigned char *pHeader)
+{
+    return !memcmp(pHeader, MECHATRONIC_FILE_MAGIC, 4) && getInteger(pHeader + 4, 2) == MECHATRONIC_FILE_VERSION &&
+           getInteger(pHeader + 6, 2) == MECHATRONIC_FILE_HEADER_SIZE && getInteger(pHeader + 8, 2) == MECHATRONIC_RECORD_SIZE;
+}
+
+/**
+ * \brief Encodes a mechatronic structure as a record of the binary file. Every field is stored in little endian:
+ *        timestamp (8 bytes), employee ID (4), ambient temperature in hundredths of degree (4), engine start and
+ *        engine off temperatures in hundredths of degree (2 + 2), humidity (2), humidity threshold (1), event type code (1)
+ *        and the CRC32C of the previous bytes (4). Temperatures that don't fit are clamped, see
+ *        mechatronic_isStorableEvent
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param unsigned char *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \return void
+ */
+void mechatronic_encodeRecord(Mechatronic *this, unsigned char *pRecord)
+{
+    putInteger(pRecord, this->timestamp, 8);
+    putInteger(pRecord + 8, this->idEmployee, 4);
+    putInteger(pRecord + 12, toHundredths(this->ambientTemperatureRead, MECHATRONIC_MIN_AMBIENT_HUNDREDTHS, MECHATRONIC_MAX_AMBIENT_HUNDREDTHS), 4);
+    putInteger(pRecord + 16, toHundredths(this->temperatureEngineOn, MECHATRONIC_MIN_ENGINE_HUNDREDTHS, MECHATRONIC_MAX_ENGINE_HUNDREDTHS), 2);
+    putInteger(pRecord + 18, toHundredths(this->temperatureEngineOff, MECHATRONIC_MIN_ENGINE_HUNDREDTHS, MECHATRONIC_MAX_ENGINE_HUNDREDTHS), 2);
+    putInteger(pRecord + 20, this->humidityTemperatureRead, 2);
+    putInteger(pRecord + 22, this->humidityThreshold, 1);
+    putInteger(pRecord + 23, this->eventType, 1);
+    putInteger(pRecord + MECHATRONIC_CHECKSUM_OFFSET, crc_checksum(pRecord, MECHATRONIC_CHECKSUM_OFFSET), 4);
+}
+
+/**
+ * \brief Decodes a record of the binary file into a mechatronic structure
+ * \param unsigned char *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param Mechatronic *pPrevious pointer to the record decoded before, its date is reused when both records belong
+ *        to the same hour. (NULL) if there is no previous record
+ * \return void
+ */
+void mechatronic_decodeRecord(unsigned char *pRecord, Mechatronic *this, Mechatronic *pPrevious)
+{
+    memset(this, 0, sizeof(Mechatronic));
+
+    mechatronic_setTimestamp(this, getInteger(pRecord, 8), pPrevious);
+    this->idEmployee = (int)getInteger(pRecord + 8, 4);
+    this->ambientTemperatureRead = (int)getInteger(pRecord + 12, 4) / 100.0f;
+    this->temperatureEngineOn = (short)getInteger(pRecord + 16, 2) / 100.0f;
+    this->temperatureEngineOff = (short)getInteger(pRecord + 18, 2) / 100.0f;
+    this->humidityTemperatureRead = (unsigned short)getInteger(pRecord + 20, 2);
+    this->humidityThreshold = (unsigned char)getInteger(pRecord + 22, 1);
+    this->eventType = (EventType)getInteger(pRecord + 23, 1);
+
+    if(this->idEmployee == ID_EMPLOYEE)
+        strcpy(this->nameSurname, EMPLOYEE_NAME);
+}
+
+/**
+ * \brief Gets the time of a record of the binary file without decoding the rest of it
+ * \param void *pRecord buffer of MECHATRONIC_RECORD_SIZE bytes
+ * \return long long value time of the record in seconds since the epoch
+ */
+long long mechatronic_getRecordTimestamp(void *pRecord)
+{
+    return getInteger((unsigned char*)pRecord, 8);
+}
+
+/**
+ * \brief Converts a record with the legacy layout into a mechatronic structure
+ * \param LegacyMechatronic *pLegacy pointer to the legacy record
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return void
+ */
+void mechatronic_decodeLegacyRecord(LegacyMechatronic *pLegacy, Mechatronic *this)
+{
+    struct tm date;
+
+    memset(this, 0, sizeof(Mechatronic));
+    memset(&date, 0, sizeof(date));
+
+    date.tm_mday = pLegacy->today.day;
+    date.tm_mon = pLegacy->today.month - 1;
+    date.tm_year = pLegacy->today.year - 1900;
+    date.tm_hour = pLegacy->today.hour;
+    date.tm_min = pLegacy->today.minutes;
+    date.tm_sec = pLegacy->today.seconds;
+    date.tm_isdst = -1;
+
+    this->today = pLegacy->today;
+    this->timestamp = mktime(&date);
+    this->idEmployee = pLegacy->idEmployee;
+    this->ambientTemperatureRead = pLegacy->ambientTemperatureRead;
+    this->humidityTemperatureRead = pLegacy->humidityTemperatureRead;
+    this->temperatureEngineOn = pLegacy->temperatureEngineOn;
+    this->temperatureEngineOff = pLegacy->temperatureEngineOff;
+    this->humidityThreshold = pLegacy->humidityThreshold;
+    this->eventType = mechatronic_getEventTypeCode(pLegacy->eventType);
+
+    if(this->idEmployee == ID_EMPLOYEE)
+        strcpy(this->nameSurname, EMPLOYEE_NAME);
+}
+
+/**
+ * \brief Sets the timestamp of the structure and the date that corresponds to it in local time
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param long long timestamp seconds since the epoch
+ * \param Mechatronic *pPrevious pointer to a structure with a date already set, it is reused when both timestamps
+ *        belong to the same hour to avoid the conversion. (NULL) to always convert
+ * \return void
+ */
+void mechatronic_setTimestamp(Mechatronic *this, long long timestamp, Mechatronic *pPrevious)
+{
+    long long hourStart;
+    int converted;
+    time_t now = (time_t)timestamp;
+    struct tm date;
+
+    this->timestamp = timestamp;
+
+    if(pPrevious != NULL)
+        hourStart = pPrevious->timestamp - pPrevious->today.minutes * 60 - pPrevious->today.seconds;
+
+    if(pPrevious != NULL && timestamp >= hourStart && timestamp < hourStart + 3600){
+        this->today = pPrevious->today;
+        this->today.minutes = (int)(timestamp - hourStart) / 60;
+        this->today.seconds = (int)(timestamp - hourStart) % 60;
+    }
+    else{
+        // la carga del archivo binario convierte fechas desde varios hilos a la vez
+#ifdef _WIN32
+        converted = localtime_s(&date, &now) == 0;
+#else
+        converted = localtime_r(&now, &date) != NULL;
+#endif
+
+        if(converted){
+            this->today.day = date.tm_mday;
+            this->today.month = date.tm_mon + 1;
+            this->today.year = date.tm_year + 1900;
+            this->today.hour = date.tm_hour;
+            this->today.minutes = date.tm_min;
+            this->today.seconds = date.tm_sec;
+        }
+    }
+}
+
+/**
+ * \brief Gets the event type that corresponds to a name
+ * \param char *eventName name of the event type
+ * \return EventType value the event type - EVENT_UNKNOWN if the name is not valid
+ */
+EventType mechatronic_getEventTypeCode(char *eventName)
+{
+    int i;
+    EventType value = EVENT_UNKNOWN;
+
+    for(i = 0; i < EVENT_TYPE_COUNT; i++){
+        if(!strcmp(eventName, eventTypeNames[i])){
+            value = (EventType)i;
+            break;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Gets the name of an event type, only used to render the reports
+ * \param EventType eventType the event type
+ * \return char *value name of the event type - empty string if the event type is not valid
+ */
+char *mechatronic_getEventTypeName(EventType eventType)
+{
+    return eventType >= 0 && eventType < EVENT_TYPE_COUNT ? eventTypeNames[eventType] : "";
+}
+
+/**
+ * \brief Appends a new record to the end of the binary event log, starting a new segment when the current one is full
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return void
+ */
+void mechatronic_saveBinaryFile(Mechatronic *this)
+{
+    int number = pSegmentLog != NULL ? pSegmentLog->next : 0;
+    unsigned char record[MECHATRONIC_RECORD_SIZE];
+
+    mechatronic_encodeRecord(this, record);
+
+    if(sl_append(pSegmentLog, record) != 0){
+        tm_clear();
+        printf("\nERROR!, no se pudo abrir el archivo: %s.\nDatos sin guardar.\n", MECHATRONIC_MANIFEST_FILE);
+        tm_pause();
+    }
+
+    // si el indice no se pudo actualizar se reconstruye al iniciar el programa
+    if(pSegmentLog != NULL && pSegmentLog->next > number)
+        ti_add(pTimeIndex, this->timestamp, number);
+}
+
+/**
+ * \brief Sets a mechatronic structure for a reading received from a sensor and classifies it with the current
+ *        configuration. The date is left for mechatronic_saveEvents
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param float temperature ambient temperature read
+ * \param int humidity ambient humidity read
+ * \param long long timestamp time of the reading in seconds since the epoch
+ * \return void
+ */
+void mechatronic_newReading(Mechatronic *this, float temperature, int humidity, long long timestamp)
+{
+    memset(this, 0, sizeof(Mechatronic));
+
+    this->timestamp = timestamp;
+    mechatronic_setIdEmployee(this);
+    mechatronic_setNameSurname(this);
+    mechatronic_setThresholds(this);
+    mechatronic_setAmbientTemperatureRead(this, temperature);
+    mechatronic_setAmbientHumidityRead(this, humidity);
+    mechatronic_setEventType(this);
+}
+
+/**
+ * \brief Sets a block of mechatronic structures for readings received from the sensors of a machine and classifies
+ *        them together with the thresholds of the machine. The dates are left for mechatronic_saveEvents
+ * \param Mechatronic *pEvents pointer to the first structure Mechatronic
+ * \param int idMachine ID of the machine, 0 for the main machine
+ * \param float *pTemperatures pointer to the ambient temperatures read
+ * \param int *pHumidities pointer to the ambient humidities read
+ * \param int count number of readings
+ * \param long long timestamp time of the readings in seconds since the epoch
+ * \return int value return (-1) if error [NULL pointer, invalid machine or invalid count]
+ *                           (0) if ok
+ */
+int mechatronic_newReadings(Mechatronic *pEvents, int idMachine, float *pTemperatures, int *pHumidities, int count, long long timestamp)
+{
+    int i;
+    int j;
+    int length;
+    int value = -1;
+    Thresholds thresholds;
+    unsigned char types[MECHATRONIC_CLASSIFY_BLOCK];
+
+    if(pEvents != NULL && pTemperatures != NULL && pHumidities != NULL && count >= 0 && mechatronic_getThresholds(idMachine, &thresholds) == 0){
+        value = 0;
+
+        for(i = 0; i < count; i++){
+            memset(pEvents + i, 0, sizeof(Mechatronic));
+
+            pEvents[i].timestamp = timestamp;
+            pEvents[i].idMachine = idMachine;
+            mechatronic_setIdEmployee(pEvents + i);
+            mechatronic_setNameSurname(pEvents + i);
+            pEvents[i].temperatureEngineOn = thresholds.temperatureEngineOn;
+            pEvents[i].temperatureEngineOff = thresholds.temperatureEngineOff;
+            pEvents[i].humidityThreshold = thresholds.humidityThreshold;
+            mechatronic_setAmbientTemperatureRead(pEvents + i, pTemperatures[i]);
+            mechatronic_setAmbientHumidityRead(pEvents + i, pHumidities[i]);
+        }
+
+        // todas las lecturas tienen los umbrales de la maquina, se clasifican por bloques
+        for(i = 0; i < count; i += length){
+            length = count - i < MECHATRONIC_CLASSIFY_BLOCK ? count - i : MECHATRONIC_CLASSIFY_BLOCK;
+            cl_classify(pTemperatures + i, pHumidities + i, length, thresholds.temperatureEngineOn, thresholds.temperatureEngineOff, thresholds.humidityThreshold, types);
+
+            for(j = 0; j < length; j++)
+                pEvents[i + j].eventType = types[j];
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Gets the thresholds of a machine: the ones of its own keys of the configuration file, the general ones for
+ *        the keys it has not. They are read from the last published configuration without locks, so any thread can
+ *        call it while the configuration is reloaded. Every thread has its own place where it writes the epoch of the
+ *        configuration it reads, the configuration replaced is released once no thread reads it since before it was
+ *        replaced. With more than MECHATRONIC_THRESHOLD_READERS threads the ones left read it with the mutex
+ * \param int idMachine ID of the machine, 0 for the main machine
+ * \param Thresholds *pThresholds pointer where the thresholds are written
+ * \return int value return (-1) if error [pThresholds is NULL pointer or invalid machine]
+ *                           (0) if ok
+ */
+int mechatronic_getThresholds(int idMachine, Thresholds *pThresholds)
+{
+    int value = -1;
+    ThresholdSnapshot *pSnapshot = NULL;
+    ThresholdReader *pReader = NULL;
+
+    if(pThresholds != NULL && idMachine >= 0 && idMachine < MECHATRONIC_MAX_MACHINES){
+        pReader = joinThresholds();
+
+        if(pReader != NULL){
+            // la epoca se publica antes de tomar la configuracion, solo se escribe la linea de cache del hilo
+            __atomic_store_n(&pReader->epoch, __atomic_load_n(&thresholdEpoch, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            pSnapshot = __atomic_load_n(&pThresholdSnapshot, __ATOMIC_ACQUIRE);
+            *pThresholds = pSnapshot->machines[idMachine];
+            __atomic_store_n(&pReader->epoch, 0, __ATOMIC_RELEASE);
+        }
+        else{
+            pthread_mutex_lock(&thresholdsMutex);
+            *pThresholds = pThresholdSnapshot->machines[idMachine];
+            pthread_mutex_unlock(&thresholdsMutex);
+        }
+
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reads the thresholds of the configuration file again and publishes them for the readings classified from
+ *        then on, without stopping the threads that classify. The three general thresholds must be in the file with
+ *        valid values, a file saved halfway is not published. The other keys are only read when the program starts
+ *        or from the menu
+ * \param char *fileName configuration file
+ * \return int value return (-1) if error [fileName is NULL pointer, the file can't be read, a general threshold is
+ *                                        missing or invalid or can't allocate memory], the previous thresholds are kept
+ *                           (version of the published thresholds) if ok
+ */
+int mechatronic_reloadThresholds(char *fileName)
+{
+    int value = -1;
+    FILE *file = NULL;
+    char line[MAX_STRING_CHARS];
+    Thresholds general;
+    Thresholds overrides[MECHATRONIC_MAX_MACHINES];
+    unsigned char keys[MECHATRONIC_MAX_MACHINES];
+
+    if(fileName != NULL)
+        file = fopen(fileName, "r");
+
+    if(file != NULL){
+        memset(&general, 0, sizeof(general));
+        memset(keys, 0, sizeof(keys));
+
+        while(fscanf(file, " %1023[^\n]", line) == 1){
+            line[strcspn(line, "\r")] = '\0';
+            parseThresholdLine(line, &general, overrides, keys);
+        }
+
+        // el archivo puede estar a medio guardar, sin los tres umbrales generales no se publica
+        if(!ferror(file) && keys[0] == MECHATRONIC_KEY_ALL)
+            value = publishThresholds(&general, overrides, keys);
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Stores a block of events without keeping them in memory: sets their dates, updates the statistics and
+ *        appends them to the binary file, its time index and the text report, flushing every file once per block
+ * \param Mechatronic *pEvents pointer to the first event, their timestamps must be set
+ * \param int count number of events
+ * \param char *pFailed pointer to SL_MAX_NAME_CHARS chars where the name of the file that failed is written - (NULL)
+ * \return int value return (-1) if error [pEvents is NULL pointer, invalid count or write failed]
+ *                           (0) if ok
+ */
+int mechatronic_saveEvents(Mechatronic *pEvents, int count, char *pFailed)
+{
+    return appendEvents(pSegmentLog, pTimeIndex, pReportWriter, MECHATRONIC_OUTPUT_FILE, &eventStats, pEvents, count, pFailed);
+}
+
+/**
+ * \brief Opens the shard of a machine: its own binary file split in segments, time index and text report, named
+ *        after MECHATRONIC_MACHINE_BASE. The records are checked to gather the statistics of the machine and to
+ *        rebuild the index or the report if they are missing. A shard is used by one thread at a time
+ * \param int idMachine ID of the machine, from 1 to MECHATRONIC_MAX_MACHINES - 1
+ * \return MachineShard *pAux Return (NULL) if error [invalid machine, can't open the files or allocate memory]
+ *                               - (pointer to the new shard) if ok
+ */
+MachineShard *mechatronic_openShard(int idMachine)
+{
+    int i;
+    int j;
+    int count;
+    int length = 0;
+    MachineShard *this = NULL;
+    MachineShard *pAux = NULL;
+    Mechatronic *pEvents = NULL;
+    Mechatronic *pTail = NULL;
+    PagedStore *pPagedStore = NULL;
+    unsigned char header[MECHATRONIC_FILE_HEADER_SIZE];
+
+    if(idMachine > 0 && idMachine < MECHATRONIC_MAX_MACHINES){
+        this = (MachineShard*)calloc(1, sizeof(MachineShard));
+        pEvents = (Mechatronic*)malloc(sizeof(Mechatronic) * MECHATRONIC_READ_CHUNK);
+    }
+
+    if(this != NULL && pEvents != NULL){
+        this->idMachine = idMachine;
+        sprintf(this->baseName, MECHATRONIC_MACHINE_BASE, idMachine);
+        sprintf(this->indexName, MECHATRONIC_MACHINE_INDEX_FILE, idMachine);
+        sprintf(this->outputName, MECHATRONIC_MACHINE_OUTPUT_FILE, idMachine);
+        mechatronic_resetStats(&this->stats);
+
+        // cada segmento lleva el id de la maquina en el encabezado, los registros no cambian
+        mechatronic_encodeFileHeader(header, idMachine);
+        this->pSegmentLog = sl_newSegmentLog(this->baseName, header, MECHATRONIC_FILE_HEADER_SIZE, MECHATRONIC_RECORD_SIZE, mechatronic_getRecordTimestamp, mechatronic_isValidRecord, durability);
+        this->pTimeIndex = ti_newTimeIndex(this->indexName, MECHATRONIC_INDEX_BUCKET);
+
+        if(this->pSegmentLog != NULL && sl_setSyncPolicy(this->pSegmentLog, durability, groupCommitEvents, groupCommitMillis) == 0 &&
+           sl_setRotation(this->pSegmentLog, segmentEvents, segmentDaily ? SL_DAY : 0) == 0 && sl_setRetention(this->pSegmentLog, (long long)retentionDays * SL_DAY) == 0){
+            this->firstEvent = sl_getFirst(this->pSegmentLog);
+
+            // las estadisticas de la maquina se toman de sus registros, hasta el primero danado
+            do{
+                count = mechatronic_loadPage(this, length, pEvents, MECHATRONIC_READ_CHUNK);
+
+                for(i = 0; i < count; i++)
+                    mechatronic_updateStats(&this->stats, &pEvents[i]);
+
+                length += count;
+            }while(count == MECHATRONIC_READ_CHUNK);
+
+            if(this->pTimeIndex != NULL && !ti_isValid(this->pTimeIndex, this->firstEvent + length, length > 0 ? this->stats.lastTimestamp : 0) && ti_clear(this->pTimeIndex) == 0){
+                for(i = 0; i < length; i += count){
+                    count = mechatronic_loadPage(this, i, pEvents, length - i < MECHATRONIC_READ_CHUNK ? length - i : MECHATRONIC_READ_CHUNK);
+
+                    if(count <= 0)
+                        break;
+
+                    for(j = 0; j < count; j++)
+                        ti_add(this->pTimeIndex, pEvents[j].timestamp, this->firstEvent + i + j);
+                }
+            }
+
+            // el historial se lee por paginas del registro de la maquina solo si hay que regenerar el informe
+            pPagedStore = ps_newPagedStore(sizeof(Mechatronic), MECHATRONIC_PAGE_EVENTS, 1, mechatronic_loadPage, this);
+
+            if(pPagedStore != NULL && ps_setStored(pPagedStore, length - length % MECHATRONIC_PAGE_EVENTS) == 0){
+                pTail = (Mechatronic*)al_reserveTail(pPagedStore->pResident, length % MECHATRONIC_PAGE_EVENTS);
+
+                if(pTail != NULL && al_addReserved(pPagedStore->pResident, mechatronic_loadPage(this, length - length % MECHATRONIC_PAGE_EVENTS, pTail, length % MECHATRONIC_PAGE_EVENTS)) == 0)
+                    this->pReportWriter = rw_newReportWriter(this->outputName, textFileHeader, mechatronic_formatTextFileRow, pPagedStore);
+            }
+
+            ps_deletePagedStore(pPagedStore);
+        }
+
+        if(this->pTimeIndex != NULL && this->pReportWriter != NULL)
+            pAux = this;
+        else
+            mechatronic_closeShard(this);
+    }
+    else
+        free(this);
+
+    free(pEvents);
+
+    return pAux;
+}
+
+/**
+ * \brief Stores a block of events of a machine in its shard, like mechatronic_saveEvents does with the main files
+ * \param MachineShard *this pointer to the shard
+ * \param Mechatronic *pEvents pointer to the first event, their timestamps must be set
+ * \param int count number of events
+ * \param char *pFailed pointer to SL_MAX_NAME_CHARS chars where the name of the file that failed is written - (NULL)
+ * \return int value return (-1) if error [NULL pointer, invalid count or write failed]
+ *                           (0) if ok
+ */
+int mechatronic_saveShardEvents(MachineShard *this, Mechatronic *pEvents, int count, char *pFailed)
+{
+    return this != NULL ? appendEvents(this->pSegmentLog, this->pTimeIndex, this->pReportWriter, this->outputName, &this->stats, pEvents, count, pFailed) : -1;
+}
+
+/**
+ * \brief Flushes and closes the files of the shard of a machine and releases it
+ * \param MachineShard *this pointer to the shard
+ * \return void
+ */
+void mechatronic_closeShard(MachineShard *this)
+{
+    if(this != NULL){
+        rw_deleteReportWriter(this->pReportWriter);
+        sl_deleteSegmentLog(this->pSegmentLog);
+        ti_deleteTimeIndex(this->pTimeIndex);
+        free(this);
+    }
+}
+
+/**
+ * \brief Flushes and closes the binary event log, stopping its compactor, and its time index
+ * \return void
+ */
+void mechatronic_closeBinaryFile(void)
+{
+    sl_deleteSegmentLog(pSegmentLog);
+    ti_deleteTimeIndex(pTimeIndex);
+    pSegmentLog = NULL;
+    pTimeIndex = NULL;
+}
+
+/**
+ * \brief Opens the text report for appending. If the file does not exist or its format changed, it is regenerated
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [can't open or regenerate the text file]
+ *                           (0) if ok
+ */
+int mechatronic_openTextFile(PagedStore *pPagedStore)
+{
+    pReportWriter = rw_newReportWriter(MECHATRONIC_OUTPUT_FILE, textFileHeader, mechatronic_formatTextFileRow, pPagedStore);
+
+    return pReportWriter != NULL ? 0 : -1;
+}
+
+/**
+ * \brief Appends the information of a new mechatronic structure to the text file
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \return void
+ */
+void mechatronic_createTextFile(Mechatronic *this)
+{
+    if(rw_append(pReportWriter, this) != 0){
+        tm_clear();
+        printf("\nERROR!, no se pudo escribir el archivo: %s\n", MECHATRONIC_OUTPUT_FILE);
+        tm_pause();
+    }
+}
+
+/**
+ * \brief Rewrites the whole text file from the binary file, for example after its format changed. The text file is
+ *        otherwise only appended to. It must run with the program stopped
+ * \param -
+ * \return int value return (-1) if error [can't open the binary file or can't write the text file]
+ *                           (0) if ok
+ */
+int mechatronic_regenerateTextFile(void)
+{
+    int value = -1;
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = mechatronic_newEventList();
+
+    if(mechatronic_createBinaryFile(pPagedStore) == 0){
+        if(mechatronic_openTextFile(pPagedStore) == 0 && rw_regenerate(pReportWriter, pPagedStore) == 0){
+            printf("Archivo '%s' regenerado con %d eventos.\n", MECHATRONIC_OUTPUT_FILE, ps_len(pPagedStore));
+            value = 0;
+        }
+        else
+            printf("ERROR!, no se pudo crear el archivo: %s\n", MECHATRONIC_OUTPUT_FILE);
+
+        mechatronic_closeTextFile();
+        mechatronic_closeBinaryFile();
+    }
+
+    mechatronic_deleteEventList(pPagedStore);
+
+    return value;
+}
+
+/**
+ * \brief Prints the events stored between two dates with the lines of the text file, reading from the binary file
+ *        only the records of the range found with the time index, followed by the average temperature and the
+ *        readings over the humidity threshold of the configuration file, taken from the columns of those records. It
+ *        must run with the program stopped
+ * \param char *from first date of the range, DD/MM/AAAA
+ * \param char *to last date of the range, DD/MM/AAAA, included
+ * \return int value return (-1) if error [invalid dates, can't open the binary file or can't read the records]
+ *                           (0) if ok
+ */
+int mechatronic_rangeEventsReport(char *from, char *to)
+{
+    int i;
+    int value = -1;
+    int readings;
+    int breaches;
+    float average;
+    long long first;
+    long long last;
+    Thresholds thresholds;
+    ArrayList *pEvents = NULL;
+    ColumnStore *pColumns = NULL;
+    TextFormatter *pFormatter = NULL;
+
+    if(parseReportDate(from, 0, &first) != 0 || parseReportDate(to, 1, &last) != 0 || first > last)
+        printf("ERROR!, las fechas deben tener el formato DD/MM/AAAA y la primera no puede ser posterior a la segunda.\n");
+    else if(mechatronic_openBinaryFile() != 0)
+        printf("ERROR!, no se pudo leer el archivo: %s.\n", MECHATRONIC_MANIFEST_FILE);
+    else{
+        // solo se abren el registro y el indice, los eventos del rango se leen con el indice
+        firstEvent = sl_getFirst(pSegmentLog);
+        mechatronic_openIndexFile(pSegmentLog->next - firstEvent);
+
+        pEvents = mechatronic_queryRange(first, last);
+        pFormatter = tf_newTextFormatter(RW_BUFFER_SIZE);
+
+        if(pEvents != NULL && tf_setFile(pFormatter, fileNumber(stdout)) == 0 && tf_putString(pFormatter, textFileHeader) == 0){
+            value = 0;
+
+            for(i = 0; i < al_len(pEvents) && value == 0; i++)
+                value = mechatronic_formatTextFileRow(pFormatter, al_get(pEvents, i));
+        }
+
+        if(tf_flush(pFormatter) != 0)
+            value = -1;
+
+        // las estadisticas se calculan sobre las columnas de los eventos del rango
+        if(value == 0)
+            pColumns = mechatronic_newColumns(pEvents);
+
+        if(pColumns != NULL){
+            printf("\nCantidad de eventos registrados entre el %s y el %s: %d\n", from, to, al_len(pEvents));
+            readings = mechatronic_getAverageTemperature(pColumns, first, last, &average);
+
+            if(readings > 0)
+                printf("Temperatura ambiente promedio: %.2f grados (%d lecturas)\n", average, readings);
+
+            // el umbral es el de la configuracion actual, no el de cada evento
+            if(mechatronic_reloadThresholds(MECHATRONIC_USER_CONFIG) >= 0 && mechatronic_getThresholds(0, &thresholds) == 0){
+                breaches = mechatronic_countHumidityBreaches(pColumns, first, last);
+
+                if(breaches >= 0)
+                    printf("Lecturas con humedad sobre el umbral de %d%%: %d\n", thresholds.humidityThreshold, breaches);
+            }
+            else
+                printf("No se pudo leer el umbral de humedad de '%s'.\n", MECHATRONIC_USER_CONFIG);
+        }
+        else{
+            printf("ERROR!, no se pudieron leer los eventos del archivo: %s.\n", MECHATRONIC_MANIFEST_FILE);
+            value = -1;
+        }
+
+        cs_deleteColumnStore(pColumns);
+        tf_deleteTextFormatter(pFormatter);
+        al_deleteArrayList(pEvents);
+        mechatronic_closeBinaryFile();
+    }
+
+    return value;
+}
+
+/**
+ * \brief Closes the text file
+ * \return void
+ */
+void mechatronic_closeTextFile(void)
+{
+    rw_deleteReportWriter(pReportWriter);
+    pReportWriter = NULL;
+}
+
+/**
+ * \brief Renders the information of a mechatronic structure as a line of the text file. The line is the same as
+ *        the one of printf "%02d/%02d/%d %02d:%02d:%02d\t\t%d\t\t%s\t\t\t%25s\t\t\t\t%.2f..."
+ * \param TextFormatter *pFormatter formatter where the line is written
+ * \param void *pElement pointer to the structure Mechatronic
+ * \return int value return (-1) if error [a write failed]
+ *                           (0) if ok
+ */
+int mechatronic_formatTextFileRow(TextFormatter *pFormatter, void *pElement)
+{
+    int value = -1;
+    Mechatronic *this = pElement;
+    char *pChars = NULL;
+
+    // la linea se arma directamente en el buffer del informe
+    pChars = tf_reserve(pFormatter, MECHATRONIC_MAX_ROW_CHARS);
+
+    if(pChars != NULL){
+        pChars = tf_formatInteger(pChars, this->today.day, 2);
+        *pChars++ = '/';
+        pChars = tf_formatInteger(pChars, this->today.month, 2);
+        *pChars++ = '/';
+        pChars = tf_formatInteger(pChars, this->today.year, 0);
+        *pChars++ = ' ';
+        pChars = tf_formatInteger(pChars, this->today.hour, 2);
+        *pChars++ = ':';
+        pChars = tf_formatInteger(pChars, this->today.minutes, 2);
+        *pChars++ = ':';
+        pChars = tf_formatInteger(pChars, this->today.seconds, 2);
+        memcpy(pChars, "\t\t", 2);
+        pChars = tf_formatInteger(pChars + 2, this->idEmployee, 0);
+        memcpy(pChars, "\t\t", 2);
+        pChars = tf_formatString(pChars + 2, this->nameSurname, 0);
+        memcpy(pChars, "\t\t\t", 3);
+        pChars = tf_formatString(pChars + 3, mechatronic_getEventTypeName(this->eventType), 25);
+        memcpy(pChars, "\t\t\t\t", 4);
+        pChars = tf_formatFloat(pChars + 4, this->ambientTemperatureRead);
+        memcpy(pChars, "\t\t\t\t\t\t", 6);
+        pChars = tf_formatInteger(pChars + 6, this->humidityTemperatureRead, 0);
+        memcpy(pChars, "\t\t\t\t\t\t", 6);
+        pChars = tf_formatFloat(pChars + 6, this->temperatureEngineOn);
+        memcpy(pChars, "\t\t\t\t\t\t", 6);
+        pChars = tf_formatFloat(pChars + 6, this->temperatureEngineOff);
+        memcpy(pChars, "\t\t\t\t\t\t", 6);
+        pChars = tf_formatInteger(pChars + 6, this->humidityThreshold, 0);
+        *pChars++ = '\n';
+
+        value = tf_commit(pFormatter, pChars);
+    }
+
+    return value;
 }
 
 /**
- * \brief Load configuration file information
+ * \brief Load configuration file information, showing it to the user. If the file can't be read nor created the
+ *        program ends
  * \param char *filename file to read
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_loadTextFile(char *fileName, ArrayList *pArrayList)
+void mechatronic_loadTextFile(char *fileName, PagedStore *pPagedStore)
 {
-    char auxTemperatureOn[MAX_STRING_CHARS], auxTemperatureOff[MAX_STRING_CHARS], auxHumidity[MAX_STRING_CHARS], stringFile[MAX_STRING_CHARS];
-    int i, j = 0, k = 0, l = 0;
-    FILE *file = NULL;
+    int result;
+    int machines = 0;
+    Thresholds general;
 
     mechatronic_showLoadConfigUserFileMessage();
-    file = fopen(fileName, "r");
+    result = mechatronic_readConfigFile(fileName, &general, &machines);
 
-    if(file == NULL){
+    if(result < 0){
+        tm_clear();
         mechatronic_showWelcomeMessage();
-        printf("No se pudo leer el archivo '%s'. El archivo no existe o su nombre fue modificado.\n\n", MECHATRONIC_USER_CONFIG);
+        printf("ERROR!, no se pudo leer ni crear el archivo: %s\n\n", fileName);
+        tm_pause();
+        exit(0);
+    }
+
+    mechatronic_showWelcomeMessage();
+
+    if(result == 1){
+        printf("No se pudo leer el archivo '%s'. El archivo no existe o su nombre fue modificado.\n\n", fileName);
+        printf("A continuacion, se creara el archivo con los siguientes valores de temperatura por defecto:\n\n");
+        printf("- Temperatura inicial motor encendido: %.2f grados\n", general.temperatureEngineOn);
+        printf("- Temperatura inicial motor apagado: %.2f grados\n", general.temperatureEngineOff);
+        printf("- Temperatura inicial umbral de humedad: %d%%\n\n", general.humidityThreshold);
+    }
+    else{
+        printf("Archivo '%s' cargado con exito.\n\n", fileName);
+        printf("- Temperatura inicial motor encendido: %.2f grados\n", general.temperatureEngineOn);
+        printf("- Temperatura inicial motor apagado: %.2f grados\n", general.temperatureEngineOff);
+        printf("- Temperatura inicial umbral de humedad: %d%%\n", general.humidityThreshold);
+        printf("- Modo de durabilidad: %s", durabilityNames[durability]);
 
-        file = fopen(fileName, "w");
+        if(durability == EL_SYNC_GROUP)
+            printf(" (cada %d eventos o %d ms)", groupCommitEvents, groupCommitMillis);
+
+        if(segmentEvents > 0)
+            printf("\n- Segmentos del archivo binario: hasta %d eventos%s", segmentEvents, segmentDaily ? ", uno por dia" : "");
+        else
+            printf("\n- Segmentos del archivo binario: %s", segmentDaily ? "uno por dia" : "sin limite");
 
-        if(file != NULL){
-            humidityThreshold = INITIAL_HUMIDITY_THRESHOLD;
-            temperatureEngineOn = INITIAL_ENGINE_START_TEMPERATURE;
-            temperatureEngineOff = INITIAL_ENGINE_IDLE_TEMPERATURE;
+        if(retentionDays > 0)
+            printf("\n- Retencion de eventos: %d dias", retentionDays);
+        else
+            printf("\n- Retencion de eventos: sin limite");
 
-            printf("A continuacion, se creara el archivo con los siguientes valores de temperatura por defecto:\n\n");
-            printf("- Temperatura inicial motor encendido: %.2f grados\n", temperatureEngineOn);
-            printf("- Temperatura inicial motor apagado: %.2f grados\n", temperatureEngineOff);
-            printf("- Temperatura inicial umbral de humedad: %d%%\n\n", humidityThreshold);
+        printf("\n- Memoria para el historial de eventos: %d MB", cacheMegabytes);
 
-            fprintf(file, "temperatureEngineOn=%.2f\n", temperatureEngineOn);
-            fprintf(file, "temperatureEngineOff=%.2f\n", temperatureEngineOff);
-            fprintf(file, "humidityThreshold=%d", humidityThreshold);
+        if(machines > 0)
+            printf("\n- Maquinas con umbrales propios: %d", machines);
 
-            system("pause");
-        }
-        else{
-            system("cls");
-            mechatronic_showWelcomeMessage();
-            printf("ERROR!, no se pudo crear el archivo: %s\n\n", MECHATRONIC_USER_CONFIG);
-            system("pause");
-            exit(0);
-        }
+        printf("\n\n");
     }
+
+    tm_pause();
+
+    if(mechatronic_applyConfig(pPagedStore) != 0)
+        tm_pause();
+}
+
+/**
+ * \brief Load configuration file information without user interaction, for the modes that run unattended. One line
+ *        tells if the file was read or created, or why it failed
+ * \param char *fileName file to read
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [the file can't be read nor created or a setting can't be applied]
+ *                           (0) if ok
+ */
+int mechatronic_loadConfigFile(char *fileName, PagedStore *pPagedStore)
+{
+    int value = -1;
+    int result;
+    int machines = 0;
+    Thresholds general;
+
+    result = mechatronic_readConfigFile(fileName, &general, &machines);
+
+    if(result < 0)
+        printf("ERROR!, no se pudo leer ni crear el archivo: %s\n", fileName != NULL ? fileName : "");
     else{
-        // limpio los arrays
-        memset(&auxTemperatureOn, 0, sizeof(auxTemperatureOn));
-        memset(&auxTemperatureOff, 0, sizeof(auxTemperatureOff));
-        memset(&auxHumidity, 0, sizeof(auxHumidity));
+        if(result == 1)
+            printf("Archivo '%s' creado con los valores por defecto.\n", fileName);
+        else
+            printf("Archivo '%s' cargado con exito (maquinas con umbrales propios: %d).\n", fileName, machines);
 
-        // leo y cargo cada linea del archivo
-        while(!feof(file)){
-            fscanf(file, "%[^\n]\n", auxTemperatureOn);
-            fscanf(file, "%[^\n]\n", auxTemperatureOff);
-            fscanf(file, "%[^\n]\n", auxHumidity);
-        }
+        value = mechatronic_applyConfig(pPagedStore);
+    }
 
-        // declaro variables para leer la longitud de cada linea del archivo
-        int lengthTempOnRead, lengthTempOffRead, lengthHumidityRead;
+    return value;
+}
 
-        lengthTempOnRead = strlen(auxTemperatureOn);
-        lengthTempOffRead = strlen(auxTemperatureOff);
-        lengthHumidityRead = strlen(auxHumidity);
+/**
+ * \brief Reads the configuration file and publishes its thresholds, without user interaction. The keys that are
+ *        missing or invalid keep their default values. If the file does not exist it is created with the default values
+ * \param char *fileName file to read
+ * \param Thresholds *pGeneral pointer where the general thresholds are written
+ * \param int *pMachines pointer where the number of machines with their own thresholds is written
+ * \return int value return (-1) if error [NULL pointer, the file can't be read nor created or can't allocate memory]
+ *                           (0) if the file was read
+ *                           (1) if the file was created with the default values
+ */
+int mechatronic_readConfigFile(char *fileName, Thresholds *pGeneral, int *pMachines)
+{
+    int i;
+    int value = -1;
+    char line[MAX_STRING_CHARS];
+    FILE *file = NULL;
+    Thresholds overrides[MECHATRONIC_MAX_MACHINES];
+    unsigned char keys[MECHATRONIC_MAX_MACHINES];
+
+    if(fileName != NULL && pGeneral != NULL && pMachines != NULL){
+        // las maquinas sin claves propias usan los umbrales generales
+        pGeneral->temperatureEngineOn = INITIAL_ENGINE_START_TEMPERATURE;
+        pGeneral->temperatureEngineOff = INITIAL_ENGINE_IDLE_TEMPERATURE;
+        pGeneral->humidityThreshold = INITIAL_HUMIDITY_THRESHOLD;
+        memset(keys, 0, sizeof(keys));
+        *pMachines = 0;
+
+        // las claves que faltan mantienen los valores por defecto
+        durability = INITIAL_DURABILITY;
+        groupCommitEvents = INITIAL_GROUP_COMMIT_EVENTS;
+        groupCommitMillis = INITIAL_GROUP_COMMIT_MILLIS;
+        segmentEvents = INITIAL_SEGMENT_EVENTS;
+        segmentDaily = INITIAL_SEGMENT_DAILY;
+        retentionDays = INITIAL_RETENTION_DAYS;
+        cacheMegabytes = INITIAL_CACHE_MEGABYTES;
+
+        file = fopen(fileName, "r");
 
-        if((lengthTempOnRead > MAX_STRING_CHARS) || (lengthTempOffRead > MAX_STRING_CHARS) || (lengthHumidityRead > MAX_STRING_CHARS)){
-            printf("\nNo se puede leer el archivo '%s'. Revise su configuracion y vuelva a reintentar.\n\n", MECHATRONIC_USER_CONFIG);
-            system("pause");
-            exit(0);
+        if(file == NULL){
+            file = fopen(fileName, "w");
+
+            if(file != NULL){
+                fprintf(file, "temperatureEngineOn=%.2f\n", pGeneral->temperatureEngineOn);
+                fprintf(file, "temperatureEngineOff=%.2f\n", pGeneral->temperatureEngineOff);
+                fprintf(file, "humidityThreshold=%d\n", pGeneral->humidityThreshold);
+                fprintf(file, "durability=%s\n", durabilityNames[durability]);
+                fprintf(file, "groupCommitEvents=%d\n", groupCommitEvents);
+                fprintf(file, "groupCommitMillis=%d\n", groupCommitMillis);
+                fprintf(file, "segmentEvents=%d\n", segmentEvents);
+                fprintf(file, "segmentDaily=%d\n", segmentDaily);
+                fprintf(file, "retentionDays=%d\n", retentionDays);
+                fprintf(file, "cacheMegabytes=%d", cacheMegabytes);
+
+                if(fclose(file) == 0 && publishThresholds(pGeneral, overrides, keys) >= 0)
+                    value = 1;
+            }
         }
         else{
-            memset(&stringFile, 0, sizeof(stringFile));
+            // leo cada linea del archivo y la asigno segun su clave
+            while(fscanf(file, " %1023[^\n]", line) == 1){
+                line[strcspn(line, "\r")] = '\0';
 
-            // Recorro el array de la primera linea del archivo en busca del valor de 'temperatura motor encendido'
-            for(i = 0; i < MAX_STRING_CHARS; i++){
-                if(auxTemperatureOn[i] >= '0' && auxTemperatureOn[i] <= '9'){
-                    stringFile[j] = auxTemperatureOn[i];
-                    j++;
-                }
-                else if(auxTemperatureOn[i] == '.'){
-                    break;
-                }
-            }
+                // los umbrales se leen igual que al recargarlos con el programa en marcha
+                if(parseThresholdLine(line, pGeneral, overrides, keys) == 0)
+                    continue;
 
-            temperatureEngineOn = atof(stringFile);
-            memset(&stringFile, 0, sizeof(stringFile));
+                if(!strncmp(line, "durability=", 11))
+                    durability = mechatronic_getDurabilityCode(line + 11);
 
-            // Recorro el array de la segunda linea del archivo en busca del valor de 'temperatura motor apagado'
-            for(i = 0; i < MAX_STRING_CHARS; i++){
-                if(auxTemperatureOff[i] >= '0' && auxTemperatureOff[i] <= '9'){
-                    stringFile[k] = auxTemperatureOff[i];
-                    k++;
-                }
-                else if(auxTemperatureOff[i] == '.'){
-                    break;
-                }
-            }
+                else if(!strncmp(line, "groupCommitEvents=", 18) && atoi(line + 18) > 0)
+                    groupCommitEvents = atoi(line + 18);
 
-            temperatureEngineOff = atof(stringFile);
-            memset(&stringFile, 0, sizeof(stringFile));
+                else if(!strncmp(line, "groupCommitMillis=", 18) && atoi(line + 18) > 0)
+                    groupCommitMillis = atoi(line + 18);
 
-            // Recorro el array de la tercera linea del archivo en busca del valor de 'umbral de humedad'
-            for(i = 0; i < MAX_STRING_CHARS; i++){
-                if(auxHumidity[i] >= '0' && auxHumidity[i] <= '9'){
-                    stringFile[l] = auxHumidity[i];
-                    l++;
-                }
-                else if(auxHumidity[i] == '.'){
-                    break;
-                }
+                else if(!strncmp(line, "segmentEvents=", 14) && atoi(line + 14) >= 0)
+                    segmentEvents = atoi(line + 14);
+
+                else if(!strncmp(line, "segmentDaily=", 13))
+                    segmentDaily = atoi(line + 13) != 0;
+
+                else if(!strncmp(line, "retentionDays=", 14) && atoi(line + 14) >= 0)
+                    retentionDays = atoi(line + 14);
+
+                else if(!strncmp(line, "cacheMegabytes=", 15) && atoi(line + 15) > 0)
+                    cacheMegabytes = atoi(line + 15);
             }
 
-            humidityThreshold = atoi(stringFile);
+            if(!ferror(file) && publishThresholds(pGeneral, overrides, keys) >= 0)
+                value = 0;
+
+            fclose(file);
+
+            for(i = 1; i < MECHATRONIC_MAX_MACHINES; i++)
+                *pMachines += keys[i] != 0;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Applies the durability, the segments, the retention and the memory limit read from the configuration file
+ *        to the binary file and to the event store. The settings that fail are reported and the rest are applied
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \return int value return (-1) if error [a setting can't be applied]
+ *                           (0) if ok
+ */
+int mechatronic_applyConfig(PagedStore *pPagedStore)
+{
+    int value = 0;
+
+    if(pSegmentLog != NULL && sl_setSyncPolicy(pSegmentLog, durability, groupCommitEvents, groupCommitMillis) != 0){
+        printf("\nERROR!, no se pudo aplicar el modo de durabilidad '%s'.\n\n", durabilityNames[durability]);
+        value = -1;
+    }
+
+    if(pSegmentLog != NULL && (sl_setRotation(pSegmentLog, segmentEvents, segmentDaily ? SL_DAY : 0) != 0 || sl_setRetention(pSegmentLog, (long long)retentionDays * SL_DAY) != 0)){
+        printf("\nERROR!, no se pudo aplicar la retencion de %d dias.\n\n", retentionDays);
+        value = -1;
+    }
+
+    if(pPagedStore != NULL && ps_setCapacity(pPagedStore, mechatronic_getCachePages(cacheMegabytes)) != 0){
+        printf("\nERROR!, no se pudo aplicar el limite de memoria de %d MB.\n\n", cacheMegabytes);
+        value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Gets the sync policy of the binary file that corresponds to a durability mode of the configuration file
+ * \param char *durabilityName name of the durability mode: none, flush, sync or group
+ * \return int value EL_SYNC_NONE, EL_SYNC_FLUSH, EL_SYNC_FULL or EL_SYNC_GROUP - INITIAL_DURABILITY if the name is not valid
+ */
+int mechatronic_getDurabilityCode(char *durabilityName)
+{
+    int i;
+    int value = INITIAL_DURABILITY;
 
-            mechatronic_showWelcomeMessage();
-            printf("Archivo '%s' cargado con exito.\n\n", MECHATRONIC_USER_CONFIG);
-            printf("- Temperatura inicial motor encendido: %.2f grados\n", temperatureEngineOn);
-            printf("- Temperatura inicial motor apagado: %.2f grados\n", temperatureEngineOff);
-            printf("- Temperatura inicial umbral de humedad: %d%%\n\n", humidityThreshold);
-            system("pause");
+    for(i = EL_SYNC_NONE; i <= EL_SYNC_GROUP; i++){
+        if(!strcmp(durabilityName, durabilityNames[i])){
+            value = i;
+            break;
         }
     }
 
-    fclose(file);
+    return value;
 }
 
 /**
  * \brief Calls the loadtextfile function
- * \param ArrayList *pArrayList pointer to the array list
+ * \param PagedStore *pPagedStore pointer to the event store
  * \return void
  */
-void mechatronic_userConfig(ArrayList *pArrayList)
+void mechatronic_userConfig(PagedStore *pPagedStore)
 {
-    mechatronic_loadTextFile(MECHATRONIC_USER_CONFIG, pArrayList);
+    mechatronic_loadTextFile(MECHATRONIC_USER_CONFIG, pPagedStore);
 }
 
 /**
@@ -711,7 +2707,7 @@ void mechatronic_userConfig(ArrayList *pArrayList)
  */
 void mechatronic_showWelcomeMessage(void)
 {
-    system("cls");
+    tm_clear();
     printf("\n*****************************************************\n");
     printf("|          SISTEMA DE CONTROL MECATRONICO           |\n");
     printf("*****************************************************\n\n");
@@ -764,7 +2760,7 @@ void mechatronic_showErrorMessage(void)
  */
 void mechatronic_showEmergencySwitchMessage(void)
 {
-    system("cls");
+    tm_clear();
     printf("\n************ PARADA DE EMERGENCIA ************\n");
 }
 
@@ -774,7 +2770,7 @@ void mechatronic_showEmergencySwitchMessage(void)
  */
 void mechatronic_showLoadConfigUserFileMessage(void)
 {
-    system("cls");
+    tm_clear();
     printf("\n************ ARCHIVO DE CONFIGURACION DE USUARIO ************\n");
 }
 
@@ -784,7 +2780,7 @@ void mechatronic_showLoadConfigUserFileMessage(void)
  */
 void mechatronic_showSetAmbientTemperatureReadMessage(void)
 {
-    system("cls");
+    tm_clear();
     printf("\n************ NUEVA LECTURA DE TEMPERATURA AMBIENTE ************\n");
 }
 
@@ -794,7 +2790,7 @@ void mechatronic_showSetAmbientTemperatureReadMessage(void)
  */
 void mechatronic_showSetAmbientHumidityReadMessage(void)
 {
-    system("cls");
+    tm_clear();
     printf("\n************ NUEVA LECTURA DE HUMEDAD AMBIENTE ************\n");
 }
 
@@ -804,6 +2800,469 @@ void mechatronic_showSetAmbientHumidityReadMessage(void)
  */
 void mechatronic_showModifyMechatronicMessage(void)
 {
-    system("cls");
+    tm_clear();
     printf("\n************ MODIFICAR DATOS ************\n");
 }
+
+/**
+ * \brief Writes an integer in little endian
+ * \param unsigned char *pBuffer buffer where the integer is written
+ * \param long long value integer to write
+ * \param int bytes number of bytes to write
+ * \return void
+ */
+void putInteger(unsigned char *pBuffer, long long value, int bytes)
+{
+    int i;
+
+    for(i = 0; i < bytes; i++)
+        pBuffer[i] = (unsigned char)((unsigned long long)value >> (8 * i));
+}
+
+/**
+ * \brief Reads an integer written in little endian
+ * \param unsigned char *pBuffer buffer where the integer is read
+ * \param int bytes number of bytes to read
+ * \return long long value the integer read, without sign extension
+ */
+long long getInteger(unsigned char *pBuffer, int bytes)
+{
+    int i;
+    unsigned long long value = 0;
+
+    for(i = 0; i < bytes; i++)
+        value |= (unsigned long long)pBuffer[i] << (8 * i);
+
+    return (long long)value;
+}
+
+/**
+ * \brief Converts a value to hundredths, rounding half away from zero. Values out of the limits, infinities
+ *        included, are clamped to the nearest limit and NaN is 0
+ * \param float number value to convert
+ * \param long minimum smallest number of hundredths
+ * \param long maximum greatest number of hundredths
+ * \return long value the value in hundredths
+ */
+long toHundredths(float number, long minimum, long maximum)
+{
+    long value = 0;
+    float hundredths = number * 100;
+
+    if(hundredths >= maximum)
+        value = maximum;
+    else if(hundredths <= minimum)
+        value = minimum;
+    else if(hundredths == hundredths)
+        value = (long)(hundredths + (hundredths < 0 ? -0.5f : 0.5f));
+
+    return value;
+}
+
+/**
+ * \brief Checks that a value is stored in hundredths without being clamped by toHundredths
+ * \param float number value to convert
+ * \param long minimum smallest number of hundredths
+ * \param long maximum greatest number of hundredths
+ * \return int value 1 if the value rounds to a number of hundredths within the limits - 0 if not or NaN
+ */
+int fitsHundredths(float number, long minimum, long maximum)
+{
+    float hundredths = number * 100;
+
+    // NaN no cumple ninguna de las comparaciones
+    return hundredths > minimum - 0.5f && hundredths < maximum + 0.5f;
+}
+
+/**
+ * \brief Checks that the fields of a date of a legacy record are within their ranges
+ * \param Date *pDate pointer to the date
+ * \return int value 1 if the date is valid - 0 if not
+ */
+int isValidLegacyDate(Date *pDate)
+{
+    return pDate->year >= 1970 && pDate->year <= 9999 && pDate->month >= 1 && pDate->month <= 12 && pDate->day >= 1 &&
+           pDate->day <= 31 && pDate->hour >= 0 && pDate->hour <= 23 && pDate->minutes >= 0 && pDate->minutes <= 59 &&
+           pDate->seconds >= 0 && pDate->seconds <= 60;
+}
+
+/**
+ * \brief Stores a block of events without keeping them in memory: sets their dates, updates the statistics and
+ *        appends them to a binary file, its time index and its text report, flushing every file once per block
+ * \param SegmentLog *pLog pointer to the binary file
+ * \param TimeIndex *pIndex pointer to the time index of the binary file
+ * \param ReportWriter *pWriter pointer to the text report
+ * \param char *reportName name of the text report
+ * \param EventStats *pStats pointer to the statistics of the events of the binary file
+ * \param Mechatronic *pEvents pointer to the first event, their timestamps must be set
+ * \param int count number of events
+ * \param char *pFailed pointer to SL_MAX_NAME_CHARS chars where the name of the file that failed is written - (NULL)
+ * \return int value return (-1) if error [pEvents or pLog are NULL pointer, invalid count or write failed]
+ *                           (0) if ok
+ */
+int appendEvents(SegmentLog *pLog, TimeIndex *pIndex, ReportWriter *pWriter, char *reportName, EventStats *pStats, Mechatronic *pEvents, int count, char *pFailed)
+{
+    int i;
+    int j;
+    int length;
+    int value = -1;
+    unsigned char records[MECHATRONIC_RECORD_SIZE * MECHATRONIC_READ_CHUNK];
+
+    if(pEvents != NULL && count >= 0 && pLog != NULL){
+        value = 0;
+
+        for(i = 0; i < count; i += length){
+            length = count - i < MECHATRONIC_READ_CHUNK ? count - i : MECHATRONIC_READ_CHUNK;
+
+            for(j = 0; j < length; j++){
+                mechatronic_setTimestamp(&pEvents[i + j], pEvents[i + j].timestamp, i + j > 0 ? &pEvents[i + j - 1] : NULL);
+                mechatronic_updateStats(pStats, &pEvents[i + j]);
+                mechatronic_encodeRecord(&pEvents[i + j], records + MECHATRONIC_RECORD_SIZE * j);
+                ti_add(pIndex, pEvents[i + j].timestamp, pLog->next + j);
+            }
+
+            // el segmento activo es el ultimo, si no se puede nombrar fallo el manifiesto
+            if(sl_appendArray(pLog, records, length) != 0 && value == 0){
+                if(pFailed != NULL && sl_getFileName(pLog, sl_len(pLog) - 1, pFailed, SL_MAX_NAME_CHARS) != 0)
+                    snprintf(pFailed, SL_MAX_NAME_CHARS, "%s", pLog->manifestName);
+
+                value = -1;
+            }
+        }
+
+        if(rw_appendArray(pWriter, pEvents, sizeof(Mechatronic), count) != 0 && value == 0){
+            if(pFailed != NULL)
+                snprintf(pFailed, SL_MAX_NAME_CHARS, "%s", reportName);
+
+            value = -1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Keeps the value of a line of the configuration file if its key is a threshold, general or of a machine.
+ *        Values that are not valid numbers in the range of the threshold are left out
+ * \param char *pLine pointer to the line
+ * \param Thresholds *pGeneral pointer to the general thresholds
+ * \param Thresholds *pOverrides pointer to the thresholds of every machine
+ * \param unsigned char *pKeys pointer to the keys read of every machine, the general ones in the position 0
+ * \return int value return (-1) if the key is not a threshold
+ *                           (0) if ok
+ */
+int parseThresholdLine(char *pLine, Thresholds *pGeneral, Thresholds *pOverrides, unsigned char *pKeys)
+{
+    int value = 0;
+
+    if(!strncmp(pLine, "temperatureEngineOn=", 20)){
+        if(parseThresholdTemperature(pLine + 20, &pGeneral->temperatureEngineOn) == 0)
+            pKeys[0] |= MECHATRONIC_KEY_ENGINE_ON;
+    }
+    else if(!strncmp(pLine, "temperatureEngineOff=", 21)){
+        if(parseThresholdTemperature(pLine + 21, &pGeneral->temperatureEngineOff) == 0)
+            pKeys[0] |= MECHATRONIC_KEY_ENGINE_OFF;
+    }
+    else if(!strncmp(pLine, "humidityThreshold=", 18)){
+        if(parseThresholdHumidity(pLine + 18, &pGeneral->humidityThreshold) == 0)
+            pKeys[0] |= MECHATRONIC_KEY_HUMIDITY;
+    }
+    else if(!strncmp(pLine, "machine.", 8))
+        parseMachineThreshold(pLine + 8, pOverrides, pKeys);
+
+    else
+        value = -1;
+
+    return value;
+}
+
+/**
+ * \brief Reads the value of a temperature threshold, with its sign and decimals. Only spaces may follow the number
+ * \param char *pText pointer to the value, ended with '\0'
+ * \param float *pTemperature pointer where the temperature is written, it is not changed if the value is invalid
+ * \return int value return (-1) if error [not a number or out of range]
+ *                           (0) if ok
+ */
+int parseThresholdTemperature(char *pText, float *pTemperature)
+{
+    int value = -1;
+    double number;
+    char *pEnd = NULL;
+
+    errno = 0;
+    number = strtod(pText, &pEnd);
+
+    // NaN no cumple ninguna de las comparaciones
+    if(pEnd != pText && errno == 0 && pEnd[strspn(pEnd, " \t")] == '\0' &&
+       number >= MIN_THRESHOLD_TEMPERATURE && number <= MAX_THRESHOLD_TEMPERATURE){
+        *pTemperature = (float)number;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reads the value of a humidity threshold, a whole percentage. Only spaces may follow the number
+ * \param char *pText pointer to the value, ended with '\0'
+ * \param int *pHumidity pointer where the humidity is written, it is not changed if the value is invalid
+ * \return int value return (-1) if error [not an integer or out of range]
+ *                           (0) if ok
+ */
+int parseThresholdHumidity(char *pText, int *pHumidity)
+{
+    int value = -1;
+    long number;
+    char *pEnd = NULL;
+
+    errno = 0;
+    number = strtol(pText, &pEnd, 10);
+
+    if(pEnd != pText && errno == 0 && pEnd[strspn(pEnd, " \t")] == '\0' &&
+       number >= MIN_THRESHOLD_HUMIDITY && number <= MAX_THRESHOLD_HUMIDITY){
+        *pHumidity = (int)number;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Keeps a threshold of a machine of the configuration file, from a line "machine.ID.key=value" without the
+ *        "machine." prefix. The keys are the ones of the general thresholds, lines with an invalid ID or value are
+ *        ignored
+ * \param char *pLine pointer to the line after the prefix
+ * \param Thresholds *pOverrides pointer to the thresholds of every machine
+ * \param unsigned char *pKeys pointer to the keys read of every machine
+ * \return void
+ */
+void parseMachineThreshold(char *pLine, Thresholds *pOverrides, unsigned char *pKeys)
+{
+    long idMachine;
+    char *pKey = NULL;
+
+    idMachine = strtol(pLine, &pKey, 10);
+
+    if(pKey != pLine && *pKey == '.' && idMachine > 0 && idMachine < MECHATRONIC_MAX_MACHINES){
+        pKey++;
+
+        if(!strncmp(pKey, "temperatureEngineOn=", 20)){
+            if(parseThresholdTemperature(pKey + 20, &pOverrides[idMachine].temperatureEngineOn) == 0)
+                pKeys[idMachine] |= MECHATRONIC_KEY_ENGINE_ON;
+        }
+        else if(!strncmp(pKey, "temperatureEngineOff=", 21)){
+            if(parseThresholdTemperature(pKey + 21, &pOverrides[idMachine].temperatureEngineOff) == 0)
+                pKeys[idMachine] |= MECHATRONIC_KEY_ENGINE_OFF;
+        }
+        else if(!strncmp(pKey, "humidityThreshold=", 18)){
+            if(parseThresholdHumidity(pKey + 18, &pOverrides[idMachine].humidityThreshold) == 0)
+                pKeys[idMachine] |= MECHATRONIC_KEY_HUMIDITY;
+        }
+    }
+}
+
+/**
+ * \brief Builds the thresholds of every machine from the general ones and the keys of each machine and publishes
+ *        them at once. The thresholds replaced are released if no thread started reading them before they were
+ *        replaced, otherwise with a later publication or when the event store is deleted
+ * \param Thresholds *pGeneral pointer to the general thresholds, the ones of the main machine
+ * \param Thresholds *pOverrides pointer to the thresholds of every machine
+ * \param unsigned char *pKeys pointer to the keys read of every machine
+ * \return int value return (-1) if error [can't allocate memory]
+ *                          (version of the published thresholds) if ok
+ */
+int publishThresholds(Thresholds *pGeneral, Thresholds *pOverrides, unsigned char *pKeys)
+{
+    int i;
+    int value = -1;
+    ThresholdSnapshot *pSnapshot = NULL;
+
+    pSnapshot = (ThresholdSnapshot*)malloc(sizeof(ThresholdSnapshot));
+
+    if(pSnapshot != NULL){
+        pSnapshot->machines[0] = *pGeneral;
+
+        for(i = 1; i < MECHATRONIC_MAX_MACHINES; i++){
+            pSnapshot->machines[i].temperatureEngineOn = pKeys[i] & MECHATRONIC_KEY_ENGINE_ON ? pOverrides[i].temperatureEngineOn : pGeneral->temperatureEngineOn;
+            pSnapshot->machines[i].temperatureEngineOff = pKeys[i] & MECHATRONIC_KEY_ENGINE_OFF ? pOverrides[i].temperatureEngineOff : pGeneral->temperatureEngineOff;
+            pSnapshot->machines[i].humidityThreshold = pKeys[i] & MECHATRONIC_KEY_HUMIDITY ? pOverrides[i].humidityThreshold : pGeneral->humidityThreshold;
+        }
+
+        // el menu y la recarga pueden publicar a la vez, los lectores nunca esperan
+        pthread_mutex_lock(&thresholdsMutex);
+        pSnapshot->version = pThresholdSnapshot->version + 1;
+        pSnapshot->pReplaced = pThresholdSnapshot;
+        __atomic_store_n(&pThresholdSnapshot, pSnapshot, __ATOMIC_SEQ_CST);
+
+        // los lectores que vean la epoca nueva ya leen esta configuracion
+        pSnapshot->pReplaced->retired = __atomic_add_fetch(&thresholdEpoch, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        releaseThresholds(pSnapshot);
+
+        value = pSnapshot->version;
+        pthread_mutex_unlock(&thresholdsMutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Releases the thresholds replaced by a published configuration that no thread can be reading: the ones
+ *        replaced before the oldest epoch of the threads reading now. The initial ones are not allocated and are
+ *        kept. It must be called with thresholdsMutex locked
+ * \param ThresholdSnapshot *pSnapshot pointer to the published configuration
+ * \return void
+ */
+void releaseThresholds(ThresholdSnapshot *pSnapshot)
+{
+    int i;
+    unsigned long long epoch;
+    unsigned long long oldest = ~0ULL;
+    ThresholdSnapshot *pReplaced = NULL;
+
+    for(i = 0; i < MECHATRONIC_THRESHOLD_READERS; i++){
+        epoch = __atomic_load_n(&thresholdReaders[i].epoch, __ATOMIC_SEQ_CST);
+
+        if(epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
+
+    // las reemplazadas van de la mas nueva a la mas vieja, un lector que entro antes del reemplazo puede tenerla
+    while(pSnapshot->pReplaced != &initialThresholds){
+        pReplaced = pSnapshot->pReplaced;
+
+        if(pReplaced->retired <= oldest){
+            pSnapshot->pReplaced = pReplaced->pReplaced;
+            free(pReplaced);
+        }
+        else
+            pSnapshot = pReplaced;
+    }
+}
+
+/**
+ * \brief Gets the place of the calling thread among the threads that read the thresholds, taking a free one the
+ *        first time. The place is given back when the thread ends
+ * \param -
+ * \return ThresholdReader *pReader return (NULL) if error [there is no free place or can't create the key]
+ *                                  - (pointer to the place of the thread) if ok
+ */
+ThresholdReader *joinThresholds(void)
+{
+    int i;
+    int used;
+    ThresholdReader *pReader = NULL;
+
+    pthread_once(&thresholdOnce, createThresholdKey);
+
+    if(thresholdKeyCreated){
+        pReader = (ThresholdReader*)pthread_getspecific(thresholdKey);
+
+        for(i = 0; i < MECHATRONIC_THRESHOLD_READERS && pReader == NULL; i++){
+            used = 0;
+
+            if(__atomic_compare_exchange_n(&thresholdReaders[i].used, &used, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+                pReader = &thresholdReaders[i];
+
+                if(pthread_setspecific(thresholdKey, pReader) != 0){
+                    __atomic_store_n(&pReader->used, 0, __ATOMIC_RELEASE);
+                    pReader = NULL;
+                    break;
+                }
+            }
+        }
+    }
+
+    return pReader;
+}
+
+/**
+ * \brief Gives back the place of a thread that ended, it is the destructor of the key of the places
+ * \param void *pArgument pointer to the place of the thread
+ * \return void
+ */
+void leaveThresholds(void *pArgument)
+{
+    ThresholdReader *pReader = (ThresholdReader*)pArgument;
+
+    __atomic_store_n(&pReader->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&pReader->used, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * \brief Creates the key that keeps the place of every thread that reads the thresholds, it is called once
+ * \param -
+ * \return void
+ */
+void createThresholdKey(void)
+{
+    thresholdKeyCreated = pthread_key_create(&thresholdKey, leaveThresholds) == 0;
+}
+
+/**
+ * \brief Finishes the rewrite of the binary file: writes the temporary file to disk and renames it over the binary
+ *        file, so a crash leaves either the original or the rewritten file. If anything failed the temporary file is
+ *        removed and the original is kept
+ * \param FILE *target temporary file with the rewritten file, it is closed
+ * \param int value (0) if every write to target succeeded
+ * \return int value return (-1) if error [a write failed, can't sync, close or rename the temporary file]
+ *                           (0) if ok
+ */
+int replaceBinaryFile(FILE *target, int value)
+{
+    if(value == 0 && (fflush(target) != 0 || fileSync(fileNumber(target)) != 0))
+        value = -1;
+
+    if(fclose(target) != 0)
+        value = -1;
+
+    if(value == 0){
+#ifdef _WIN32
+        remove(MECHATRONIC_BINARY_FILE);
+#endif
+
+        if(rename(MECHATRONIC_BINARY_FILE_TEMP, MECHATRONIC_BINARY_FILE) != 0)
+            value = -1;
+    }
+
+    if(value != 0)
+        remove(MECHATRONIC_BINARY_FILE_TEMP);
+
+    return value;
+}
+
+/**
+ * \brief Converts a date DD/MM/AAAA to seconds since the epoch in local time, at the first or the last second of the day
+ * \param char *text date to convert
+ * \param int endOfDay 1 for the last second of the day - 0 for the first one
+ * \param long long *pTimestamp pointer where the time is written
+ * \return int value return (-1) if error [the text is not a valid date]
+ *                           (0) if ok
+ */
+int parseReportDate(char *text, int endOfDay, long long *pTimestamp)
+{
+    int day;
+    int month;
+    int year;
+    int length = 0;
+    int value = -1;
+    struct tm date;
+
+    if(sscanf(text, "%d/%d/%d%n", &day, &month, &year, &length) == 3 && text[length] == '\0'){
+        memset(&date, 0, sizeof(date));
+        date.tm_mday = day;
+        date.tm_mon = month - 1;
+        date.tm_year = year - 1900;
+        date.tm_hour = endOfDay ? 23 : 0;
+        date.tm_min = endOfDay ? 59 : 0;
+        date.tm_sec = endOfDay ? 59 : 0;
+        date.tm_isdst = -1;
+        *pTimestamp = mktime(&date);
+
+        // mktime corrige las fechas que no existen, como el 31/02
+        if(*pTimestamp != -1 && date.tm_mday == day && date.tm_mon == month - 1 && date.tm_year == year - 1900)
+            value = 0;
+    }
+
+    return value;
+}
@@ -0,0 +1,391 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/pagedstore.h"
+
+// private functions
+StorePage *findPage(PagedStore *this, int number);
+StorePage *choosePage(PagedStore *this);
+void releasePages(PagedStore *this, int from);
+void sealPage(PagedStore *this);
+
+/**
+ * \brief Allocate a store of fixed size elements where only the most recent elements are kept in memory. The older
+ *        ones are read in pages of pageSize elements when they are needed, through pLoadPage, and kept in a cache of
+ *        up to maxPages pages that drops the least recently used page first
+ * \param int elementSize size in bytes of every element
+ * \param int pageSize number of elements of every page
+ * \param int maxPages maximum number of pages kept in memory
+ * \param int (*pLoadPage)(void*, int, void*, int) function called with pContext, the index of the first element, an
+ *        array of elements and the number of elements to read. It returns the number of elements read
+ * \param void *pContext pointer passed as first argument of pLoadPage
+ * \return PagedStore *pAux Return (NULL) if error [invalid parameters or if can't allocate memory]
+ *                               - (pointer to new paged store) if ok
+ */
+PagedStore *ps_newPagedStore(int elementSize, int pageSize, int maxPages, int (*pLoadPage)(void*, int, void*, int), void *pContext)
+{
+    PagedStore *this = NULL;
+    PagedStore *pAux = NULL;
+
+    if(elementSize > 0 && pageSize > 0 && maxPages > 0 && pLoadPage != NULL){
+        this = (PagedStore*)malloc(sizeof(PagedStore));
+
+        if(this != NULL){
+            memset(this, 0, sizeof(PagedStore));
+            this->elementSize = elementSize;
+            this->pageSize = pageSize;
+            this->pLoadPage = pLoadPage;
+            this->pContext = pContext;
+            this->pResident = al_newTypedArrayList(elementSize);
+
+            if(this->pResident != NULL && ps_setCapacity(this, maxPages) == 0)
+                pAux = this;
+            else{
+                al_deleteArrayList(this->pResident);
+                free(this);
+            }
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Get the number of elements of the store, the ones in pages and the resident ones
+ * \param PagedStore *this pointer to paged store
+ * \return int value return number of elements or (-1) if error [this is NULL pointer]
+ */
+int ps_len(PagedStore *this)
+{
+    int value = -1;
+
+    if(this != NULL)
+        value = this->stored + al_len(this->pResident);
+
+    return value;
+}
+
+/**
+ * \brief Get an element by index. If it belongs to a page that is not in memory the page is read first, and the
+ *        least recently used page is dropped when the cache is full
+ * \param PagedStore *this pointer to paged store
+ * \param int index Index of the element
+ * \return void *pAux return (NULL) if error [this is NULL pointer, invalid index or the page can't be read]
+ *                         - (pointer to element) if ok, valid until the next call to ps_get or ps_add
+ */
+void *ps_get(PagedStore *this, int index)
+{
+    void *pAux = NULL;
+    StorePage *pPage = NULL;
+
+    if(this != NULL && index >= 0){
+        if(index >= this->stored)
+            pAux = al_get(this->pResident, index - this->stored);
+
+        else{
+            pPage = findPage(this, index / this->pageSize);
+
+            if(pPage != NULL && index % this->pageSize < pPage->count)
+                pAux = pPage->pElements + (size_t)this->elementSize * (index % this->pageSize);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Copy count consecutive elements, starting at index, into an array. The elements in pages are read with
+ *        pLoadPage without using the cache, so a full pass does not drop the pages in use. While the store is not
+ *        modified it can be called from several threads at once, as long as pLoadPage can
+ * \param PagedStore *this pointer to paged store
+ * \param int index Index of the first element
+ * \param void *pElements pointer to an array of count elements
+ * \param int count number of elements to copy
+ * \return int value return (-1) if error [this or pElements are NULL pointer or invalid parameters]
+ *                          (number of elements copied, less than count if a page can't be read) if ok
+ */
+int ps_read(PagedStore *this, int index, void *pElements, int count)
+{
+    int i;
+    int length;
+    int value = -1;
+
+    if(this != NULL && pElements != NULL && index >= 0 && count >= 0 && index + count <= ps_len(this)){
+        value = 0;
+
+        if(index < this->stored){
+            length = this->stored - index < count ? this->stored - index : count;
+            value = this->pLoadPage(this->pContext, index, pElements, length);
+        }
+
+        // los elementos residentes se copian solo si las paginas anteriores se leyeron completas
+        if(index + value >= this->stored){
+            for(i = value; i < count; i++)
+                memcpy((char*)pElements + (size_t)this->elementSize * i, al_get(this->pResident, index + i - this->stored), this->elementSize);
+
+            value = count;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Add a copy of an element at the end of the store. It stays resident in memory until the resident elements
+ *        fill a page, then the page goes to the cache as its most recently used page, so the resident elements never
+ *        take more than a page. Once it is dropped from the cache it is read with pLoadPage like the older pages
+ * \param PagedStore *this pointer to paged store
+ * \param void *pElement pointer to element
+ * \return int value return (-1) if error [this or pElement are NULL pointer or if can't allocate memory]
+ *                           (0) if ok
+ */
+int ps_add(PagedStore *this, void *pElement)
+{
+    int value = -1;
+
+    if(this != NULL)
+        value = al_add(this->pResident, pElement);
+
+    if(value == 0 && al_len(this->pResident) >= this->pageSize)
+        sealPage(this);
+
+    return value;
+}
+
+/**
+ * \brief Set the number of elements that are read in pages, the ones before the resident elements. The pages
+ *        in memory are dropped
+ * \param PagedStore *this pointer to paged store
+ * \param int stored number of elements, a multiple of the page size
+ * \return int value return (-1) if error [this is NULL pointer or invalid stored]
+ *                           (0) if ok
+ */
+int ps_setStored(PagedStore *this, int stored)
+{
+    int i;
+    int value = -1;
+
+    if(this != NULL && stored >= 0 && stored % this->pageSize == 0){
+        for(i = 0; i < this->maxPages; i++)
+            this->pPages[i].number = -1;
+
+        this->stored = stored;
+        this->pLastPage = NULL;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Set the maximum number of pages kept in memory. Pages over the new limit are released
+ * \param PagedStore *this pointer to paged store
+ * \param int maxPages maximum number of pages, at least 1
+ * \return int value return (-1) if error [this is NULL pointer, invalid maxPages or if can't allocate memory]
+ *                           (0) if ok
+ */
+int ps_setCapacity(PagedStore *this, int maxPages)
+{
+    int i;
+    int value = -1;
+    StorePage *pAux = NULL;
+
+    if(this != NULL && maxPages > 0){
+        releasePages(this, maxPages);
+        pAux = (StorePage*)realloc(this->pPages, sizeof(StorePage) * maxPages);
+
+        if(pAux != NULL){
+            // las paginas nuevas se reservan recien cuando se usan
+            for(i = this->maxPages; i < maxPages; i++){
+                memset(&pAux[i], 0, sizeof(StorePage));
+                pAux[i].number = -1;
+            }
+
+            this->pPages = pAux;
+            this->maxPages = maxPages;
+            this->pLastPage = NULL;
+            value = 0;
+        }
+        else if(maxPages < this->maxPages){
+            this->maxPages = maxPages;
+            this->pLastPage = NULL;
+            value = 0;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Remove every element of the store and release the memory of the pages
+ * \param PagedStore *this pointer to paged store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int ps_clear(PagedStore *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        releasePages(this, 0);
+        al_clear(this->pResident);
+        al_shrinkToFit(this->pResident);
+        this->stored = 0;
+        this->pLastPage = NULL;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Release the pages and the resident elements and delete the store
+ * \param PagedStore *this pointer to paged store
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int ps_deletePagedStore(PagedStore *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        releasePages(this, 0);
+        al_deleteArrayList(this->pResident);
+        free(this->pPages);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Finds a page in memory and marks it as the most recently used. If it is not in memory it is read in the
+ *        place of a free page or of the least recently used one
+ * \param PagedStore *this pointer to paged store
+ * \param int number number of the page, the index of its first element divided by the page size
+ * \return StorePage *pPage return (NULL) if error [can't allocate memory or the page can't be read]
+ *                               - (pointer to the page) if ok
+ */
+StorePage *findPage(PagedStore *this, int number)
+{
+    int i;
+    int count;
+    StorePage *pPage = NULL;
+
+    // los recorridos en orden piden muchas veces seguidas la misma pagina
+    if(this->pLastPage != NULL && this->pLastPage->number == number)
+        pPage = this->pLastPage;
+
+    for(i = 0; i < this->maxPages && pPage == NULL; i++){
+        if(this->pPages[i].number == number)
+            pPage = &this->pPages[i];
+    }
+
+    if(pPage == NULL){
+        pPage = choosePage(this);
+        count = this->stored - number * this->pageSize;
+
+        if(pPage != NULL){
+            this->faults++;
+            pPage->number = number;
+            pPage->count = this->pLoadPage(this->pContext, number * this->pageSize, pPage->pElements, count < this->pageSize ? count : this->pageSize);
+
+            if(pPage->count <= 0){
+                pPage->number = -1;
+                pPage = NULL;
+            }
+        }
+    }
+
+    if(pPage != NULL){
+        pPage->lastUse = ++this->clock;
+        this->pLastPage = pPage;
+    }
+
+    return pPage;
+}
+
+/**
+ * \brief Chooses the page where a page that is not in memory is read: a page not used yet or else the least recently
+ *        used one
+ * \param PagedStore *this pointer to paged store
+ * \return StorePage *pPage return (NULL) if error [can't allocate memory]
+ *                               - (pointer to the page) if ok
+ */
+StorePage *choosePage(PagedStore *this)
+{
+    int i;
+    StorePage *pPage = &this->pPages[0];
+
+    for(i = 1; i < this->maxPages && pPage->number != -1; i++){
+        if(this->pPages[i].number == -1 || this->pPages[i].lastUse < pPage->lastUse)
+            pPage = &this->pPages[i];
+    }
+
+    if(pPage->pElements == NULL)
+        pPage->pElements = (char*)malloc((size_t)this->elementSize * this->pageSize);
+
+    if(pPage->pElements == NULL)
+        pPage = NULL;
+
+    return pPage;
+}
+
+/**
+ * \brief Releases the memory of the pages from a position to the end of the cache
+ * \param PagedStore *this pointer to paged store
+ * \param int from position of the first page released
+ * \return void
+ */
+void releasePages(PagedStore *this, int from)
+{
+    int i;
+
+    for(i = from; i < this->maxPages; i++){
+        free(this->pPages[i].pElements);
+        this->pPages[i].pElements = NULL;
+        this->pPages[i].number = -1;
+    }
+}
+
+/**
+ * \brief Moves the resident elements, a full page, to the cache as its most recently used page, in the place of a
+ *        free page or of the least recently used one. If there is no memory for the page they stay resident
+ * \param PagedStore *this pointer to paged store
+ * \return void
+ */
+void sealPage(PagedStore *this)
+{
+    StorePage *pPage = NULL;
+    void (*pRemoveHook)(void*, void*) = this->pResident->pRemoveHook;
+    void *pRemoveHookContext = this->pResident->pRemoveHookContext;
+
+    pPage = choosePage(this);
+
+    if(pPage != NULL){
+        memcpy(pPage->pElements, al_get(this->pResident, 0), (size_t)this->elementSize * this->pageSize);
+        pPage->number = this->stored / this->pageSize;
+        pPage->count = this->pageSize;
+        pPage->lastUse = ++this->clock;
+        this->pLastPage = pPage;
+        this->stored += this->pageSize;
+
+        // los elementos siguen en el almacen, el hook de borrado no se entera
+        al_setRemoveHook(this->pResident, NULL, NULL);
+        al_clear(this->pResident);
+        al_setRemoveHook(this->pResident, pRemoveHook, pRemoveHookContext);
+    }
+}
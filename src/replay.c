@@ -0,0 +1,522 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/replay.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#define makeDirectory(name) _mkdir(name)
+#define changeDirectory(name) _chdir(name)
+#define getDirectory(buffer, size) _getcwd(buffer, size)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define makeDirectory(name) mkdir(name, 0755)
+#define changeDirectory(name) chdir(name)
+#define getDirectory(buffer, size) getcwd(buffer, size)
+#endif
+
+// private functions
+int enterReplayDirectory(char *directory, char *pLiveDirectory, int size);
+int openTrace(ReplayTrace *this, char *path);
+int nextSample(ReplayTrace *this, long long *pTimestamp, float *pTemperature, int *pHumidity);
+int parseTraceLine(char *pLine, long long *pTimestamp, float *pTemperature, int *pHumidity);
+long long readTraceInteger(unsigned char *pBytes, int bytes);
+double replayClock(void);
+void waitUntil(double time);
+void addLatency(ReplayStats *this, double seconds);
+double getLatencyPercentile(ReplayStats *this, double fraction);
+void printReplayStats(ReplayStats *this, char *path, int binary, double speed);
+
+/**
+ * \brief Runs a recorded trace of readings through the classification and the storage of the ingest daemon and
+ *        reports the throughput and the time of each stage. The trace is a text file with one line
+ *        "timestamp,temperature,humidity" per reading (comma, semicolon or spaces) or a binary file that starts
+ *        with REPLAY_BINARY_MAGIC. Lines that do not start with a number are skipped. The log and the report
+ *        of the replay are written in the given directory, never over the live files of the current directory,
+ *        while the thresholds are read from the user configuration of the current directory
+ * \param char *path path of the trace
+ * \param char *directory directory for the files of the replay, created if it does not exist
+ * \param double speed [0] as fast as possible
+ *                     [> 0] the readings are released at the times of the trace divided by speed
+ * \return int value return (-1) if error [invalid parameters, can't open the trace, invalid directory or write failed]
+ *                           (0) if ok
+ */
+int replay_run(char *path, char *directory, double speed)
+{
+    int i;
+    int count;
+    int result;
+    int held = 0;
+    int started = 0;
+    int finished = 0;
+    int saveFailed = 0;
+    int value = -1;
+    int humidity = 0;
+    float temperature = 0;
+    long long timestamp = 0;
+    long long firstTimestamp = 0;
+    double start;
+    double due;
+    double times[REPLAY_STAGE_COUNT + 1];
+    char failedFile[SL_MAX_NAME_CHARS] = MECHATRONIC_MANIFEST_FILE;
+    char liveDirectory[REPLAY_MAX_PATH_CHARS];
+    char configName[REPLAY_MAX_PATH_CHARS + sizeof(MECHATRONIC_USER_CONFIG) + 1];
+    long long *pTimestamps = NULL;
+    float *pTemperatures = NULL;
+    int *pHumidities = NULL;
+    double *pArrivals = NULL;
+    Mechatronic *pEvents = NULL;
+    PagedStore *pPagedStore = NULL;
+    ReplayTrace trace;
+    ReplayStats stats;
+
+    memset(&trace, 0, sizeof(ReplayTrace));
+
+    if(path == NULL || directory == NULL || !(speed >= 0))
+        printf("\nERROR!, parametros de reproduccion invalidos.\n");
+
+    // la traza se abre antes de cambiar de directorio, las rutas relativas son las del usuario
+    else if(openTrace(&trace, path) != 0)
+        printf("\nERROR!, no se pudo abrir la traza '%s'.\n", path);
+
+    else if(enterReplayDirectory(directory, liveDirectory, REPLAY_MAX_PATH_CHARS) != 0)
+        printf("\nERROR!, no se puede usar '%s' para la reproduccion, debe ser un directorio distinto del actual.\n", directory);
+
+    else{
+        // los umbrales son los del directorio en vivo
+        sprintf(configName, "%s/%s", liveDirectory, MECHATRONIC_USER_CONFIG);
+
+        pTimestamps = (long long*)malloc(sizeof(long long) * REPLAY_BATCH_SIZE);
+        pTemperatures = (float*)malloc(sizeof(float) * REPLAY_BATCH_SIZE);
+        pHumidities = (int*)malloc(sizeof(int) * REPLAY_BATCH_SIZE);
+        pArrivals = (double*)malloc(sizeof(double) * REPLAY_BATCH_SIZE);
+        pEvents = (Mechatronic*)malloc(sizeof(Mechatronic) * REPLAY_BATCH_SIZE);
+
+        if(pTimestamps != NULL && pTemperatures != NULL && pHumidities != NULL && pArrivals != NULL && pEvents != NULL){
+            memset(&stats, 0, sizeof(ReplayStats));
+
+            // mismo arranque que el modo sin interaccion, los eventos no se mantienen en memoria
+            pPagedStore = mechatronic_newEventList();
+            value = mechatronic_createBinaryFile(pPagedStore);
+
+            if(value == 0){
+                value = mechatronic_openTextFile(pPagedStore);
+
+                if(value != 0)
+                    printf("ERROR!, no se pudo crear el archivo: %s/%s\n", directory, MECHATRONIC_OUTPUT_FILE);
+                else
+                    value = mechatronic_loadConfigFile(configName, pPagedStore);
+
+                mechatronic_evictEvents(pPagedStore);
+            }
+
+            if(value == 0){
+                printf("Reproduciendo '%s' en '%s'...\n", path, directory);
+                start = replayClock();
+
+                while(!finished && value == 0){
+                    count = 0;
+                    times[REPLAY_STAGE_READ] = replayClock();
+
+                    while(count < REPLAY_BATCH_SIZE){
+                        if(!held){
+                            result = nextSample(&trace, &timestamp, &temperature, &humidity);
+
+                            if(result == 0){
+                                finished = 1;
+                                break;
+                            }
+
+                            if(result < 0){
+                                stats.discarded++;
+                                continue;
+                            }
+
+                            if(!started){
+                                firstTimestamp = timestamp;
+                                started = 1;
+                            }
+
+                            held = 1;
+                        }
+
+                        // con velocidad la lectura espera su momento, el bloque se cierra con las que ya llegaron
+                        due = speed > 0 ? start + (timestamp - firstTimestamp) / speed : times[REPLAY_STAGE_READ];
+
+                        if(speed > 0 && due > replayClock()){
+                            if(count > 0)
+                                break;
+
+                            waitUntil(due);
+                            times[REPLAY_STAGE_READ] = replayClock();
+                        }
+
+                        pTimestamps[count] = timestamp;
+                        pTemperatures[count] = temperature;
+                        pHumidities[count] = humidity;
+                        pArrivals[count++] = due;
+                        held = 0;
+                    }
+
+                    if(count > 0){
+                        times[REPLAY_STAGE_CLASSIFY] = replayClock();
+                        mechatronic_newReadings(pEvents, 0, pTemperatures, pHumidities, count, 0);
+
+                        for(i = 0; i < count; i++)
+                            pEvents[i].timestamp = pTimestamps[i];
+
+                        times[REPLAY_STAGE_SAVE] = replayClock();
+
+                        if(mechatronic_saveEvents(pEvents, count, failedFile) != 0){
+                            saveFailed = 1;
+                            value = -1;
+                        }
+
+                        times[REPLAY_STAGE_COUNT] = replayClock();
+
+                        for(i = 0; i < REPLAY_STAGE_COUNT; i++){
+                            stats.stageSeconds[i] += times[i + 1] - times[i];
+
+                            if(times[i + 1] - times[i] > stats.stageMaxSeconds[i])
+                                stats.stageMaxSeconds[i] = times[i + 1] - times[i];
+                        }
+
+                        for(i = 0; i < count; i++)
+                            addLatency(&stats, times[REPLAY_STAGE_COUNT] - pArrivals[i]);
+
+                        stats.readings += count;
+                        stats.blocks++;
+                    }
+                }
+
+                stats.seconds = replayClock() - start;
+                printReplayStats(&stats, path, trace.binary, speed);
+
+                if(saveFailed)
+                    printf("ERROR!, no se pudieron guardar todos los eventos en: %s/%s.\n", directory, failedFile);
+            }
+
+            mechatronic_closeTextFile();
+            mechatronic_closeBinaryFile();
+            mechatronic_deleteEventList(pPagedStore);
+        }
+        else
+            printf("\nERROR!, no hay espacio en memoria RAM.\n");
+
+        // se vuelve al directorio de trabajo original
+        if(changeDirectory(liveDirectory) != 0){
+            printf("\nERROR!, no se pudo volver al directorio '%s'.\n", liveDirectory);
+            value = -1;
+        }
+    }
+
+    free(pTimestamps);
+    free(pTemperatures);
+    free(pHumidities);
+    free(pArrivals);
+    free(pEvents);
+    mf_deleteMappedFile(trace.pMappedFile);
+
+    return value;
+}
+
+/**
+ * \brief Moves the working directory to the directory of a replay, creating it if it does not exist. The files
+ *        of the replay keep their usual names there, so the directory can't be the current one
+ * \param char *directory directory for the files of the replay
+ * \param char *pLiveDirectory buffer for the current working directory before the change
+ * \param int size size of pLiveDirectory
+ * \return int value return (-1) if error [can't read the current directory, can't create or enter the directory or
+ *                                       it is the current one]
+ *                           (0) if ok
+ */
+int enterReplayDirectory(char *directory, char *pLiveDirectory, int size)
+{
+    int value = -1;
+    char current[REPLAY_MAX_PATH_CHARS];
+
+    if(getDirectory(pLiveDirectory, size) != NULL && (makeDirectory(directory) == 0 || errno == EEXIST)){
+
+        if(changeDirectory(directory) == 0){
+
+            // mismo directorio con otro nombre, los archivos en vivo se pisarian
+            if(getDirectory(current, REPLAY_MAX_PATH_CHARS) != NULL && strcmp(current, pLiveDirectory) != 0)
+                value = 0;
+            else
+                changeDirectory(pLiveDirectory);
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Maps a trace and detects its format
+ * \param ReplayTrace *this pointer to the trace
+ * \param char *path path of the trace
+ * \return int value return (-1) if error [can't map the file or unknown version of a binary trace]
+ *                           (0) if ok
+ */
+int openTrace(ReplayTrace *this, char *path)
+{
+    int value = -1;
+    unsigned char *pData = NULL;
+
+    this->pMappedFile = mf_newMappedFile(path);
+    this->binary = 0;
+    this->position = 0;
+
+    if(this->pMappedFile != NULL){
+        value = 0;
+        pData = (unsigned char*)this->pMappedFile->pData;
+
+        if(this->pMappedFile->size >= REPLAY_HEADER_SIZE && !memcmp(pData, REPLAY_BINARY_MAGIC, 4)){
+            this->binary = 1;
+            this->position = REPLAY_HEADER_SIZE;
+
+            if(readTraceInteger(pData + 4, 2) != REPLAY_BINARY_VERSION || readTraceInteger(pData + 6, 2) != REPLAY_RECORD_SIZE)
+                value = -1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reads the next reading of a trace. Text lines that do not start with a number are skipped
+ * \param ReplayTrace *this pointer to the trace
+ * \param long long *pTimestamp pointer where the time of the reading is written
+ * \param float *pTemperature pointer where the temperature is written
+ * \param int *pHumidity pointer where the humidity is written
+ * \return int value return (-1) if the reading is not valid [bad format, out of range or incomplete record]
+ *                           (0) at the end of the trace
+ *                           (1) if ok
+ */
+int nextSample(ReplayTrace *this, long long *pTimestamp, float *pTemperature, int *pHumidity)
+{
+    int value = 0;
+    int length;
+    unsigned int bits;
+    char *pData = (char*)this->pMappedFile->pData;
+    char *pEnd = NULL;
+    char line[REPLAY_MAX_LINE_CHARS];
+
+    if(this->binary && this->position < this->pMappedFile->size){
+        // un registro incompleto al final se descarta
+        if(this->pMappedFile->size - this->position < REPLAY_RECORD_SIZE){
+            this->position = this->pMappedFile->size;
+            value = -1;
+        }
+        else{
+            *pTimestamp = readTraceInteger((unsigned char*)pData + this->position, 8);
+            bits = (unsigned int)readTraceInteger((unsigned char*)pData + this->position + 8, 4);
+            memcpy(pTemperature, &bits, 4);
+            *pHumidity = (int)readTraceInteger((unsigned char*)pData + this->position + 12, 4);
+            this->position += REPLAY_RECORD_SIZE;
+
+            // mismos rangos que el ingreso manual
+            value = *pTemperature >= -20 && *pTemperature <= 60 && *pHumidity >= 0 && *pHumidity <= 100 ? 1 : -1;
+        }
+    }
+
+    while(!this->binary && value == 0 && this->position < this->pMappedFile->size){
+        pEnd = memchr(pData + this->position, '\n', this->pMappedFile->size - this->position);
+        length = (pEnd != NULL ? pEnd - pData : this->pMappedFile->size) - this->position;
+
+        if(length < REPLAY_MAX_LINE_CHARS){
+            memcpy(line, pData + this->position, length);
+            line[length] = '\0';
+            pEnd = line + strspn(line, " \t");
+
+            // los encabezados, comentarios y lineas vacias no son lecturas
+            if(isdigit((unsigned char)*pEnd) || *pEnd == '-' || *pEnd == '+')
+                value = parseTraceLine(pEnd, pTimestamp, pTemperature, pHumidity);
+        }
+        else
+            value = -1;
+
+        this->position += length + 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Parses a line "timestamp,temperature,humidity" of a text trace. The values are separated with a comma, a
+ *        semicolon or spaces
+ * \param char *pLine pointer to the line, ended with '\0'
+ * \param long long *pTimestamp pointer where the time of the reading is written
+ * \param float *pTemperature pointer where the temperature is written
+ * \param int *pHumidity pointer where the humidity is written
+ * \return int value return (-1) if the line is not valid [bad format or out of range]
+ *                           (1) if ok
+ */
+int parseTraceLine(char *pLine, long long *pTimestamp, float *pTemperature, int *pHumidity)
+{
+    int i;
+    int value = -1;
+    char *pNext = NULL;
+
+    *pTimestamp = strtoll(pLine, &pNext, 10);
+
+    for(i = 0; i < 2 && pNext != pLine; i++){
+        pLine = pNext + strspn(pNext, " \t");
+
+        if(*pLine == ',' || *pLine == ';')
+            pLine++;
+
+        if(i == 0)
+            *pTemperature = strtof(pLine, &pNext);
+        else
+            *pHumidity = (int)strtol(pLine, &pNext, 10);
+    }
+
+    if(i == 2 && pNext != pLine){
+        pNext += strspn(pNext, " \t\r");
+
+        // mismos rangos que el ingreso manual
+        if(*pNext == '\0' && *pTemperature >= -20 && *pTemperature <= 60 && *pHumidity >= 0 && *pHumidity <= 100)
+            value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reads a little endian integer of a binary trace
+ * \param unsigned char *pBytes pointer to the first byte
+ * \param int bytes number of bytes, up to 8
+ * \return long long value the integer, sign extended
+ */
+long long readTraceInteger(unsigned char *pBytes, int bytes)
+{
+    int i;
+    unsigned long long value = 0;
+
+    for(i = bytes - 1; i >= 0; i--)
+        value = value << 8 | pBytes[i];
+
+    // extension del signo para los enteros de menos de 8 bytes
+    if(bytes < 8 && (value >> (8 * bytes - 1)) & 1)
+        value |= ~0ULL << (8 * bytes);
+
+    return (long long)value;
+}
+
+/**
+ * \brief Gets the time of a monotonic clock
+ * \param -
+ * \return double value seconds since an unspecified point
+ */
+double replayClock(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * \brief Sleeps until a time of replayClock
+ * \param double time time to wake up
+ * \return void
+ */
+void waitUntil(double time)
+{
+    double remaining;
+    struct timespec wait;
+
+    while((remaining = time - replayClock()) > 0){
+        wait.tv_sec = (time_t)remaining;
+        wait.tv_nsec = (long)((remaining - wait.tv_sec) * 1e9);
+        nanosleep(&wait, NULL);
+    }
+}
+
+/**
+ * \brief Adds the latency of a reading, from its arrival until it is stored, to the histogram
+ * \param ReplayStats *this pointer to the statistics
+ * \param double seconds latency of the reading
+ * \return void
+ */
+void addLatency(ReplayStats *this, double seconds)
+{
+    int bucket = 0;
+    double microseconds = seconds * 1e6;
+
+    while(bucket < REPLAY_LATENCY_BUCKETS - 1 && microseconds >= (double)(1LL << bucket))
+        bucket++;
+
+    this->latencyCounts[bucket]++;
+
+    if(seconds > this->maxLatency)
+        this->maxLatency = seconds;
+}
+
+/**
+ * \brief Gets an upper bound of a percentile of the latency
+ * \param ReplayStats *this pointer to the statistics
+ * \param double fraction percentile as a fraction, between 0 and 1
+ * \return double value latency in microseconds under which the fraction of the readings is stored
+ */
+double getLatencyPercentile(ReplayStats *this, double fraction)
+{
+    int bucket = 0;
+    long long count = this->latencyCounts[0];
+
+    while(bucket < REPLAY_LATENCY_BUCKETS - 1 && count < fraction * this->readings)
+        count += this->latencyCounts[++bucket];
+
+    // el limite del intervalo no puede superar la latencia maxima
+    return (double)(1LL << bucket) < this->maxLatency * 1e6 ? (double)(1LL << bucket) : this->maxLatency * 1e6;
+}
+
+/**
+ * \brief Prints the throughput, the time of each stage and the latency of a replay
+ * \param ReplayStats *this pointer to the statistics
+ * \param char *path path of the trace
+ * \param int binary 1 if the trace is binary - 0 if it is text
+ * \param double speed speed of the replay, 0 is as fast as possible
+ * \return void
+ */
+void printReplayStats(ReplayStats *this, char *path, int binary, double speed)
+{
+    int i;
+    char *stageNames[REPLAY_STAGE_COUNT] = {"Lectura", "Clasificacion", "Guardado"};
+    char *instructionSets[] = {"escalar", "SSE2", "AVX2"};
+
+    printf("\nTraza: %s (%s)\n", path, binary ? "binaria" : "texto");
+
+    if(speed > 0)
+        printf("Velocidad: x%.2f\n", speed);
+    else
+        printf("Velocidad: maxima\n");
+
+    printf("Clasificacion: %s\n", instructionSets[cl_getInstructionSet()]);
+    printf("\nLecturas guardadas: %lld en %d bloques\nLecturas descartadas: %lld\n", this->readings, this->blocks, this->discarded);
+    printf("Tiempo total: %.3f s (%.0f lecturas/s)\n", this->seconds, this->seconds > 0 ? this->readings / this->seconds : 0);
+
+    printf("\n%-15s%12s%18s%18s\n", "Etapa", "Total (s)", "Lectura (ns)", "Max bloque (ms)");
+
+    for(i = 0; i < REPLAY_STAGE_COUNT; i++)
+        printf("%-15s%12.3f%18.1f%18.3f\n", stageNames[i], this->stageSeconds[i],
+               this->readings > 0 ? this->stageSeconds[i] / this->readings * 1e9 : 0, this->stageMaxSeconds[i] * 1e3);
+
+    if(this->readings > 0)
+        printf("\nLatencia hasta guardar: p50 <= %.0f us, p99 <= %.0f us, maxima %.0f us\n", getLatencyPercentile(this, 0.5),
+               getLatencyPercentile(this, 0.99), this->maxLatency * 1e6);
+}
@@ -0,0 +1,367 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/reportwriter.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define fileNumber(file) _fileno(file)
+#else
+#define fileNumber(file) fileno(file)
+#endif
+
+// private functions
+int countRows(char *fileName, char *header);
+void renderChunk(void *pContext, int index);
+
+/**
+ * \brief Open a text report for appending. If the file does not exist, its header does not match or it does not have
+ *        one line for every element of pPagedStore, the report is regenerated from pPagedStore
+ * \param char *fileName path of the report file
+ * \param char *header text written once at the beginning of the report
+ * \param pFunction (*pFunction) pointer to function that renders one element as a line of the report into the
+ *        formatter. It returns (0) if ok or (-1) if error
+ * \param PagedStore *pPagedStore pointer to paged store with the elements already stored
+ * \return ReportWriter *pAux Return (NULL) if error [invalid parameters or can't open the file]
+ *                                 - (pointer to new report writer) if ok
+ */
+ReportWriter *rw_newReportWriter(char *fileName, char *header, int (*pFunction)(TextFormatter*, void*), PagedStore *pPagedStore)
+{
+    ReportWriter *this = NULL;
+    ReportWriter *pAux = NULL;
+
+    if(fileName != NULL && header != NULL && pFunction != NULL && pPagedStore != NULL){
+        this = (ReportWriter*)malloc(sizeof(ReportWriter));
+
+        if(this != NULL){
+            this->fileName = fileName;
+            this->header = header;
+            this->pFunction = pFunction;
+            this->pFormatter = tf_newTextFormatter(RW_BUFFER_SIZE);
+            this->file = NULL;
+
+            // un informe cortado o con lineas de mas se genera de nuevo
+            if(this->pFormatter != NULL && countRows(fileName, header) == ps_len(pPagedStore)){
+                this->file = fopen(fileName, "a");
+
+                if(this->file != NULL)
+                    tf_setFile(this->pFormatter, fileNumber(this->file));
+            }
+
+            else if(this->pFormatter != NULL){
+                this->file = fopen(fileName, "w");
+
+                if(this->file != NULL && rw_regenerate(this, pPagedStore) != 0 && this->file != NULL){
+                    fclose(this->file);
+                    this->file = NULL;
+                }
+            }
+
+            if(this->file != NULL)
+                pAux = this;
+
+            else{
+                tf_deleteTextFormatter(this->pFormatter);
+                free(this);
+            }
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Append one element as a new line at the end of the report
+ * \param ReportWriter *this pointer to report writer
+ * \param void *pElement pointer to element
+ * \return int value return (-1) if error [this or pElement are NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int rw_append(ReportWriter *this, void *pElement)
+{
+    int value = -1;
+    int rendered;
+
+    if(this != NULL && this->file != NULL && pElement != NULL){
+        rendered = this->pFunction(this->pFormatter, pElement);
+
+        if(tf_flush(this->pFormatter) == 0 && rendered == 0)
+            value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append count consecutive elements as new lines at the end of the report, writing the file once
+ *        per full buffer
+ * \param ReportWriter *this pointer to report writer
+ * \param void *pElements pointer to the first element
+ * \param int elementSize size in bytes of every element
+ * \param int count number of elements
+ * \return int value return (-1) if error [this or pElements are NULL pointer, invalid sizes or write failed]
+ *                           (0) if ok
+ */
+int rw_appendArray(ReportWriter *this, void *pElements, int elementSize, int count)
+{
+    int i;
+    int value = -1;
+
+    if(this != NULL && this->file != NULL && pElements != NULL && elementSize > 0 && count >= 0){
+        value = 0;
+
+        for(i = 0; i < count && value == 0; i++){
+            if(this->pFunction(this->pFormatter, (char*)pElements + (size_t)elementSize * i) != 0)
+                value = -1;
+        }
+
+        if(tf_flush(this->pFormatter) != 0)
+            value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Truncate the report and write the header and every element of pPagedStore again. The elements are
+ *        rendered in parallel blocks with rw_renderStore
+ * \param ReportWriter *this pointer to report writer
+ * \param PagedStore *pPagedStore pointer to paged store
+ * \return int value return (-1) if error [this or pPagedStore are NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int rw_regenerate(ReportWriter *this, PagedStore *pPagedStore)
+{
+    int value = -1;
+
+    if(this != NULL && this->file != NULL && pPagedStore != NULL){
+        this->file = freopen(this->fileName, "w", this->file);
+
+        if(this->file != NULL){
+            tf_setFile(this->pFormatter, fileNumber(this->file));
+            value = tf_putString(this->pFormatter, this->header);
+
+            if(value == 0)
+                value = rw_renderStore(this->pFormatter, pPagedStore, this->pFunction);
+
+            if(tf_flush(this->pFormatter) != 0)
+                value = -1;
+
+            // a partir de aqui solo se agregan lineas al final del informe
+            this->file = freopen(this->fileName, "a", this->file);
+
+            if(this->file != NULL)
+                tf_setFile(this->pFormatter, fileNumber(this->file));
+            else
+                value = -1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Render every element of pPagedStore, in order, into pOutput. The elements are split in blocks that are read
+ *        and rendered at the same time by a pool of threads, each one into its own buffer. The buffers are written
+ *        in order with as few writes as possible
+ * \param TextFormatter *pOutput pointer to formatter with file descriptor where the text is written
+ * \param PagedStore *pPagedStore pointer to paged store, it can't be modified until the function returns
+ * \param pFunction (*pFunction) pointer to function that renders one element into the formatter. It is called from
+ *        several threads at once. It returns (0) if ok or (-1) if error
+ * \return int value return (-1) if error [NULL pointer, can't allocate memory, an element can't be read or a write
+ *                           failed]
+ *                           (0) if ok
+ */
+int rw_renderStore(TextFormatter *pOutput, PagedStore *pPagedStore, int (*pFunction)(TextFormatter*, void*))
+{
+    return rw_renderStoreThreads(pOutput, pPagedStore, pFunction, RW_RENDER_THREADS > 0 ? RW_RENDER_THREADS : wp_getProcessors());
+}
+
+/**
+ * \brief Render every element of pPagedStore, in order, into pOutput like rw_renderStore, with a given number of
+ *        threads. The text does not depend on the number of threads
+ * \param TextFormatter *pOutput pointer to formatter with file descriptor where the text is written
+ * \param PagedStore *pPagedStore pointer to paged store, it can't be modified until the function returns
+ * \param pFunction (*pFunction) pointer to function that renders one element into the formatter. It is called from
+ *        several threads at once. It returns (0) if ok or (-1) if error
+ * \param int threads number of threads of the pool, at least 1
+ * \return int value return (-1) if error [NULL pointer, invalid threads, can't allocate memory, an element can't be
+ *                           read or a write failed]
+ *                           (0) if ok
+ */
+int rw_renderStoreThreads(TextFormatter *pOutput, PagedStore *pPagedStore, int (*pFunction)(TextFormatter*, void*), int threads)
+{
+    int i;
+    int used;
+    int first;
+    int length;
+    int chunkCount;
+    int value = -1;
+    RenderChunk *pChunks = NULL;
+    TextFormatter **ppTexts = NULL;
+    WorkerPool *pWorkerPool = NULL;
+
+    length = ps_len(pPagedStore);
+
+    if(pOutput != NULL && pFunction != NULL && length >= 0 && threads > 0){
+        chunkCount = (length + RW_CHUNK_ELEMENTS - 1) / RW_CHUNK_ELEMENTS;
+
+        if(threads > chunkCount)
+            threads = chunkCount > 0 ? chunkCount : 1;
+
+        // la memoria depende de la cantidad de hilos, no del largo del historial
+        if(chunkCount > threads * RW_CHUNKS_PER_THREAD)
+            chunkCount = threads * RW_CHUNKS_PER_THREAD;
+
+        pChunks = (RenderChunk*)calloc(chunkCount > 0 ? chunkCount : 1, sizeof(RenderChunk));
+        ppTexts = (TextFormatter**)malloc(sizeof(TextFormatter*) * (chunkCount > 0 ? chunkCount : 1));
+        pWorkerPool = wp_newWorkerPool(threads);
+
+        if(pChunks != NULL && ppTexts != NULL && pWorkerPool != NULL)
+            value = 0;
+
+        for(i = 0; i < chunkCount && value == 0; i++){
+            pChunks[i].pPagedStore = pPagedStore;
+            pChunks[i].pFunction = pFunction;
+            pChunks[i].pElements = (char*)malloc((size_t)pPagedStore->elementSize * RW_CHUNK_ELEMENTS);
+            pChunks[i].pText = tf_newTextFormatter(RW_BUFFER_SIZE);
+            ppTexts[i] = pChunks[i].pText;
+
+            if(pChunks[i].pElements == NULL || pChunks[i].pText == NULL)
+                value = -1;
+        }
+
+        for(first = 0; first < length && value == 0;){
+            for(used = 0; used < chunkCount && first < length; used++){
+                pChunks[used].first = first;
+                pChunks[used].count = length - first < RW_CHUNK_ELEMENTS ? length - first : RW_CHUNK_ELEMENTS;
+                first += pChunks[used].count;
+            }
+
+            wp_run(pWorkerPool, renderChunk, pChunks, used);
+
+            for(i = 0; i < used; i++){
+                if(pChunks[i].failed)
+                    value = -1;
+            }
+
+            // los bloques se escriben en orden aunque hayan terminado en cualquier orden
+            if(tf_writeBuffers(pOutput, ppTexts, used) != 0)
+                value = -1;
+        }
+
+        for(i = 0; pChunks != NULL && i < chunkCount; i++){
+            free(pChunks[i].pElements);
+            tf_deleteTextFormatter(pChunks[i].pText);
+        }
+
+        wp_deleteWorkerPool(pWorkerPool);
+        free(pChunks);
+        free(ppTexts);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Close the report file and release the report writer
+ * \param ReportWriter *this pointer to report writer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int rw_deleteReportWriter(ReportWriter *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        if(this->file != NULL)
+            fclose(this->file);
+
+        tf_deleteTextFormatter(this->pFormatter);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Check if the file exists and begins with the given header, and count the lines written after it
+ * \param char *fileName path of the file
+ * \param char *header expected header
+ * \return int value return (-1) if error [the file can't be read, does not begin with header or its last line is
+ *                           not finished]
+ *                           (number of lines after the header) if ok
+ */
+int countRows(char *fileName, char *header)
+{
+    int i;
+    int value = -1;
+    int read;
+    char last = '\n';
+    char *pBuffer = NULL;
+    FILE *file = NULL;
+
+    file = fopen(fileName, "r");
+    pBuffer = (char*)malloc(RW_READ_CHARS);
+
+    if(file != NULL && pBuffer != NULL){
+        value = 0;
+
+        for(i = 0; header[i] != '\0' && value == 0; i++){
+            if(fgetc(file) != (unsigned char)header[i])
+                value = -1;
+        }
+
+        while(value >= 0 && (read = fread(pBuffer, 1, RW_READ_CHARS, file)) > 0){
+            for(i = 0; i < read; i++)
+                value += pBuffer[i] == '\n';
+
+            last = pBuffer[read - 1];
+        }
+
+        if(ferror(file) || last != '\n')
+            value = -1;
+    }
+
+    if(file != NULL)
+        fclose(file);
+
+    free(pBuffer);
+
+    return value;
+}
+
+/**
+ * \brief Read the elements of a block and render them into the buffer of the block. It is the task of the worker
+ *        pool that renders the report
+ * \param void *pContext pointer to the array of blocks
+ * \param int index position of the block in the array
+ * \return void
+ */
+void renderChunk(void *pContext, int index)
+{
+    int i;
+    int read;
+    RenderChunk *pChunk = (RenderChunk*)pContext + index;
+
+    read = ps_read(pChunk->pPagedStore, pChunk->first, pChunk->pElements, pChunk->count);
+    pChunk->failed = read != pChunk->count;
+
+    for(i = 0; i < read; i++){
+        if(pChunk->pFunction(pChunk->pText, pChunk->pElements + (size_t)pChunk->pPagedStore->elementSize * i) != 0)
+            pChunk->failed = 1;
+    }
+}
@@ -0,0 +1,179 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/ringbuffer.h"
+
+/**
+ * \brief Allocate a lock-free queue of fixed size elements for one producer thread and one consumer thread
+ * \param int elementSize size in bytes of every element
+ * \param int capacity maximum number of queued elements, rounded up to a power of two
+ * \return RingBuffer *pAux Return (NULL) if error [invalid parameters or if can't allocate memory]
+ *                               - (pointer to new ring buffer) if ok
+ */
+RingBuffer *rb_newRingBuffer(int elementSize, int capacity)
+{
+    unsigned int size = 1;
+    RingBuffer *this = NULL;
+    RingBuffer *pAux = NULL;
+
+    if(elementSize > 0 && capacity > 0 && capacity <= (1 << 30)){
+        // con una capacidad potencia de dos la posicion se obtiene con una mascara
+        while(size < (unsigned int)capacity)
+            size <<= 1;
+
+        this = (RingBuffer*)malloc(sizeof(RingBuffer));
+
+        if(this != NULL){
+            memset(this, 0, sizeof(RingBuffer));
+            this->pElements = (char*)malloc((size_t)elementSize * size);
+
+            if(this->pElements != NULL){
+                this->elementSize = elementSize;
+                this->capacity = size;
+                pAux = this;
+            }
+            else
+                free(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Copy an element at the end of the queue. Only the producer thread can call it
+ * \param RingBuffer *this pointer to ring buffer
+ * \param void *pElement pointer to element
+ * \return int value return (-1) if error [this or pElement are NULL pointer or the queue is full]
+ *                           (0) if ok
+ */
+int rb_push(RingBuffer *this, void *pElement)
+{
+    int value = -1;
+    unsigned int head;
+
+    if(this != NULL && pElement != NULL){
+        head = this->head;
+
+        // el indice del consumidor solo se vuelve a leer cuando la copia local indica que esta lleno
+        if(head - this->cachedTail == this->capacity)
+            this->cachedTail = __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE);
+
+        if(head - this->cachedTail < this->capacity){
+            memcpy(this->pElements + (size_t)this->elementSize * (head & (this->capacity - 1)), pElement, this->elementSize);
+            __atomic_store_n(&this->head, head + 1, __ATOMIC_RELEASE);
+            value = 0;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Copy up to count elements from the front of the queue and remove them. Only the consumer thread can call it
+ * \param RingBuffer *this pointer to ring buffer
+ * \param void *pElements pointer to an array of at least count elements
+ * \param int count maximum number of elements to copy
+ * \return int value return (-1) if error [this or pElements are NULL pointer or invalid count]
+ *                          (number of elements copied, 0 if the queue is empty) if ok
+ */
+int rb_popArray(RingBuffer *this, void *pElements, int count)
+{
+    int value = -1;
+    unsigned int tail;
+    unsigned int first;
+    unsigned int length;
+
+    if(this != NULL && pElements != NULL && count >= 0){
+        tail = this->tail;
+
+        if(this->cachedHead - tail < (unsigned int)count)
+            this->cachedHead = __atomic_load_n(&this->head, __ATOMIC_ACQUIRE);
+
+        length = this->cachedHead - tail;
+
+        if(length > (unsigned int)count)
+            length = count;
+
+        // los elementos pueden dar la vuelta al final del array
+        first = tail & (this->capacity - 1);
+
+        if(first + length > this->capacity){
+            memcpy(pElements, this->pElements + (size_t)this->elementSize * first, (size_t)this->elementSize * (this->capacity - first));
+            memcpy((char*)pElements + (size_t)this->elementSize * (this->capacity - first), this->pElements, (size_t)this->elementSize * (first + length - this->capacity));
+        }
+        else
+            memcpy(pElements, this->pElements + (size_t)this->elementSize * first, (size_t)this->elementSize * length);
+
+        __atomic_store_n(&this->tail, tail + length, __ATOMIC_RELEASE);
+        value = length;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Mark that the producer won't push more elements. Only the producer thread can call it
+ * \param RingBuffer *this pointer to ring buffer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int rb_close(RingBuffer *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        __atomic_store_n(&this->closed, 1, __ATOMIC_RELEASE);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Find if the producer closed the queue. The elements pushed before closing are still available after it
+ * \param RingBuffer *this pointer to ring buffer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if it is open
+ *                           (1) if it is closed
+ */
+int rb_isClosed(RingBuffer *this)
+{
+    int value = -1;
+
+    if(this != NULL)
+        value = __atomic_load_n(&this->closed, __ATOMIC_ACQUIRE);
+
+    return value;
+}
+
+/**
+ * \brief Release the ring buffer. No thread can be using it
+ * \param RingBuffer *this pointer to ring buffer
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int rb_deleteRingBuffer(RingBuffer *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        free(this->pElements);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
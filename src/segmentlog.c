@@ -0,0 +1,1281 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/segmentlog.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define fileSync(fd) _commit(fd)
+#define fileTruncate(fd, size) _chsize(fd, size)
+#define fileNumber(file) _fileno(file)
+#else
+#include <dirent.h>
+#include <unistd.h>
+#define fileSync(fd) fsync(fd)
+#define fileTruncate(fd, size) ftruncate(fd, size)
+#define fileNumber(file) fileno(file)
+#endif
+
+// private functions
+SegmentLog *allocSegmentLog(char *baseName, int headerSize, int recordSize);
+void setManifestHeader(SegmentLog *this, unsigned char *pHeader);
+void encodeSegment(Segment *pSegment, unsigned char *pBuffer);
+void decodeSegment(unsigned char *pBuffer, Segment *pSegment);
+void putManifestInteger(unsigned char *pBuffer, long long value, int bytes);
+long long getManifestInteger(unsigned char *pBuffer, int bytes);
+int loadManifest(SegmentLog *this);
+int readManifest(SegmentLog *this);
+int writeManifest(SegmentLog *this);
+int formatSegmentName(SegmentLog *this, int number, char *fileName, int size);
+int parseSegmentName(SegmentLog *this, char *entryName);
+int isListed(SegmentLog *this, int number);
+int sweepSegments(SegmentLog *this);
+int findSegment(SegmentLog *this, int record);
+int openActive(SegmentLog *this);
+int truncateActive(SegmentLog *this, char *fileName);
+int sealActive(SegmentLog *this);
+int fitsActive(SegmentLog *this, Segment *pSegment, long long timestamp);
+long long periodOf(SegmentLog *this, long long timestamp);
+int dropExpired(SegmentLog *this);
+int stopCompactor(SegmentLog *this);
+void *compactSegments(void *pArgument);
+
+/**
+ * \brief Open a log of fixed size records split in segment files named baseName.NNNNNN.bin and listed in order by
+ *        the manifest baseName.manifest. Every segment but the last is sealed and never written again, records are
+ *        only appended to the last one. If there is no manifest and the single file baseName.bin exists, it becomes
+ *        the first segment. Records are numbered from the first record ever appended, the numbers are kept when old
+ *        segments are dropped. The segment being written is checked before it is opened and cut at the first
+ *        damaged or incomplete record, the number of records removed is left in truncated. Segment files that the
+ *        manifest does not list, left by a crash while a segment was dropped or started, are deleted
+ * \param char *baseName path of the log without extension
+ * \param void *pHeader pointer to the header written at the beginning of every segment, (NULL) if they have no header
+ * \param int headerSize size in bytes of the header
+ * \param int recordSize size in bytes of every record
+ * \param long long (*pTimestampOf)(void*) function that returns the time of a record in seconds since the epoch
+ * \param int (*pIsValid)(void*) function that returns 1 if a record is not damaged, (NULL) to only remove an
+ *        incomplete last record
+ * \param int syncPolicy sync policy of the segment being written, see el_newEventLog
+ * \return SegmentLog *pAux Return (NULL) if error [invalid parameters, invalid manifest, can't open the files or
+ *                               can't allocate memory]
+ *                               - (pointer to new segment log) if ok
+ */
+SegmentLog *sl_newSegmentLog(char *baseName, void *pHeader, int headerSize, int recordSize, long long (*pTimestampOf)(void*), int (*pIsValid)(void*), int syncPolicy)
+{
+    SegmentLog *this = NULL;
+    SegmentLog *pAux = NULL;
+
+    if(headerSize >= 0 && (pHeader != NULL || headerSize == 0) && pTimestampOf != NULL && syncPolicy >= EL_SYNC_NONE && syncPolicy <= EL_SYNC_GROUP){
+        this = allocSegmentLog(baseName, headerSize, recordSize);
+
+        if(this != NULL){
+            this->pTimestampOf = pTimestampOf;
+            this->pIsValid = pIsValid;
+            this->syncPolicy = syncPolicy;
+            this->groupSize = EL_GROUP_SIZE;
+            this->groupInterval = EL_GROUP_INTERVAL;
+
+            if(headerSize > 0)
+                memcpy(this->pHeader, pHeader, headerSize);
+
+            if(loadManifest(this) == 0 && openActive(this) == 0)
+                pAux = this;
+            else
+                sl_deleteSegmentLog(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Open the manifest of a log only to list its segments, see sl_newSegmentLog. Nothing is written: the single
+ *        file of an old log is not renamed, the segment being written is neither checked nor cut, the compactor is
+ *        not started and records can't be appended. The segment files are read by the caller with sl_getFileName
+ * \param char *baseName path of the log without extension
+ * \param int headerSize size in bytes of the header of every segment
+ * \param int recordSize size in bytes of every record
+ * \return SegmentLog *pAux Return (NULL) if error [invalid parameters, there is no manifest or it is not valid or
+ *                               can't allocate memory]
+ *                               - (pointer to new segment log) if ok
+ */
+SegmentLog *sl_newReadOnlySegmentLog(char *baseName, int headerSize, int recordSize)
+{
+    SegmentLog *this = NULL;
+    SegmentLog *pAux = NULL;
+
+    if(headerSize >= 0){
+        this = allocSegmentLog(baseName, headerSize, recordSize);
+
+        if(this != NULL){
+            this->readOnly = 1;
+
+            if(readManifest(this) == 0){
+                this->first = ((Segment*)al_get(this->pSegments, 0))->first;
+                pAux = this;
+            }
+            else
+                sl_deleteSegmentLog(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Change the sync policy of the segment being written and of the next ones, see el_setSyncPolicy
+ * \param SegmentLog *this pointer to segment log
+ * \param int syncPolicy EL_SYNC_NONE, EL_SYNC_FLUSH, EL_SYNC_FULL or EL_SYNC_GROUP
+ * \param int groupSize maximum number of records of a group, only used by EL_SYNC_GROUP
+ * \param int groupInterval maximum time in milliseconds a record waits for its group, only used by EL_SYNC_GROUP
+ * \return int value return (-1) if error [this is NULL pointer or invalid parameters]
+ *                           (0) if ok
+ */
+int sl_setSyncPolicy(SegmentLog *this, int syncPolicy, int groupSize, int groupInterval)
+{
+    int value = -1;
+
+    if(this != NULL && syncPolicy >= EL_SYNC_NONE && syncPolicy <= EL_SYNC_GROUP && groupSize > 0 && groupInterval > 0){
+        pthread_mutex_lock(&this->mutex);
+
+        this->syncPolicy = syncPolicy;
+        this->groupSize = groupSize;
+        this->groupInterval = groupInterval;
+        value = el_setSyncPolicy(this->pActive, syncPolicy, groupSize, groupInterval);
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Set when the segment being written is sealed and a new one is started: before it holds more than
+ *        segmentRecords records, or before a record of a new period of segmentPeriod seconds is appended
+ * \param SegmentLog *this pointer to segment log
+ * \param int segmentRecords maximum number of records of a segment, (0) without limit
+ * \param int segmentPeriod length in seconds of the period of a segment, SL_DAY for a segment per day, (0) without limit
+ * \return int value return (-1) if error [this is NULL pointer or invalid parameters]
+ *                           (0) if ok
+ */
+int sl_setRotation(SegmentLog *this, int segmentRecords, int segmentPeriod)
+{
+    int value = -1;
+
+    if(this != NULL && segmentRecords >= 0 && segmentPeriod >= 0){
+        pthread_mutex_lock(&this->mutex);
+
+        this->segmentRecords = segmentRecords;
+        this->segmentPeriod = segmentPeriod;
+        value = 0;
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Set how long the records are kept. A background thread drops, every SL_COMPACT_INTERVAL seconds and after
+ *        a segment is sealed, the sealed segments whose last record is older than the retention. The segment being
+ *        written is never dropped and the writers are not blocked while the files are removed
+ * \param SegmentLog *this pointer to segment log
+ * \param long long retention time in seconds the records are kept, (0) to keep them forever
+ * \return int value return (-1) if error [this is NULL pointer, the log is read only, invalid retention or
+ *                           can't start the thread]
+ *                           (0) if ok
+ */
+int sl_setRetention(SegmentLog *this, long long retention)
+{
+    int value = -1;
+
+    if(this != NULL && !this->readOnly && retention >= 0){
+        pthread_mutex_lock(&this->mutex);
+
+        value = 0;
+        this->retention = retention;
+
+        if(retention == 0 && this->running)
+            stopCompactor(this);
+
+        else if(retention > 0 && !this->running){
+            this->running = 1;
+
+            if(pthread_create(&this->compactor, NULL, compactSegments, this) != 0){
+                this->running = 0;
+                value = -1;
+            }
+        }
+        // la nueva retencion se aplica sin esperar la proxima pasada
+        else
+            pthread_cond_signal(&this->condition);
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append one record to the segment being written, sealing it first if the record does not fit in it
+ * \param SegmentLog *this pointer to segment log
+ * \param void *pRecord pointer to the record to write
+ * \return int value return (-1) if error [this or pRecord are NULL pointer, the log is read only, write failed
+ *                           or can't start a new segment]
+ *                           (0) if ok
+ */
+int sl_append(SegmentLog *this, void *pRecord)
+{
+    return sl_appendArray(this, pRecord, 1);
+}
+
+/**
+ * \brief Append count consecutive records, with a single write per segment they are stored in
+ * \param SegmentLog *this pointer to segment log
+ * \param void *pRecords pointer to the first record
+ * \param int count number of records
+ * \return int value return (-1) if error [this or pRecords are NULL pointer, the log is read only, invalid count,
+ *                           write failed or can't start a new segment]
+ *                           (0) if ok
+ */
+int sl_appendArray(SegmentLog *this, void *pRecords, int count)
+{
+    int i;
+    int length;
+    int written;
+    int value = -1;
+    long long timestamp;
+    char *pRecord = NULL;
+    Segment segment;
+    Segment *pSegment = NULL;
+
+    if(this != NULL && !this->readOnly && pRecords != NULL && count >= 0){
+        pthread_mutex_lock(&this->mutex);
+        value = 0;
+
+        for(i = 0; i < count && value == 0; i += length){
+            pSegment = al_get(this->pSegments, al_len(this->pSegments) - 1);
+            segment = *pSegment;
+
+            // registros consecutivos que entran en el segmento activo
+            for(length = 0; i + length < count; length++){
+                pRecord = (char*)pRecords + (size_t)this->recordSize * (i + length);
+                timestamp = this->pTimestampOf(pRecord);
+
+                if(!fitsActive(this, &segment, timestamp))
+                    break;
+
+                if(segment.count == 0)
+                    segment.firstTimestamp = timestamp;
+
+                segment.lastTimestamp = timestamp;
+                segment.count++;
+            }
+
+            if(length == 0)
+                value = sealActive(this);
+
+            else if(this->pActive != NULL){
+                written = this->pActive->count;
+                value = el_appendArray(this->pActive, (char*)pRecords + (size_t)this->recordSize * i, length);
+                written = this->pActive->count - written;
+
+                if(written == length)
+                    *pSegment = segment;
+                else
+                    pSegment->count += written;
+
+                this->next += written;
+            }
+            else
+                value = -1;
+        }
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Read consecutive records, crossing from one segment to the next when needed
+ * \param SegmentLog *this pointer to segment log
+ * \param int record number of the first record to read
+ * \param void *pRecords pointer to a buffer of count records
+ * \param int count maximum number of records to read
+ * \return int value return (-1) if error [this or pRecords are NULL pointer, invalid parameters or the record was
+ *                          dropped]
+ *                          (number of records read, 0 after the last record) if ok
+ */
+int sl_read(SegmentLog *this, int record, void *pRecords, int count)
+{
+    int index;
+    int offset;
+    int length;
+    int read;
+    int stop = 0;
+    int value = -1;
+    FILE *file = NULL;
+    Segment *pSegment = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    if(this != NULL && pRecords != NULL && record >= 0 && count >= 0){
+        pthread_mutex_lock(&this->mutex);
+
+        if(record >= this->first){
+            value = 0;
+
+            // el segmento se busca en cada vuelta porque el compactador puede borrar los mas antiguos
+            while(!stop && value < count && (index = findSegment(this, record + value)) >= 0){
+                pSegment = al_get(this->pSegments, index);
+                offset = record + value - pSegment->first;
+                length = pSegment->count - offset < count - value ? pSegment->count - offset : count - value;
+                read = 0;
+
+                if(length > 0 && formatSegmentName(this, pSegment->number, fileName, sizeof(fileName)) == 0){
+                    if(!pSegment->sealed)
+                        el_flush(this->pActive);
+
+                    // los archivos se leen sin bloquear a los escritores, solo crecen al final
+                    pthread_mutex_unlock(&this->mutex);
+                    file = fopen(fileName, "rb");
+
+                    if(file != NULL){
+                        if(fseek(file, this->headerSize + (long)offset * this->recordSize, SEEK_SET) == 0)
+                            read = fread((char*)pRecords + (size_t)this->recordSize * value, this->recordSize, length, file);
+
+                        fclose(file);
+                    }
+
+                    pthread_mutex_lock(&this->mutex);
+                }
+
+                value += read;
+                stop = read == 0 || read < length;
+            }
+        }
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the number of segments of the log
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (number of segments) if ok
+ */
+int sl_len(SegmentLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+        value = al_len(this->pSegments);
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the number of the oldest record kept, the records before it were dropped with their segments
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (number of the first record) if ok
+ */
+int sl_getFirst(SegmentLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+        value = this->first;
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the file name of a segment. Sealed segments can be read without locking, they are not written again
+ * \param SegmentLog *this pointer to segment log
+ * \param int index position of the segment, from the oldest (0) to the segment being written (sl_len - 1)
+ * \param char *fileName buffer where the name is copied
+ * \param int size size of the buffer
+ * \return int value return (-1) if error [this or fileName are NULL pointer, invalid index or the buffer is too small]
+ *                           (0) if ok
+ */
+int sl_getFileName(SegmentLog *this, int index, char *fileName, int size)
+{
+    int value = -1;
+    Segment *pSegment = NULL;
+
+    if(this != NULL && fileName != NULL){
+        pthread_mutex_lock(&this->mutex);
+        pSegment = al_get(this->pSegments, index);
+
+        if(pSegment != NULL)
+            value = formatSegmentName(this, pSegment->number, fileName, size);
+
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Drop now the sealed segments older than the retention
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer, the log is read only or can't write the manifest]
+ *                          (number of segments dropped) if ok
+ */
+int sl_compact(SegmentLog *this)
+{
+    int value = -1;
+
+    if(this != NULL && !this->readOnly){
+        pthread_mutex_lock(&this->mutex);
+        value = dropExpired(this);
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Hand every pending record of the segment being written to the operating system, see el_flush
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer or flush failed]
+ *                           (0) if ok
+ */
+int sl_flush(SegmentLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+        value = el_flush(this->pActive);
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Force every pending record of the segment being written to the storage device, see el_sync
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer or sync failed]
+ *                           (0) if ok
+ */
+int sl_sync(SegmentLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+        value = el_sync(this->pActive);
+        pthread_mutex_unlock(&this->mutex);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Stop the compactor, close the segment being written and release the segment log
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int sl_deleteSegmentLog(SegmentLog *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        pthread_mutex_lock(&this->mutex);
+
+        if(this->running)
+            stopCompactor(this);
+
+        pthread_mutex_unlock(&this->mutex);
+
+        if(this->pActive != NULL)
+            el_deleteEventLog(this->pActive);
+
+        if(this->pSegments != NULL)
+            al_deleteArrayList(this->pSegments);
+
+        pthread_mutex_destroy(&this->mutex);
+        pthread_cond_destroy(&this->condition);
+        free(this->baseName);
+        free(this->manifestName);
+        free(this->pHeader);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Allocate a segment log without segments, with its names, header buffer and segment list
+ * \param char *baseName path of the log without extension
+ * \param int headerSize size in bytes of the header of every segment
+ * \param int recordSize size in bytes of every record
+ * \return SegmentLog *pAux Return (NULL) if error [invalid parameters or can't allocate memory]
+ *                               - (pointer to new segment log) if ok
+ */
+SegmentLog *allocSegmentLog(char *baseName, int headerSize, int recordSize)
+{
+    SegmentLog *this = NULL;
+    SegmentLog *pAux = NULL;
+
+    if(baseName != NULL && strlen(baseName) + 16 < SL_MAX_NAME_CHARS && recordSize > 0){
+        this = (SegmentLog*)malloc(sizeof(SegmentLog));
+
+        if(this != NULL){
+            memset(this, 0, sizeof(SegmentLog));
+            this->headerSize = headerSize;
+            this->recordSize = recordSize;
+            this->baseName = (char*)malloc(strlen(baseName) + 1);
+            this->manifestName = (char*)malloc(strlen(baseName) + 10);
+            this->pHeader = headerSize > 0 ? malloc(headerSize) : NULL;
+            this->pSegments = al_newTypedArrayList(sizeof(Segment));
+            pthread_mutex_init(&this->mutex, NULL);
+            pthread_cond_init(&this->condition, NULL);
+
+            if(this->baseName != NULL && this->manifestName != NULL && (headerSize == 0 || this->pHeader != NULL) && this->pSegments != NULL){
+                strcpy(this->baseName, baseName);
+                sprintf(this->manifestName, "%s.manifest", baseName);
+                pAux = this;
+            }
+            else
+                sl_deleteSegmentLog(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Write the header expected at the beginning of the manifest: magic, version, header size, entry size and
+ *        record size, the integers in little endian
+ * \param SegmentLog *this pointer to segment log
+ * \param unsigned char *pHeader buffer of SL_HEADER_SIZE bytes
+ * \return void
+ */
+void setManifestHeader(SegmentLog *this, unsigned char *pHeader)
+{
+    memset(pHeader, 0, SL_HEADER_SIZE);
+    memcpy(pHeader, SL_FILE_MAGIC, 4);
+    putManifestInteger(pHeader + 4, SL_FILE_VERSION, 2);
+    putManifestInteger(pHeader + 6, SL_HEADER_SIZE, 2);
+    putManifestInteger(pHeader + 8, SL_ENTRY_SIZE, 2);
+    putManifestInteger(pHeader + 12, this->recordSize, 4);
+}
+
+/**
+ * \brief Write a segment as it is listed in the manifest: number, first record, count of records and sealed in 4
+ *        bytes each, and the times of the first and the last record in 8 bytes each, in little endian
+ * \param Segment *pSegment pointer to the segment
+ * \param unsigned char *pBuffer buffer of SL_ENTRY_SIZE bytes
+ * \return void
+ */
+void encodeSegment(Segment *pSegment, unsigned char *pBuffer)
+{
+    putManifestInteger(pBuffer, pSegment->number, 4);
+    putManifestInteger(pBuffer + 4, pSegment->first, 4);
+    putManifestInteger(pBuffer + 8, pSegment->count, 4);
+    putManifestInteger(pBuffer + 12, pSegment->sealed, 4);
+    putManifestInteger(pBuffer + 16, pSegment->firstTimestamp, 8);
+    putManifestInteger(pBuffer + 24, pSegment->lastTimestamp, 8);
+}
+
+/**
+ * \brief Read a segment written with encodeSegment
+ * \param unsigned char *pBuffer buffer of SL_ENTRY_SIZE bytes
+ * \param Segment *pSegment pointer where the segment is written
+ * \return void
+ */
+void decodeSegment(unsigned char *pBuffer, Segment *pSegment)
+{
+    pSegment->number = (int)getManifestInteger(pBuffer, 4);
+    pSegment->first = (int)getManifestInteger(pBuffer + 4, 4);
+    pSegment->count = (int)getManifestInteger(pBuffer + 8, 4);
+    pSegment->sealed = (int)getManifestInteger(pBuffer + 12, 4);
+    pSegment->firstTimestamp = getManifestInteger(pBuffer + 16, 8);
+    pSegment->lastTimestamp = getManifestInteger(pBuffer + 24, 8);
+}
+
+/**
+ * \brief Writes an integer in little endian
+ * \param unsigned char *pBuffer buffer where the integer is written
+ * \param long long value integer to write
+ * \param int bytes number of bytes to write
+ * \return void
+ */
+void putManifestInteger(unsigned char *pBuffer, long long value, int bytes)
+{
+    int i;
+
+    for(i = 0; i < bytes; i++)
+        pBuffer[i] = (unsigned char)((unsigned long long)value >> (8 * i));
+}
+
+/**
+ * \brief Reads an integer written in little endian
+ * \param unsigned char *pBuffer buffer where the integer is read
+ * \param int bytes number of bytes to read
+ * \return long long value the integer read, without sign extension
+ */
+long long getManifestInteger(unsigned char *pBuffer, int bytes)
+{
+    int i;
+    unsigned long long value = 0;
+
+    for(i = 0; i < bytes; i++)
+        value |= (unsigned long long)pBuffer[i] << (8 * i);
+
+    return (long long)value;
+}
+
+/**
+ * \brief Load the segments listed in the manifest. Without manifest the log starts with a single segment, that takes
+ *        the place of the file of the log before it was split in segments if it exists
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [the manifest is not valid, can't rename the single file or can't write
+ *                           the new manifest]
+ *                           (0) if ok
+ */
+int loadManifest(SegmentLog *this)
+{
+    int value = -1;
+    FILE *file = NULL;
+    Segment segment;
+    char fileName[SL_MAX_NAME_CHARS];
+    char singleName[SL_MAX_NAME_CHARS];
+
+    file = fopen(this->manifestName, "rb");
+
+    if(file != NULL){
+        fclose(file);
+        value = readManifest(this);
+
+        // sin manifiesto no se sabe que segmentos son del registro, solo se limpia si se leyo
+        if(value == 0)
+            sweepSegments(this);
+    }
+    else{
+        memset(&segment, 0, sizeof(Segment));
+        segment.number = 1;
+        sprintf(singleName, "%s.bin", this->baseName);
+
+        if(formatSegmentName(this, segment.number, fileName, sizeof(fileName)) == 0 && al_add(this->pSegments, &segment) == 0){
+            value = 0;
+            file = fopen(singleName, "rb");
+
+            // si se cae antes de escribir el manifiesto, el segmento renombrado se retoma en el proximo inicio
+            if(file != NULL){
+                fclose(file);
+
+                if(rename(singleName, fileName) != 0)
+                    value = -1;
+            }
+
+            if(value == 0)
+                value = writeManifest(this);
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Read the segments listed in the manifest, checking that they follow each other and only the last one is open
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [can't read the manifest or it is not valid]
+ *                           (0) if ok
+ */
+int readManifest(SegmentLog *this)
+{
+    int value = -1;
+    long size;
+    FILE *file = NULL;
+    Segment segment;
+    Segment *pLast = NULL;
+    unsigned char header[SL_HEADER_SIZE];
+    unsigned char expected[SL_HEADER_SIZE];
+    unsigned char buffer[SL_ENTRY_SIZE];
+
+    file = fopen(this->manifestName, "rb");
+
+    if(file != NULL){
+        setManifestHeader(this, expected);
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+
+        if((size - SL_HEADER_SIZE) % SL_ENTRY_SIZE == 0 && fread(header, SL_HEADER_SIZE, 1, file) == 1 && !memcmp(header, expected, SL_HEADER_SIZE)){
+            value = 0;
+
+            // los segmentos deben seguirse sin huecos y solo el ultimo puede estar abierto
+            while(value == 0 && fread(buffer, SL_ENTRY_SIZE, 1, file) == 1){
+                decodeSegment(buffer, &segment);
+
+                if((pLast != NULL && (!pLast->sealed || segment.number <= pLast->number || segment.first != pLast->first + pLast->count)) || al_add(this->pSegments, &segment) != 0)
+                    value = -1;
+                else
+                    pLast = al_get(this->pSegments, al_len(this->pSegments) - 1);
+            }
+
+            if(pLast == NULL || pLast->sealed)
+                value = -1;
+        }
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Write the manifest to a temporary file and replace the previous one with it, so a crash leaves either the
+ *        previous or the new manifest
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [can't write or replace the manifest]
+ *                           (0) if ok
+ */
+int writeManifest(SegmentLog *this)
+{
+    int i;
+    int value = -1;
+    FILE *file = NULL;
+    unsigned char header[SL_HEADER_SIZE];
+    unsigned char buffer[SL_ENTRY_SIZE];
+    char tempName[SL_MAX_NAME_CHARS];
+
+    sprintf(tempName, "%s.tmp", this->manifestName);
+    file = fopen(tempName, "wb");
+
+    if(file != NULL){
+        setManifestHeader(this, header);
+
+        if(fwrite(header, SL_HEADER_SIZE, 1, file) == 1)
+            value = 0;
+
+        for(i = 0; i < al_len(this->pSegments) && value == 0; i++){
+            encodeSegment(al_get(this->pSegments, i), buffer);
+
+            if(fwrite(buffer, SL_ENTRY_SIZE, 1, file) != 1)
+                value = -1;
+        }
+
+        if(value == 0 && (fflush(file) != 0 || fileSync(fileNumber(file)) != 0))
+            value = -1;
+
+        if(fclose(file) != 0)
+            value = -1;
+
+        if(value == 0){
+#ifdef _WIN32
+            remove(this->manifestName);
+#endif
+
+            if(rename(tempName, this->manifestName) != 0)
+                value = -1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Write the file name of a segment
+ * \param SegmentLog *this pointer to segment log
+ * \param int number number of the segment
+ * \param char *fileName buffer where the name is written
+ * \param int size size of the buffer
+ * \return int value return (-1) if error [the buffer is too small]
+ *                           (0) if ok
+ */
+int formatSegmentName(SegmentLog *this, int number, char *fileName, int size)
+{
+    int length = snprintf(fileName, size, "%s.%06d.bin", this->baseName, number);
+
+    return length >= 0 && length < size ? 0 : -1;
+}
+
+/**
+ * \brief Get the number of a segment from the name of a file of its directory
+ * \param SegmentLog *this pointer to segment log
+ * \param char *entryName name of the file, without the directory
+ * \return int value return (-1) if error [the name is not baseName.NNNNNN.bin]
+ *                          (number of the segment) if ok
+ */
+int parseSegmentName(SegmentLog *this, char *entryName)
+{
+    int value = -1;
+    int digits;
+    char *pPrefix = NULL;
+    size_t length;
+
+    // el nombre del registro sin el directorio
+    pPrefix = strrchr(this->baseName, '/');
+#ifdef _WIN32
+    if(strrchr(this->baseName, '\\') > pPrefix)
+        pPrefix = strrchr(this->baseName, '\\');
+#endif
+    pPrefix = pPrefix != NULL ? pPrefix + 1 : this->baseName;
+    length = strlen(pPrefix);
+
+    if(!strncmp(entryName, pPrefix, length) && entryName[length] == '.'){
+        entryName += length + 1;
+        digits = strspn(entryName, "0123456789");
+
+        // los numeros tienen al menos 6 cifras y entran en un int
+        if(digits >= 6 && digits <= 9 && !strcmp(entryName + digits, ".bin"))
+            value = atoi(entryName);
+
+        // solo son segmentos los nombres que escribe formatSegmentName, sin ceros de mas
+        if(value >= 0 && digits > 6 && *entryName == '0')
+            value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Check if the manifest lists a segment
+ * \param SegmentLog *this pointer to segment log
+ * \param int number number of the segment
+ * \return int value 1 if it is listed - 0 if not
+ */
+int isListed(SegmentLog *this, int number)
+{
+    int low = 0;
+    int high = al_len(this->pSegments) - 1;
+    int middle;
+    int value = 0;
+    Segment *pSegment = NULL;
+
+    // los numeros del manifiesto son crecientes
+    while(low <= high && !value){
+        middle = low + (high - low) / 2;
+        pSegment = al_get(this->pSegments, middle);
+
+        if(pSegment->number == number)
+            value = 1;
+        else if(pSegment->number < number)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Delete the segment files of the directory of the log that the manifest does not list. The manifest is
+ *        written before a segment file is deleted or created, so a crash can leave the file of a segment already
+ *        dropped or of one that was never started
+ * \param SegmentLog *this pointer to segment log
+ * \return int value number of files deleted
+ */
+int sweepSegments(SegmentLog *this)
+{
+    int value = 0;
+    int number;
+    char fileName[SL_MAX_NAME_CHARS];
+    char directory[SL_MAX_NAME_CHARS];
+    char *pSlash = NULL;
+
+    strcpy(directory, this->baseName);
+    pSlash = strrchr(directory, '/');
+#ifdef _WIN32
+    if(strrchr(directory, '\\') > pSlash)
+        pSlash = strrchr(directory, '\\');
+#endif
+
+    if(pSlash != NULL)
+        pSlash[1] = '\0';
+    else
+        directory[0] = '\0';
+
+#ifdef _WIN32
+    intptr_t handle;
+    struct _finddata_t entry;
+
+    snprintf(fileName, sizeof(fileName), "%s*.bin", directory);
+    handle = _findfirst(fileName, &entry);
+
+    if(handle != -1){
+        do{
+            number = parseSegmentName(this, entry.name);
+
+            if(number >= 0 && !isListed(this, number) && formatSegmentName(this, number, fileName, sizeof(fileName)) == 0 && remove(fileName) == 0)
+                value++;
+        }while(_findnext(handle, &entry) == 0);
+
+        _findclose(handle);
+    }
+#else
+    DIR *pDirectory = NULL;
+    struct dirent *pEntry = NULL;
+
+    pDirectory = opendir(directory[0] != '\0' ? directory : ".");
+
+    if(pDirectory != NULL){
+        while((pEntry = readdir(pDirectory)) != NULL){
+            number = parseSegmentName(this, pEntry->d_name);
+
+            if(number >= 0 && !isListed(this, number) && formatSegmentName(this, number, fileName, sizeof(fileName)) == 0 && remove(fileName) == 0)
+                value++;
+        }
+
+        closedir(pDirectory);
+    }
+#endif
+
+    return value;
+}
+
+/**
+ * \brief Find the segment that holds a record. The mutex must be locked
+ * \param SegmentLog *this pointer to segment log
+ * \param int record number of the record
+ * \return int value return (-1) if error [the record was dropped]
+ *                          (position of the last segment that starts at or before the record) if ok
+ */
+int findSegment(SegmentLog *this, int record)
+{
+    int low = 0;
+    int high = al_len(this->pSegments) - 1;
+    int middle;
+    int value = -1;
+    Segment *pSegment = NULL;
+
+    while(low <= high){
+        middle = low + (high - low) / 2;
+        pSegment = al_get(this->pSegments, middle);
+
+        if(pSegment->first <= record){
+            value = middle;
+            low = middle + 1;
+        }
+        else
+            high = middle - 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Open the last segment of the manifest for appending, once its damaged records are removed. Its number of
+ *        records and the time of its first and last records are taken from the file, the manifest is only written
+ *        when a segment is sealed. The mutex must be locked or the log not shared yet
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [can't open the segment or can't allocate memory]
+ *                           (0) if ok
+ */
+int openActive(SegmentLog *this)
+{
+    int value = -1;
+    FILE *file = NULL;
+    Segment *pSegment = NULL;
+    void *pRecord = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    pSegment = al_get(this->pSegments, al_len(this->pSegments) - 1);
+    pRecord = malloc(this->recordSize);
+
+    if(pSegment != NULL && pRecord != NULL && formatSegmentName(this, pSegment->number, fileName, sizeof(fileName)) == 0 && truncateActive(this, fileName) == 0){
+        this->pActive = el_newEventLog(fileName, this->pHeader, this->headerSize, this->recordSize, EL_SYNC_NONE);
+
+        if(this->pActive != NULL && el_setSyncPolicy(this->pActive, this->syncPolicy, this->groupSize, this->groupInterval) == 0){
+            value = 0;
+            pSegment->count = this->pActive->count;
+            pSegment->firstTimestamp = 0;
+            pSegment->lastTimestamp = 0;
+
+            // las fechas del primer y el ultimo registro deciden cuando se sella el segmento
+            if(pSegment->count > 0){
+                file = fopen(fileName, "rb");
+
+                if(file != NULL){
+                    if(fseek(file, this->headerSize, SEEK_SET) == 0 && fread(pRecord, this->recordSize, 1, file) == 1)
+                        pSegment->firstTimestamp = this->pTimestampOf(pRecord);
+
+                    if(fseek(file, this->headerSize + (long)(pSegment->count - 1) * this->recordSize, SEEK_SET) == 0 && fread(pRecord, this->recordSize, 1, file) == 1)
+                        pSegment->lastTimestamp = this->pTimestampOf(pRecord);
+
+                    fclose(file);
+                }
+            }
+
+            this->first = ((Segment*)al_get(this->pSegments, 0))->first;
+            this->next = pSegment->first + pSegment->count;
+        }
+        else if(this->pActive != NULL){
+            el_deleteEventLog(this->pActive);
+            this->pActive = NULL;
+        }
+    }
+
+    free(pRecord);
+
+    return value;
+}
+
+/**
+ * \brief Cut the segment being written at its first damaged record, or at its last record if the file ends with an
+ *        incomplete one, as left by a write interrupted by a crash or a power cut. Records after a damaged one are
+ *        removed too, they can't be trusted and the numbering must not have gaps
+ * \param SegmentLog *this pointer to segment log
+ * \param char *fileName path of the segment
+ * \return int value return (-1) if error [can't read or cut the file]
+ *                           (0) if ok, also when the file does not exist yet
+ */
+int truncateActive(SegmentLog *this, char *fileName)
+{
+    int i;
+    int count;
+    int value = 0;
+    int stop = 0;
+    long size;
+    long length;
+    FILE *file = NULL;
+    char *pRecords = NULL;
+
+    file = fopen(fileName, "r+b");
+
+    if(file != NULL){
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+        length = size < this->headerSize ? 0 : this->headerSize;
+        pRecords = (char*)malloc((size_t)this->recordSize * SL_READ_CHUNK + this->headerSize);
+
+        if(pRecords == NULL)
+            value = -1;
+
+        // un segmento de otro formato no se corta, se rechaza sin tocar sus registros
+        else if(length > 0 && (fread(pRecords, 1, this->headerSize, file) != (size_t)this->headerSize || memcmp(pRecords, this->pHeader, this->headerSize)))
+            value = -1;
+
+        if(value == 0 && size > this->headerSize){
+            while(value == 0 && !stop && (count = fread(pRecords, this->recordSize, SL_READ_CHUNK, file)) > 0){
+                for(i = 0; i < count && !stop; i++){
+                    if(this->pIsValid != NULL && !this->pIsValid(pRecords + (size_t)this->recordSize * i))
+                        stop = 1;
+                    else
+                        length += this->recordSize;
+                }
+            }
+        }
+
+        free(pRecords);
+
+        // un encabezado escrito a medias se descarta y se vuelve a escribir al abrir el segmento
+        if(value == 0 && length < size){
+            if(length > 0)
+                this->truncated += (size - length + this->recordSize - 1) / this->recordSize;
+
+            if(fflush(file) != 0 || fileTruncate(fileNumber(file), length) != 0)
+                value = -1;
+        }
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Seal the segment being written and start the next one. The sealed segment is forced to the storage device
+ *        before it is listed as sealed. If the new segment can't be started the previous one is kept open. The mutex
+ *        must be locked
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [can't write the manifest or can't open the new segment]
+ *                           (0) if ok
+ */
+int sealActive(SegmentLog *this)
+{
+    int value = -1;
+    int last = al_len(this->pSegments) - 1;
+    Segment segment;
+    Segment *pSegment = NULL;
+
+    el_sync(this->pActive);
+    el_deleteEventLog(this->pActive);
+    this->pActive = NULL;
+
+    pSegment = al_get(this->pSegments, last);
+    pSegment->sealed = 1;
+
+    memset(&segment, 0, sizeof(Segment));
+    segment.number = pSegment->number + 1;
+    segment.first = pSegment->first + pSegment->count;
+
+    if(al_add(this->pSegments, &segment) == 0 && writeManifest(this) == 0 && openActive(this) == 0){
+        pthread_cond_signal(&this->condition);
+        value = 0;
+    }
+    else{
+        if(al_len(this->pSegments) > last + 1)
+            al_remove(this->pSegments, last + 1);
+
+        pSegment = al_get(this->pSegments, last);
+        pSegment->sealed = 0;
+        writeManifest(this);
+        openActive(this);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Check if a record can be appended to a segment without breaking its limits of records and period
+ * \param SegmentLog *this pointer to segment log
+ * \param Segment *pSegment pointer to the segment
+ * \param long long timestamp time of the record in seconds since the epoch
+ * \return int value 1 if the record fits in the segment - 0 if not
+ */
+int fitsActive(SegmentLog *this, Segment *pSegment, long long timestamp)
+{
+    int value = 1;
+
+    if(pSegment->count > 0){
+        if(this->segmentRecords > 0 && pSegment->count >= this->segmentRecords)
+            value = 0;
+
+        else if(this->segmentPeriod > 0 && periodOf(this, timestamp) != periodOf(this, pSegment->firstTimestamp))
+            value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the start of the period of a segment that contains a time
+ * \param SegmentLog *this pointer to segment log
+ * \param long long timestamp time in seconds since the epoch
+ * \return long long value start of the period in seconds since the epoch
+ */
+long long periodOf(SegmentLog *this, long long timestamp)
+{
+    long long value = timestamp - timestamp % this->segmentPeriod;
+
+    if(timestamp < 0 && value != timestamp)
+        value -= this->segmentPeriod;
+
+    return value;
+}
+
+/**
+ * \brief Drop the sealed segments whose last record is older than the retention, from the oldest on. Each segment
+ *        is first removed from the manifest and then its file is deleted, with the mutex released. The mutex must
+ *        be locked
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [can't write the manifest]
+ *                          (number of segments dropped) if ok
+ */
+int dropExpired(SegmentLog *this)
+{
+    int value = 0;
+    long long limit;
+    Segment removed;
+    Segment *pSegment = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    if(this->retention > 0){
+        limit = (long long)time(NULL) - this->retention;
+        pSegment = al_get(this->pSegments, 0);
+
+        // el segmento activo nunca esta sellado, asi que siempre queda al menos uno
+        while(value >= 0 && pSegment->sealed && pSegment->lastTimestamp < limit){
+            removed = *pSegment;
+            al_remove(this->pSegments, 0);
+
+            if(writeManifest(this) != 0){
+                al_push(this->pSegments, 0, &removed);
+                value = -1;
+            }
+            else{
+                pSegment = al_get(this->pSegments, 0);
+                this->first = pSegment->first;
+                formatSegmentName(this, removed.number, fileName, sizeof(fileName));
+
+                pthread_mutex_unlock(&this->mutex);
+                remove(fileName);
+                pthread_mutex_lock(&this->mutex);
+
+                pSegment = al_get(this->pSegments, 0);
+                value++;
+            }
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Stop the compactor thread and wait for it. The mutex must be locked
+ * \param SegmentLog *this pointer to segment log
+ * \return int value return (-1) if error [can't join the thread]
+ *                           (0) if ok
+ */
+int stopCompactor(SegmentLog *this)
+{
+    int value;
+
+    this->running = 0;
+    pthread_cond_signal(&this->condition);
+    pthread_mutex_unlock(&this->mutex);
+    value = pthread_join(this->compactor, NULL) == 0 ? 0 : -1;
+    pthread_mutex_lock(&this->mutex);
+
+    return value;
+}
+
+/**
+ * \brief Body of the compactor thread. Drops the expired segments every SL_COMPACT_INTERVAL seconds or when a
+ *        segment is sealed
+ * \param void *pArgument pointer to segment log
+ * \return void *value (NULL)
+ */
+void *compactSegments(void *pArgument)
+{
+    struct timespec deadline;
+    SegmentLog *this = (SegmentLog*)pArgument;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while(this->running){
+        dropExpired(this);
+
+        // mientras se borraban archivos se pudo pedir la detencion
+        if(this->running){
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += SL_COMPACT_INTERVAL;
+            pthread_cond_timedwait(&this->condition, &this->mutex, &deadline);
+        }
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
@@ -0,0 +1,203 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/terminal.h"
+
+#ifdef _WIN32
+#include <conio.h>
+#include <io.h>
+#include <windows.h>
+
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+
+#define isConsole(fd) _isatty(fd)
+#else
+#include <termios.h>
+#include <unistd.h>
+
+#define isConsole(fd) isatty(fd)
+#endif
+
+// private functions
+void clearConsole(void);
+int waitKey(void);
+
+int ansiConsole = 1;
+
+/**
+ * \brief Prepare the console. The standard output is fully buffered, so every screen is written at once when the
+ *        program waits for the user, and on Windows the console is set to understand ANSI sequences
+ * \param void
+ * \return int value return (-1) if error [the console does not support ANSI sequences, tm_clear uses the console API]
+ *                           (0) if ok
+ */
+int tm_init(void)
+{
+    int value = 0;
+
+#ifdef _WIN32
+    DWORD mode;
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+
+    if(!GetConsoleMode(console, &mode) || !SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING)){
+        ansiConsole = 0;
+        value = -1;
+    }
+#endif
+
+    setvbuf(stdout, NULL, _IOFBF, TM_OUTPUT_BUFFER);
+
+    return value;
+}
+
+/**
+ * \brief Start a new screen: the console is cleared and the cursor goes to the top left corner.
+ *        The clear is buffered with the rest of the screen
+ * \param void
+ * \return void
+ */
+void tm_clear(void)
+{
+    if(ansiConsole)
+        fputs(TM_CLEAR_SEQUENCE, stdout);
+    else
+        clearConsole();
+}
+
+/**
+ * \brief Write the buffered screen to the console
+ * \param void
+ * \return void
+ */
+void tm_flush(void)
+{
+    fflush(stdout);
+}
+
+/**
+ * \brief Show the buffered screen and wait until the user presses a key. When the input is not a console
+ *        there is nobody to wait for and it returns right away
+ * \param void
+ * \return void
+ */
+void tm_pause(void)
+{
+    if(isConsole(0)){
+        fputs(TM_PAUSE_MESSAGE, stdout);
+        fflush(stdout);
+        waitKey();
+        fputs("\n", stdout);
+    }
+
+    fflush(stdout);
+}
+
+/**
+ * \brief Show the buffered screen and read a line typed by the user, without the line break
+ * \param char *input buffer where the line is loaded
+ * \param int size size of the buffer, longer lines are cut and the rest is discarded
+ * \return int value return (-1) if error [invalid parameters or end of the input, input is left empty]
+ *                           (0) if ok
+ */
+int tm_readLine(char *input, int size)
+{
+    int c;
+    int length;
+    int value = -1;
+
+    if(input != NULL && size > 0){
+        fflush(stdout);
+        input[0] = '\0';
+
+        if(fgets(input, size, stdin) != NULL){
+            length = strlen(input);
+
+            if(length > 0 && input[length - 1] == '\n')
+                input[--length] = '\0';
+
+            // el resto de una linea demasiado larga no debe quedar para la proxima lectura
+            else{
+                while((c = getchar()) != '\n' && c != EOF)
+                    ;
+            }
+
+            if(length > 0 && input[length - 1] == '\r')
+                input[--length] = '\0';
+
+            value = 0;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Clear the console without ANSI sequences. Only used by Windows consoles that don't support them
+ * \param void
+ * \return void
+ */
+void clearConsole(void)
+{
+#ifdef _WIN32
+    DWORD written;
+    COORD origin = {0, 0};
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+
+    // lo pendiente pertenece a la pantalla anterior
+    fflush(stdout);
+
+    if(GetConsoleScreenBufferInfo(console, &info)){
+        FillConsoleOutputCharacter(console, ' ', info.dwSize.X * info.dwSize.Y, origin, &written);
+        FillConsoleOutputAttribute(console, info.wAttributes, info.dwSize.X * info.dwSize.Y, origin, &written);
+        SetConsoleCursorPosition(console, origin);
+    }
+#else
+    fputs(TM_CLEAR_SEQUENCE, stdout);
+#endif
+}
+
+/**
+ * \brief Wait for a single key press, without echo and without waiting for a line break
+ * \param void
+ * \return int value the key pressed - EOF if the input ended
+ */
+int waitKey(void)
+{
+    int value;
+
+#ifdef _WIN32
+    value = _getch();
+#else
+    struct termios previous;
+    struct termios raw;
+
+    if(tcgetattr(0, &previous) == 0){
+        raw = previous;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(0, TCSANOW, &raw);
+        value = getchar();
+        tcsetattr(0, TCSANOW, &previous);
+    }
+    else
+        value = getchar();
+#endif
+
+    return value;
+}
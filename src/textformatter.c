@@ -0,0 +1,493 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+#include "../inc/textformatter.h"
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define fileWrite(fd, pChars, count) _write(fd, pChars, count)
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#define fileWrite(fd, pChars, count) write(fd, pChars, count)
+#endif
+
+// private functions
+void writeChars(TextFormatter *this, char *pChars, int count);
+void growBuffer(TextFormatter *this, int size);
+char *putDigits(char *pEnd, unsigned long long number);
+int countDigits(unsigned long long number);
+
+// pares de digitos del 00 al 99, se convierten dos digitos por division
+char digitPairs[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+/**
+ * \brief Allocate a formatter that renders text into a reusable buffer of size bytes. The buffer is written to the
+ *        file descriptor with one write when it is full or when tf_flush is called. Until tf_setFile is called the
+ *        buffer grows instead, keeping all the text until it is written with tf_writeBuffers
+ * \param int size size in bytes of the buffer, not less than TF_MAX_NUMBER_CHARS
+ * \return TextFormatter *pAux Return (NULL) if error [invalid size or if can't allocate memory]
+ *                                  - (pointer to new formatter) if ok
+ */
+TextFormatter *tf_newTextFormatter(int size)
+{
+    TextFormatter *this = NULL;
+    TextFormatter *pAux = NULL;
+
+    // un numero siempre entra completo en el buffer
+    if(size >= TF_MAX_NUMBER_CHARS){
+        this = (TextFormatter*)malloc(sizeof(TextFormatter));
+
+        if(this != NULL){
+            this->fd = -1;
+            this->size = size;
+            this->length = 0;
+            this->failed = 0;
+            this->pBuffer = (char*)malloc(size);
+
+            if(this->pBuffer != NULL)
+                pAux = this;
+            else
+                free(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Set the file descriptor where the buffer is written. The text already in the buffer is not written
+ * \param TextFormatter *this pointer to formatter
+ * \param int fd file descriptor opened for writing
+ * \return int value return (-1) if error [this is NULL pointer or fd is invalid]
+ *                           (0) if ok
+ */
+int tf_setFile(TextFormatter *this, int fd)
+{
+    int value = -1;
+
+    if(this != NULL && fd >= 0){
+        this->fd = fd;
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append count characters
+ * \param TextFormatter *this pointer to formatter
+ * \param char *pChars pointer to the characters
+ * \param int count number of characters
+ * \return int value return (-1) if error [this or pChars are NULL pointer, count is negative or write failed]
+ *                           (0) if ok
+ */
+int tf_putChars(TextFormatter *this, char *pChars, int count)
+{
+    int value = -1;
+    char *pBuffer = NULL;
+
+    if(this != NULL && pChars != NULL && count >= 0){
+        if(count <= this->size || this->fd < 0){
+            pBuffer = tf_reserve(this, count);
+
+            if(pBuffer != NULL){
+                memcpy(pBuffer, pChars, count);
+                this->length += count;
+            }
+        }
+        else{
+            // un texto mas grande que el buffer se escribe directamente, despues de lo pendiente
+            writeChars(this, this->pBuffer, this->length);
+            writeChars(this, pChars, count);
+            this->length = 0;
+        }
+
+        value = this->failed ? -1 : 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Append a string, the same as printf "%s"
+ * \param TextFormatter *this pointer to formatter
+ * \param char *string string ended with '\0'
+ * \return int value return (-1) if error [this or string are NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int tf_putString(TextFormatter *this, char *string)
+{
+    int value = -1;
+
+    if(string != NULL)
+        value = tf_putChars(this, string, strlen(string));
+
+    return value;
+}
+
+/**
+ * \brief Make room for up to count characters at the end of the buffer, writing the buffer first if they don't fit.
+ *        The characters are rendered directly in the buffer with the tf_format functions and appended with tf_commit
+ * \param TextFormatter *this pointer to formatter
+ * \param int count maximum number of characters that will be rendered
+ * \return char *pAux Return (NULL) if error [this is NULL pointer, count is negative or greater than the buffer of a
+ *                            formatter with file descriptor, or can't allocate memory]
+ *                    - (pointer to the first free character of the buffer) if ok
+ */
+char *tf_reserve(TextFormatter *this, int count)
+{
+    char *pAux = NULL;
+
+    if(this != NULL && count >= 0 && (count <= this->size || this->fd < 0)){
+        if(this->length + count > this->size && this->fd < 0)
+            growBuffer(this, this->length + count);
+
+        else if(this->length + count > this->size){
+            writeChars(this, this->pBuffer, this->length);
+            this->length = 0;
+        }
+
+        if(this->length + count <= this->size)
+            pAux = this->pBuffer + this->length;
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Append the characters rendered in the buffer since the last tf_reserve
+ * \param TextFormatter *this pointer to formatter
+ * \param char *pEnd pointer to the character after the last one rendered
+ * \return int value return (-1) if error [this is NULL pointer, pEnd is out of the buffer or a write failed]
+ *                           (0) if ok
+ */
+int tf_commit(TextFormatter *this, char *pEnd)
+{
+    int value = -1;
+
+    if(this != NULL && pEnd >= this->pBuffer + this->length && pEnd <= this->pBuffer + this->size){
+        this->length = pEnd - this->pBuffer;
+        value = this->failed ? -1 : 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Render an integer filled with zeros up to width characters, the same as printf "%0*d". With width 0 it
+ *        is the same as "%d". It renders at most the greater of width and 11 characters
+ * \param char *pChars pointer where the text is rendered
+ * \param int number number to render
+ * \param int width minimum number of characters, the sign included
+ * \return char *pAux pointer to the character after the text
+ */
+char *tf_formatInteger(char *pChars, int number, int width)
+{
+    int length;
+    unsigned int magnitude;
+
+    // el modulo se calcula sin signo para que INT_MIN no desborde
+    magnitude = number < 0 ? 0u - (unsigned int)number : (unsigned int)number;
+    length = countDigits(magnitude);
+
+    // como en printf, los ceros van despues del signo
+    if(number < 0){
+        *pChars++ = '-';
+        width--;
+    }
+
+    for(; width > length; width--)
+        *pChars++ = '0';
+
+    return putDigits(pChars + length, magnitude);
+}
+
+/**
+ * \brief Render a float with two decimals, the same as printf "%.2f". The rounding is done over the exact value of
+ *        the float, so the text is identical to the one of printf. It renders at most TF_MAX_NUMBER_CHARS characters
+ * \param char *pChars pointer where the text is rendered
+ * \param float number number to render
+ * \return char *pAux pointer to the character after the text
+ */
+char *tf_formatFloat(char *pChars, float number)
+{
+    int length;
+    int negative;
+    double scaled;
+    double fraction;
+    unsigned long long hundredths;
+
+    // un float tiene 24 bits de mantisa y 100 ocupa 7, el producto en double es exacto
+    scaled = (double)number * 100;
+
+    if(scaled > -1e15 && scaled < 1e15){
+        negative = signbit(number) != 0;
+
+        if(negative){
+            *pChars++ = '-';
+            scaled = -scaled;
+        }
+
+        // printf redondea el valor exacto, el empate va al par
+        hundredths = (unsigned long long)scaled;
+        fraction = scaled - (double)hundredths;
+
+        if(fraction > 0.5 || (fraction == 0.5 && (hundredths & 1)))
+            hundredths++;
+
+        length = countDigits(hundredths / 100);
+        pChars = putDigits(pChars + length, hundredths / 100);
+        *pChars++ = '.';
+        memcpy(pChars, digitPairs + (hundredths % 100) * 2, 2);
+        pChars += 2;
+    }
+    else
+        // infinito, NaN y valores muy grandes se dejan a printf
+        pChars += snprintf(pChars, TF_MAX_NUMBER_CHARS, "%.2f", number);
+
+    return pChars;
+}
+
+/**
+ * \brief Render a string aligned to the right with spaces up to width characters, the same as printf "%*s". With
+ *        width 0 it is the same as "%s". It renders the greater of width and the length of the string
+ * \param char *pChars pointer where the text is rendered
+ * \param char *string string ended with '\0'
+ * \param int width minimum number of characters
+ * \return char *pAux pointer to the character after the text
+ */
+char *tf_formatString(char *pChars, char *string, int width)
+{
+    int length = strlen(string);
+
+    for(; width > length; width--)
+        *pChars++ = ' ';
+
+    memcpy(pChars, string, length);
+
+    return pChars + length;
+}
+
+/**
+ * \brief Write the text of the buffer and then the text of count formatters without file descriptor, in order, with
+ *        as few writes as possible. The buffers of the formatters are emptied
+ * \param TextFormatter *this pointer to formatter
+ * \param TextFormatter **ppBuffers pointer to an array of count formatters
+ * \param int count number of formatters
+ * \return int value return (-1) if error [this or ppBuffers are NULL pointer, count is negative or a write failed]
+ *                           (0) if ok
+ */
+int tf_writeBuffers(TextFormatter *this, TextFormatter **ppBuffers, int count)
+{
+    int i;
+    int value = -1;
+#ifndef _WIN32
+    int used;
+    int first;
+    ssize_t written;
+    struct iovec vectors[TF_MAX_VECTORS];
+#endif
+
+    if(this != NULL && ppBuffers != NULL && count >= 0){
+#ifdef _WIN32
+        writeChars(this, this->pBuffer, this->length);
+
+        for(i = 0; i < count; i++)
+            writeChars(this, ppBuffers[i]->pBuffer, ppBuffers[i]->length);
+#else
+        // el buffer propio va primero, el indice -1 lo representa
+        for(i = -1; i < count && !this->failed; i += used){
+            used = 0;
+
+            for(first = i; first + used < count && used < TF_MAX_VECTORS; used++){
+                vectors[used].iov_base = first + used < 0 ? this->pBuffer : ppBuffers[first + used]->pBuffer;
+                vectors[used].iov_len = first + used < 0 ? this->length : ppBuffers[first + used]->length;
+            }
+
+            for(first = 0; first < used && !this->failed;){
+                // una escritura parcial continua donde quedo, sin los buffers vacios
+                while(first < used && vectors[first].iov_len == 0)
+                    first++;
+
+                if(first == used)
+                    break;
+
+                written = writev(this->fd, vectors + first, used - first);
+
+                if(written < 0 && errno == EINTR)
+                    continue;
+
+                if(written <= 0)
+                    this->failed = 1;
+
+                for(; first < used && written >= (ssize_t)vectors[first].iov_len; first++)
+                    written -= vectors[first].iov_len;
+
+                if(first < used && written > 0){
+                    vectors[first].iov_base = (char*)vectors[first].iov_base + written;
+                    vectors[first].iov_len -= written;
+                }
+            }
+        }
+#endif
+
+        this->length = 0;
+
+        for(i = 0; i < count; i++)
+            ppBuffers[i]->length = 0;
+
+        value = this->failed ? -1 : 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Write the text of the buffer to the file descriptor and empty the buffer
+ * \param TextFormatter *this pointer to formatter
+ * \return int value return (-1) if error [this is NULL pointer or a write failed since the last flush]
+ *                           (0) if ok
+ */
+int tf_flush(TextFormatter *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        writeChars(this, this->pBuffer, this->length);
+        this->length = 0;
+        value = this->failed ? -1 : 0;
+        this->failed = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Release the formatter. The text that was not flushed is lost
+ * \param TextFormatter *this pointer to formatter
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int tf_deleteTextFormatter(TextFormatter *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        free(this->pBuffer);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Write count characters to the file descriptor, retrying partial writes. After an error nothing else is
+ *        written until the next tf_flush
+ * \param TextFormatter *this pointer to formatter
+ * \param char *pChars pointer to the characters
+ * \param int count number of characters
+ * \return void
+ */
+void writeChars(TextFormatter *this, char *pChars, int count)
+{
+    int written;
+
+    while(count > 0 && !this->failed){
+        written = fileWrite(this->fd, pChars, count);
+
+        if(written > 0){
+            pChars += written;
+            count -= written;
+        }
+        else if(written < 0 && errno == EINTR)
+            continue;
+        else
+            this->failed = 1;
+    }
+}
+
+/**
+ * \brief Enlarge the buffer of a formatter without file descriptor to at least size bytes, doubling its size. If
+ *        there is no memory the buffer is kept and the formatter is marked as failed
+ * \param TextFormatter *this pointer to formatter
+ * \param int size minimum size in bytes
+ * \return void
+ */
+void growBuffer(TextFormatter *this, int size)
+{
+    int length = this->size;
+    char *pAux = NULL;
+
+    while(length < size)
+        length = length <= INT_MAX / 2 ? length * 2 : size;
+
+    pAux = (char*)realloc(this->pBuffer, length);
+
+    if(pAux != NULL){
+        this->pBuffer = pAux;
+        this->size = length;
+    }
+    else
+        this->failed = 1;
+}
+
+/**
+ * \brief Write the decimal digits of a number backwards, ending just before pEnd
+ * \param char *pEnd pointer to the character after the last digit
+ * \param unsigned long long number number to convert
+ * \return char *pEnd the same pointer received
+ */
+char *putDigits(char *pEnd, unsigned long long number)
+{
+    char *pChar = pEnd;
+
+    while(number >= 100){
+        pChar -= 2;
+        memcpy(pChar, digitPairs + (number % 100) * 2, 2);
+        number /= 100;
+    }
+
+    if(number >= 10){
+        pChar -= 2;
+        memcpy(pChar, digitPairs + number * 2, 2);
+    }
+    else
+        *--pChar = '0' + number;
+
+    return pEnd;
+}
+
+/**
+ * \brief Count the decimal digits of a number
+ * \param unsigned long long number number to measure
+ * \return int value number of digits, at least one
+ */
+int countDigits(unsigned long long number)
+{
+    int value = 1;
+
+    while(number >= 10){
+        number /= 10;
+        value++;
+    }
+
+    return value;
+}
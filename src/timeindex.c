@@ -0,0 +1,358 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/timeindex.h"
+
+// private functions
+void setHeader(TimeIndex *this, unsigned char *pHeader);
+void encodeEntry(TimeIndexEntry *pEntry, unsigned char *pBuffer);
+void decodeEntry(unsigned char *pBuffer, TimeIndexEntry *pEntry);
+void putIndexInteger(unsigned char *pBuffer, long long value, int bytes);
+long long getIndexInteger(unsigned char *pBuffer, int bytes);
+int loadEntries(TimeIndex *this);
+long long bucketOf(TimeIndex *this, long long timestamp);
+
+/**
+ * \brief Open a sparse index of a log whose records are appended in chronological order. The index keeps one
+ *        entry per time bucket with the number of the first record of that bucket. If the file does not exist,
+ *        is not valid or was written with another bucket size it is created empty
+ * \param char *fileName path of the index file
+ * \param int bucketSize size of every bucket in seconds
+ * \return TimeIndex *pAux Return (NULL) if error [invalid parameters, can't open the file or can't allocate memory]
+ *                              - (pointer to new time index) if ok
+ */
+TimeIndex *ti_newTimeIndex(char *fileName, int bucketSize)
+{
+    TimeIndex *this = NULL;
+    TimeIndex *pAux = NULL;
+
+    if(fileName != NULL && bucketSize > 0){
+        this = (TimeIndex*)malloc(sizeof(TimeIndex));
+
+        if(this != NULL){
+            this->file = NULL;
+            this->bucketSize = bucketSize;
+            this->fileName = (char*)malloc(strlen(fileName) + 1);
+            this->pEntries = al_newTypedArrayList(sizeof(TimeIndexEntry));
+
+            if(this->fileName != NULL && this->pEntries != NULL){
+                strcpy(this->fileName, fileName);
+
+                if(loadEntries(this) == 0 || ti_clear(this) == 0)
+                    pAux = this;
+            }
+
+            if(pAux == NULL)
+                ti_deleteTimeIndex(this);
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Register a record appended to the log. An entry is only written when the record starts a new bucket
+ * \param TimeIndex *this pointer to time index
+ * \param long long timestamp time of the record in seconds since the epoch
+ * \param int record number of the record in the log
+ * \return int value return (-1) if error [this is NULL pointer or write failed]
+ *                           (0) if ok
+ */
+int ti_add(TimeIndex *this, long long timestamp, int record)
+{
+    int value = -1;
+    TimeIndexEntry entry;
+    TimeIndexEntry *pLast = NULL;
+    unsigned char buffer[TI_ENTRY_SIZE];
+
+    if(this != NULL){
+        value = 0;
+        pLast = al_len(this->pEntries) > 0 ? al_get(this->pEntries, al_len(this->pEntries) - 1) : NULL;
+
+        // un reloj que retrocede no genera entradas para mantener el indice ordenado
+        if(pLast == NULL || bucketOf(this, timestamp) > pLast->bucket){
+            memset(&entry, 0, sizeof(TimeIndexEntry));
+            entry.bucket = bucketOf(this, timestamp);
+            entry.record = record;
+            encodeEntry(&entry, buffer);
+
+            if(al_add(this->pEntries, &entry) != 0 || fwrite(buffer, TI_ENTRY_SIZE, 1, this->file) != 1 || fflush(this->file) != 0)
+                value = -1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Find the record where a scan for the records at or after a time has to start
+ * \param TimeIndex *this pointer to time index
+ * \param long long timestamp time in seconds since the epoch
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                          (number of the first record of the bucket that contains timestamp, or of the first
+ *                          bucket after it) if ok
+ */
+int ti_find(TimeIndex *this, long long timestamp)
+{
+    int low;
+    int high;
+    int middle;
+    int value = -1;
+    long long bucket;
+    TimeIndexEntry *pEntry = NULL;
+
+    if(this != NULL){
+        value = 0;
+        low = 0;
+        high = al_len(this->pEntries) - 1;
+        bucket = bucketOf(this, timestamp);
+
+        // ultima entrada cuyo bucket no es posterior al buscado
+        while(low <= high){
+            middle = low + (high - low) / 2;
+            pEntry = al_get(this->pEntries, middle);
+
+            if(pEntry->bucket <= bucket){
+                value = pEntry->record;
+                low = middle + 1;
+            }
+            else
+                high = middle - 1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Check if the index covers every record of the log, that is, the last entry points to an existing record
+ *        and no record after it starts a new bucket
+ * \param TimeIndex *this pointer to time index
+ * \param int count number of records of the log
+ * \param long long lastTimestamp time of the last record of the log
+ * \return int value return (1) if the index is valid - (0) if not or this is NULL pointer
+ */
+int ti_isValid(TimeIndex *this, int count, long long lastTimestamp)
+{
+    int value = 0;
+    TimeIndexEntry *pLast = NULL;
+
+    if(this != NULL){
+        if(al_len(this->pEntries) == 0)
+            value = count == 0;
+        else{
+            pLast = al_get(this->pEntries, al_len(this->pEntries) - 1);
+            value = pLast->record < count && bucketOf(this, lastTimestamp) <= pLast->bucket;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Remove every entry of the index and truncate the file so it can be rebuilt with ti_add
+ * \param TimeIndex *this pointer to time index
+ * \return int value return (-1) if error [this is NULL pointer or can't reopen the file]
+ *                           (0) if ok
+ */
+int ti_clear(TimeIndex *this)
+{
+    int value = -1;
+    unsigned char header[TI_HEADER_SIZE];
+
+    if(this != NULL){
+        if(this->file != NULL)
+            fclose(this->file);
+
+        al_clear(this->pEntries);
+        this->file = fopen(this->fileName, "wb");
+
+        if(this->file != NULL){
+            setHeader(this, header);
+
+            if(fwrite(header, TI_HEADER_SIZE, 1, this->file) == 1 && fflush(this->file) == 0)
+                value = 0;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Close the file and release the time index
+ * \param TimeIndex *this pointer to time index
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int ti_deleteTimeIndex(TimeIndex *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        if(this->file != NULL)
+            fclose(this->file);
+
+        al_deleteArrayList(this->pEntries);
+        free(this->fileName);
+        free(this);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Write the header that identifies the file of the index: magic, version, header size, entry size and bucket
+ *        size, the integers in little endian
+ * \param TimeIndex *this pointer to time index
+ * \param unsigned char *pHeader buffer of TI_HEADER_SIZE bytes
+ * \return void
+ */
+void setHeader(TimeIndex *this, unsigned char *pHeader)
+{
+    memset(pHeader, 0, TI_HEADER_SIZE);
+    memcpy(pHeader, TI_FILE_MAGIC, 4);
+    putIndexInteger(pHeader + 4, TI_FILE_VERSION, 2);
+    putIndexInteger(pHeader + 6, TI_HEADER_SIZE, 2);
+    putIndexInteger(pHeader + 8, TI_ENTRY_SIZE, 2);
+    putIndexInteger(pHeader + 12, this->bucketSize, 4);
+}
+
+/**
+ * \brief Write an entry as it is stored in the file: the bucket in 8 bytes and the record in 4, in little endian,
+ *        followed by 4 reserved bytes
+ * \param TimeIndexEntry *pEntry pointer to the entry
+ * \param unsigned char *pBuffer buffer of TI_ENTRY_SIZE bytes
+ * \return void
+ */
+void encodeEntry(TimeIndexEntry *pEntry, unsigned char *pBuffer)
+{
+    memset(pBuffer, 0, TI_ENTRY_SIZE);
+    putIndexInteger(pBuffer, pEntry->bucket, 8);
+    putIndexInteger(pBuffer + 8, pEntry->record, 4);
+}
+
+/**
+ * \brief Read an entry written with encodeEntry
+ * \param unsigned char *pBuffer buffer of TI_ENTRY_SIZE bytes
+ * \param TimeIndexEntry *pEntry pointer where the entry is written
+ * \return void
+ */
+void decodeEntry(unsigned char *pBuffer, TimeIndexEntry *pEntry)
+{
+    pEntry->bucket = getIndexInteger(pBuffer, 8);
+    pEntry->record = (int)getIndexInteger(pBuffer + 8, 4);
+}
+
+/**
+ * \brief Writes an integer in little endian
+ * \param unsigned char *pBuffer buffer where the integer is written
+ * \param long long value integer to write
+ * \param int bytes number of bytes to write
+ * \return void
+ */
+void putIndexInteger(unsigned char *pBuffer, long long value, int bytes)
+{
+    int i;
+
+    for(i = 0; i < bytes; i++)
+        pBuffer[i] = (unsigned char)((unsigned long long)value >> (8 * i));
+}
+
+/**
+ * \brief Reads an integer written in little endian
+ * \param unsigned char *pBuffer buffer where the integer is read
+ * \param int bytes number of bytes to read
+ * \return long long value the integer read, without sign extension
+ */
+long long getIndexInteger(unsigned char *pBuffer, int bytes)
+{
+    int i;
+    unsigned long long value = 0;
+
+    for(i = 0; i < bytes; i++)
+        value |= (unsigned long long)pBuffer[i] << (8 * i);
+
+    return (long long)value;
+}
+
+/**
+ * \brief Read the entries of an existing index file and leave it open for appending
+ * \param TimeIndex *this pointer to time index
+ * \return int value return (-1) if error [the file does not exist, has another header, a partial entry or its
+ *                           entries are not in order]
+ *                           (0) if ok
+ */
+int loadEntries(TimeIndex *this)
+{
+    int value = -1;
+    long size;
+    FILE *file = NULL;
+    TimeIndexEntry entry;
+    TimeIndexEntry *pLast = NULL;
+    unsigned char header[TI_HEADER_SIZE];
+    unsigned char expected[TI_HEADER_SIZE];
+    unsigned char buffer[TI_ENTRY_SIZE];
+
+    file = fopen(this->fileName, "rb");
+
+    if(file != NULL){
+        setHeader(this, expected);
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+
+        // una entrada escrita a medias deja el archivo desalineado
+        if((size - TI_HEADER_SIZE) % TI_ENTRY_SIZE == 0 && fread(header, TI_HEADER_SIZE, 1, file) == 1 && !memcmp(header, expected, TI_HEADER_SIZE)){
+            value = 0;
+
+            while(value == 0 && fread(buffer, TI_ENTRY_SIZE, 1, file) == 1){
+                decodeEntry(buffer, &entry);
+
+                if((pLast != NULL && (entry.bucket <= pLast->bucket || entry.record <= pLast->record)) || al_add(this->pEntries, &entry) != 0)
+                    value = -1;
+                else
+                    pLast = al_get(this->pEntries, al_len(this->pEntries) - 1);
+            }
+        }
+
+        fclose(file);
+    }
+
+    if(value == 0){
+        this->file = fopen(this->fileName, "ab");
+
+        if(this->file == NULL)
+            value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the start of the bucket that contains a time
+ * \param TimeIndex *this pointer to time index
+ * \param long long timestamp time in seconds since the epoch
+ * \return long long value start of the bucket in seconds since the epoch
+ */
+long long bucketOf(TimeIndex *this, long long timestamp)
+{
+    long long value = timestamp - timestamp % this->bucketSize;
+
+    if(timestamp < 0 && value != timestamp)
+        value -= this->bucketSize;
+
+    return value;
+}
@@ -189,8 +189,7 @@ int onlyPhoneNumber(char *string)
 void getString(char *message, char *input)
 {
     printf("%s", message);
-    fflush(stdin);
-    gets(input);
+    tm_readLine(input, MAX_LENGTH);
 }
 
 /**
@@ -341,7 +340,7 @@ int getValidString(char *requestMessage, char *errorMessage, char *errorMessageL
             printf("%s", errorMessage);
             continue;
         }
-        if(strlen(buffer) < minLength || strlen(buffer) > maxLength){
+        if((int)strlen(buffer) < minLength || (int)strlen(buffer) > maxLength){
             printf("%s", errorMessageLength);
             continue;
         }
@@ -377,12 +376,12 @@ int getValidAlphanumeric(char *requestMessage, char *errorMessage, char *errorMe
             printf ("%s", errorMessage);
             continue;
         }
-        if(strlen(buffer) < minLength || strlen(buffer) > maxLength){
+        if((int)strlen(buffer) < minLength || (int)strlen(buffer) > maxLength){
             printf ("%s", errorMessageLength);
             continue;
         }
 
-        strupr(buffer);
+        allUppercaseLetters(buffer);
         strcpy(input, buffer);
         value = 0;
         break;
@@ -532,7 +531,7 @@ int getValidEmail(char *requestMessage, char *errorMessage, char *errorMessageLe
             printf("%s", errorMessage);
             continue;
         }
-        if(strlen(buffer) > maxLength){
+        if((int)strlen(buffer) > maxLength){
             printf("%s", errorMessageLength);
             continue;
         }
@@ -567,7 +566,7 @@ int getValidPhoneNumber(char *requestMessage, char *errorMessage, char *errorMes
             printf("%s", errorMessage);
             continue;
         }
-        if(strlen(buffer) < minLength || strlen(buffer) > maxLength){
+        if((int)strlen(buffer) < minLength || (int)strlen(buffer) > maxLength){
             printf("%s", errorMessageLength);
             continue;
         }
@@ -602,3 +601,16 @@ void firstUppercaseLetter(char *string)
             string[i] = tolower(string[i]);
     }
 }
+
+/**
+ * \brief Converts every character to uppercase
+ * \param char *string string to convert
+ * \return void
+ */
+void allUppercaseLetters(char *string)
+{
+    int i;
+
+    for(i = 0; string[i] != '\0'; i++)
+        string[i] = toupper((unsigned char)string[i]);
+}
@@ -0,0 +1,256 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include "../inc/workerpool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// private functions
+void *runWorker(void *pArgument);
+void runTasks(WorkerPool *this);
+int stopWorkers(WorkerPool *this, int count);
+
+/**
+ * \brief Allocate a pool of threads that run the tasks given with wp_run. The thread that calls wp_run also runs
+ *        tasks, so the pool creates threads - 1 threads
+ * \param int threads number of threads that run tasks, (0) to use one for every processor of the system
+ * \return WorkerPool *pAux Return (NULL) if error [invalid threads, can't allocate memory or can't start a thread]
+ *                               - (pointer to new worker pool) if ok
+ */
+WorkerPool *wp_newWorkerPool(int threads)
+{
+    int i;
+    WorkerPool *this = NULL;
+    WorkerPool *pAux = NULL;
+
+    if(threads == 0)
+        threads = wp_getProcessors();
+
+    if(threads > WP_MAX_THREADS)
+        threads = WP_MAX_THREADS;
+
+    if(threads > 0){
+        this = (WorkerPool*)malloc(sizeof(WorkerPool));
+
+        if(this != NULL){
+            memset(this, 0, sizeof(WorkerPool));
+            this->pThreads = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+
+            if(this->pThreads != NULL){
+                pthread_mutex_init(&this->mutex, NULL);
+                pthread_cond_init(&this->start, NULL);
+                pthread_cond_init(&this->done, NULL);
+                this->threads = threads;
+                this->running = 1;
+
+                // el hilo que llama a wp_run es el primero del pool
+                for(i = 1; i < threads && pthread_create(&this->pThreads[i], NULL, runWorker, this) == 0; i++);
+
+                if(i == threads)
+                    pAux = this;
+                else{
+                    stopWorkers(this, i);
+                    pthread_mutex_destroy(&this->mutex);
+                    pthread_cond_destroy(&this->start);
+                    pthread_cond_destroy(&this->done);
+                }
+            }
+
+            if(pAux == NULL){
+                free(this->pThreads);
+                free(this);
+            }
+        }
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Run taskCount tasks calling pTask(pContext, index) for every index from 0 to taskCount - 1, spread over the
+ *        threads of the pool. Tasks are taken in increasing order but can finish in any order. It returns when every
+ *        task has finished
+ * \param WorkerPool *this pointer to worker pool
+ * \param void (*pTask)(void*, int) function that runs a task
+ * \param void *pContext pointer given to every task
+ * \param int taskCount number of tasks
+ * \return int value return (-1) if error [this or pTask are NULL pointer or invalid taskCount]
+ *                           (0) if ok
+ */
+int wp_run(WorkerPool *this, void (*pTask)(void*, int), void *pContext, int taskCount)
+{
+    int value = -1;
+
+    if(this != NULL && pTask != NULL && taskCount >= 0){
+        pthread_mutex_lock(&this->mutex);
+        this->pTask = pTask;
+        this->pContext = pContext;
+        this->taskCount = taskCount;
+        this->nextTask = 0;
+        this->busy = this->threads - 1;
+        this->round++;
+        pthread_cond_broadcast(&this->start);
+        pthread_mutex_unlock(&this->mutex);
+
+        runTasks(this);
+
+        pthread_mutex_lock(&this->mutex);
+
+        while(this->busy > 0)
+            pthread_cond_wait(&this->done, &this->mutex);
+
+        pthread_mutex_unlock(&this->mutex);
+        value = 0;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the number of threads that run tasks, including the one that calls wp_run
+ * \param WorkerPool *this pointer to worker pool
+ * \return int value return number of threads or (-1) if error [this is NULL pointer]
+ */
+int wp_len(WorkerPool *this)
+{
+    int value = -1;
+
+    if(this != NULL)
+        value = this->threads;
+
+    return value;
+}
+
+/**
+ * \brief Get the number of processors of the system available to run threads
+ * \param -
+ * \return int value number of processors, at least 1
+ */
+int wp_getProcessors(void)
+{
+    int value;
+
+#ifdef _WIN32
+    SYSTEM_INFO information;
+
+    GetSystemInfo(&information);
+    value = (int)information.dwNumberOfProcessors;
+#else
+    value = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return value > 0 ? value : 1;
+}
+
+/**
+ * \brief Stop the threads of the pool and release it. It must not be called while wp_run is running
+ * \param WorkerPool *this pointer to worker pool
+ * \return int value return (-1) if error [this is NULL pointer]
+ *                           (0) if ok
+ */
+int wp_deleteWorkerPool(WorkerPool *this)
+{
+    int value = -1;
+
+    if(this != NULL){
+        value = stopWorkers(this, this->threads);
+        pthread_mutex_destroy(&this->mutex);
+        pthread_cond_destroy(&this->start);
+        pthread_cond_destroy(&this->done);
+        free(this->pThreads);
+        free(this);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Body of the threads of the pool. Waits for a new round of tasks, runs tasks until there are no more and
+ *        waits again, until the pool is stopped
+ * \param void *pArgument pointer to worker pool
+ * \return void *value (NULL)
+ */
+void *runWorker(void *pArgument)
+{
+    int round = 0;
+    WorkerPool *this = (WorkerPool*)pArgument;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while(1){
+        while(this->running && this->round == round)
+            pthread_cond_wait(&this->start, &this->mutex);
+
+        if(!this->running)
+            break;
+
+        round = this->round;
+        pthread_mutex_unlock(&this->mutex);
+
+        runTasks(this);
+
+        pthread_mutex_lock(&this->mutex);
+
+        if(--this->busy == 0)
+            pthread_cond_signal(&this->done);
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+/**
+ * \brief Takes the tasks of the current round one by one and runs them, until every task has been taken
+ * \param WorkerPool *this pointer to worker pool
+ * \return void
+ */
+void runTasks(WorkerPool *this)
+{
+    int index;
+
+    // cada hilo toma el siguiente indice libre, asi los hilos mas rapidos hacen mas tareas
+    while((index = __atomic_fetch_add(&this->nextTask, 1, __ATOMIC_RELAXED)) < this->taskCount)
+        this->pTask(this->pContext, index);
+}
+
+/**
+ * \brief Stops the threads of the pool and waits for them to end
+ * \param WorkerPool *this pointer to worker pool
+ * \param int count number of threads created, counting the one that calls wp_run
+ * \return int value return (-1) if error [can't join a thread]
+ *                           (0) if ok
+ */
+int stopWorkers(WorkerPool *this, int count)
+{
+    int i;
+    int value = 0;
+
+    pthread_mutex_lock(&this->mutex);
+    this->running = 0;
+    pthread_cond_broadcast(&this->start);
+    pthread_mutex_unlock(&this->mutex);
+
+    for(i = 1; i < count; i++){
+        if(pthread_join(this->pThreads[i], NULL) != 0)
+            value = -1;
+    }
+
+    return value;
+}
@@ -0,0 +1,141 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <time.h>
+#include "../inc/arraylist.h"
+
+// CANTIDADES DE ELEMENTOS MEDIDAS
+#define BENCH_SIZES 4
+#define BENCH_MAX_ELEMENTS 10000000
+
+// LA VERSION ANTERIOR CRECIA DE A 10 LUGARES, SE MIDE SOLO HASTA ESTA CANTIDAD
+#define BENCH_FIXED_INCREMENT 10
+#define BENCH_FIXED_MAX_ELEMENTS 1000000
+
+double elapsedSeconds(struct timespec *pStart);
+double addGeometric(int count, int reserve);
+double addFixedIncrement(int count);
+
+/**
+ * \brief Measures the time to add elements to an ArrayList, as the binary loader did, growing it geometrically, with
+ *        al_reserve and with the fixed increment of 10 elements of the previous version. The time per element of
+ *        geometric growth must stay about the same up to 10M elements
+ * \return int value (0)
+ */
+int main(void)
+{
+    int i;
+    int sizes[BENCH_SIZES] = {10000, 100000, 1000000, BENCH_MAX_ELEMENTS};
+    double seconds;
+
+    printf("%12s %22s %22s %22s\n", "elementos", "geometrico (ns/elem)", "al_reserve (ns/elem)", "de a 10 (ns/elem)");
+
+    for(i = 0; i < BENCH_SIZES; i++){
+        printf("%12d", sizes[i]);
+
+        seconds = addGeometric(sizes[i], 0);
+        printf(" %22.2f", seconds * 1e9 / sizes[i]);
+
+        seconds = addGeometric(sizes[i], 1);
+        printf(" %22.2f", seconds * 1e9 / sizes[i]);
+
+        if(sizes[i] <= BENCH_FIXED_MAX_ELEMENTS){
+            seconds = addFixedIncrement(sizes[i]);
+            printf(" %22.2f\n", seconds * 1e9 / sizes[i]);
+        }
+        else
+            printf(" %22s\n", "-");
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Gets the seconds elapsed since a moment
+ * \param struct timespec *pStart pointer to the moment
+ * \return double value seconds elapsed
+ */
+double elapsedSeconds(struct timespec *pStart)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - pStart->tv_sec) + (end.tv_nsec - pStart->tv_nsec) / 1e9;
+}
+
+/**
+ * \brief Adds count elements to a new ArrayList
+ * \param int count number of elements
+ * \param int reserve (1) to reserve room for every element first
+ * \return double value seconds taken
+ */
+double addGeometric(int count, int reserve)
+{
+    int i;
+    double value;
+    ArrayList *pList = NULL;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pList = al_newArrayList();
+
+    if(reserve)
+        al_reserve(pList, count);
+
+    for(i = 0; i < count; i++)
+        al_add(pList, pList);
+
+    value = elapsedSeconds(&start);
+    al_deleteArrayList(pList);
+
+    return value;
+}
+
+/**
+ * \brief Adds count pointers to an array that grows 10 elements at a time, as al_add did before geometric growth
+ * \param int count number of elements
+ * \return double value seconds taken
+ */
+double addFixedIncrement(int count)
+{
+    int i;
+    int reservedSize = 0;
+    double value;
+    void **pElements = NULL;
+    void **pAux = NULL;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(i = 0; i < count; i++){
+        if(i == reservedSize){
+            pAux = (void**)realloc(pElements, sizeof(void*) * (reservedSize + BENCH_FIXED_INCREMENT));
+
+            if(pAux == NULL)
+                break;
+
+            pElements = pAux;
+            reservedSize += BENCH_FIXED_INCREMENT;
+        }
+
+        pElements[i] = pElements;
+    }
+
+    value = elapsedSeconds(&start);
+    free(pElements);
+
+    return value;
+}
@@ -0,0 +1,151 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "../inc/mechatronic.h"
+
+// LINEAS DEL INFORME ESCRITAS EN CADA MEDICION
+#define BENCH_ROWS 1000000
+
+// EVENTOS DISTINTOS QUE SE REPITEN HASTA COMPLETAR LAS LINEAS
+#define BENCH_EVENTS 1024
+
+// MEDICIONES DE CADA FORMA, SE TOMA LA MAS RAPIDA
+#define BENCH_REPEATS 5
+
+double getElapsedSeconds(struct timespec *pStart);
+double renderWithFprintf(Mechatronic *pEvents);
+double renderWithFormatter(Mechatronic *pEvents);
+
+/**
+ * \brief Measures the time to render the lines of the text report to /dev/null with the fprintf line used before the
+ *        formatter and with mechatronic_formatTextFileRow through a TextFormatter, so only the formatting is measured
+ * \return int value (0) if ok - (1) if the events can't be allocated
+ */
+int main(void)
+{
+    int i;
+    int value = 1;
+    double fprintfSeconds = 0;
+    double formatterSeconds = 0;
+    double seconds;
+    Mechatronic *pEvents = NULL;
+
+    pEvents = (Mechatronic*)malloc(sizeof(Mechatronic) * BENCH_EVENTS);
+
+    if(pEvents != NULL){
+        for(i = 0; i < BENCH_EVENTS; i++){
+            mechatronic_newReading(&pEvents[i], -20.0f + (i % 801) / 10.0f, i % 101, 0);
+            mechatronic_setTimestamp(&pEvents[i], 1700000000LL + i * 3607LL, NULL);
+        }
+
+        for(i = 0; i < BENCH_REPEATS; i++){
+            seconds = renderWithFprintf(pEvents);
+            fprintfSeconds = i == 0 || seconds < fprintfSeconds ? seconds : fprintfSeconds;
+
+            seconds = renderWithFormatter(pEvents);
+            formatterSeconds = i == 0 || seconds < formatterSeconds ? seconds : formatterSeconds;
+        }
+
+        printf("%12s %16s %16s\n", "lineas", "fprintf (ns/l)", "tf_ (ns/l)");
+        printf("%12d %16.1f %16.1f\n", BENCH_ROWS, fprintfSeconds * 1e9 / BENCH_ROWS, formatterSeconds * 1e9 / BENCH_ROWS);
+        printf("Aceleracion: %.2fx\n", fprintfSeconds / formatterSeconds);
+        value = 0;
+    }
+
+    free(pEvents);
+
+    return value;
+}
+
+/**
+ * \brief Gets the seconds elapsed since a moment
+ * \param struct timespec *pStart pointer to the moment
+ * \return double value seconds elapsed
+ */
+double getElapsedSeconds(struct timespec *pStart)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - pStart->tv_sec) + (end.tv_nsec - pStart->tv_nsec) / 1e9;
+}
+
+/**
+ * \brief Renders BENCH_ROWS lines with the fprintf of the text report before the formatter
+ * \param Mechatronic *pEvents pointer to BENCH_EVENTS events
+ * \return double value seconds taken
+ */
+double renderWithFprintf(Mechatronic *pEvents)
+{
+    int i;
+    double value;
+    FILE *file = NULL;
+    Mechatronic *this = NULL;
+    struct timespec start;
+
+    file = fopen("/dev/null", "w");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(i = 0; file != NULL && i < BENCH_ROWS; i++){
+        this = &pEvents[i % BENCH_EVENTS];
+        fprintf(file, "%02d/%02d/%d %02d:%02d:%02d\t\t%d\t\t%s\t\t\t%25s\t\t\t\t%.2f\t\t\t\t\t\t%d\t\t\t\t\t\t%.2f\t\t\t\t\t\t%.2f\t\t\t\t\t\t%d\n", this->today.day, this->today.month, this->today.year, this->today.hour, this->today.minutes, this->today.seconds, this->idEmployee, this->nameSurname, mechatronic_getEventTypeName(this->eventType), this->ambientTemperatureRead, this->humidityTemperatureRead, this->temperatureEngineOn, this->temperatureEngineOff, this->humidityThreshold);
+    }
+
+    if(file != NULL)
+        fflush(file);
+
+    value = getElapsedSeconds(&start);
+
+    if(file != NULL)
+        fclose(file);
+
+    return value;
+}
+
+/**
+ * \brief Renders BENCH_ROWS lines with mechatronic_formatTextFileRow through a TextFormatter with the buffer size of
+ *        the report writer
+ * \param Mechatronic *pEvents pointer to BENCH_EVENTS events
+ * \return double value seconds taken
+ */
+double renderWithFormatter(Mechatronic *pEvents)
+{
+    int i;
+    int fd;
+    double value;
+    TextFormatter *pFormatter = NULL;
+    struct timespec start;
+
+    fd = open("/dev/null", O_WRONLY);
+    pFormatter = tf_newTextFormatter(RW_BUFFER_SIZE);
+    tf_setFile(pFormatter, fd);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(i = 0; pFormatter != NULL && i < BENCH_ROWS; i++)
+        mechatronic_formatTextFileRow(pFormatter, &pEvents[i % BENCH_EVENTS]);
+
+    tf_flush(pFormatter);
+    value = getElapsedSeconds(&start);
+    tf_deleteTextFormatter(pFormatter);
+
+    if(fd >= 0)
+        close(fd);
+
+    return value;
+}
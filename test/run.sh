@@ -0,0 +1,37 @@
+#!/bin/sh
+# Compila y ejecuta las pruebas de test/. Con "bench" ejecuta tambien las mediciones de rendimiento.
+# Uso: test/run.sh [bench]
+
+cd "$(dirname "$0")" || exit 1
+
+BUILD=$(mktemp -d)
+SOURCES=$(ls ../src/*.c | grep -v '/main\.c$')
+PROGRAMS="test_*.c"
+FAILED=0
+
+if [ "$1" = "bench" ]; then
+    PROGRAMS="test_*.c bench_*.c"
+fi
+
+for program in $PROGRAMS; do
+    [ -f "$program" ] || continue
+    name=${program%.c}
+
+    if ! gcc -Wall -O2 -o "$BUILD/$name" "$program" $SOURCES -lpthread -lm; then
+        echo "$name: ERROR de compilacion"
+        FAILED=1
+        continue
+    fi
+
+    # cada programa trabaja en su propio directorio, algunos crean archivos
+    mkdir "$BUILD/$name.dir"
+
+    if ! (cd "$BUILD/$name.dir" && "$BUILD/$name"); then
+        echo "$name: ERROR"
+        FAILED=1
+    fi
+done
+
+rm -rf "$BUILD"
+
+exit $FAILED
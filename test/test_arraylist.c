@@ -0,0 +1,214 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <limits.h>
+#include <stdio.h>
+#include "../inc/arraylist.h"
+
+// MAYOR CANTIDAD DE ELEMENTOS ORDENADA
+#define TEST_MAX_ELEMENTS 5000
+
+// FORMAS DE LAS LISTAS ORDENADAS
+#define TEST_RANDOM 0
+#define TEST_FEW_KEYS 1
+#define TEST_ASCENDING 2
+#define TEST_DESCENDING 3
+#define TEST_EQUAL 4
+#define TEST_EXTREME 5
+#define TEST_SHAPES 6
+
+struct TestItem{
+
+    long long key;
+    int position;
+
+}typedef TestItem;
+
+int compareItems(void *pFirst, void *pSecond);
+long long getItemKey(void *pElement);
+void fillItems(TestItem *pItems, int count, int shape);
+int checkSort(int count, int shape, int typed, int byKey, int order);
+
+// semilla del generador de claves, fija para que las pruebas se repitan igual
+unsigned int testSeed = 12345;
+
+/**
+ * \brief Checks al_sort and al_sortByKey on lists of pointers and on typed lists, in both orders: empty lists, one
+ *        element, two elements, random keys, a few keys repeated many times, keys already sorted in one order or the
+ *        other, every key equal and the greatest and smallest keys. The result must be a sorted permutation of the
+ *        elements that keeps equal keys in the order they had. Invalid parameters must be rejected
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int shape;
+    int typed;
+    int byKey;
+    int order;
+    int failed = 0;
+    int counts[] = {0, 1, 2, 3, 17, 100, 1000, TEST_MAX_ELEMENTS};
+    ArrayList *pArrayList = NULL;
+
+    for(i = 0; i < (int)(sizeof(counts) / sizeof(int)); i++){
+        for(shape = 0; shape < TEST_SHAPES; shape++){
+            for(typed = 0; typed <= 1; typed++){
+                for(byKey = 0; byKey <= 1; byKey++){
+                    for(order = 0; order <= 1; order++)
+                        failed += checkSort(counts[i], shape, typed, byKey, order);
+                }
+            }
+        }
+    }
+
+    pArrayList = al_newArrayList();
+
+    if(al_sort(NULL, compareItems, 1) != -1 || al_sort(pArrayList, NULL, 1) != -1 || al_sort(pArrayList, compareItems, 2) != -1 ||
+       al_sortByKey(NULL, getItemKey, 1) != -1 || al_sortByKey(pArrayList, NULL, 1) != -1 || al_sortByKey(pArrayList, getItemKey, -1) != -1){
+        printf("ERROR!, al_sort o al_sortByKey aceptaron parametros invalidos\n");
+        failed++;
+    }
+
+    al_deleteArrayList(pArrayList);
+
+    printf("test_arraylist: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Compares two items by their key
+ * \param void *pFirst pointer to the first item
+ * \param void *pSecond pointer to the second item
+ * \return int value (-1) if the first key is smaller - (0) if equal - (1) if greater
+ */
+int compareItems(void *pFirst, void *pSecond)
+{
+    long long first = ((TestItem*)pFirst)->key;
+    long long second = ((TestItem*)pSecond)->key;
+
+    return (first > second) - (first < second);
+}
+
+/**
+ * \brief Gets the key of an item
+ * \param void *pElement pointer to the item
+ * \return long long value key of the item
+ */
+long long getItemKey(void *pElement)
+{
+    return ((TestItem*)pElement)->key;
+}
+
+/**
+ * \brief Sets the keys of count items with one of the shapes of the test and numbers them in order
+ * \param TestItem *pItems pointer to the first item
+ * \param int count number of items
+ * \param int shape TEST_RANDOM, TEST_FEW_KEYS, TEST_ASCENDING, TEST_DESCENDING, TEST_EQUAL or TEST_EXTREME
+ * \return void
+ */
+void fillItems(TestItem *pItems, int count, int shape)
+{
+    int i;
+    long long extremes[] = {LLONG_MIN, LLONG_MAX, -1, 0, 1, LLONG_MIN + 1, LLONG_MAX - 1, INT_MIN, INT_MAX};
+
+    for(i = 0; i < count; i++){
+        testSeed = testSeed * 1103515245 + 12345;
+
+        if(shape == TEST_RANDOM)
+            pItems[i].key = (long long)(testSeed >> 8) - (1 << 23);
+        else if(shape == TEST_FEW_KEYS)
+            pItems[i].key = (testSeed >> 16) % 5 - 2;
+        else if(shape == TEST_ASCENDING)
+            pItems[i].key = i / 3;
+        else if(shape == TEST_DESCENDING)
+            pItems[i].key = (count - i) / 3;
+        else if(shape == TEST_EQUAL)
+            pItems[i].key = 7;
+        else
+            pItems[i].key = extremes[(testSeed >> 16) % (sizeof(extremes) / sizeof(long long))];
+
+        pItems[i].position = i;
+    }
+}
+
+/**
+ * \brief Sorts a list of items with al_sort or al_sortByKey and checks that every item is still there, once, that
+ *        the keys are in order and that the items with equal keys keep the order they had
+ * \param int count number of items
+ * \param int shape shape of the keys, see fillItems
+ * \param int typed [1] typed list with the items by value - [0] list of pointers to the items
+ * \param int byKey [1] al_sortByKey - [0] al_sort
+ * \param int order [1] indicate UP - [0] indicate DOWN
+ * \return int value (0) if ok - (1) if not
+ */
+int checkSort(int count, int shape, int typed, int byKey, int order)
+{
+    int i;
+    int value = 0;
+    int result = -1;
+    int comparison;
+    char *pSeen = NULL;
+    TestItem *pItems = NULL;
+    TestItem *pPrevious = NULL;
+    TestItem *pCurrent = NULL;
+    ArrayList *pArrayList = NULL;
+
+    pItems = (TestItem*)malloc(sizeof(TestItem) * (count + 1));
+    pSeen = (char*)calloc(count + 1, 1);
+    pArrayList = typed ? al_newTypedArrayList(sizeof(TestItem)) : al_newArrayList();
+
+    if(pItems != NULL && pSeen != NULL && pArrayList != NULL){
+        fillItems(pItems, count, shape);
+
+        for(i = 0; i < count; i++)
+            al_add(pArrayList, &pItems[i]);
+
+        result = byKey ? al_sortByKey(pArrayList, getItemKey, order) : al_sort(pArrayList, compareItems, order);
+    }
+
+    if(result != 0 || al_len(pArrayList) != count)
+        value = 1;
+
+    for(i = 0; i < count && value == 0; i++){
+        pCurrent = (TestItem*)al_get(pArrayList, i);
+
+        if(pCurrent == NULL || pCurrent->position < 0 || pCurrent->position >= count || pSeen[pCurrent->position])
+            value = 1;
+        else{
+            pSeen[pCurrent->position] = 1;
+
+            // las claves iguales conservan el orden que tenian
+            if(pPrevious != NULL){
+                comparison = order == 1 ? compareItems(pPrevious, pCurrent) : compareItems(pCurrent, pPrevious);
+
+                if(comparison > 0 || (comparison == 0 && pPrevious->position > pCurrent->position))
+                    value = 1;
+            }
+        }
+
+        pPrevious = pCurrent;
+    }
+
+    if(value != 0)
+        printf("ERROR!, %s de %d elementos con la forma %d en una lista %s, orden %s\n", byKey ? "al_sortByKey" : "al_sort", count, shape,
+               typed ? "por valor" : "de punteros", order == 1 ? "ascendente" : "descendente");
+
+    al_deleteArrayList(pArrayList);
+    free(pItems);
+    free(pSeen);
+
+    return value;
+}
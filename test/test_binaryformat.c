@@ -0,0 +1,394 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include "../inc/mechatronic.h"
+
+// REGISTROS DE CADA ARCHIVO CONVERTIDO
+#define TEST_RECORDS 500
+
+// BYTES DE UN REGISTRO INCOMPLETO AL FINAL DE LOS ARCHIVOS
+#define TEST_LEGACY_TAIL 10
+#define TEST_PREVIOUS_TAIL 7
+
+void testEvent(Mechatronic *this, int number);
+void testLegacyEvent(LegacyMechatronic *pLegacy, int number);
+int writeTestFile(char *pBytes, int length);
+int checkBinaryFile(unsigned char *pExpected, int count);
+int checkRoundTrip(void);
+int checkClamp(void);
+int checkLegacyImport(void);
+int checkUpgrade(void);
+
+/**
+ * \brief Checks the current format of the binary file and the conversions of the older ones: events encoded and
+ *        decoded keep their values, a changed byte makes the checksum fail, temperatures that are not finite or out
+ *        of their fields are clamped and reported as not storable, a legacy file is imported leaving out the
+ *        records with invalid dates or values and the incomplete one at the end, and a file of the previous version
+ *        is upgraded with the checksum added to every record and the incomplete one at the end removed
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+
+    failed += checkRoundTrip();
+    failed += checkClamp();
+    failed += checkLegacyImport();
+    failed += checkUpgrade();
+
+    printf("test_binaryformat: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Sets an event whose values depend on its number, from the greatest negative values to the greatest
+ *        positive ones that fit in a record
+ * \param Mechatronic *this pointer to the structure Mechatronic
+ * \param int number number of the event
+ * \return void
+ */
+void testEvent(Mechatronic *this, int number)
+{
+    memset(this, 0, sizeof(Mechatronic));
+    mechatronic_setTimestamp(this, 1600000000LL + number * 3607LL, NULL);
+    this->idEmployee = number % 2 ? ID_EMPLOYEE : -number;
+    this->eventType = (EventType)(number % EVENT_TYPE_COUNT);
+    this->ambientTemperatureRead = (number % 3 - 1) * (number * 4111.37f);
+    this->temperatureEngineOn = number % 7 == 0 ? 327.67f : (number % 400 - 200) * 1.5f + 0.01f;
+    this->temperatureEngineOff = number % 11 == 0 ? -327.68f : (number % 300 - 150) * -2.0f;
+    this->humidityTemperatureRead = number % 13 == 0 ? USHRT_MAX : number * 37 % 1000;
+    this->humidityThreshold = number % 17 == 0 ? UCHAR_MAX : number % 101;
+
+    if(this->idEmployee == ID_EMPLOYEE)
+        strcpy(this->nameSurname, EMPLOYEE_NAME);
+}
+
+/**
+ * \brief Sets a record of the legacy layout whose values depend on its number
+ * \param LegacyMechatronic *pLegacy pointer to the legacy record
+ * \param int number number of the record
+ * \return void
+ */
+void testLegacyEvent(LegacyMechatronic *pLegacy, int number)
+{
+    memset(pLegacy, 0, sizeof(LegacyMechatronic));
+    pLegacy->today.day = 1 + number % 28;
+    pLegacy->today.month = 1 + number % 12;
+    pLegacy->today.year = 2020 + number % 5;
+    pLegacy->today.hour = number % 24;
+    pLegacy->today.minutes = number % 60;
+    pLegacy->today.seconds = number * 7 % 60;
+    strcpy(pLegacy->eventType, mechatronic_getEventTypeName((EventType)(number % EVENT_TYPE_COUNT)));
+    pLegacy->idEmployee = ID_EMPLOYEE;
+    strcpy(pLegacy->nameSurname, EMPLOYEE_NAME);
+    pLegacy->ambientTemperatureRead = -20 + number % 80 + 0.25f;
+    pLegacy->humidityTemperatureRead = number % 101;
+    pLegacy->temperatureEngineOn = 25 + number % 10;
+    pLegacy->temperatureEngineOff = 15 - number % 10;
+    pLegacy->humidityThreshold = 70;
+}
+
+/**
+ * \brief Writes the binary file
+ * \param char *pBytes bytes of the file
+ * \param int length number of bytes
+ * \return int value (0) if ok - (-1) if error
+ */
+int writeTestFile(char *pBytes, int length)
+{
+    int value = -1;
+    FILE *file = NULL;
+
+    file = fopen(MECHATRONIC_BINARY_FILE, "wb");
+
+    if(file != NULL){
+        if((int)fwrite(pBytes, 1, length, file) == length)
+            value = 0;
+
+        if(fclose(file) != 0)
+            value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Checks that the binary file has the header of the current format followed by exactly the expected records
+ * \param unsigned char *pExpected pointer to the expected records
+ * \param int count number of expected records
+ * \return int value (0) if equal - (1) if not
+ */
+int checkBinaryFile(unsigned char *pExpected, int count)
+{
+    int value = 1;
+    long size;
+    unsigned char *pBytes = NULL;
+    FILE *file = NULL;
+
+    file = fopen(MECHATRONIC_BINARY_FILE, "rb");
+
+    if(file != NULL){
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+        pBytes = (unsigned char*)malloc(size + 1);
+
+        if(pBytes != NULL && size == MECHATRONIC_FILE_HEADER_SIZE + (long)MECHATRONIC_RECORD_SIZE * count &&
+           (long)fread(pBytes, 1, size, file) == size && mechatronic_checkFileHeader(pBytes) &&
+           mechatronic_checkRecords(pBytes + MECHATRONIC_FILE_HEADER_SIZE, count) == count &&
+           !memcmp(pBytes + MECHATRONIC_FILE_HEADER_SIZE, pExpected, (size_t)MECHATRONIC_RECORD_SIZE * count))
+            value = 0;
+
+        free(pBytes);
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Encodes and decodes events with every event type and the limits of every field, and checks that their
+ *        values are kept and that changing any byte of a record makes its checksum fail
+ * \return int value (0) if ok - (1) if not
+ */
+int checkRoundTrip(void)
+{
+    int i;
+    int j;
+    int value = 0;
+    Mechatronic event;
+    Mechatronic decoded;
+    unsigned char record[MECHATRONIC_RECORD_SIZE];
+
+    for(i = 0; i < TEST_RECORDS && value == 0; i++){
+        testEvent(&event, i);
+        mechatronic_encodeRecord(&event, record);
+        mechatronic_decodeRecord(record, &decoded, NULL);
+
+        if(!mechatronic_isStorableEvent(&event) || !mechatronic_isValidRecord(record) || decoded.timestamp != event.timestamp ||
+           decoded.today.hour != event.today.hour || decoded.idEmployee != event.idEmployee || strcmp(decoded.nameSurname, event.nameSurname) ||
+           decoded.eventType != event.eventType || fabs(decoded.ambientTemperatureRead - event.ambientTemperatureRead) > 0.006 + fabs(event.ambientTemperatureRead) * 1e-6 ||
+           fabsf(decoded.temperatureEngineOn - event.temperatureEngineOn) > 0.006f || fabsf(decoded.temperatureEngineOff - event.temperatureEngineOff) > 0.006f ||
+           decoded.humidityTemperatureRead != event.humidityTemperatureRead || decoded.humidityThreshold != event.humidityThreshold ||
+           mechatronic_getRecordTimestamp(record) != event.timestamp)
+            value = 1;
+
+        // cualquier byte cambiado invalida el registro
+        for(j = 0; j < MECHATRONIC_RECORD_SIZE && value == 0; j++){
+            record[j] ^= 0x10;
+
+            if(mechatronic_isValidRecord(record))
+                value = 1;
+
+            record[j] ^= 0x10;
+        }
+    }
+
+    if(value != 0)
+        printf("ERROR!, el evento %d no se codifico y decodifico igual\n", i - 1);
+
+    return value;
+}
+
+/**
+ * \brief Encodes events with temperatures that are not finite or don't fit in their fields and checks that they are
+ *        reported as not storable and stored clamped to the limits, NaN as 0. Humidities, thresholds and event types
+ *        out of their fields are reported too
+ * \return int value (0) if ok - (1) if not
+ */
+int checkClamp(void)
+{
+    int i;
+    int value = 0;
+    float temperatures[] = {NAN, INFINITY, -INFINITY, FLT_MAX, -FLT_MAX, 327.68f, -327.70f, 1e10f, -1e10f};
+    float ambient[] = {0.0f, INT_MAX / 100.0f, INT_MIN / 100.0f, INT_MAX / 100.0f, INT_MIN / 100.0f};
+    float engine[] = {0.0f, SHRT_MAX / 100.0f, SHRT_MIN / 100.0f, SHRT_MAX / 100.0f, SHRT_MIN / 100.0f, SHRT_MAX / 100.0f, SHRT_MIN / 100.0f,
+                      SHRT_MAX / 100.0f, SHRT_MIN / 100.0f};
+    Mechatronic event;
+    Mechatronic decoded;
+    unsigned char record[MECHATRONIC_RECORD_SIZE];
+
+    for(i = 0; i < (int)(sizeof(temperatures) / sizeof(float)) && value == 0; i++){
+        testEvent(&event, 1);
+        event.temperatureEngineOn = temperatures[i];
+        event.temperatureEngineOff = temperatures[i];
+
+        if(i < (int)(sizeof(ambient) / sizeof(float)))
+            event.ambientTemperatureRead = temperatures[i];
+
+        mechatronic_encodeRecord(&event, record);
+        mechatronic_decodeRecord(record, &decoded, NULL);
+
+        if(mechatronic_isStorableEvent(&event) || !mechatronic_isValidRecord(record) || decoded.temperatureEngineOn != engine[i] ||
+           decoded.temperatureEngineOff != engine[i] || (i < (int)(sizeof(ambient) / sizeof(float)) && decoded.ambientTemperatureRead != ambient[i]))
+            value = 1;
+    }
+
+    if(value != 0)
+        printf("ERROR!, la temperatura %g no se limito al codificarla\n", temperatures[i - 1]);
+
+    testEvent(&event, 1);
+    event.humidityTemperatureRead = USHRT_MAX + 1;
+
+    if(mechatronic_isStorableEvent(&event))
+        value = 1;
+
+    testEvent(&event, 1);
+    event.humidityThreshold = -1;
+
+    if(mechatronic_isStorableEvent(&event))
+        value = 1;
+
+    testEvent(&event, 1);
+    event.eventType = EVENT_UNKNOWN;
+
+    if(mechatronic_isStorableEvent(&event))
+        value = 1;
+
+    if(value != 0)
+        printf("ERROR!, mechatronic_isStorableEvent acepto un evento que no entra en un registro\n");
+
+    return value;
+}
+
+/**
+ * \brief Imports a legacy file with valid records, records with invalid dates, event types and values, and an
+ *        incomplete record at the end. Only the valid records must be converted, in order, and the others counted
+ * \return int value (0) if ok - (1) if not
+ */
+int checkLegacyImport(void)
+{
+    int i;
+    int value = 1;
+    int result;
+    int invalid = 0;
+    int discarded = 0;
+    int expectedCount = 0;
+    int expectedInvalid = 0;
+    char *pBytes = NULL;
+    int length = 0;
+    Mechatronic record;
+    LegacyMechatronic legacy;
+    unsigned char *pExpected = NULL;
+
+    pBytes = (char*)malloc(sizeof(LegacyMechatronic) * TEST_RECORDS + TEST_LEGACY_TAIL);
+    pExpected = (unsigned char*)malloc((size_t)MECHATRONIC_RECORD_SIZE * TEST_RECORDS);
+
+    for(i = 0; i < TEST_RECORDS && pBytes != NULL && pExpected != NULL; i++){
+        testLegacyEvent(&legacy, i);
+
+        // cada registro invalido tiene un solo valor fuera de rango
+        if(i % 10 == 3)
+            legacy.today.month = 13;
+        else if(i % 10 == 5)
+            legacy.ambientTemperatureRead = NAN;
+        else if(i % 10 == 7)
+            legacy.temperatureEngineOn = 500;
+        else if(i % 20 == 9)
+            strcpy(legacy.eventType, "Evento desconocido");
+        else if(i % 20 == 19)
+            legacy.humidityTemperatureRead = -1;
+        else{
+            mechatronic_decodeLegacyRecord(&legacy, &record);
+            mechatronic_encodeRecord(&record, pExpected + (size_t)MECHATRONIC_RECORD_SIZE * expectedCount++);
+        }
+
+        memcpy(pBytes + length, &legacy, sizeof(LegacyMechatronic));
+        length += sizeof(LegacyMechatronic);
+    }
+
+    expectedInvalid = TEST_RECORDS - expectedCount;
+
+    if(pBytes != NULL && pExpected != NULL){
+        memset(pBytes + length, 0x5A, TEST_LEGACY_TAIL);
+
+        if(writeTestFile(pBytes, length + TEST_LEGACY_TAIL) == 0 && mechatronic_isLegacyBinaryFile()){
+            result = mechatronic_importLegacyBinaryFile(&discarded, &invalid);
+
+            if(result == 0 && discarded == TEST_LEGACY_TAIL && invalid == expectedInvalid && !mechatronic_isLegacyBinaryFile() &&
+               checkBinaryFile(pExpected, expectedCount) == 0)
+                value = 0;
+            else
+                printf("ERROR!, importacion del formato anterior: resultado %d, %d bytes descartados, %d registros invalidos de %d\n",
+                       result, discarded, invalid, expectedInvalid);
+        }
+    }
+
+    free(pBytes);
+    free(pExpected);
+
+    return value;
+}
+
+/**
+ * \brief Upgrades a file of the previous version, whose records have no checksum, with an incomplete record at the
+ *        end. Every record must get its checksum and the incomplete one must be removed. A file that already has the
+ *        current version must be left as it is
+ * \return int value (0) if ok - (1) if not
+ */
+int checkUpgrade(void)
+{
+    int i;
+    int value = 1;
+    int result;
+    int discarded = -1;
+    int length = MECHATRONIC_FILE_HEADER_SIZE;
+    char *pBytes = NULL;
+    Mechatronic event;
+    unsigned char *pExpected = NULL;
+
+    pBytes = (char*)malloc(MECHATRONIC_FILE_HEADER_SIZE + (size_t)MECHATRONIC_PREVIOUS_RECORD_SIZE * TEST_RECORDS + TEST_PREVIOUS_TAIL);
+    pExpected = (unsigned char*)malloc((size_t)MECHATRONIC_RECORD_SIZE * TEST_RECORDS);
+
+    if(pBytes != NULL && pExpected != NULL){
+        // el encabezado de la version anterior solo cambia la version y el tamanio del registro
+        mechatronic_encodeFileHeader((unsigned char*)pBytes, 0);
+        pBytes[4] = MECHATRONIC_PREVIOUS_VERSION;
+        pBytes[8] = MECHATRONIC_PREVIOUS_RECORD_SIZE;
+
+        for(i = 0; i < TEST_RECORDS; i++){
+            testEvent(&event, i);
+            mechatronic_encodeRecord(&event, pExpected + (size_t)MECHATRONIC_RECORD_SIZE * i);
+            memcpy(pBytes + length, pExpected + (size_t)MECHATRONIC_RECORD_SIZE * i, MECHATRONIC_PREVIOUS_RECORD_SIZE);
+            length += MECHATRONIC_PREVIOUS_RECORD_SIZE;
+        }
+
+        memset(pBytes + length, 0xA5, TEST_PREVIOUS_TAIL);
+
+        if(writeTestFile(pBytes, length + TEST_PREVIOUS_TAIL) == 0){
+            result = mechatronic_upgradeBinaryFile(&discarded);
+
+            if(result == 0 && discarded == TEST_PREVIOUS_TAIL && checkBinaryFile(pExpected, TEST_RECORDS) == 0){
+                // con la version actual no se cambia nada
+                result = mechatronic_upgradeBinaryFile(&discarded);
+
+                if(result == 0 && discarded == 0 && checkBinaryFile(pExpected, TEST_RECORDS) == 0)
+                    value = 0;
+            }
+
+            if(value != 0)
+                printf("ERROR!, actualizacion de la version %d: resultado %d, %d bytes descartados\n", MECHATRONIC_PREVIOUS_VERSION, result, discarded);
+        }
+    }
+
+    free(pBytes);
+    free(pExpected);
+
+    return value;
+}
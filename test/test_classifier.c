@@ -0,0 +1,196 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "../inc/classifier.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TEST_SIMD
+#endif
+
+// LECTURAS DE CADA BLOQUE COMPARADO, MAS QUE EL ANCHO DE AVX2 PARA PROBAR TODOS LOS RESTOS
+#define TEST_MAX_COUNT 40
+
+// TEMPERATURAS Y HUMEDADES ESPECIALES COMBINADAS
+#define TEST_TEMPERATURES 16
+#define TEST_HUMIDITIES 10
+#define TEST_COMBINATIONS (TEST_TEMPERATURES * TEST_HUMIDITIES)
+
+// BLOQUES DE LECTURAS AL AZAR
+#define TEST_RANDOM_BLOCKS 2000
+
+// private functions of classifier.c
+void classifyScalar(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+#ifdef TEST_SIMD
+void classifySse2(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+void classifyAvx2(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold, unsigned char *pTypes);
+#endif
+
+unsigned char expectedType(float temperature, int humidity, float engineOn, float engineOff, int humidityThreshold);
+int checkKernels(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold);
+unsigned int nextRandom(unsigned int *pState);
+
+/**
+ * \brief Checks that the scalar, SSE2 and AVX2 kernels and cl_classify give the rules of the event types for every
+ *        reading: values equal to the thresholds, NaN and infinite temperatures and thresholds, the extreme
+ *        humidities, inverted thresholds, every block length up to TEST_MAX_COUNT and blocks that don't start aligned.
+ *        AVX2 is only checked if the processor has it
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int j;
+    int count;
+    int first;
+    int failed = 0;
+    int hasAvx2 = 0;
+    unsigned int state = 12345;
+    float temperatures[TEST_COMBINATIONS];
+    int humidities[TEST_COMBINATIONS];
+    float specialTemperatures[TEST_TEMPERATURES] = {25.0f, 24.999998f, 25.000002f, 15.0f, 14.999999f, 15.000001f, 0.0f, -0.0f,
+                                                    NAN, -NAN, INFINITY, -INFINITY, -20.0f, 60.0f, 1e30f, -1e30f};
+    int specialHumidities[TEST_HUMIDITIES] = {50, 49, 51, 0, 100, -1, INT_MIN, INT_MAX, INT_MIN + 1, INT_MAX - 1};
+    float thresholds[][2] = {{25.0f, 15.0f}, {15.0f, 25.0f}, {20.0f, 20.0f}, {NAN, 15.0f}, {25.0f, NAN}, {INFINITY, -INFINITY},
+                             {-INFINITY, INFINITY}, {0.0f, -0.0f}};
+    int humidityThresholds[] = {50, 0, -1, INT_MIN, INT_MAX};
+
+#ifdef TEST_SIMD
+    __builtin_cpu_init();
+    hasAvx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+    // cada temperatura especial con cada humedad especial
+    for(i = 0; i < TEST_COMBINATIONS; i++){
+        temperatures[i] = specialTemperatures[i % TEST_TEMPERATURES];
+        humidities[i] = specialHumidities[i / TEST_TEMPERATURES];
+    }
+
+    // desde cada posicion cada lectura cae en otro carril de los vectores, y con cada largo en otro resto
+    for(i = 0; i < (int)(sizeof(thresholds) / sizeof(thresholds[0])); i++){
+        for(j = 0; j < (int)(sizeof(humidityThresholds) / sizeof(int)); j++){
+            for(first = 0; first + TEST_MAX_COUNT <= TEST_COMBINATIONS; first++)
+                failed += checkKernels(temperatures + first, humidities + first, TEST_MAX_COUNT, thresholds[i][0], thresholds[i][1], humidityThresholds[j]);
+
+            for(count = 0; count <= TEST_MAX_COUNT; count++)
+                failed += checkKernels(temperatures + 1, humidities + 1, count, thresholds[i][0], thresholds[i][1], humidityThresholds[j]);
+        }
+    }
+
+    // lecturas al azar en los rangos del ingreso, en pasos de un grado para que caigan sobre los umbrales
+    for(i = 0; i < TEST_RANDOM_BLOCKS; i++){
+        count = nextRandom(&state) % (TEST_MAX_COUNT + 1);
+
+        for(j = 0; j < count; j++){
+            temperatures[j] = (int)(nextRandom(&state) % 81) - 20 + (nextRandom(&state) % 4 == 0 ? 0.5f : 0.0f);
+            humidities[j] = nextRandom(&state) % 101;
+        }
+
+        failed += checkKernels(temperatures, humidities, count, (float)(nextRandom(&state) % 41), (float)(nextRandom(&state) % 41) - 10, nextRandom(&state) % 101);
+    }
+
+    printf("test_classifier (%s): %s\n", hasAvx2 ? "escalar, SSE2 y AVX2" : "escalar y SSE2", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Gets the type of a reading with the rules written as in the documentation of cl_classify
+ * \param float temperature temperature read
+ * \param int humidity humidity read
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \return unsigned char value CL_ code of the reading
+ */
+unsigned char expectedType(float temperature, int humidity, float engineOn, float engineOff, int humidityThreshold)
+{
+    unsigned char value = CL_STOP_BY_HUMIDITY;
+
+    if(temperature > engineOn && !(humidity < humidityThreshold))
+        value = CL_BOOT_BY_TEMPERATURE;
+    else if(temperature < engineOff)
+        value = CL_STOP_BY_TEMPERATURE;
+    else if(humidity > humidityThreshold)
+        value = CL_BOOT_BY_HUMIDITY;
+
+    return value;
+}
+
+/**
+ * \brief Classifies a block with every kernel and with cl_classify and compares them with expectedType. The byte
+ *        after the block must not be written
+ * \param float *pTemperatures pointer to the temperatures read
+ * \param int *pHumidities pointer to the humidities read
+ * \param int count number of readings, up to TEST_MAX_COUNT
+ * \param float engineOn temperature to boot the engine
+ * \param float engineOff temperature to stop the engine
+ * \param int humidityThreshold humidity threshold
+ * \return int value (0) if all of them are right - (number of kernels that are wrong) if not
+ */
+int checkKernels(float *pTemperatures, int *pHumidities, int count, float engineOn, float engineOff, int humidityThreshold)
+{
+    int i;
+    int k;
+    int value = 0;
+    int kernels = 2;
+    char *names[] = {"escalar", "cl_classify", "SSE2", "AVX2"};
+    unsigned char expected[TEST_MAX_COUNT + 1];
+    unsigned char types[TEST_MAX_COUNT + 1];
+
+    for(i = 0; i < count; i++)
+        expected[i] = expectedType(pTemperatures[i], pHumidities[i], engineOn, engineOff, humidityThreshold);
+
+#ifdef TEST_SIMD
+    kernels = __builtin_cpu_supports("avx2") ? 4 : 3;
+#endif
+
+    for(k = 0; k < kernels; k++){
+        memset(types, 0xEE, sizeof(types));
+
+        if(k == 0)
+            classifyScalar(pTemperatures, pHumidities, count, engineOn, engineOff, humidityThreshold, types);
+        else if(k == 1)
+            cl_classify(pTemperatures, pHumidities, count, engineOn, engineOff, humidityThreshold, types);
+#ifdef TEST_SIMD
+        else if(k == 2)
+            classifySse2(pTemperatures, pHumidities, count, engineOn, engineOff, humidityThreshold, types);
+        else
+            classifyAvx2(pTemperatures, pHumidities, count, engineOn, engineOff, humidityThreshold, types);
+#endif
+
+        if(memcmp(types, expected, count) || types[count] != 0xEE){
+            printf("ERROR!, %s con %d lecturas y umbrales %g, %g, %d no clasifico como las reglas\n", names[k], count, engineOn, engineOff, humidityThreshold);
+            value++;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Gets the next number of a simple pseudo random sequence, the same on every system
+ * \param unsigned int *pState pointer to the state of the sequence
+ * \return unsigned int value next number
+ */
+unsigned int nextRandom(unsigned int *pState)
+{
+    *pState = *pState * 1103515245u + 12345u;
+
+    return *pState >> 8;
+}
@@ -0,0 +1,143 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include "../inc/crc32c.h"
+
+// LONGITUD MAXIMA DE LOS BLOQUES COMPARADOS ENTRE LA TABLA Y LA INSTRUCCION
+#define TEST_MAX_LENGTH 1024
+
+// private functions of crc32c.c
+unsigned int updateWithTable(unsigned int crc, unsigned char *pData, int length);
+
+int checkVector(char *name, void *pData, int length, unsigned int expected);
+int checkTable(void);
+int checkUpdate(void);
+
+/**
+ * \brief Checks the CRC32C against known vectors, the ones of RFC 3720 and the usual "123456789", that the table and
+ *        the crc32 instruction give the same result for every length and alignment, and that a CRC continued with
+ *        crc_update over several blocks equals the one of the whole block
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int failed = 0;
+    unsigned char block[32];
+
+    failed += checkVector("\"123456789\"", "123456789", 9, 0xE3069283u);
+
+    memset(block, 0, sizeof(block));
+    failed += checkVector("32 bytes 0x00", block, sizeof(block), 0x8A9136AAu);
+
+    memset(block, 0xFF, sizeof(block));
+    failed += checkVector("32 bytes 0xFF", block, sizeof(block), 0x62A8AB43u);
+
+    for(i = 0; i < 32; i++)
+        block[i] = i;
+
+    failed += checkVector("32 bytes ascendentes", block, sizeof(block), 0x46DD794Eu);
+
+    for(i = 0; i < 32; i++)
+        block[i] = 31 - i;
+
+    failed += checkVector("32 bytes descendentes", block, sizeof(block), 0x113FDB5Cu);
+    failed += checkVector("0 bytes", block, 0, 0);
+    failed += checkTable();
+    failed += checkUpdate();
+
+    printf("test_crc32c (%s): %s\n", crc_isHardware() ? "SSE4.2" : "por tabla", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Checks the CRC32C of a block
+ * \param char *name description of the block printed if the check fails
+ * \param void *pData pointer to the bytes
+ * \param int length number of bytes
+ * \param unsigned int expected CRC32C of the block
+ * \return int value (0) if ok - (1) if not
+ */
+int checkVector(char *name, void *pData, int length, unsigned int expected)
+{
+    int value = 0;
+    unsigned int crc = crc_checksum(pData, length);
+
+    if(crc != expected){
+        printf("ERROR!, CRC de %s: %08X, se esperaba %08X\n", name, crc, expected);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Checks that the CRC in use, the instruction when the processor has it, equals the one of the table for every
+ *        length up to TEST_MAX_LENGTH and every alignment of the first byte
+ * \return int value (0) if ok - (1) if not
+ */
+int checkTable(void)
+{
+    int i;
+    int offset;
+    int length;
+    int value = 0;
+    unsigned char block[TEST_MAX_LENGTH + 8];
+
+    srand(1);
+
+    for(i = 0; i < (int)sizeof(block); i++)
+        block[i] = rand();
+
+    for(offset = 0; offset < 8 && value == 0; offset++){
+        for(length = 0; length <= TEST_MAX_LENGTH && value == 0; length++){
+            if(crc_checksum(block + offset, length) != (updateWithTable(CRC_INITIAL, block + offset, length) ^ CRC_INITIAL)){
+                printf("ERROR!, la tabla y el CRC en uso difieren con %d bytes desde el byte %d\n", length, offset);
+                value = 1;
+            }
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Checks that a CRC continued with crc_update over two blocks equals the CRC of both blocks together
+ * \return int value (0) if ok - (1) if not
+ */
+int checkUpdate(void)
+{
+    int i;
+    int value = 0;
+    unsigned int crc;
+    unsigned char block[TEST_MAX_LENGTH];
+
+    for(i = 0; i < TEST_MAX_LENGTH; i++)
+        block[i] = i * 7;
+
+    for(i = 0; i <= TEST_MAX_LENGTH && value == 0; i += 13){
+        crc = crc_update(CRC_INITIAL, block, i);
+        crc = crc_update(crc, block + i, TEST_MAX_LENGTH - i) ^ CRC_INITIAL;
+
+        if(crc != crc_checksum(block, TEST_MAX_LENGTH)){
+            printf("ERROR!, el CRC continuado desde el byte %d no coincide\n", i);
+            value = 1;
+        }
+    }
+
+    return value;
+}
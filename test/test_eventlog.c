@@ -0,0 +1,272 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "../inc/eventlog.h"
+
+// REGISTRO Y ENCABEZADO DE PRUEBA, LOS GRUPOS ENTRAN EN EL BUFFER DE STDIO
+#define TEST_RECORD_SIZE 16
+#define TEST_HEADER_SIZE 8
+#define TEST_HEADER "TLOG0001"
+
+// REGISTROS DE UN GRUPO Y MILISEGUNDOS DE ESPERA DEL PRIMERO, UNO DE LOS DOS NUNCA SE ALCANZA EN CADA PRUEBA
+#define TEST_GROUP_SIZE 8
+#define TEST_GROUP_INTERVAL 200
+#define TEST_LONG_INTERVAL 60000
+#define TEST_LARGE_GROUP 1000
+
+// MILISEGUNDOS QUE SE ESPERA COMO MAXIMO A QUE UN GRUPO LLEGUE AL ARCHIVO
+#define TEST_TIMEOUT 5000
+
+long long elapsedMillis(struct timespec *pStart);
+long fileRecords(char *fileName);
+long waitRecords(char *fileName, long records, long long *pMillis);
+int appendRecords(EventLog *this, int first, int count);
+int checkGroupSize(void);
+int checkGroupInterval(void);
+int checkClose(void);
+
+/**
+ * \brief Checks the group commit of the event log: the records of a group stay out of the file until the group has
+ *        groupSize records or its first record waited groupInterval milliseconds, and then all of them reach the
+ *        file together, and closing the log commits the last group
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+
+    failed += checkGroupSize();
+    failed += checkGroupInterval();
+    failed += checkClose();
+
+    printf("test_eventlog: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Gets the milliseconds passed since a moment
+ * \param struct timespec *pStart pointer to the moment, taken with CLOCK_MONOTONIC
+ * \return long long value milliseconds passed
+ */
+long long elapsedMillis(struct timespec *pStart)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - pStart->tv_sec) * 1000LL + (now.tv_nsec - pStart->tv_nsec) / 1000000;
+}
+
+/**
+ * \brief Gets the number of complete records that reached a log file, the ones still in the stdio buffer are not there
+ * \param char *fileName path of the log file
+ * \return long value number of records - (-1) if the file can't be read
+ */
+long fileRecords(char *fileName)
+{
+    long value = -1;
+    struct stat status;
+
+    if(stat(fileName, &status) == 0 && status.st_size >= TEST_HEADER_SIZE)
+        value = (status.st_size - TEST_HEADER_SIZE) / TEST_RECORD_SIZE;
+
+    return value;
+}
+
+/**
+ * \brief Waits until a log file has a number of records, up to TEST_TIMEOUT milliseconds
+ * \param char *fileName path of the log file
+ * \param long records number of records expected
+ * \param long long *pMillis pointer where the milliseconds waited are written
+ * \return long value number of records of the file when the wait ended
+ */
+long waitRecords(char *fileName, long records, long long *pMillis)
+{
+    long value;
+    struct timespec start;
+    struct timespec pause = {0, 2000000};
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while((value = fileRecords(fileName)) < records && elapsedMillis(&start) < TEST_TIMEOUT)
+        nanosleep(&pause, NULL);
+
+    *pMillis = elapsedMillis(&start);
+
+    return value;
+}
+
+/**
+ * \brief Appends consecutive test records one by one
+ * \param EventLog *this pointer to event log
+ * \param int first number of the first record
+ * \param int count number of records
+ * \return int value (0) if ok - (-1) if an append failed
+ */
+int appendRecords(EventLog *this, int first, int count)
+{
+    int i;
+    int value = 0;
+    unsigned char record[TEST_RECORD_SIZE];
+
+    for(i = first; i < first + count && value == 0; i++){
+        memset(record, i & 0xFF, sizeof(record));
+        value = el_append(this, record);
+    }
+
+    return value;
+}
+
+/**
+ * \brief With a wait that never ends, the records of a group must reach the file when the group is full: a group
+ *        appended one by one and a group appended with a single el_appendArray
+ * \return int value (0) if ok - (1) if not
+ */
+int checkGroupSize(void)
+{
+    int value = 0;
+    long records;
+    long long millis;
+    EventLog *pEventLog = NULL;
+    unsigned char block[TEST_GROUP_SIZE * TEST_RECORD_SIZE];
+    struct timespec pause = {0, 50000000};
+
+    pEventLog = el_newEventLog("size.bin", TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, EL_SYNC_GROUP);
+
+    if(pEventLog == NULL || el_setSyncPolicy(pEventLog, EL_SYNC_GROUP, TEST_GROUP_SIZE, TEST_LONG_INTERVAL) != 0)
+        value = 1;
+
+    // un registro menos que el grupo se queda en el buffer
+    if(value == 0 && appendRecords(pEventLog, 0, TEST_GROUP_SIZE - 1) == 0){
+        nanosleep(&pause, NULL);
+
+        if(fileRecords("size.bin") != 0){
+            printf("ERROR!, el grupo incompleto llego al archivo antes de tiempo\n");
+            value = 1;
+        }
+    }
+    else
+        value = 1;
+
+    if(value == 0 && appendRecords(pEventLog, TEST_GROUP_SIZE - 1, 1) == 0){
+        records = waitRecords("size.bin", TEST_GROUP_SIZE, &millis);
+
+        if(records != TEST_GROUP_SIZE){
+            printf("ERROR!, el grupo de %d registros no llego al archivo (%ld registros en %lld ms)\n", TEST_GROUP_SIZE, records, millis);
+            value = 1;
+        }
+    }
+    else
+        value = 1;
+
+    memset(block, 0xAB, sizeof(block));
+
+    if(value == 0 && el_appendArray(pEventLog, block, TEST_GROUP_SIZE) == 0){
+        records = waitRecords("size.bin", 2 * TEST_GROUP_SIZE, &millis);
+
+        if(records != 2 * TEST_GROUP_SIZE){
+            printf("ERROR!, el grupo escrito de una vez no llego al archivo (%ld registros en %lld ms)\n", records, millis);
+            value = 1;
+        }
+    }
+    else
+        value = 1;
+
+    el_deleteEventLog(pEventLog);
+
+    return value;
+}
+
+/**
+ * \brief With a group that is never full, the records must reach the file groupInterval milliseconds after the first
+ *        of them was appended, not before
+ * \return int value (0) if ok - (1) if not
+ */
+int checkGroupInterval(void)
+{
+    int value = 0;
+    long records;
+    long long millis;
+    long long early;
+    struct timespec start;
+    EventLog *pEventLog = NULL;
+
+    pEventLog = el_newEventLog("interval.bin", TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, EL_SYNC_GROUP);
+
+    if(pEventLog == NULL || el_setSyncPolicy(pEventLog, EL_SYNC_GROUP, TEST_LARGE_GROUP, TEST_GROUP_INTERVAL) != 0)
+        value = 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if(value == 0 && appendRecords(pEventLog, 0, 3) == 0){
+        records = fileRecords("interval.bin");
+        early = elapsedMillis(&start);
+
+        // solo se puede exigir que falten si todavia no paso el intervalo
+        if(records != 0 && early < TEST_GROUP_INTERVAL){
+            printf("ERROR!, el grupo llego al archivo a los %lld ms, antes de %d ms\n", early, TEST_GROUP_INTERVAL);
+            value = 1;
+        }
+
+        records = waitRecords("interval.bin", 3, &millis);
+        millis = elapsedMillis(&start);
+
+        if(records != 3){
+            printf("ERROR!, el grupo no llego al archivo %d ms despues del primer registro (%ld registros en %lld ms)\n",
+                   TEST_GROUP_INTERVAL, records, millis);
+            value = 1;
+        }
+        else if(millis < TEST_GROUP_INTERVAL - 10){
+            printf("ERROR!, el grupo llego al archivo a los %lld ms, antes de %d ms\n", millis, TEST_GROUP_INTERVAL);
+            value = 1;
+        }
+    }
+    else
+        value = 1;
+
+    el_deleteEventLog(pEventLog);
+
+    return value;
+}
+
+/**
+ * \brief Closing a log with a group that is not full and did not wait must write the group to the file
+ * \return int value (0) if ok - (1) if not
+ */
+int checkClose(void)
+{
+    int value = 0;
+    EventLog *pEventLog = NULL;
+
+    pEventLog = el_newEventLog("close.bin", TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, EL_SYNC_GROUP);
+
+    if(pEventLog == NULL || el_setSyncPolicy(pEventLog, EL_SYNC_GROUP, TEST_LARGE_GROUP, TEST_LONG_INTERVAL) != 0 ||
+       appendRecords(pEventLog, 0, 5) != 0)
+        value = 1;
+
+    el_deleteEventLog(pEventLog);
+
+    if(value != 0 || fileRecords("close.bin") != 5){
+        printf("ERROR!, al cerrar el registro no se guardo el ultimo grupo\n");
+        value = 1;
+    }
+
+    return value;
+}
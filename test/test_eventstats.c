@@ -0,0 +1,166 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../inc/mechatronic.h"
+
+// EVENTOS AGREGADOS AL ALMACEN
+#define TEST_EVENTS 20
+
+// EVENTOS DEL ARCHIVO BINARIO Y EVENTOS POR SEGMENTO, LOS DOS PRIMEROS SEGMENTOS QUEDAN SELLADOS
+#define TEST_FILE_EVENTS 25
+#define TEST_SEGMENT_EVENTS 10
+
+// private variables of mechatronic.c
+extern SegmentLog *pSegmentLog;
+extern int segmentEvents;
+extern int statsOutdated;
+
+int testExpected(PagedStore *pPagedStore, char *step);
+int checkLoad(void);
+
+/**
+ * \brief Checks that the statistics and the columns of the event store follow every change of the resident events:
+ *        events added, replaced with al_set, removed with al_remove and al_pop and cleared with al_clear. The minimum,
+ *        maximum and first values are removed on purpose, they can't be taken back without going through the events.
+ *        When the binary file is loaded only the segment being written is checked, the statistics of the sealed
+ *        segments are gathered the first time they are requested
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int failed = 0;
+    Mechatronic event;
+    EventStats stats;
+    PagedStore *pPagedStore = NULL;
+
+    mechatronic_enableColumns(1);
+    pPagedStore = mechatronic_newEventList();
+
+    for(i = 0; i < TEST_EVENTS; i++){
+        mechatronic_newReading(&event, 10.0f + i * 1.5f, 30 + (i * 7) % 60, 1700000000LL + i * 60);
+        ps_add(pPagedStore, &event);
+    }
+
+    failed += testExpected(pPagedStore, "al_add");
+
+    al_remove(pPagedStore->pResident, 0);
+    failed += testExpected(pPagedStore, "al_remove");
+
+    mechatronic_newReading(&event, -5.25f, 99, 1700000000LL + 5 * 60);
+    al_set(pPagedStore->pResident, 4, &event);
+    failed += testExpected(pPagedStore, "al_set");
+
+    al_pop(pPagedStore->pResident, ps_len(pPagedStore) - 1);
+    failed += testExpected(pPagedStore, "al_pop");
+
+    // el almacen se vacia de la memoria pero las estadisticas describen el archivo binario
+    stats = *mechatronic_getStats(pPagedStore);
+    mechatronic_evictEvents(pPagedStore);
+
+    if(ps_len(pPagedStore) != 0 || memcmp(&stats, mechatronic_getStats(pPagedStore), sizeof(EventStats))){
+        printf("ERROR!, mechatronic_evictEvents no conservo las estadisticas\n");
+        failed++;
+    }
+
+    for(i = 0; i < 3; i++){
+        mechatronic_newReading(&event, 20.0f, 40, 1700100000LL + i);
+        ps_add(pPagedStore, &event);
+    }
+
+    al_clear(pPagedStore->pResident);
+    failed += testExpected(pPagedStore, "al_clear");
+
+    mechatronic_deleteEventList(pPagedStore);
+    failed += checkLoad();
+    printf("test_eventstats: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Compares the statistics and the columns of the event store with the ones of its current events
+ * \param PagedStore *pPagedStore pointer to the event store
+ * \param char *step operation checked, printed if the check fails
+ * \return int value (0) if ok - (1) if not
+ */
+int testExpected(PagedStore *pPagedStore, char *step)
+{
+    int i;
+    int value = 0;
+    EventStats expected;
+    EventStats *pStats = NULL;
+
+    mechatronic_resetStats(&expected);
+
+    for(i = 0; i < ps_len(pPagedStore); i++)
+        mechatronic_updateStats(&expected, ps_get(pPagedStore, i));
+
+    pStats = mechatronic_getStats(pPagedStore);
+
+    if(memcmp(&expected, pStats, sizeof(EventStats)) || cs_len(mechatronic_getColumns()) != ps_len(pPagedStore)){
+        printf("ERROR!, despues de %s hay %d eventos y las estadisticas cuentan %d (minimo %.2f, maximo %.2f)\n", step,
+               ps_len(pPagedStore), pStats->count, pStats->minTemperature, pStats->maxTemperature);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Saves events in several segments and loads the binary file again. The sealed segments are not checked
+ *        and their statistics and columns are gathered when they are requested
+ * \return int value (0) if ok - (1) if not
+ */
+int checkLoad(void)
+{
+    int i;
+    int value = 1;
+    Mechatronic event;
+    PagedStore *pPagedStore = NULL;
+
+    segmentEvents = TEST_SEGMENT_EVENTS;
+    mkdir("load", 0755);
+
+    if(chdir("load") == 0 && mechatronic_openBinaryFile() == 0 && mechatronic_applyConfig(NULL) == 0){
+        for(i = 0; i < TEST_FILE_EVENTS; i++){
+            mechatronic_newReading(&event, 12.0f + (i * 13) % 30, 20 + (i * 11) % 70, 1700200000LL + i * 60);
+            mechatronic_saveBinaryFile(&event);
+        }
+
+        if(sl_len(pSegmentLog) == 3)
+            value = 0;
+
+        mechatronic_closeBinaryFile();
+    }
+
+    pPagedStore = mechatronic_newEventList();
+
+    if(value == 0 && (mechatronic_createBinaryFile(pPagedStore) != 0 || ps_len(pPagedStore) != TEST_FILE_EVENTS || !statsOutdated)){
+        printf("ERROR!, se revisaron los segmentos sellados al cargar el archivo binario\n");
+        value = 1;
+    }
+
+    if(value == 0)
+        value = testExpected(pPagedStore, "cargar el archivo binario");
+
+    mechatronic_closeBinaryFile();
+    mechatronic_deleteEventList(pPagedStore);
+
+    return chdir("..") == 0 ? value : 1;
+}
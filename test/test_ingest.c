@@ -0,0 +1,179 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include "../inc/ingest.h"
+
+// VALOR QUE EL PARSER NO DEBE TOCAR SI LA LINEA NO ES VALIDA
+#define TEST_UNTOUCHED -12345
+
+// CAPACIDAD DE LA COLA DEL HILO DE ESCRITURA SIMULADO
+#define TEST_QUEUE_SIZE 64
+
+struct TestLine{
+
+    char *pLine;
+    int valid;
+    int idMachine;
+    float temperature;
+    int humidity;
+
+}typedef TestLine;
+
+// private functions and variables of ingest.c
+int parseReadings(IngestWriter *pWriters, int writers, char *pBuffer, int length, long long timestamp);
+int parseReading(char *pLine, int *pMachine, float *pTemperature, int *pHumidity);
+extern int readingsDiscarded;
+
+int checkLines(void);
+int checkBuffer(void);
+
+/**
+ * \brief Checks the parser of the readings received without user interaction: the lines of the main machine and of
+ *        the other machines with every separator, the values out of range, numbers too big for an int that must not
+ *        wrap into a valid machine or humidity, and a buffer with several lines, an empty one, an invalid one and an
+ *        incomplete one at the end, whose readings must reach the queue of the writer thread
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+
+    failed += checkLines();
+    failed += checkBuffer();
+
+    printf("test_ingest: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Parses valid and invalid lines one by one and checks the values read. Invalid lines must not change the
+ *        machine nor the humidity
+ * \return int value (0) if ok - (1) if not
+ */
+int checkLines(void)
+{
+    int i;
+    int value = 0;
+    int idMachine;
+    int humidity;
+    float temperature;
+    char line[64];
+    TestLine lines[] = {
+        {"25.5 60", 1, 0, 25.5f, 60},
+        {"3 25.5 60", 1, 3, 25.5f, 60},
+        {"3,25.5;60", 1, 3, 25.5f, 60},
+        {"255;-20,100 \t\r", 1, 255, -20.0f, 100},
+        {"  7 60 0", 1, 7, 60.0f, 0},
+        {"0 -19.75 1", 1, 0, -19.75f, 1},
+        {"256 25 60", 0, 0, 0, 0},
+        {"-1 25 60", 0, 0, 0, 0},
+        {"4294967299 25 60", 0, 0, 0, 0},
+        {"18446744073709551619 25 60", 0, 0, 0, 0},
+        {"-4294967293 25 60", 0, 0, 0, 0},
+        {"2 25 4294967346", 0, 0, 0, 0},
+        {"25 4294967346", 0, 0, 0, 0},
+        {"2 25 -4294967246", 0, 0, 0, 0},
+        {"25 101", 0, 0, 0, 0},
+        {"25 -1", 0, 0, 0, 0},
+        {"60.5 50", 0, 0, 0, 0},
+        {"-20.5 50", 0, 0, 0, 0},
+        {"1e40 50", 0, 0, 0, 0},
+        {"nan 50", 0, 0, 0, 0},
+        {"25", 0, 0, 0, 0},
+        {"25 60 x", 0, 0, 0, 0},
+        {"1 25 60 7", 0, 0, 0, 0},
+        {"25 60.5", 0, 0, 0, 0},
+        {"abc", 0, 0, 0, 0},
+        {"", 0, 0, 0, 0}
+    };
+
+    for(i = 0; i < (int)(sizeof(lines) / sizeof(TestLine)); i++){
+        idMachine = TEST_UNTOUCHED;
+        humidity = TEST_UNTOUCHED;
+
+        // el parser escribe sobre la linea, se le pasa una copia
+        strcpy(line, lines[i].pLine);
+
+        if(parseReading(line, &idMachine, &temperature, &humidity) != lines[i].valid){
+            printf("ERROR!, la linea \"%s\" se tomo como %s\n", lines[i].pLine, lines[i].valid ? "invalida" : "valida");
+            value = 1;
+        }
+        else if(lines[i].valid && (idMachine != lines[i].idMachine || temperature != lines[i].temperature || humidity != lines[i].humidity)){
+            printf("ERROR!, la linea \"%s\" se leyo como %d %.2f %d\n", lines[i].pLine, idMachine, temperature, humidity);
+            value = 1;
+        }
+        else if(!lines[i].valid && (idMachine != TEST_UNTOUCHED || humidity != TEST_UNTOUCHED)){
+            printf("ERROR!, la linea invalida \"%s\" cambio la maquina o la humedad\n", lines[i].pLine);
+            value = 1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * \brief Parses a buffer as the reader thread does and checks the bytes consumed, the lines discarded and the events
+ *        queued to a writer thread that is not running
+ * \return int value (0) if ok - (1) if not
+ */
+int checkBuffer(void)
+{
+    int i;
+    int value = 0;
+    int consumed;
+    int complete;
+    int count = 0;
+    char buffer[] = "0 20 50\n5,21.5;55\n4294967301 22 60\n\n2 23 65\r\n1 24";
+    int machines[] = {0, 5, 2};
+    float temperatures[] = {20.0f, 21.5f, 23.0f};
+    Mechatronic events[TEST_QUEUE_SIZE];
+    IngestWriter writer;
+
+    memset(&writer, 0, sizeof(IngestWriter));
+    writer.pQueue = rb_newRingBuffer(sizeof(Mechatronic), TEST_QUEUE_SIZE);
+    pthread_mutex_init(&writer.mutex, NULL);
+    pthread_cond_init(&writer.queued, NULL);
+    pthread_cond_init(&writer.released, NULL);
+
+    // la ultima linea no tiene salto de linea todavia y queda para la proxima lectura
+    complete = strrchr(buffer, '\n') + 1 - buffer;
+
+    if(writer.pQueue != NULL){
+        consumed = parseReadings(&writer, 1, buffer, strlen(buffer), 1700000000LL);
+        count = rb_popArray(writer.pQueue, events, TEST_QUEUE_SIZE);
+
+        if(consumed != complete || readingsDiscarded != 1 || count != 3)
+            value = 1;
+
+        for(i = 0; i < count && value == 0; i++){
+            if(events[i].idMachine != machines[i] || events[i].ambientTemperatureRead != temperatures[i] || events[i].timestamp != 1700000000LL)
+                value = 1;
+        }
+    }
+    else
+        value = 1;
+
+    if(value != 0)
+        printf("ERROR!, el buffer se leyo con %d lecturas en la cola y %d descartadas\n", count, readingsDiscarded);
+
+    rb_deleteRingBuffer(writer.pQueue);
+    pthread_mutex_destroy(&writer.mutex);
+    pthread_cond_destroy(&writer.queued);
+    pthread_cond_destroy(&writer.released);
+
+    return value;
+}
@@ -0,0 +1,360 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include "../inc/pagedstore.h"
+
+// ELEMENTOS POR PAGINA, PAGINAS EN MEMORIA Y ELEMENTOS DEL ARCHIVO SIMULADO
+#define TEST_PAGE_SIZE 4
+#define TEST_MAX_PAGES 2
+#define TEST_FILE_SIZE 64
+
+// ELEMENTOS EN PAGINAS Y ELEMENTOS RESIDENTES DE LA PRUEBA DE BORDES, LA ULTIMA PAGINA QUEDA INCOMPLETA
+#define TEST_STORED 12
+#define TEST_RESIDENT 3
+
+int testFile[TEST_FILE_SIZE];
+int testLoads = 0;
+int testRemoved = 0;
+
+int testLoadPage(void *pContext, int first, void *pElements, int count);
+void testCountRemoved(void *pContext, void *pElement);
+PagedStore *testNewStore(int stored, int resident);
+int testResidentPages(PagedStore *this);
+int testGet(PagedStore *this, int index);
+int checkBoundaries(void);
+int checkLeastRecentlyUsed(void);
+int checkCapacity(void);
+int checkSealedTail(void);
+
+/**
+ * \brief Checks the paged store: every element is found across the edges of the pages and of the resident
+ *        elements, the cache drops the least recently used page first and never keeps more pages than its limit,
+ *        and the resident elements that fill a page move to the cache without leaving the store
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int failed = 0;
+
+    // el archivo simulado guarda en cada posicion su indice por mil
+    for(i = 0; i < TEST_FILE_SIZE; i++)
+        testFile[i] = i * 1000;
+
+    failed += checkBoundaries();
+    failed += checkLeastRecentlyUsed();
+    failed += checkCapacity();
+    failed += checkSealedTail();
+
+    printf("test_pagedstore: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Reads elements of the simulated file, it is the function that loads the pages of the test stores
+ * \param void *pContext not used
+ * \param int first index of the first element
+ * \param void *pElements pointer to an array of count elements
+ * \param int count number of elements to read
+ * \return int value number of elements read
+ */
+int testLoadPage(void *pContext, int first, void *pElements, int count)
+{
+    int value = 0;
+
+    (void)pContext;
+
+    if(first >= 0 && first < TEST_FILE_SIZE){
+        value = TEST_FILE_SIZE - first < count ? TEST_FILE_SIZE - first : count;
+        memcpy(pElements, &testFile[first], sizeof(int) * value);
+        testLoads++;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Counts the elements removed from the resident elements, it is their remove hook
+ * \param void *pContext not used
+ * \param void *pElement not used
+ * \return void
+ */
+void testCountRemoved(void *pContext, void *pElement)
+{
+    (void)pContext;
+    (void)pElement;
+    testRemoved++;
+}
+
+/**
+ * \brief Creates a store whose first elements are read from the simulated file and the next ones are resident,
+ *        with the same values as the file
+ * \param int stored number of elements read in pages, a multiple of the page size
+ * \param int resident number of resident elements
+ * \return PagedStore *this pointer to the store - (NULL) if error
+ */
+PagedStore *testNewStore(int stored, int resident)
+{
+    int i;
+    PagedStore *this = NULL;
+
+    this = ps_newPagedStore(sizeof(int), TEST_PAGE_SIZE, TEST_MAX_PAGES, testLoadPage, NULL);
+
+    if(this != NULL && ps_setStored(this, stored) == 0){
+        for(i = stored; i < stored + resident; i++)
+            al_add(this->pResident, &testFile[i]);
+    }
+
+    return this;
+}
+
+/**
+ * \brief Counts the pages of a store that have memory
+ * \param PagedStore *this pointer to the store
+ * \return int value number of pages
+ */
+int testResidentPages(PagedStore *this)
+{
+    int i;
+    int value = 0;
+
+    for(i = 0; i < this->maxPages; i++){
+        if(this->pPages[i].pElements != NULL)
+            value++;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Gets an element of a store and checks it is the one of the simulated file
+ * \param PagedStore *this pointer to the store
+ * \param int index index of the element
+ * \return int value (0) if ok - (1) if not
+ */
+int testGet(PagedStore *this, int index)
+{
+    int value = 1;
+    int *pElement = NULL;
+
+    pElement = (int*)ps_get(this, index);
+
+    if(pElement != NULL && *pElement == testFile[index])
+        value = 0;
+    else
+        printf("ERROR!, el elemento %d no se leyo\n", index);
+
+    return value;
+}
+
+/**
+ * \brief Gets every element, in order and backwards, across the edges of the pages and of the resident elements,
+ *        and copies blocks that start and end in the middle of the pages. The indexes out of the store are rejected
+ * \return int value (0) if ok - (1) if not
+ */
+int checkBoundaries(void)
+{
+    int i;
+    int j;
+    int value = 0;
+    int elements[TEST_STORED + TEST_RESIDENT];
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = testNewStore(TEST_STORED, TEST_RESIDENT);
+
+    if(pPagedStore == NULL || ps_len(pPagedStore) != TEST_STORED + TEST_RESIDENT)
+        value = 1;
+
+    for(i = 0; i < TEST_STORED + TEST_RESIDENT && value == 0; i++)
+        value = testGet(pPagedStore, i);
+
+    for(i = TEST_STORED + TEST_RESIDENT - 1; i >= 0 && value == 0; i--)
+        value = testGet(pPagedStore, i);
+
+    // el primer elemento de cada pagina despues del ultimo de la anterior, con la cache llena
+    for(i = TEST_PAGE_SIZE; i <= TEST_STORED && value == 0; i += TEST_PAGE_SIZE)
+        value = testGet(pPagedStore, i - 1) + testGet(pPagedStore, i);
+
+    if(value == 0 && (ps_get(pPagedStore, -1) != NULL || ps_get(pPagedStore, TEST_STORED + TEST_RESIDENT) != NULL)){
+        printf("ERROR!, se obtuvo un elemento fuera del almacen\n");
+        value = 1;
+    }
+
+    for(i = 0; i < TEST_STORED + TEST_RESIDENT && value == 0; i += 3){
+        memset(elements, 0, sizeof(elements));
+
+        if(ps_read(pPagedStore, i, elements, TEST_STORED + TEST_RESIDENT - i) != TEST_STORED + TEST_RESIDENT - i)
+            value = 1;
+
+        for(j = 0; j < TEST_STORED + TEST_RESIDENT - i && value == 0; j++){
+            if(elements[j] != testFile[i + j])
+                value = 1;
+        }
+
+        if(value != 0)
+            printf("ERROR!, no se copiaron los elementos desde el %d\n", i);
+    }
+
+    ps_deletePagedStore(pPagedStore);
+
+    return value;
+}
+
+/**
+ * \brief Uses the pages in a known order and checks which ones are read again: the page used the longest time ago
+ *        is dropped first, and the pages in memory are not read again
+ * \return int value (0) if ok - (1) if not
+ */
+int checkLeastRecentlyUsed(void)
+{
+    int value = 0;
+    int faults;
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = testNewStore(TEST_STORED, 0);
+
+    if(pPagedStore == NULL)
+        value = 1;
+
+    // las paginas 0 y 1 quedan en memoria, la 0 se usa despues que la 1
+    if(value == 0)
+        value = testGet(pPagedStore, 0) + testGet(pPagedStore, TEST_PAGE_SIZE) + testGet(pPagedStore, 1);
+
+    if(value == 0 && pPagedStore->faults != 2)
+        value = 1;
+
+    // la pagina 2 ocupa el lugar de la 1, la 0 sigue en memoria y la 1 se lee de nuevo
+    if(value == 0){
+        faults = pPagedStore->faults;
+        value = testGet(pPagedStore, 2 * TEST_PAGE_SIZE) + testGet(pPagedStore, 2);
+
+        if(value == 0 && pPagedStore->faults != faults + 1)
+            value = 1;
+
+        if(value == 0 && (testGet(pPagedStore, TEST_PAGE_SIZE + 1) != 0 || pPagedStore->faults != faults + 2))
+            value = 1;
+
+        // al leer la 1 se descarto la 2, la menos usada, y la 0 sigue en memoria
+        if(value == 0 && (testGet(pPagedStore, 3) != 0 || pPagedStore->faults != faults + 2 ||
+                          testGet(pPagedStore, 2 * TEST_PAGE_SIZE) != 0 || pPagedStore->faults != faults + 3))
+            value = 1;
+    }
+
+    if(value != 0)
+        printf("ERROR!, la cache no descarto primero la pagina menos usada (%d lecturas)\n", pPagedStore != NULL ? pPagedStore->faults : -1);
+
+    ps_deletePagedStore(pPagedStore);
+
+    return value;
+}
+
+/**
+ * \brief Goes through every page of a long store and checks that the cache never has more pages than its limit,
+ *        also after lowering and raising it, and that the limit can't be less than one page
+ * \return int value (0) if ok - (1) if not
+ */
+int checkCapacity(void)
+{
+    int i;
+    int value = 0;
+    int faults;
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = testNewStore(TEST_FILE_SIZE, 0);
+
+    if(pPagedStore == NULL || testResidentPages(pPagedStore) != 0)
+        value = 1;
+
+    for(i = 0; i < TEST_FILE_SIZE && value == 0; i++){
+        value = testGet(pPagedStore, i);
+
+        if(testResidentPages(pPagedStore) > TEST_MAX_PAGES)
+            value = 1;
+    }
+
+    if(value == 0 && (pPagedStore->faults != TEST_FILE_SIZE / TEST_PAGE_SIZE || testResidentPages(pPagedStore) != TEST_MAX_PAGES))
+        value = 1;
+
+    // con una sola pagina cada cambio de pagina la vuelve a leer
+    if(value == 0 && (ps_setCapacity(pPagedStore, 0) != -1 || ps_setCapacity(pPagedStore, 1) != 0 || testResidentPages(pPagedStore) > 1))
+        value = 1;
+
+    if(value == 0){
+        faults = pPagedStore->faults;
+        value = testGet(pPagedStore, 0) + testGet(pPagedStore, TEST_PAGE_SIZE) + testGet(pPagedStore, 0);
+
+        if(value == 0 && (pPagedStore->faults < faults + 2 || testResidentPages(pPagedStore) != 1))
+            value = 1;
+    }
+
+    if(value == 0 && (ps_setCapacity(pPagedStore, TEST_MAX_PAGES + 1) != 0 || testGet(pPagedStore, 0) != 0 ||
+                      testGet(pPagedStore, TEST_PAGE_SIZE) != 0 || testGet(pPagedStore, 2 * TEST_PAGE_SIZE) != 0 ||
+                      testResidentPages(pPagedStore) != TEST_MAX_PAGES + 1))
+        value = 1;
+
+    if(value != 0)
+        printf("ERROR!, la cache supero su limite de paginas\n");
+
+    ps_deletePagedStore(pPagedStore);
+
+    return value;
+}
+
+/**
+ * \brief Adds elements one by one and checks that every time the resident elements fill a page it goes to the
+ *        cache, without calling the remove hook, so the resident elements never take more than a page. The pages
+ *        are found in the cache until they are dropped, and then they are read from the simulated file
+ * \return int value (0) if ok - (1) if not
+ */
+int checkSealedTail(void)
+{
+    int i;
+    int value = 0;
+    int loads;
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = ps_newPagedStore(sizeof(int), TEST_PAGE_SIZE, TEST_MAX_PAGES, testLoadPage, NULL);
+
+    if(pPagedStore == NULL)
+        value = 1;
+    else
+        al_setRemoveHook(pPagedStore->pResident, testCountRemoved, NULL);
+
+    loads = testLoads;
+
+    for(i = 0; i < 3 * TEST_PAGE_SIZE + 1 && value == 0; i++){
+        if(ps_add(pPagedStore, &testFile[i]) != 0 || testGet(pPagedStore, i) != 0 || al_len(pPagedStore->pResident) >= TEST_PAGE_SIZE ||
+           pPagedStore->stored != (i + 1) / TEST_PAGE_SIZE * TEST_PAGE_SIZE)
+            value = 1;
+    }
+
+    // las dos ultimas paginas selladas estan en la cache y no se leyo nada del archivo
+    if(value == 0 && (testLoads != loads || testRemoved != 0 || ps_len(pPagedStore) != 3 * TEST_PAGE_SIZE + 1 ||
+                      testGet(pPagedStore, TEST_PAGE_SIZE) != 0 || testGet(pPagedStore, 2 * TEST_PAGE_SIZE + 3) != 0 || testLoads != loads))
+        value = 1;
+
+    // la primera pagina se descarto al sellar la tercera
+    if(value == 0 && (testGet(pPagedStore, 0) != 0 || testLoads != loads + 1 || testResidentPages(pPagedStore) != TEST_MAX_PAGES))
+        value = 1;
+
+    if(value != 0)
+        printf("ERROR!, los elementos residentes no pasaron a la cache al llenar una pagina\n");
+
+    ps_deletePagedStore(pPagedStore);
+
+    return value;
+}
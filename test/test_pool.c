@@ -0,0 +1,174 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include "../inc/pool.h"
+
+// ELEMENTOS POR BLOQUE DE MEMORIA DEL POOL PROBADO
+#define TEST_SLAB 7
+
+// ELEMENTOS PEDIDOS AL POOL, NO ES MULTIPLO DE TEST_SLAB
+#define TEST_ELEMENTS 1000
+
+// TAMANIO DE CADA ELEMENTO, MAYOR QUE UN PUNTERO
+#define TEST_ELEMENT_SIZE 24
+
+int checkGrowth(Pool *pPool, char **ppElements);
+int checkReuse(Pool *pPool, char **ppElements);
+int checkRelease(Pool *pPool);
+
+/**
+ * \brief Checks the pool: invalid parameters are rejected, elements are taken slab by slab and a new slab is
+ *        allocated only when the current one is full, every element is distinct and keeps its contents, released
+ *        elements are reused before taking new ones, and pl_clear releases every slab and leaves the pool ready to
+ *        be used again
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+    char *elements[TEST_ELEMENTS];
+    Pool *pPool = NULL;
+
+    if(pl_newPool(sizeof(void*) - 1, TEST_SLAB) != NULL || pl_newPool(TEST_ELEMENT_SIZE, 0) != NULL || pl_alloc(NULL) != NULL ||
+       pl_free(NULL, elements) != -1 || pl_clear(NULL) != -1 || pl_deletePool(NULL) != -1){
+        printf("ERROR!, el pool acepto parametros invalidos\n");
+        failed++;
+    }
+
+    pPool = pl_newPool(TEST_ELEMENT_SIZE, TEST_SLAB);
+
+    if(pPool == NULL || pl_free(pPool, NULL) != -1){
+        printf("ERROR!, no se pudo crear el pool o acepto liberar NULL\n");
+        failed++;
+    }
+    else{
+        failed += checkGrowth(pPool, elements);
+        failed += checkReuse(pPool, elements);
+        failed += checkRelease(pPool);
+    }
+
+    if(pPool != NULL && pl_deletePool(pPool) != 0){
+        printf("ERROR!, pl_deletePool fallo\n");
+        failed++;
+    }
+
+    printf("test_pool: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Takes TEST_ELEMENTS elements from an empty pool, filling every one with its number, and checks that a new
+ *        slab is allocated only when the last one is full and that no element overwrote another
+ * \param Pool *pPool pointer to the empty pool
+ * \param char **ppElements pointer to TEST_ELEMENTS pointers where the elements are written
+ * \return int value (0) if ok - (1) if not
+ */
+int checkGrowth(Pool *pPool, char **ppElements)
+{
+    int i;
+    int value = 0;
+
+    for(i = 0; i < TEST_ELEMENTS && value == 0; i++){
+        ppElements[i] = (char*)pl_alloc(pPool);
+
+        if(ppElements[i] == NULL || al_len(pPool->pSlabs) != i / TEST_SLAB + 1)
+            value = 1;
+        else
+            memset(ppElements[i], i % 251, TEST_ELEMENT_SIZE);
+    }
+
+    for(i = 0; i < TEST_ELEMENTS && value == 0; i++){
+        if(ppElements[i][0] != (char)(i % 251) || ppElements[i][TEST_ELEMENT_SIZE - 1] != (char)(i % 251))
+            value = 1;
+    }
+
+    if(value != 0)
+        printf("ERROR!, el pool no crecio de a %d elementos o piso un elemento (elemento %d)\n", TEST_SLAB, i);
+
+    return value;
+}
+
+/**
+ * \brief Releases every other element and takes them again: the last released is the first reused, no slab is
+ *        allocated while there are released elements and the next element comes from a new slab
+ * \param Pool *pPool pointer to the pool with the TEST_ELEMENTS elements of checkGrowth
+ * \param char **ppElements pointer to the TEST_ELEMENTS elements
+ * \return int value (0) if ok - (1) if not
+ */
+int checkReuse(Pool *pPool, char **ppElements)
+{
+    int i;
+    int value = 0;
+    int slabs = al_len(pPool->pSlabs);
+    char *pElement = NULL;
+
+    for(i = 0; i < TEST_ELEMENTS && value == 0; i += 2){
+        if(pl_free(pPool, ppElements[i]) != 0)
+            value = 1;
+    }
+
+    // la lista de libres es una pila, el ultimo liberado sale primero
+    for(i = (TEST_ELEMENTS - 1) / 2 * 2; i >= 0 && value == 0; i -= 2){
+        pElement = (char*)pl_alloc(pPool);
+
+        if(pElement != ppElements[i] || al_len(pPool->pSlabs) != slabs)
+            value = 1;
+    }
+
+    // los elementos que no se liberaron siguen intactos
+    for(i = 1; i < TEST_ELEMENTS && value == 0; i += 2){
+        if(ppElements[i][TEST_ELEMENT_SIZE / 2] != (char)(i % 251))
+            value = 1;
+    }
+
+    pElement = (char*)pl_alloc(pPool);
+
+    if(value == 0 && (pElement == NULL || al_len(pPool->pSlabs) != (TEST_ELEMENTS % TEST_SLAB != 0 ? slabs : slabs + 1)))
+        value = 1;
+
+    if(value != 0)
+        printf("ERROR!, el pool no reutilizo los elementos liberados (elemento %d)\n", i);
+
+    return value;
+}
+
+/**
+ * \brief Releases every element with pl_clear and checks that the slabs are gone and that the pool can be used again
+ * \param Pool *pPool pointer to the pool
+ * \return int value (0) if ok - (1) if not
+ */
+int checkRelease(Pool *pPool)
+{
+    int i;
+    int value = 0;
+    void *pElement = NULL;
+
+    if(pl_clear(pPool) != 0 || al_len(pPool->pSlabs) != 0 || pPool->pFree != NULL)
+        value = 1;
+
+    for(i = 0; i < TEST_SLAB + 1 && value == 0; i++){
+        pElement = pl_alloc(pPool);
+
+        if(pElement == NULL || al_len(pPool->pSlabs) != i / TEST_SLAB + 1)
+            value = 1;
+    }
+
+    if(value != 0)
+        printf("ERROR!, pl_clear no libero los bloques o el pool no se pudo volver a usar\n");
+
+    return value;
+}
@@ -0,0 +1,360 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "../inc/reportwriter.h"
+
+// ELEMENTOS POR PAGINA Y PAGINAS EN MEMORIA, MENOS QUE LOS BLOQUES DE RW_CHUNK_ELEMENTS
+#define TEST_PAGE_ELEMENTS 1000
+#define TEST_MAX_PAGES 2
+
+// CARACTERES MAXIMOS DE UNA LINEA
+#define TEST_ROW_CHARS 64
+
+// MAYOR CANTIDAD DE HILOS PROBADA
+#define TEST_MAX_THREADS 8
+
+// ELEMENTOS DEL INFORME QUE SE VUELVE A ABRIR
+#define TEST_REPORT_ROWS 300
+
+// ENCABEZADO DEL INFORME QUE SE VUELVE A ABRIR
+#define TEST_HEADER "numero\tletras\n"
+
+int loadTestRows(void *pContext, int first, void *pElements, int count);
+int renderTestRow(TextFormatter *pFormatter, void *pElement);
+PagedStore *newTestStore(int length);
+int readTestFile(char *fileName, char **ppText);
+int checkRender(int length, int threads);
+int writeTestFile(char *fileName, char *pText, int length);
+int checkReopen(void);
+
+// elemento cuya linea falla, -1 para ninguno
+int failingRow = -1;
+
+/**
+ * \brief Checks that rw_renderStoreThreads writes the same text with any number of threads as rendering every element
+ *        in order with one formatter, for empty stores, stores shorter and longer than a block, lengths that are not
+ *        multiples of the blocks or the pages, and with elements both in pages and resident. A line that fails must
+ *        make the whole rendering fail. A report opened again is kept only if it has one line per element
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int threads;
+    int failed = 0;
+    int lengths[] = {0, 1, TEST_PAGE_ELEMENTS, RW_CHUNK_ELEMENTS - 1, RW_CHUNK_ELEMENTS, RW_CHUNK_ELEMENTS + 1,
+                     RW_CHUNK_ELEMENTS * RW_CHUNKS_PER_THREAD * 3 + 17, 100003};
+    int fd;
+    PagedStore *pPagedStore = NULL;
+    TextFormatter *pOutput = NULL;
+
+    for(i = 0; i < (int)(sizeof(lengths) / sizeof(int)); i++){
+        for(threads = 1; threads <= TEST_MAX_THREADS; threads++)
+            failed += checkRender(lengths[i], threads);
+    }
+
+    // una linea que no se puede generar hace fallar todo el informe
+    failingRow = RW_CHUNK_ELEMENTS * 2 + 5;
+    pPagedStore = newTestStore(RW_CHUNK_ELEMENTS * 4);
+    pOutput = tf_newTextFormatter(RW_BUFFER_SIZE);
+    fd = open("failed.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(tf_setFile(pOutput, fd) != 0 || rw_renderStoreThreads(pOutput, pPagedStore, renderTestRow, 3) != -1){
+        printf("ERROR!, rw_renderStoreThreads no informo la linea que fallo\n");
+        failed++;
+    }
+
+    if(rw_renderStoreThreads(pOutput, pPagedStore, renderTestRow, 0) != -1){
+        printf("ERROR!, rw_renderStoreThreads acepto 0 hilos\n");
+        failed++;
+    }
+
+    failingRow = -1;
+    tf_deleteTextFormatter(pOutput);
+    ps_deletePagedStore(pPagedStore);
+
+    if(fd >= 0)
+        close(fd);
+
+    failed += checkReopen();
+
+    printf("test_reportwriter: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Page loader of the test store. Every element is its own index, so any thread can read it
+ * \param void *pContext unused
+ * \param int first index of the first element
+ * \param void *pElements pointer to an array of count ints
+ * \param int count number of elements to read
+ * \return int value number of elements read
+ */
+int loadTestRows(void *pContext, int first, void *pElements, int count)
+{
+    int i;
+
+    (void)pContext;
+
+    for(i = 0; i < count; i++)
+        ((int*)pElements)[i] = first + i;
+
+    return count;
+}
+
+/**
+ * \brief Renders an element as its number followed by a run of characters whose length depends on it, so the lines
+ *        have different lengths and the blocks end anywhere in the buffers
+ * \param TextFormatter *pFormatter pointer to formatter
+ * \param void *pElement pointer to the int
+ * \return int value return (-1) if error [the element is failingRow or a write failed]
+ *                           (0) if ok
+ */
+int renderTestRow(TextFormatter *pFormatter, void *pElement)
+{
+    int value = -1;
+    int number = *(int*)pElement;
+    char *pChars = NULL;
+
+    pChars = tf_reserve(pFormatter, TEST_ROW_CHARS);
+
+    if(pChars != NULL && number != failingRow){
+        pChars = tf_formatInteger(pChars, number, 0);
+        *pChars++ = '\t';
+        memset(pChars, 'a' + number % 26, number % 23);
+        pChars += number % 23;
+        *pChars++ = '\n';
+
+        value = tf_commit(pFormatter, pChars);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Creates a store of length elements: the whole pages are read with loadTestRows and the rest are resident
+ * \param int length number of elements
+ * \return PagedStore *pAux pointer to the store - (NULL) if error
+ */
+PagedStore *newTestStore(int length)
+{
+    int i;
+    PagedStore *pAux = NULL;
+
+    pAux = ps_newPagedStore(sizeof(int), TEST_PAGE_ELEMENTS, TEST_MAX_PAGES, loadTestRows, NULL);
+
+    if(pAux != NULL && ps_setStored(pAux, length - length % TEST_PAGE_ELEMENTS) == 0){
+        for(i = length - length % TEST_PAGE_ELEMENTS; i < length; i++)
+            ps_add(pAux, &i);
+    }
+
+    return pAux;
+}
+
+/**
+ * \brief Reads a whole file into memory
+ * \param char *fileName name of the file
+ * \param char **ppText pointer where the allocated text is written, it must be released with free
+ * \return int value length of the text - (-1) if error
+ */
+int readTestFile(char *fileName, char **ppText)
+{
+    int value = -1;
+    long size;
+    FILE *file = NULL;
+
+    *ppText = NULL;
+    file = fopen(fileName, "rb");
+
+    if(file != NULL){
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        rewind(file);
+        *ppText = (char*)malloc(size + 1);
+
+        if(*ppText != NULL && (long)fread(*ppText, 1, size, file) == size)
+            value = (int)size;
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Renders a store of length elements with rw_renderStoreThreads and with one formatter element by element,
+ *        and compares both files
+ * \param int length number of elements
+ * \param int threads number of threads of rw_renderStoreThreads
+ * \return int value (0) if equal - (1) if not
+ */
+int checkRender(int length, int threads)
+{
+    int i;
+    int fd;
+    int value = 1;
+    int result;
+    int parallelLength;
+    int sequentialLength;
+    char *pParallel = NULL;
+    char *pSequential = NULL;
+    PagedStore *pPagedStore = NULL;
+    TextFormatter *pOutput = NULL;
+
+    pPagedStore = newTestStore(length);
+
+    // en orden, como rw_append agrega cada evento
+    pOutput = tf_newTextFormatter(RW_BUFFER_SIZE);
+    fd = open("sequential.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    result = tf_setFile(pOutput, fd);
+
+    for(i = 0; i < length && result == 0; i++)
+        result = renderTestRow(pOutput, ps_get(pPagedStore, i));
+
+    if(tf_flush(pOutput) != 0)
+        result = -1;
+
+    tf_deleteTextFormatter(pOutput);
+
+    if(fd >= 0)
+        close(fd);
+
+    pOutput = tf_newTextFormatter(RW_BUFFER_SIZE);
+    fd = open("parallel.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(result == 0 && (tf_setFile(pOutput, fd) != 0 || rw_renderStoreThreads(pOutput, pPagedStore, renderTestRow, threads) != 0 || tf_flush(pOutput) != 0))
+        result = -1;
+
+    tf_deleteTextFormatter(pOutput);
+
+    if(fd >= 0)
+        close(fd);
+
+    sequentialLength = readTestFile("sequential.txt", &pSequential);
+    parallelLength = readTestFile("parallel.txt", &pParallel);
+
+    if(result == 0 && ps_len(pPagedStore) == length && sequentialLength >= 0 && parallelLength == sequentialLength &&
+       !memcmp(pSequential, pParallel, sequentialLength))
+        value = 0;
+    else
+        printf("ERROR!, %d elementos con %d hilos: %d bytes en paralelo, %d en orden\n", length, threads, parallelLength, sequentialLength);
+
+    free(pSequential);
+    free(pParallel);
+    ps_deletePagedStore(pPagedStore);
+
+    return value;
+}
+
+/**
+ * \brief Writes a whole file
+ * \param char *fileName name of the file
+ * \param char *pText text to write
+ * \param int length length of the text
+ * \return int value (0) if ok - (-1) if error
+ */
+int writeTestFile(char *fileName, char *pText, int length)
+{
+    int value = -1;
+    FILE *file = NULL;
+
+    file = fopen(fileName, "wb");
+
+    if(file != NULL){
+        if((int)fwrite(pText, 1, length, file) == length)
+            value = 0;
+
+        if(fclose(file) != 0)
+            value = -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Opens a report again after changing it: a report with one line per element is kept as it is, even with
+ *        other text in its lines, and a report with a line cut, a line less or a line more is generated again
+ * \return int value (0) if every check passed - (1) if not
+ */
+int checkReopen(void)
+{
+    int i;
+    int value = 0;
+    int length;
+    int changedLength;
+    int reopenedLength;
+    char *pText = NULL;
+    char *pChanged = NULL;
+    char *pReopened = NULL;
+    char *steps[] = {"linea cortada", "linea de menos", "linea de mas", "mismas lineas"};
+    PagedStore *pPagedStore = NULL;
+    ReportWriter *pWriter = NULL;
+
+    pPagedStore = newTestStore(TEST_REPORT_ROWS);
+    remove("report.txt");
+    pWriter = rw_newReportWriter("report.txt", TEST_HEADER, renderTestRow, pPagedStore);
+    rw_deleteReportWriter(pWriter);
+    length = readTestFile("report.txt", &pText);
+
+    if(pWriter == NULL || length <= (int)strlen(TEST_HEADER))
+        value = 1;
+
+    for(i = 0; i < 4 && value == 0; i++){
+        pChanged = (char*)malloc(length + TEST_ROW_CHARS);
+        memcpy(pChanged, pText, length);
+        changedLength = length;
+
+        if(i == 0)
+            changedLength -= 3;
+        else if(i == 1){
+            // sin la ultima linea entera, hasta el fin de la anterior
+            changedLength--;
+
+            while(pChanged[changedLength - 1] != '\n')
+                changedLength--;
+        }
+        else if(i == 2)
+            changedLength += sprintf(pChanged + length, "otra\n");
+        else
+            pChanged[length - 2] = 'z';
+
+        pWriter = NULL;
+
+        if(writeTestFile("report.txt", pChanged, changedLength) == 0)
+            pWriter = rw_newReportWriter("report.txt", TEST_HEADER, renderTestRow, pPagedStore);
+
+        rw_deleteReportWriter(pWriter);
+        reopenedLength = readTestFile("report.txt", &pReopened);
+
+        // solo el informe con una linea por elemento se conserva sin generarlo de nuevo
+        if(pWriter == NULL || (i < 3 && (reopenedLength != length || memcmp(pReopened, pText, length))) ||
+           (i == 3 && (reopenedLength != changedLength || memcmp(pReopened, pChanged, changedLength)))){
+            printf("ERROR!, informe abierto de nuevo con %s: %d bytes\n", steps[i], reopenedLength);
+            value = 1;
+        }
+
+        free(pChanged);
+        free(pReopened);
+    }
+
+    free(pText);
+    ps_deletePagedStore(pPagedStore);
+
+    return value;
+}
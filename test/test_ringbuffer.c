@@ -0,0 +1,273 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include "../inc/ringbuffer.h"
+
+// CAPACIDAD PEDIDA, NO ES POTENCIA DE DOS, Y CAPACIDAD REAL
+#define TEST_CAPACITY 5
+#define TEST_ROUNDED 8
+
+// ELEMENTOS QUE PASAN DE UN HILO AL OTRO Y CAPACIDAD DE SU COLA
+#define TEST_STREAM 2000000
+#define TEST_STREAM_CAPACITY 1000
+
+// MAYOR CANTIDAD DE ELEMENTOS TOMADOS POR LLAMADA EN LA PRUEBA CON HILOS
+#define TEST_MAX_POP 97
+
+int checkInvalid(void);
+int checkCapacity(void);
+int checkWrap(void);
+int checkClose(void);
+int checkThreads(void);
+void *produce(void *pArgument);
+
+/**
+ * \brief Checks the ring buffer: invalid parameters are rejected, the capacity is rounded up to a power of two and
+ *        a full queue rejects new elements, elements keep their order when they wrap around the end of the array,
+ *        the elements pushed before closing can still be taken, and a producer thread and a consumer thread pass
+ *        millions of elements without losing, repeating or reordering any of them
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+
+    failed += checkInvalid();
+    failed += checkCapacity();
+    failed += checkWrap();
+    failed += checkClose();
+    failed += checkThreads();
+
+    printf("test_ringbuffer: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Checks that every function rejects invalid parameters
+ * \return int value (0) if ok - (1) if not
+ */
+int checkInvalid(void)
+{
+    int value = 0;
+    int element = 0;
+    RingBuffer *pRingBuffer = NULL;
+
+    pRingBuffer = rb_newRingBuffer(sizeof(int), TEST_CAPACITY);
+
+    if(rb_newRingBuffer(0, TEST_CAPACITY) != NULL || rb_newRingBuffer(sizeof(int), 0) != NULL || rb_newRingBuffer(sizeof(int), (1 << 30) + 1) != NULL ||
+       pRingBuffer == NULL || rb_push(NULL, &element) != -1 || rb_push(pRingBuffer, NULL) != -1 || rb_popArray(NULL, &element, 1) != -1 ||
+       rb_popArray(pRingBuffer, NULL, 1) != -1 || rb_popArray(pRingBuffer, &element, -1) != -1 || rb_close(NULL) != -1 ||
+       rb_isClosed(NULL) != -1 || rb_deleteRingBuffer(NULL) != -1){
+        printf("ERROR!, la cola acepto parametros invalidos\n");
+        value = 1;
+    }
+
+    rb_deleteRingBuffer(pRingBuffer);
+
+    return value;
+}
+
+/**
+ * \brief Fills a queue and checks that it takes exactly the capacity rounded up to a power of two, that a pop of
+ *        zero elements or of an empty queue takes nothing and that the elements come out in order
+ * \return int value (0) if ok - (1) if not
+ */
+int checkCapacity(void)
+{
+    int i;
+    int value = 0;
+    int elements[TEST_ROUNDED + 1];
+    RingBuffer *pRingBuffer = NULL;
+
+    pRingBuffer = rb_newRingBuffer(sizeof(int), TEST_CAPACITY);
+
+    if(pRingBuffer == NULL || pRingBuffer->capacity != TEST_ROUNDED || rb_popArray(pRingBuffer, elements, TEST_ROUNDED) != 0)
+        value = 1;
+
+    for(i = 0; i < TEST_ROUNDED && value == 0; i++){
+        if(rb_push(pRingBuffer, &i) != 0)
+            value = 1;
+    }
+
+    if(value == 0 && (rb_push(pRingBuffer, &i) != -1 || rb_popArray(pRingBuffer, elements, 0) != 0 ||
+                      rb_popArray(pRingBuffer, elements, TEST_ROUNDED + 1) != TEST_ROUNDED || rb_popArray(pRingBuffer, elements, 1) != 0))
+        value = 1;
+
+    for(i = 0; i < TEST_ROUNDED && value == 0; i++){
+        if(elements[i] != i)
+            value = 1;
+    }
+
+    if(value != 0)
+        printf("ERROR!, la cola no tomo %d elementos o no los devolvio en orden\n", TEST_ROUNDED);
+
+    rb_deleteRingBuffer(pRingBuffer);
+
+    return value;
+}
+
+/**
+ * \brief Pushes and takes elements in blocks of different sizes, so the blocks start at every position of the array
+ *        and many of them wrap around its end
+ * \return int value (0) if ok - (1) if not
+ */
+int checkWrap(void)
+{
+    int i;
+    int j;
+    int count;
+    int value = 0;
+    int next = 0;
+    int expected = 0;
+    int elements[TEST_ROUNDED];
+    RingBuffer *pRingBuffer = NULL;
+
+    pRingBuffer = rb_newRingBuffer(sizeof(int), TEST_ROUNDED);
+
+    if(pRingBuffer == NULL)
+        value = 1;
+
+    for(i = 0; i < 200 && value == 0; i++){
+        // se encolan entre 1 y 8 elementos y se toman entre 1 y 5, los bloques empiezan cada vez en otra posicion
+        for(j = 0; j < 1 + i % TEST_ROUNDED && value == 0; j++){
+            if(rb_push(pRingBuffer, &next) == 0)
+                next++;
+            else if(next - expected != TEST_ROUNDED)
+                value = 1;
+        }
+
+        count = rb_popArray(pRingBuffer, elements, 1 + i % 5);
+
+        for(j = 0; j < count && value == 0; j++){
+            if(elements[j] != expected++)
+                value = 1;
+        }
+
+        if(count < 0 || count > 1 + i % 5)
+            value = 1;
+    }
+
+    if(value == 0 && (rb_popArray(pRingBuffer, elements, TEST_ROUNDED) != next - expected || elements[0] != expected))
+        value = 1;
+
+    if(value != 0)
+        printf("ERROR!, los elementos que dan la vuelta al final de la cola cambiaron de orden (elemento %d)\n", expected);
+
+    rb_deleteRingBuffer(pRingBuffer);
+
+    return value;
+}
+
+/**
+ * \brief Closes a queue with elements and checks that they can still be taken
+ * \return int value (0) if ok - (1) if not
+ */
+int checkClose(void)
+{
+    int i;
+    int value = 0;
+    int elements[TEST_ROUNDED];
+    RingBuffer *pRingBuffer = NULL;
+
+    pRingBuffer = rb_newRingBuffer(sizeof(int), TEST_ROUNDED);
+
+    for(i = 0; pRingBuffer != NULL && i < 3; i++)
+        rb_push(pRingBuffer, &i);
+
+    if(pRingBuffer == NULL || rb_isClosed(pRingBuffer) != 0 || rb_close(pRingBuffer) != 0 || rb_isClosed(pRingBuffer) != 1 ||
+       rb_popArray(pRingBuffer, elements, TEST_ROUNDED) != 3 || elements[2] != 2 || rb_popArray(pRingBuffer, elements, TEST_ROUNDED) != 0){
+        printf("ERROR!, la cola cerrada no devolvio los elementos encolados antes de cerrarla\n");
+        value = 1;
+    }
+
+    rb_deleteRingBuffer(pRingBuffer);
+
+    return value;
+}
+
+/**
+ * \brief Passes TEST_STREAM numbers from a producer thread to this thread through a small queue, taking blocks of
+ *        every size. Both threads find the queue full or empty many times
+ * \return int value (0) if ok - (1) if not
+ */
+int checkThreads(void)
+{
+    int i;
+    int j;
+    int count = 0;
+    int closed = 0;
+    int value = 0;
+    int expected = 0;
+    int elements[TEST_MAX_POP];
+    pthread_t producer;
+    RingBuffer *pRingBuffer = NULL;
+
+    pRingBuffer = rb_newRingBuffer(sizeof(int), TEST_STREAM_CAPACITY);
+
+    if(pRingBuffer == NULL || pthread_create(&producer, NULL, produce, pRingBuffer) != 0){
+        printf("ERROR!, no se pudo iniciar el hilo productor\n");
+        value = 1;
+    }
+    else{
+        // el cierre se lee antes de vaciar la cola, igual que los hilos de escritura
+        for(i = 0; !closed || count > 0; i++){
+            closed = rb_isClosed(pRingBuffer);
+            count = rb_popArray(pRingBuffer, elements, 1 + i % TEST_MAX_POP);
+
+            if(count == 0)
+                sched_yield();
+
+            for(j = 0; j < count; j++){
+                if(elements[j] != expected++)
+                    value = 1;
+            }
+        }
+
+        pthread_join(producer, NULL);
+
+        if(value != 0 || expected != TEST_STREAM){
+            printf("ERROR!, se perdieron o se desordenaron elementos entre dos hilos (%d de %d)\n", expected, TEST_STREAM);
+            value = 1;
+        }
+    }
+
+    rb_deleteRingBuffer(pRingBuffer);
+
+    return value;
+}
+
+/**
+ * \brief Body of the producer thread, pushes the numbers from 0 to TEST_STREAM - 1 and closes the queue
+ * \param void *pArgument pointer to the ring buffer
+ * \return void *value (NULL)
+ */
+void *produce(void *pArgument)
+{
+    int i;
+    RingBuffer *pRingBuffer = (RingBuffer*)pArgument;
+
+    for(i = 0; i < TEST_STREAM; i++){
+        while(rb_push(pRingBuffer, &i) != 0)
+            sched_yield();
+    }
+
+    rb_close(pRingBuffer);
+
+    return NULL;
+}
@@ -0,0 +1,460 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include "../inc/segmentlog.h"
+#include "../inc/crc32c.h"
+
+// REGISTRO DE PRUEBA: FECHA, NUMERO Y CHECKSUM DE LOS BYTES ANTERIORES
+#define TEST_RECORD_SIZE 16
+#define TEST_CHECKSUM_OFFSET 12
+
+// ENCABEZADO DE CADA SEGMENTO
+#define TEST_HEADER_SIZE 8
+#define TEST_HEADER "TSEG0001"
+
+// NOMBRE DEL REGISTRO
+#define TEST_BASE "log"
+
+// REGISTROS POR SEGMENTO AL ROTAR
+#define TEST_SEGMENT_RECORDS 10
+
+long long testTimestampOf(void *pRecord);
+int testIsValid(void *pRecord);
+void testEncode(unsigned char *pRecord, int number);
+SegmentLog *testOpen(void);
+int testAppend(SegmentLog *this, int first, int count);
+int testCheckRecords(SegmentLog *this, int first, int count);
+long testFileSize(char *fileName);
+int testRotation(void);
+int testIncompleteRecord(void);
+int testDamagedRecord(void);
+int testReadOnly(void);
+int testSingleFile(void);
+int testCreateFile(char *fileName);
+int testOrphanSegments(void);
+
+/**
+ * \brief Checks the recovery of the segment log: records written in several segments are read back after the log
+ *        is reopened, an incomplete or damaged record at the end of the segment being written is cut with every
+ *        record after it, the read only log does not change any file and the single file of an old log becomes
+ *        its first segment, and the segment files that the manifest does not list are deleted
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+
+    failed += testRotation();
+    failed += testIncompleteRecord();
+    failed += testDamagedRecord();
+    failed += testReadOnly();
+    failed += testSingleFile();
+    failed += testOrphanSegments();
+
+    printf("test_segmentlog: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Get the time of a test record, the record number plus a fixed date
+ * \param void *pRecord pointer to the record
+ * \return long long timestamp time of the record in seconds since the epoch
+ */
+long long testTimestampOf(void *pRecord)
+{
+    long long timestamp;
+
+    memcpy(&timestamp, pRecord, sizeof(timestamp));
+
+    return timestamp;
+}
+
+/**
+ * \brief Check the checksum of a test record
+ * \param void *pRecord pointer to the record
+ * \return int value 1 if the record is valid - 0 if it is damaged
+ */
+int testIsValid(void *pRecord)
+{
+    unsigned int checksum;
+
+    memcpy(&checksum, (unsigned char*)pRecord + TEST_CHECKSUM_OFFSET, sizeof(checksum));
+
+    return checksum == crc_checksum(pRecord, TEST_CHECKSUM_OFFSET);
+}
+
+/**
+ * \brief Write the test record with a number
+ * \param unsigned char *pRecord buffer of TEST_RECORD_SIZE bytes
+ * \param int number number of the record
+ * \return void
+ */
+void testEncode(unsigned char *pRecord, int number)
+{
+    long long timestamp = 1700000000LL + number;
+    unsigned int checksum;
+
+    memcpy(pRecord, &timestamp, sizeof(timestamp));
+    memcpy(pRecord + 8, &number, sizeof(number));
+    checksum = crc_checksum(pRecord, TEST_CHECKSUM_OFFSET);
+    memcpy(pRecord + TEST_CHECKSUM_OFFSET, &checksum, sizeof(checksum));
+}
+
+/**
+ * \brief Open the test log, TEST_SEGMENT_RECORDS records per segment
+ * \return SegmentLog *this pointer to the log - (NULL) if error
+ */
+SegmentLog *testOpen(void)
+{
+    SegmentLog *this = NULL;
+
+    this = sl_newSegmentLog(TEST_BASE, TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, testTimestampOf, testIsValid, EL_SYNC_FLUSH);
+
+    if(this != NULL)
+        sl_setRotation(this, TEST_SEGMENT_RECORDS, 0);
+
+    return this;
+}
+
+/**
+ * \brief Append consecutive test records
+ * \param SegmentLog *this pointer to the log
+ * \param int first number of the first record
+ * \param int count number of records
+ * \return int value (0) if ok - (-1) if an append failed
+ */
+int testAppend(SegmentLog *this, int first, int count)
+{
+    int i;
+    int value = 0;
+    unsigned char record[TEST_RECORD_SIZE];
+
+    for(i = 0; i < count && value == 0; i++){
+        testEncode(record, first + i);
+        value = sl_append(this, record);
+    }
+
+    return value;
+}
+
+/**
+ * \brief Check that the log holds exactly the records first to first + count - 1
+ * \param SegmentLog *this pointer to the log
+ * \param int first number of the first record
+ * \param int count number of records
+ * \return int value (0) if ok - (1) if not
+ */
+int testCheckRecords(SegmentLog *this, int first, int count)
+{
+    int i;
+    int value = 0;
+    unsigned char record[TEST_RECORD_SIZE];
+    unsigned char expected[TEST_RECORD_SIZE];
+
+    for(i = 0; i < count && value == 0; i++){
+        testEncode(expected, first + i);
+
+        if(sl_read(this, first + i, record, 1) != 1 || memcmp(record, expected, TEST_RECORD_SIZE)){
+            printf("ERROR!, no se leyo el registro %d\n", first + i);
+            value = 1;
+        }
+    }
+
+    if(value == 0 && sl_read(this, first + count, record, 1) != 0){
+        printf("ERROR!, hay registros despues del %d\n", first + count - 1);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Get the size of a file
+ * \param char *fileName path of the file
+ * \return long size size in bytes - (-1) if the file does not exist
+ */
+long testFileSize(char *fileName)
+{
+    struct stat status;
+
+    return stat(fileName, &status) == 0 ? (long)status.st_size : -1;
+}
+
+/**
+ * \brief Records appended in several segments are read back after the log is reopened
+ * \return int value (0) if ok - (1) if not
+ */
+int testRotation(void)
+{
+    int value = 1;
+    SegmentLog *this = NULL;
+
+    this = testOpen();
+
+    if(this != NULL && testAppend(this, 0, 25) == 0){
+        sl_deleteSegmentLog(this);
+        this = testOpen();
+
+        if(this != NULL && sl_len(this) == 3 && this->truncated == 0 && testCheckRecords(this, 0, 25) == 0 && testAppend(this, 25, 5) == 0 &&
+           testCheckRecords(this, 0, 30) == 0)
+            value = 0;
+    }
+
+    if(value != 0)
+        printf("ERROR!, los registros rotados no se recuperaron\n");
+
+    sl_deleteSegmentLog(this);
+
+    return value;
+}
+
+/**
+ * \brief An incomplete record at the end of the segment being written, a write cut by a crash, is removed
+ * \return int value (0) if ok - (1) if not
+ */
+int testIncompleteRecord(void)
+{
+    int value = 1;
+    FILE *file = NULL;
+    SegmentLog *this = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    this = testOpen();
+
+    if(this != NULL && sl_getFileName(this, sl_len(this) - 1, fileName, sizeof(fileName)) == 0){
+        sl_deleteSegmentLog(this);
+        file = fopen(fileName, "ab");
+
+        if(file != NULL){
+            fwrite("partial", 7, 1, file);
+            fclose(file);
+        }
+
+        this = testOpen();
+
+        if(this != NULL && this->truncated == 1 && testCheckRecords(this, 0, 30) == 0 && testFileSize(fileName) == TEST_HEADER_SIZE + 10 * TEST_RECORD_SIZE)
+            value = 0;
+    }
+
+    if(value != 0)
+        printf("ERROR!, el registro incompleto no se descarto\n");
+
+    sl_deleteSegmentLog(this);
+
+    return value;
+}
+
+/**
+ * \brief A damaged record of the segment being written is removed with every record after it
+ * \return int value (0) if ok - (1) if not
+ */
+int testDamagedRecord(void)
+{
+    int value = 1;
+    FILE *file = NULL;
+    SegmentLog *this = NULL;
+    char fileName[SL_MAX_NAME_CHARS];
+
+    this = testOpen();
+
+    // el segmento activo tiene los registros 30 a 34, se dana el 32
+    if(this != NULL && testAppend(this, 30, 5) == 0 && sl_getFileName(this, sl_len(this) - 1, fileName, sizeof(fileName)) == 0){
+        sl_deleteSegmentLog(this);
+        file = fopen(fileName, "r+b");
+
+        if(file != NULL){
+            fseek(file, TEST_HEADER_SIZE + 2 * TEST_RECORD_SIZE + 9, SEEK_SET);
+            fputc(0x5A, file);
+            fclose(file);
+        }
+
+        this = testOpen();
+
+        if(this != NULL && this->truncated == 3 && testCheckRecords(this, 0, 32) == 0 && testAppend(this, 32, 3) == 0 && testCheckRecords(this, 0, 35) == 0)
+            value = 0;
+    }
+
+    if(value != 0)
+        printf("ERROR!, el registro danado no se descarto\n");
+
+    sl_deleteSegmentLog(this);
+
+    return value;
+}
+
+/**
+ * \brief The read only log lists the segments without changing any file, not even an incomplete record at the end
+ *        of the segment being written, and records can't be appended to it. Without manifest it is not opened
+ * \return int value (0) if ok - (1) if not
+ */
+int testReadOnly(void)
+{
+    int value = 1;
+    long size;
+    long manifestSize;
+    FILE *file = NULL;
+    SegmentLog *this = NULL;
+    unsigned char record[TEST_RECORD_SIZE];
+    char fileName[SL_MAX_NAME_CHARS];
+
+    this = sl_newReadOnlySegmentLog(TEST_BASE, TEST_HEADER_SIZE, TEST_RECORD_SIZE);
+
+    if(this != NULL && sl_len(this) == 4 && sl_getFileName(this, 3, fileName, sizeof(fileName)) == 0){
+        file = fopen(fileName, "ab");
+
+        if(file != NULL){
+            fwrite("partial", 7, 1, file);
+            fclose(file);
+        }
+
+        sl_deleteSegmentLog(this);
+        size = testFileSize(fileName);
+        manifestSize = testFileSize(TEST_BASE ".manifest");
+        this = sl_newReadOnlySegmentLog(TEST_BASE, TEST_HEADER_SIZE, TEST_RECORD_SIZE);
+        testEncode(record, 35);
+
+        if(this != NULL && sl_len(this) == 4 && this->truncated == 0 && sl_append(this, record) != 0 && sl_compact(this) != 0 &&
+           testFileSize(fileName) == size && testFileSize(TEST_BASE ".manifest") == manifestSize &&
+           sl_newReadOnlySegmentLog("missing", TEST_HEADER_SIZE, TEST_RECORD_SIZE) == NULL && testFileSize("missing.manifest") < 0)
+            value = 0;
+    }
+
+    if(value != 0)
+        printf("ERROR!, el registro de solo lectura modifico los archivos\n");
+
+    sl_deleteSegmentLog(this);
+
+    return value;
+}
+
+/**
+ * \brief The single file of a log written before it was split in segments becomes its first segment
+ * \return int value (0) if ok - (1) if not
+ */
+int testSingleFile(void)
+{
+    int i;
+    int value = 1;
+    FILE *file = NULL;
+    SegmentLog *this = NULL;
+    unsigned char record[TEST_RECORD_SIZE];
+
+    file = fopen("single.bin", "wb");
+
+    if(file != NULL){
+        fwrite(TEST_HEADER, TEST_HEADER_SIZE, 1, file);
+
+        for(i = 0; i < 5; i++){
+            testEncode(record, i);
+            fwrite(record, TEST_RECORD_SIZE, 1, file);
+        }
+
+        fclose(file);
+        this = sl_newSegmentLog("single", TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, testTimestampOf, testIsValid, EL_SYNC_FLUSH);
+
+        if(this != NULL && sl_len(this) == 1 && testCheckRecords(this, 0, 5) == 0 && testFileSize("single.bin") < 0 &&
+           testFileSize("single.000001.bin") == TEST_HEADER_SIZE + 5 * TEST_RECORD_SIZE)
+            value = 0;
+    }
+
+    if(value != 0)
+        printf("ERROR!, el archivo unico no paso a ser el primer segmento\n");
+
+    sl_deleteSegmentLog(this);
+
+    return value;
+}
+
+/**
+ * \brief Create a file with a test segment header
+ * \param char *fileName path of the file
+ * \return int value (0) if ok - (1) if not
+ */
+int testCreateFile(char *fileName)
+{
+    int value = 1;
+    FILE *file = NULL;
+
+    file = fopen(fileName, "wb");
+
+    if(file != NULL){
+        if(fwrite(TEST_HEADER, TEST_HEADER_SIZE, 1, file) == 1)
+            value = 0;
+
+        fclose(file);
+    }
+
+    return value;
+}
+
+/**
+ * \brief The segment files that the manifest does not list, before the first segment, after the last one and
+ *        between them, are deleted when the log is opened. The listed segments and the files that only look like a
+ *        segment are kept
+ * \return int value (0) if ok - (1) if not
+ */
+int testOrphanSegments(void)
+{
+    int i;
+    int value = 1;
+    int created = 0;
+    SegmentLog *this = NULL;
+    char *orphans[] = {"orphan.000000.bin", "orphan.000001.bin", "orphan.000004.bin", "orphan.000009.bin", "orphan.1000000.bin"};
+    char *others[] = {"orphan.00005.bin", "orphan.000006.bin.tmp", "orphan.000007.txt", "orphan.00000x.bin", "other.000008.bin", "orphans.000010.bin", "orphan.0000012.bin"};
+
+    this = sl_newSegmentLog("orphan", TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, testTimestampOf, testIsValid, EL_SYNC_FLUSH);
+
+    // los registros de prueba son de 2023, con un segundo de retencion se descartan los segmentos 1 y 2
+    if(this != NULL && sl_setRotation(this, TEST_SEGMENT_RECORDS, 0) == 0 && testAppend(this, 0, 25) == 0 && sl_setRetention(this, 1) == 0 &&
+       sl_compact(this) >= 0 && sl_len(this) == 1){
+        sl_deleteSegmentLog(this);
+
+        for(i = 0; i < (int)(sizeof(orphans) / sizeof(char*)); i++)
+            created += testCreateFile(orphans[i]);
+
+        for(i = 0; i < (int)(sizeof(others) / sizeof(char*)); i++)
+            created += testCreateFile(others[i]);
+
+        this = sl_newSegmentLog("orphan", TEST_HEADER, TEST_HEADER_SIZE, TEST_RECORD_SIZE, testTimestampOf, testIsValid, EL_SYNC_FLUSH);
+
+        if(created == 0 && this != NULL && sl_len(this) == 1 && sl_getFirst(this) == 20 && testCheckRecords(this, 20, 5) == 0 &&
+           testFileSize("orphan.000003.bin") == TEST_HEADER_SIZE + 5 * TEST_RECORD_SIZE)
+            value = 0;
+
+        for(i = 0; i < (int)(sizeof(orphans) / sizeof(char*)); i++){
+            if(testFileSize(orphans[i]) >= 0){
+                printf("ERROR!, el segmento huerfano %s no se borro\n", orphans[i]);
+                value = 1;
+            }
+        }
+
+        for(i = 0; i < (int)(sizeof(others) / sizeof(char*)); i++){
+            if(testFileSize(others[i]) != TEST_HEADER_SIZE){
+                printf("ERROR!, se borro el archivo %s, que no es un segmento\n", others[i]);
+                value = 1;
+            }
+        }
+    }
+
+    if(value != 0)
+        printf("ERROR!, los segmentos que el manifiesto no lista no se borraron\n");
+
+    sl_deleteSegmentLog(this);
+
+    return value;
+}
@@ -0,0 +1,195 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include "../inc/mechatronic.h"
+
+// ANCHO MAXIMO PROBADO DE LOS ENTEROS Y LAS CADENAS
+#define TEST_MAX_WIDTH 40
+
+// VALORES RECORRIDOS DE CENTESIMO EN CENTESIMO, DE -TEST_HUNDREDTHS A TEST_HUNDREDTHS
+#define TEST_HUNDREDTHS 100000
+
+// EVENTOS COMPARADOS CON LA LINEA DEL INFORME ANTERIOR
+#define TEST_ROWS 200
+
+int checkInteger(int number, int width);
+int checkFloat(float number);
+int checkString(char *string, int width);
+int checkRows(void);
+
+/**
+ * \brief Checks that the tf_format functions render the same text as printf: integers with INT_MIN, INT_MAX and every
+ *        width up to TEST_MAX_WIDTH, floats around every hundredth with both signs, the halves that round to even,
+ *        the negative values that round to zero and the greatest ones, and strings aligned to every width. Then the
+ *        rows of the text report are compared with the fprintf line they replaced
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int width;
+    int failed = 0;
+    int integers[] = {0, 1, -1, 9, -9, 10, -10, 99, 100, 12345, -12345, 999999999, 1000000000, -1000000000, INT_MAX, INT_MIN, INT_MIN + 1};
+    float floats[] = {0.0f, -0.0f, 0.004f, -0.004f, 0.005f, -0.005f, 0.015f, -0.015f, 0.125f, -0.125f, 0.375f, -0.375f, 2.5f, -2.5f,
+                      19.995f, -19.995f, 60.0f, -20.0f, 1e13f, -1e13f, 9.99e12f, -9.99e12f, 1e15f, -1e15f, FLT_MAX, -FLT_MAX,
+                      FLT_MIN, -FLT_MIN, 1.0f / 0.0f, -1.0f / 0.0f};
+    char *strings[] = {"", "a", EMERGENCY, BOOT_BY_TEMPERATURE, "una cadena mas larga que el ancho de la columna del informe"};
+
+    for(i = 0; i < (int)(sizeof(integers) / sizeof(int)); i++){
+        for(width = 0; width <= TEST_MAX_WIDTH; width++)
+            failed += checkInteger(integers[i], width);
+    }
+
+    for(i = 0; i < (int)(sizeof(floats) / sizeof(float)); i++)
+        failed += checkFloat(floats[i]);
+
+    // cada centesimo y los float vecinos, que caen a uno y otro lado del redondeo
+    for(i = -TEST_HUNDREDTHS; i <= TEST_HUNDREDTHS; i++){
+        failed += checkFloat(i / 100.0f);
+        failed += checkFloat(nextafterf(i / 100.0f, -FLT_MAX));
+        failed += checkFloat(nextafterf(i / 100.0f, FLT_MAX));
+        failed += checkFloat(i / 100.0f + 0.005f);
+    }
+
+    for(i = 0; i < (int)(sizeof(strings) / sizeof(char*)); i++){
+        for(width = 0; width <= TEST_MAX_WIDTH; width++)
+            failed += checkString(strings[i], width);
+    }
+
+    failed += checkRows();
+
+    printf("test_textformatter: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Compares tf_formatInteger with printf "%0*d" and checks that it renders no more than the greater of width
+ *        and 11 characters
+ * \param int number number to render
+ * \param int width minimum number of characters
+ * \return int value (0) if equal - (1) if not
+ */
+int checkInteger(int number, int width)
+{
+    int value = 0;
+    int length;
+    char expected[TEST_MAX_WIDTH + TF_MAX_NUMBER_CHARS];
+    char rendered[TEST_MAX_WIDTH + TF_MAX_NUMBER_CHARS];
+
+    snprintf(expected, sizeof(expected), "%0*d", width, number);
+    length = tf_formatInteger(rendered, number, width) - rendered;
+
+    if(length != (int)strlen(expected) || memcmp(rendered, expected, length) || length > (width > 11 ? width : 11)){
+        printf("ERROR!, tf_formatInteger(%d, %d) = '%.*s', printf = '%s'\n", number, width, length, rendered, expected);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Compares tf_formatFloat with printf "%.2f" and checks that it renders less than TF_MAX_NUMBER_CHARS
+ *        characters
+ * \param float number number to render
+ * \return int value (0) if equal - (1) if not
+ */
+int checkFloat(float number)
+{
+    int value = 0;
+    int length;
+    char expected[TF_MAX_NUMBER_CHARS];
+    char rendered[TF_MAX_NUMBER_CHARS];
+
+    snprintf(expected, sizeof(expected), "%.2f", number);
+    length = tf_formatFloat(rendered, number) - rendered;
+
+    if(length >= TF_MAX_NUMBER_CHARS || length != (int)strlen(expected) || memcmp(rendered, expected, length)){
+        printf("ERROR!, tf_formatFloat(%.9g) = '%.*s', printf = '%s'\n", number, length < TF_MAX_NUMBER_CHARS ? length : 0, rendered, expected);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Compares tf_formatString with printf "%*s"
+ * \param char *string string to render
+ * \param int width minimum number of characters
+ * \return int value (0) if equal - (1) if not
+ */
+int checkString(char *string, int width)
+{
+    int value = 0;
+    int length;
+    char expected[TEST_MAX_WIDTH + MAX_STRING_CHARS];
+    char rendered[TEST_MAX_WIDTH + MAX_STRING_CHARS];
+
+    snprintf(expected, sizeof(expected), "%*s", width, string);
+    length = tf_formatString(rendered, string, width) - rendered;
+
+    if(length != (int)strlen(expected) || memcmp(rendered, expected, length)){
+        printf("ERROR!, tf_formatString('%s', %d) = '%.*s', printf = '%s'\n", string, width, length, rendered, expected);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Renders the rows of the text report with mechatronic_formatTextFileRow in a formatter without file and
+ *        compares them with the line that fprintf wrote before the formatter, for events of every type, negative
+ *        temperatures and dates of several years
+ * \return int value (0) if equal - (1) if not
+ */
+int checkRows(void)
+{
+    int i;
+    int length;
+    int value = 0;
+    char expected[MECHATRONIC_MAX_ROW_CHARS * 2];
+    Mechatronic event;
+    TextFormatter *pFormatter = NULL;
+
+    pFormatter = tf_newTextFormatter(MECHATRONIC_MAX_ROW_CHARS);
+
+    for(i = 0; i < TEST_ROWS && pFormatter != NULL && value == 0; i++){
+        mechatronic_newReading(&event, -20.0f + i * 0.4f - (i % 3) * 0.005f, (i * 37) % 101, 0);
+        mechatronic_setTimestamp(&event, 946684800LL + i * 7919LL * 3607LL, NULL);
+
+        length = snprintf(expected, sizeof(expected), "%02d/%02d/%d %02d:%02d:%02d\t\t%d\t\t%s\t\t\t%25s\t\t\t\t%.2f\t\t\t\t\t\t%d\t\t\t\t\t\t%.2f\t\t\t\t\t\t%.2f\t\t\t\t\t\t%d\n",
+                          event.today.day, event.today.month, event.today.year, event.today.hour, event.today.minutes, event.today.seconds,
+                          event.idEmployee, event.nameSurname, mechatronic_getEventTypeName(event.eventType), event.ambientTemperatureRead,
+                          event.humidityTemperatureRead, event.temperatureEngineOn, event.temperatureEngineOff, event.humidityThreshold);
+
+        pFormatter->length = 0;
+
+        if(mechatronic_formatTextFileRow(pFormatter, &event) != 0 || pFormatter->length != length || memcmp(pFormatter->pBuffer, expected, length)){
+            printf("ERROR!, la linea del informe '%.*s' no es la de fprintf '%s'\n", pFormatter->length, pFormatter->pBuffer, expected);
+            value = 1;
+        }
+    }
+
+    if(pFormatter == NULL)
+        value = 1;
+
+    tf_deleteTextFormatter(pFormatter);
+
+    return value;
+}
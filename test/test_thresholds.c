@@ -0,0 +1,341 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include "../inc/mechatronic.h"
+
+// ARCHIVO DE CONFIGURACION DE LAS PRUEBAS, EN EL DIRECTORIO DE LA PRUEBA
+#define TEST_CONFIG_FILE "test.ini"
+
+// RECARGAS MIENTRAS OTROS HILOS LEEN LOS UMBRALES, HILOS LECTORES Y RONDAS DE LA PRUEBA
+#define TEST_RELOADS 2000
+#define TEST_READERS 4
+#define TEST_ROUNDS 3
+
+// RECARGAS QUE SE ESPERA COMO MAXIMO A QUE SE LIBEREN LAS CONFIGURACIONES CON LOS LECTORES ACTIVOS
+#define TEST_RELEASE_TRIES 50
+
+// CONFIGURACIONES QUE SE ALTERNAN EN LAS RECARGAS, CADA LECTURA DEBE SER UNA DE LAS DOS COMPLETA
+#define TEST_CONFIG_A "temperatureEngineOn=30.5\ntemperatureEngineOff=10.25\nhumidityThreshold=50\n"
+#define TEST_CONFIG_B "temperatureEngineOn=-3.5\ntemperatureEngineOff=-10.75\nhumidityThreshold=90\n"
+
+// private variables of mechatronic.c
+extern ThresholdSnapshot initialThresholds;
+extern ThresholdSnapshot *pThresholdSnapshot;
+extern ThresholdReader thresholdReaders[MECHATRONIC_THRESHOLD_READERS];
+extern unsigned long long thresholdEpoch;
+
+int writeTestConfig(char *text);
+int checkThresholds(int idMachine, float engineOn, float engineOff, int humidity, char *step);
+int checkRejected(char *text, char *step);
+int countReplaced(void);
+int checkStalledReader(void);
+int checkConcurrentReloads(void);
+void *readThresholds(void *pArgument);
+
+int readerDone = 0;
+
+/**
+ * \brief Checks the thresholds of the configuration file: signs and decimals are kept, invalid values are left out
+ *        when the program starts and a reload without the three general thresholds is rejected. The thresholds
+ *        replaced by a reload are released once no thread can be reading them: not before a thread that started
+ *        reading before they were replaced ends, and while several threads read them all the time and the
+ *        configuration is reloaded again and again
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int i;
+    int failed = 0;
+    int machines = -1;
+    Thresholds general;
+    PagedStore *pPagedStore = NULL;
+
+    pPagedStore = mechatronic_newEventList();
+
+    // al arrancar los valores invalidos se dejan de lado y las maquinas usan los generales
+    writeTestConfig("temperatureEngineOn=-5.75\ntemperatureEngineOff=12.5 \nhumidityThreshold=65\n"
+                    "machine.3.temperatureEngineOn=40.25\nmachine.4.humidityThreshold=abc\nmachine.5.humidityThreshold=101\n");
+
+    if(mechatronic_readConfigFile(TEST_CONFIG_FILE, &general, &machines) != 0 || machines != 1){
+        printf("ERROR!, no se leyo la configuracion inicial (maquinas: %d)\n", machines);
+        failed++;
+    }
+
+    failed += checkThresholds(0, -5.75f, 12.5f, 65, "arranque");
+    failed += checkThresholds(3, 40.25f, 12.5f, 65, "maquina 3");
+    failed += checkThresholds(4, -5.75f, 12.5f, 65, "maquina 4");
+    failed += checkThresholds(5, -5.75f, 12.5f, 65, "maquina 5");
+
+    writeTestConfig("temperatureEngineOn=hot\ntemperatureEngineOff=1e9\nhumidityThreshold=7x\n");
+    mechatronic_readConfigFile(TEST_CONFIG_FILE, &general, &machines);
+    failed += checkThresholds(0, INITIAL_ENGINE_START_TEMPERATURE, INITIAL_ENGINE_IDLE_TEMPERATURE, INITIAL_HUMIDITY_THRESHOLD, "valores invalidos");
+
+    // una recarga sin los tres umbrales generales validos mantiene los anteriores
+    writeTestConfig("temperatureEngineOn=327.67\ntemperatureEngineOff=-327.68\nhumidityThreshold=0\n");
+
+    if(mechatronic_reloadThresholds(TEST_CONFIG_FILE) < 0){
+        printf("ERROR!, se rechazo una recarga valida\n");
+        failed++;
+    }
+
+    failed += checkThresholds(0, 327.67f, -327.68f, 0, "limites");
+    failed += checkRejected("temperatureEngineOn=30\ntemperatureEngineOff=20\n", "sin humedad");
+    failed += checkRejected("temperatureEngineOn=30\ntemperatureEngineOff=20\nhumidityThreshold=\n", "humedad vacia");
+    failed += checkRejected("temperatureEngineOn=30\ntemperatureEngineOff=20\nhumidityThreshold=6.5\n", "humedad con decimales");
+    failed += checkRejected("temperatureEngineOn=30\ntemperatureEngineOff=20\nhumidityThreshold=-1\n", "humedad negativa");
+    failed += checkRejected("temperatureEngineOn=327.68\ntemperatureEngineOff=20\nhumidityThreshold=60\n", "temperatura fuera de rango");
+    failed += checkRejected("temperatureEngineOn=nan\ntemperatureEngineOff=20\nhumidityThreshold=60\n", "temperatura NaN");
+    failed += checkRejected("temperatureEngineOn=30 grados\ntemperatureEngineOff=20\nhumidityThreshold=60\n", "texto al final");
+    failed += checkRejected("", "archivo vacio");
+
+    if(mechatronic_reloadThresholds("no-existe.ini") >= 0){
+        printf("ERROR!, se recargo un archivo que no existe\n");
+        failed++;
+    }
+
+    if(countReplaced() != 0){
+        printf("ERROR!, quedaron %d configuraciones reemplazadas sin liberar\n", countReplaced());
+        failed++;
+    }
+
+    failed += checkStalledReader();
+
+    for(i = 0; i < TEST_ROUNDS; i++)
+        failed += checkConcurrentReloads();
+
+    mechatronic_deleteEventList(pPagedStore);
+    remove(TEST_CONFIG_FILE);
+    printf("test_thresholds: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Writes the configuration file of the tests
+ * \param char *text content of the file
+ * \return int value return (-1) if error [can't write the file]
+ *                           (0) if ok
+ */
+int writeTestConfig(char *text)
+{
+    int value = -1;
+    FILE *file = NULL;
+
+    file = fopen(TEST_CONFIG_FILE, "w");
+
+    if(file != NULL){
+        fputs(text, file);
+        value = fclose(file) == 0 ? 0 : -1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Checks the published thresholds of a machine
+ * \param int idMachine ID of the machine
+ * \param float engineOn temperature expected to start the engine
+ * \param float engineOff temperature expected to stop the engine
+ * \param int humidity humidity threshold expected
+ * \param char *step name of the check
+ * \return int value (0) if they are the expected ones - (1) if not
+ */
+int checkThresholds(int idMachine, float engineOn, float engineOff, int humidity, char *step)
+{
+    int value = 0;
+    Thresholds thresholds;
+
+    if(mechatronic_getThresholds(idMachine, &thresholds) != 0 || thresholds.temperatureEngineOn != engineOn ||
+       thresholds.temperatureEngineOff != engineOff || thresholds.humidityThreshold != humidity){
+        printf("ERROR!, %s: umbrales %.2f %.2f %d, se esperaba %.2f %.2f %d\n", step, thresholds.temperatureEngineOn,
+               thresholds.temperatureEngineOff, thresholds.humidityThreshold, engineOn, engineOff, humidity);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Checks that a reload of a configuration file is rejected and keeps the published thresholds
+ * \param char *text content of the file
+ * \param char *step name of the check
+ * \return int value (0) if it was rejected - (1) if not
+ */
+int checkRejected(char *text, char *step)
+{
+    int value = 0;
+    Thresholds before;
+
+    mechatronic_getThresholds(0, &before);
+    writeTestConfig(text);
+
+    if(mechatronic_reloadThresholds(TEST_CONFIG_FILE) >= 0){
+        printf("ERROR!, %s: se acepto la recarga\n", step);
+        value = 1;
+    }
+    else
+        value = checkThresholds(0, before.temperatureEngineOn, before.temperatureEngineOff, before.humidityThreshold, step);
+
+    return value;
+}
+
+/**
+ * \brief Counts the thresholds replaced that are still allocated
+ * \return int value number of configurations replaced, without the initial one
+ */
+int countReplaced(void)
+{
+    int value = 0;
+    ThresholdSnapshot *pSnapshot = NULL;
+
+    for(pSnapshot = pThresholdSnapshot->pReplaced; pSnapshot != NULL && pSnapshot != &initialThresholds; pSnapshot = pSnapshot->pReplaced)
+        value++;
+
+    return value;
+}
+
+/**
+ * \brief Takes the place of a thread that stopped while it was reading the thresholds and checks that the
+ *        configurations it can have are kept, and only those: the one it was reading and every one replaced after
+ *        it started. When it reads again the older ones are released
+ * \return int value (0) if ok - (1) if not
+ */
+int checkStalledReader(void)
+{
+    int value = 0;
+    int kept[3];
+    ThresholdReader *pReader = &thresholdReaders[MECHATRONIC_THRESHOLD_READERS - 1];
+
+    writeTestConfig(TEST_CONFIG_A);
+
+    // el lugar queda ocupado para que ningun hilo lo tome
+    pReader->used = 1;
+    pReader->epoch = thresholdEpoch;
+
+    if(mechatronic_reloadThresholds(TEST_CONFIG_FILE) < 0 || mechatronic_reloadThresholds(TEST_CONFIG_FILE) < 0)
+        value = 1;
+
+    kept[0] = countReplaced();
+
+    // el lector vuelve a leer, solo puede tener la ultima configuracion
+    pReader->epoch = thresholdEpoch;
+
+    if(mechatronic_reloadThresholds(TEST_CONFIG_FILE) < 0)
+        value = 1;
+
+    kept[1] = countReplaced();
+    pReader->epoch = 0;
+
+    if(mechatronic_reloadThresholds(TEST_CONFIG_FILE) < 0)
+        value = 1;
+
+    kept[2] = countReplaced();
+    pReader->used = 0;
+
+    if(value != 0 || kept[0] != 2 || kept[1] != 1 || kept[2] != 0){
+        printf("ERROR!, con un lector detenido quedaron %d, %d y %d configuraciones reemplazadas, se esperaban 2, 1 y 0\n", kept[0], kept[1], kept[2]);
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Reloads the configuration again and again while several threads read the thresholds. Every read must be
+ *        one of the configurations complete, and the configurations replaced must be released while the threads
+ *        keep reading, not only when they stop
+ * \return int value (0) if ok - (1) if not
+ */
+int checkConcurrentReloads(void)
+{
+    int i;
+    int value = 0;
+    int started = 0;
+    int inconsistent[TEST_READERS] = {0};
+    pthread_t readers[TEST_READERS];
+    struct timespec pause = {0, 2000000};
+
+    __atomic_store_n(&readerDone, 0, __ATOMIC_RELEASE);
+
+    for(i = 0; i < TEST_READERS; i++){
+        if(pthread_create(&readers[i], NULL, readThresholds, &inconsistent[i]) == 0)
+            started++;
+        else
+            break;
+    }
+
+    for(i = 0; i < TEST_RELOADS; i++){
+        writeTestConfig(i % 2 == 0 ? TEST_CONFIG_A : TEST_CONFIG_B);
+
+        if(mechatronic_reloadThresholds(TEST_CONFIG_FILE) < 0)
+            value = 1;
+    }
+
+    // con los lectores activos las recargas siguientes liberan lo que quedo pendiente
+    for(i = 0; i < TEST_RELEASE_TRIES && countReplaced() > 1; i++){
+        nanosleep(&pause, NULL);
+        mechatronic_reloadThresholds(TEST_CONFIG_FILE);
+    }
+
+    if(countReplaced() > 1){
+        printf("ERROR!, con %d lectores activos quedaron %d configuraciones reemplazadas sin liberar\n", started, countReplaced());
+        value = 1;
+    }
+
+    __atomic_store_n(&readerDone, 1, __ATOMIC_RELEASE);
+
+    for(i = 0; i < started; i++){
+        pthread_join(readers[i], NULL);
+
+        if(inconsistent[i] > 0){
+            printf("ERROR!, el lector %d hizo %d lecturas que mezclaron dos configuraciones\n", i, inconsistent[i]);
+            value = 1;
+        }
+    }
+
+    // sin lectores la siguiente recarga libera todo
+    mechatronic_reloadThresholds(TEST_CONFIG_FILE);
+
+    if(started != TEST_READERS || countReplaced() != 0){
+        printf("ERROR!, quedaron %d configuraciones reemplazadas sin liberar\n", countReplaced());
+        value = 1;
+    }
+
+    return value;
+}
+
+/**
+ * \brief Body of the thread that reads the thresholds of the main machine until the reloads end
+ * \param void *pArgument pointer to the number of reads that mixed the two configurations
+ * \return void *value (NULL)
+ */
+void *readThresholds(void *pArgument)
+{
+    Thresholds thresholds;
+
+    while(!__atomic_load_n(&readerDone, __ATOMIC_ACQUIRE)){
+        mechatronic_getThresholds(0, &thresholds);
+
+        if(!(thresholds.temperatureEngineOn == 30.5f && thresholds.temperatureEngineOff == 10.25f && thresholds.humidityThreshold == 50) &&
+           !(thresholds.temperatureEngineOn == -3.5f && thresholds.temperatureEngineOff == -10.75f && thresholds.humidityThreshold == 90) &&
+           !(thresholds.temperatureEngineOn == 327.67f && thresholds.temperatureEngineOff == -327.68f && thresholds.humidityThreshold == 0))
+            (*(int*)pArgument)++;
+    }
+
+    return NULL;
+}
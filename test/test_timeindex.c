@@ -0,0 +1,347 @@
+/**
+* Copyrigth (c) 2023, Iriarte Federico (fedeiria@gmail.com)
+*
+* This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+* General Public License as published by the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+* even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with this program. If not, see
+* <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../inc/mechatronic.h"
+
+// EVENTOS GUARDADOS Y EVENTOS POR SEGMENTO, EL REGISTRO QUEDA EN VARIOS SEGMENTOS
+#define TEST_EVENTS 45
+#define TEST_SEGMENT_EVENTS 10
+
+// FECHA DEL PRIMER EVENTO Y SEGUNDOS ENTRE EVENTOS, DOS EVENTOS POR BALDE DEL INDICE
+#define TEST_START 1600000000LL
+#define TEST_STEP 1800LL
+
+// DESPLAZAMIENTO DE LAS FECHAS DE UN SEGUNDO REGISTRO, UN DIA
+#define TEST_SHIFT 86400LL
+
+// private variables of mechatronic.c
+extern SegmentLog *pSegmentLog;
+extern TimeIndex *pTimeIndex;
+extern int firstEvent;
+extern int segmentEvents;
+
+long long testTimestamp(int number, long long shift);
+int openLog(char *directory);
+int closeLog(void);
+int saveTestEvents(int first, int count, long long shift, int indexed);
+int checkRange(long long from, long long to, int first, int count, long long shift, char *step);
+int checkRanges(void);
+int checkStaleIndex(void);
+int checkInvalidIndex(void);
+int checkIndexAhead(void);
+
+/**
+ * \brief Checks the ranges read with the time index as the --range report does, opening only the binary file and
+ *        the index: empty ranges, ranges before and after every event, ranges that go through several segments, and
+ *        indexes that don't match the binary file, because events were saved without them, the file is damaged or
+ *        it belongs to a longer binary file. Those indexes must be rebuilt and the ranges read as if they were right
+ * \return int value (0) if every check passed - (1) if not
+ */
+int main(void)
+{
+    int failed = 0;
+
+    segmentEvents = TEST_SEGMENT_EVENTS;
+
+    failed += checkRanges();
+    failed += checkStaleIndex();
+    failed += checkInvalidIndex();
+    failed += checkIndexAhead();
+
+    printf("test_timeindex: %s\n", failed == 0 ? "OK" : "ERROR");
+
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Gets the time of a test event
+ * \param int number number of the event
+ * \param long long shift seconds added to every event of the binary file
+ * \return long long timestamp time of the event in seconds since the epoch
+ */
+long long testTimestamp(int number, long long shift)
+{
+    return TEST_START + shift + number * TEST_STEP;
+}
+
+/**
+ * \brief Opens the binary file and its time index of a directory the same way the --range report does, creating
+ *        the directory if it does not exist
+ * \param char *directory directory of the binary file, the working directory until closeLog
+ * \return int value (0) if ok - (1) if not
+ */
+int openLog(char *directory)
+{
+    int value = 1;
+
+    mkdir(directory, 0755);
+
+    if(chdir(directory) == 0 && mechatronic_openBinaryFile() == 0 && mechatronic_applyConfig(NULL) == 0){
+        firstEvent = sl_getFirst(pSegmentLog);
+        mechatronic_openIndexFile(pSegmentLog->next - firstEvent);
+
+        if(pTimeIndex != NULL)
+            value = 0;
+    }
+
+    if(value != 0)
+        printf("ERROR!, no se pudo abrir el archivo binario de %s\n", directory);
+
+    return value;
+}
+
+/**
+ * \brief Closes the binary file and its time index and goes back to the directory of the test
+ * \return int value (0) if ok - (1) if not
+ */
+int closeLog(void)
+{
+    mechatronic_closeBinaryFile();
+
+    return chdir("..") == 0 ? 0 : 1;
+}
+
+/**
+ * \brief Saves test events at the end of the binary file
+ * \param int first number of the first event
+ * \param int count number of events
+ * \param long long shift seconds added to the time of every event
+ * \param int indexed [1] the events are added to the time index - [0] the index is left as it was
+ * \return int value (0) if ok - (1) if not
+ */
+int saveTestEvents(int first, int count, long long shift, int indexed)
+{
+    int i;
+    int next = pSegmentLog->next;
+    Mechatronic event;
+    TimeIndex *pIndex = pTimeIndex;
+
+    if(!indexed)
+        pTimeIndex = NULL;
+
+    for(i = first; i < first + count; i++){
+        memset(&event, 0, sizeof(Mechatronic));
+        mechatronic_setTimestamp(&event, testTimestamp(i, shift), NULL);
+        event.eventType = (EventType)(i % EVENT_TYPE_COUNT);
+        event.ambientTemperatureRead = i * 0.5f;
+        event.humidityTemperatureRead = i;
+        mechatronic_saveBinaryFile(&event);
+    }
+
+    pTimeIndex = pIndex;
+
+    return pSegmentLog->next == next + count ? 0 : 1;
+}
+
+/**
+ * \brief Reads a time range with mechatronic_queryRange and checks that it returns exactly the expected events, in order
+ * \param long long from start of the range
+ * \param long long to end of the range, included
+ * \param int first number of the first event expected
+ * \param int count number of events expected
+ * \param long long shift seconds added to the time of every event of the binary file
+ * \param char *step name of the check for the error message
+ * \return int value (0) if ok - (1) if not
+ */
+int checkRange(long long from, long long to, int first, int count, long long shift, char *step)
+{
+    int i;
+    int value = 0;
+    Mechatronic *pEvent = NULL;
+    ArrayList *pEvents = NULL;
+
+    pEvents = mechatronic_queryRange(from, to);
+
+    if(pEvents == NULL || al_len(pEvents) != count)
+        value = 1;
+
+    for(i = 0; i < count && value == 0; i++){
+        pEvent = al_get(pEvents, i);
+
+        if(pEvent->timestamp != testTimestamp(first + i, shift) || pEvent->humidityTemperatureRead != first + i)
+            value = 1;
+    }
+
+    if(value != 0)
+        printf("ERROR!, %s: se esperaban %d eventos desde el %d y se leyeron %d\n", step, count, first, pEvents != NULL ? al_len(pEvents) : -1);
+
+    al_deleteArrayList(pEvents);
+
+    return value;
+}
+
+/**
+ * \brief Saves the events in several segments and reads ranges after opening the binary file again: an inverted
+ *        range, a range between two events, ranges before the first event and after the last one, every event, a
+ *        range inside one bucket and ranges that go through two or more segments
+ * \return int value (0) if ok - (1) if not
+ */
+int checkRanges(void)
+{
+    int value = 0;
+
+    if(openLog("ranges") == 0){
+        value += saveTestEvents(0, TEST_EVENTS, 0, 1);
+        value += closeLog();
+    }
+    else
+        value++;
+
+    if(value == 0 && openLog("ranges") == 0){
+        if(sl_len(pSegmentLog) < TEST_EVENTS / TEST_SEGMENT_EVENTS)
+            value++;
+
+        value += checkRange(testTimestamp(10, 0), testTimestamp(5, 0), 0, 0, 0, "rango invertido");
+        value += checkRange(testTimestamp(7, 0) + 1, testTimestamp(8, 0) - 1, 0, 0, 0, "rango entre dos eventos");
+        value += checkRange(0, testTimestamp(0, 0) - 1, 0, 0, 0, "rango anterior al primer evento");
+        value += checkRange(testTimestamp(TEST_EVENTS, 0), testTimestamp(TEST_EVENTS + 100, 0), 0, 0, 0, "rango posterior al ultimo evento");
+        value += checkRange(0, LLONG_MAX, 0, TEST_EVENTS, 0, "todos los eventos");
+        value += checkRange(testTimestamp(3, 0), testTimestamp(3, 0), 3, 1, 0, "rango de un evento");
+        value += checkRange(testTimestamp(8, 0), testTimestamp(11, 0), 8, 4, 0, "rango entre dos segmentos");
+        value += checkRange(testTimestamp(5, 0) - 1, testTimestamp(37, 0) + 1, 5, 33, 0, "rango de varios segmentos");
+        value += checkRange(testTimestamp(40, 0), LLONG_MAX, 40, TEST_EVENTS - 40, 0, "rango hasta el final");
+        value += closeLog();
+    }
+    else
+        value++;
+
+    return value != 0 ? 1 : 0;
+}
+
+/**
+ * \brief Saves events without adding them to the index, as after a crash, and checks that the index is rebuilt
+ *        when the binary file is opened again and covers the new events
+ * \return int value (0) if ok - (1) if not
+ */
+int checkStaleIndex(void)
+{
+    int value = 0;
+
+    if(openLog("stale") == 0){
+        value += saveTestEvents(0, 20, 0, 1);
+        value += saveTestEvents(20, TEST_EVENTS - 20, 0, 0);
+        value += closeLog();
+    }
+    else
+        value++;
+
+    if(value == 0 && openLog("stale") == 0){
+        if(!ti_isValid(pTimeIndex, pSegmentLog->next, testTimestamp(TEST_EVENTS - 1, 0))){
+            printf("ERROR!, el indice desactualizado no se reconstruyo\n");
+            value++;
+        }
+
+        value += checkRange(testTimestamp(25, 0), testTimestamp(44, 0), 25, 20, 0, "indice desactualizado");
+        value += checkRange(testTimestamp(15, 0), testTimestamp(24, 0), 15, 10, 0, "indice desactualizado, antes y despues");
+        value += closeLog();
+    }
+    else
+        value++;
+
+    return value != 0 ? 1 : 0;
+}
+
+/**
+ * \brief Overwrites the index with bytes that are not an index and checks that it is rebuilt
+ * \return int value (0) if ok - (1) if not
+ */
+int checkInvalidIndex(void)
+{
+    int value = 0;
+    FILE *file = NULL;
+
+    if(openLog("invalid") == 0){
+        value += saveTestEvents(0, TEST_EVENTS, 0, 1);
+        value += closeLog();
+    }
+    else
+        value++;
+
+    file = fopen("invalid/" MECHATRONIC_INDEX_FILE, "wb");
+
+    if(file == NULL || fwrite("esto no es un indice valido", 1, 27, file) != 27)
+        value++;
+
+    if(file != NULL)
+        fclose(file);
+
+    if(value == 0 && openLog("invalid") == 0){
+        value += checkRange(testTimestamp(9, 0), testTimestamp(30, 0), 9, 22, 0, "indice invalido");
+        value += checkRange(0, LLONG_MAX, 0, TEST_EVENTS, 0, "indice invalido, todos los eventos");
+        value += closeLog();
+    }
+    else
+        value++;
+
+    return value != 0 ? 1 : 0;
+}
+
+/**
+ * \brief Copies the index of a binary file over the index of a shorter binary file with other dates, the index
+ *        points to records that don't exist, and checks that it is rebuilt
+ * \return int value (0) if ok - (1) if not
+ */
+int checkIndexAhead(void)
+{
+    int value = 0;
+    long size = 0;
+    char *pBytes = NULL;
+    FILE *file = NULL;
+
+    // el indice de checkRanges cubre TEST_EVENTS eventos
+    file = fopen("ranges/" MECHATRONIC_INDEX_FILE, "rb");
+
+    if(file != NULL && fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0){
+        pBytes = (char*)malloc(size);
+
+        if(pBytes == NULL || (long)fread(pBytes, 1, size, file) != size)
+            value++;
+    }
+    else
+        value++;
+
+    if(file != NULL)
+        fclose(file);
+
+    if(value == 0 && openLog("ahead") == 0){
+        value += saveTestEvents(0, 20, TEST_SHIFT, 1);
+        value += closeLog();
+
+        file = fopen("ahead/" MECHATRONIC_INDEX_FILE, "wb");
+
+        if(file == NULL || (long)fwrite(pBytes, 1, size, file) != size)
+            value++;
+
+        if(file != NULL)
+            fclose(file);
+    }
+    else
+        value++;
+
+    if(value == 0 && openLog("ahead") == 0){
+        value += checkRange(testTimestamp(0, TEST_SHIFT), testTimestamp(19, TEST_SHIFT), 0, 20, TEST_SHIFT, "indice de otro archivo");
+        value += checkRange(testTimestamp(12, TEST_SHIFT), LLONG_MAX, 12, 8, TEST_SHIFT, "indice de otro archivo, hasta el final");
+        value += closeLog();
+    }
+    else
+        value++;
+
+    free(pBytes);
+
+    return value != 0 ? 1 : 0;
+}